@@ -0,0 +1,61 @@
+/**
+ * @file bench_main.cpp
+ * @brief Host runner for the firmware micro-benchmark suite
+ *
+ *   bench_firmware [--filter <substring>] [--json <file>]
+ *
+ * Prints a table to stdout; --json also writes the machine-readable
+ * results for tools/bench_compare.py.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench_suite.h"
+
+/**
+ * @brief Print adapter over a stdio stream
+ */
+class FilePrint : public Print {
+    FILE* _f;
+public:
+    explicit FilePrint(FILE* f) : _f(f) {}
+    size_t write(uint8_t c) override { return fputc(c, _f) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buf, size_t size) override { return fwrite(buf, 1, size, _f); }
+};
+
+int main(int argc, char** argv) {
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--filter <substring>] [--json <file>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    registerBenchSuite();
+    if (benchRun(filter) == 0) {
+        fprintf(stderr, "no benchmark matches '%s'\n", filter ? filter : "");
+        return 1;
+    }
+
+    FilePrint out(stdout);
+    printBenchTable(out);
+
+    if (jsonPath != nullptr) {
+        FILE* f = fopen(jsonPath, "w");
+        if (f == nullptr) {
+            perror(jsonPath);
+            return 1;
+        }
+        FilePrint json(f);
+        printBenchJson(json);
+        fclose(f);
+    }
+    return 0;
+}
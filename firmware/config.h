@@ -32,6 +32,42 @@
  */
 #define SIMULATION_MODE false
 
+// =============================================================================
+// BENCHMARK BUILD
+// =============================================================================
+/**
+ * @brief Run the micro-benchmark suite at boot instead of monitoring
+ * Results are printed over Serial (table + one JSON line for
+ * tools/bench_compare.py), then the device idles. Never deploy with true.
+ */
+#define BENCH_BUILD false
+
+// =============================================================================
+// LOGGING
+// =============================================================================
+/**
+ * @brief Emit LOGT() messages as binary token frames instead of text
+ * Cuts serial/ring bandwidth ~10x. Decode with tools/log_decode.py.
+ */
+#define LOG_TOKENIZED false
+
+/**
+ * @brief Leveled logging (0=none 1=error 2=warn 3=info 4=debug 5=verbose)
+ * LOG_COMPILE_LEVEL: messages above it are compiled out entirely.
+ * LOG_DEFAULT_LEVEL: boot-time runtime level for every module, adjustable
+ * per module over MQTT or the dashboard. Production: set both to 3.
+ */
+#define LOG_COMPILE_LEVEL 4
+#define LOG_DEFAULT_LEVEL 4
+
+/**
+ * @brief Drain log output to Serial from a background task
+ * true: Log.print() only copies into the ring and never waits on the UART;
+ * if the UART falls a full ring behind, the oldest bytes are dropped and
+ * counted. false: every write goes to Serial synchronously.
+ */
+#define LOG_ASYNC_SERIAL true
+
 // =============================================================================
 // [REQUIRED] ADMIN PHONE NUMBER
 // =============================================================================
@@ -58,6 +94,15 @@
 #define WIFI_SSID "Airtel_Dantales-wifi"  ///< WiFi network name
 #define WIFI_PASS_KEY "9823807410"        ///< WiFi password
 #define WIFI_CONNECT_TIMEOUT 10000UL      ///< 10 seconds - WiFi connection timeout
+#define WIFI_FAST_CONNECT_TIMEOUT 1500UL  ///< Cached BSSID/channel fast-path timeout
+#define WIFI_FAST_REUSE_LEASE true        ///< Reuse the lease after a soft reset (skips DHCP)
+#define WIFI_LEASE_REUSE_MAX_MS 1800000UL ///< 30 min - keep below the router's lease time
+
+// Optional static IP - leave WIFI_STATIC_IP empty to use DHCP
+#define WIFI_STATIC_IP ""                 ///< e.g. "192.168.1.50"
+#define WIFI_STATIC_GATEWAY ""            ///< e.g. "192.168.1.1"
+#define WIFI_STATIC_SUBNET "255.255.255.0"
+#define WIFI_STATIC_DNS ""                ///< Defaults to gateway if empty
 
 // =============================================================================
 // MQTT BROKER SETTINGS — compile-time defaults, overridden by portal config in NVS
@@ -82,9 +127,39 @@
 #define SMS_CHECK_INTERVAL 5000UL      ///< 5 seconds - check for SMS
 #define GPRS_RETRY_INTERVAL 60000UL    ///< 1 minute - between GPRS retries
 #define WIFI_RETRY_INTERVAL 60000UL    ///< 1 minute - between WiFi retries
+#define DIAG_PUBLISH_INTERVAL 300000UL ///< 5 minutes - latency/scheduler diagnostics
 #define NETWORK_TIMEOUT 60000UL        ///< 1 minute - wait for network
 #define WATCHDOG_TIMEOUT_S 30          ///< 30 seconds - watchdog timeout
 
+// =============================================================================
+// BOOT
+// =============================================================================
+/**
+ * @brief Fast boot: take and queue the first reading straight after the
+ * config load, then start the remaining subsystems. WiFi connects from
+ * the network task, the startup LED blink and serial-attach delay are
+ * skipped, and the current zero-bias calibration starts short and is
+ * refined by the sensing task.
+ */
+#define FAST_BOOT true
+
+// =============================================================================
+// POWER MANAGEMENT
+// =============================================================================
+/**
+ * @brief Dynamic frequency scaling and automatic light sleep while idle
+ * Light sleep needs CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE
+ * in the SDK build; without tickless idle only DFS is used. Light sleep is
+ * blocked while the portal AP is up or MQTT runs over GPRS (UART link).
+ */
+#define POWER_LIGHT_SLEEP true
+#define POWER_MAX_FREQ_MHZ 240
+#define POWER_MIN_FREQ_MHZ 80          ///< Lowest DFS step (keeps APB at 80 MHz)
+#define POWER_NET_IDLE_MAX_MS 200      ///< Longest net task sleep (MQTT inbound latency)
+#define POWER_UI_POLL_MS 50            ///< Dashboard/portal poll period
+#define POWER_UI_IDLE_MAX_MS 1000      ///< UI task sleep with no server running
+#define PIN_GSM_RI -1                  ///< SIM800C RI -> GPIO wake source (-1 = not wired)
+
 // =============================================================================
 // PIN DEFINITIONS - GSM Module (SIM800C)
 // =============================================================================
@@ -119,6 +194,33 @@
 // =============================================================================
 #define PIN_STATUS_LED 2  ///< Built-in LED on most ESP32 dev boards
 
+// =============================================================================
+// PIN DEFINITIONS - Control Outputs (Stage 2)
+// GPIO 14 and 27 carry temperature sensors on this board, so the E-stop
+// relay is on GPIO 13 (the Stage 2 plan has it on 27)
+// =============================================================================
+#define PIN_RELAY_COMPRESSOR 4   ///< Relay 1 - Compressor enable
+#define PIN_RELAY_FAN_LOW 5      ///< Relay 2 - Fan low speed
+#define PIN_RELAY_FAN_MED 18     ///< Relay 3 - Fan medium speed
+#define PIN_RELAY_FAN_HIGH 19    ///< Relay 4 - Fan high speed
+#define PIN_RELAY_VALVE_COOL 21  ///< Relay 5 - Cooling mode valve
+#define PIN_RELAY_VALVE_HEAT 22  ///< Relay 6 - Heating mode valve
+#define PIN_RELAY_DEFROST 23     ///< Relay 7 - Defrost trigger
+#define PIN_RELAY_ESTOP 13       ///< Relay 8 - Safety chain (NC, energised while running)
+
+#define RELAY_ACTIVE LOW     ///< Most relay modules are active-low
+#define RELAY_INACTIVE HIGH
+
+// =============================================================================
+// CONTROL TIMING (milliseconds)
+// =============================================================================
+#define COMPRESSOR_RESTART_DELAY_MS 180000UL  ///< Minimum compressor off time
+#define COMPRESSOR_MIN_RUN_MS 120000UL        ///< Minimum compressor on time
+#define FAN_PRERUN_DELAY_MS 30000UL           ///< Fan runs before the compressor starts
+#define FAN_POSTRUN_DELAY_MS 60000UL          ///< Fan keeps running after it stops
+#define MODE_TRANSITION_DELAY_MS 5000UL       ///< Valve settles before the compressor starts
+#define DEFROST_TRIGGER_MS 2000UL             ///< Defrost relay pulse length
+
 // =============================================================================
 // SENSOR CALIBRATION CONSTANTS
 // =============================================================================
@@ -143,6 +245,7 @@
 #define CURRENT_SAMPLES 500         ///< Number of samples for RMS calculation
 #define CURRENT_NOISE_FLOOR 0.3f    ///< Below this threshold (Amps), report 0
 #define CURRENT_ZERO_SAMPLES 1000   ///< Samples for auto-zero calibration at startup
+#define CURRENT_ZERO_SAMPLES_FAST 100 ///< Quick auto-zero for the first reading (FAST_BOOT)
 
 // Pressure Transducer (0.5-4.5V = 0-500 PSI)
 #define PRESSURE_MIN_VOLTAGE 0.5f
@@ -207,5 +310,6 @@
 #define SMS_BUFFER_SIZE 160     ///< Max SMS message length
 #define JSON_BUFFER_SIZE 1024   ///< JSON payload buffer size
 #define STATUS_BUFFER_SIZE 256  ///< Status message buffer size
+#define MQTT_CMD_BUFFER_SIZE 384  ///< Incoming MQTT command payload buffer
 
 #endif  // CONFIG_H
@@ -12,6 +12,8 @@
  * - MQTT data publishing over GPRS
  * - Local data buffering when offline
  * - Watchdog timer for automatic recovery
+ * - Safety-interlocked relay control (Stage 2)
+ * - Closed-loop outlet water temperature control
  *
  * Hardware:
  * - ESP32 WROOM
@@ -36,6 +38,8 @@
 // =============================================================================
 
 #include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include <atomic>
 #include "config.h"
 #include "src/types.h"
 #include "src/globals.h"
@@ -46,13 +50,28 @@
 #include "src/mqtt.h"
 #include "src/provision.h"
 #include "src/dashboard.h"
+#include "src/wifi_link.h"
+#include "src/log_level.h"
+#include "src/postmortem.h"
+#include "src/tasks.h"
+#include "src/scheduler.h"
+#include "src/latency.h"
+#include "src/memstats.h"
+#include "src/control.h"
+#include "src/power.h"
+#include "src/supervisor.h"
+#include "src/events.h"
+#include "src/boot.h"
+#include "src/led.h"
+#include "src/bench_suite.h"
 
 // =============================================================================
 // GLOBAL OBJECT DEFINITIONS
 // =============================================================================
 
 LogCapture Log(Serial);
-TinyGsm modem(Serial2);
+ModemStream modemUart(Serial2);
+TinyGsm modem(modemUart);
 TinyGsmClient gsmClient(modem);
 GSMState gsmState = GSM_UNINITIALIZED;
 PubSubClient mqtt(gsmClient);
@@ -67,12 +86,24 @@ RuntimeConfig runtimeCfg;
 // TIMING STATE
 // =============================================================================
 
-static unsigned long lastSensorRead = 0;
-static unsigned long lastMQTTPublish = 0;
-static unsigned long lastSMSCheck = 0;
+static uint32_t schedMillis() { return millis(); }
+static uint32_t schedMicros() { return micros(); }
+
+/** @brief Periodic jobs of the network task */
+static Scheduler netSched("net", schedMillis, schedMicros);
+static uint8_t smsJob = SCHED_INVALID;
+static uint8_t publishJob = SCHED_INVALID;
+
 static unsigned long lastGPRSAttempt = 0;
 static unsigned long lastWiFiAttempt = 0;
-static unsigned long lastBlink = 0;
+
+/** @brief Config events for the network task (published on any task) */
+static QueueHandle_t netEvents = nullptr;
+
+/** @brief First publish cycle checks the deferred boot WiFi connect (FAST_BOOT) */
+static bool wifiBootCheck = false;
+/** @brief Set by the network task when boot WiFi failed; the UI task starts the portal */
+static std::atomic<bool> portalRequested(false);
 
 // =============================================================================
 // FUNCTION DECLARATIONS
@@ -82,12 +113,18 @@ static void validateConfiguration();
 static void handleSMSCommand(const SMSMessage& msg);
 static void handleStatusCommand(const String& sender);
 static void handleResetCommand();
-static void blinkLED(int times, int duration);
 static void printStartupBanner();
-static bool connectWiFi();
-static bool isWiFiConnected();
 static void ensureMQTTTransport(unsigned long currentMillis);
 static void handleWiFiResetCommand(const String& sender);
+static void setTransport(ConnectionType conn);
+static void applyNetworkConfig();
+static void smsPollJob(void* ctx);
+static void publishJobFn(void* ctx);
+static void diagJob(void* ctx);
+static void memJob(void* ctx);
+static void onDeadlineMiss(const SchedJob& job, int32_t lateMs);
+static void sensingTask(void* arg);
+static void networkTask(void* arg);
 
 // =============================================================================
 // CONFIGURATION VALIDATION
@@ -148,12 +185,52 @@ static void printStartupBanner() {
 // =============================================================================
 
 void setup() {
+    bootMark(BOOT_SETUP);
+    initLed();  // Booting pattern from the first millisecond
+
     // Initialize Serial for debugging
     Log.begin(115200);
+    initPostMortem();  // Before anything else logs over the previous tail
+    bootMark(BOOT_LOG);
+    initControl();     // Relays off and the safety chain open until the engine runs
+
+#if BENCH_BUILD
+    // Benchmark build: no monitoring, no network, no watchdog
+    Log.println(F("[BENCH] Running micro-benchmark suite..."));
+    registerBenchSuite();
+    benchRun(nullptr);
+    Log.flush();
+    printBenchTable(Serial);
+    printBenchJson(Serial);
+    for (;;) {
+        delay(1000);
+    }
+#endif
+#if !FAST_BOOT
     delay(1000);
+#endif
+
+    // Load runtime config from NVS (falls back to config.h defaults); the
+    // first reading needs the calibration and alert thresholds
+    initTaskQueues();
+    initLatency();
+    initMemStats();
+    memRegisterTask(xTaskGetCurrentTaskHandle(), "loop", CONFIG_ARDUINO_LOOP_STACK_SIZE);
+    memRegisterTask(Log.drainTask(), "logtx", LOG_SERIAL_TASK_STACK);
+    initSensors();
+    initAlerts();
+    loadConfig(runtimeCfg);
+    bootMark(BOOT_CONFIG);
+
+    // Take and queue the first reading before the slow subsystems start
+    currentData = readAllSensors();
+    checkAllAlerts(currentData);
+    publishReadingEvent(currentData);
+    bootMark(BOOT_FIRST_READING);
 
     printStartupBanner();
     validateConfiguration();
+    printSensorData(currentData);
 
     // Initialize watchdog timer
     Log.println(F("\n--- Watchdog Timer ---"));
@@ -174,14 +251,9 @@ void setup() {
     Log.print(WATCHDOG_TIMEOUT_S);
     Log.println(F("s timeout"));
 
-    // Initialize status LED
-    pinMode(PIN_STATUS_LED, OUTPUT);
-    blinkLED(3, 200);  // Startup indication
-
     // Initialize subsystems
-    initSensors();
+    initPower();
     initBuffer();
-    initAlerts();
 
     // Initialize GSM module
 //     esp_task_wdt_reset();  // Reset watchdog before long-blocking GSM init
@@ -207,170 +279,348 @@ void setup() {
 //         }
 //     }
 
-    // Load runtime config from NVS (falls back to config.h defaults)
-    esp_task_wdt_reset();
     Log.println(F("\n--- Provisioning ---"));
-    loadConfig(runtimeCfg);
-
     if (!isProvisioned()) {
-        startProvisioningPortal(runtimeCfg);
+        startProvisioningPortal(runtimeCfg);  // Non-blocking, serviced in loop()
     }
 
     // Attempt WiFi connection
-    esp_task_wdt_reset();  // Reset watchdog before long-blocking WiFi init
     Log.println(F("\n--- WiFi Initialization ---"));
+#if FAST_BOOT
+    // Connect from the first publish cycle on the network task instead
+    lastWiFiAttempt = millis() - WIFI_RETRY_INTERVAL;
+    wifiBootCheck = true;
+    Log.println(F("[WIFI] Deferred to the network task"));
+#else
+    esp_task_wdt_reset();  // Reset watchdog before long-blocking WiFi init
     if (connectWiFi()) {
-        activeConnection = CONN_WIFI;
+        setTransport(CONN_WIFI);
         mqtt.setClient(wifiClient);
         Log.println(F("[WIFI] Will use WiFi for MQTT"));
-        initDashboard();
     } else {
-        Log.println(F("[WIFI] Not available, re-launching portal for credential fix"));
+        Log.println(F("[WIFI] Not available, will use GPRS for MQTT"));
+        Log.println(F("[WIFI] Portal running in background for credential fix"));
         startProvisioningPortal(runtimeCfg);
-        esp_task_wdt_reset();
-        if (connectWiFi()) {
-            activeConnection = CONN_WIFI;
-            mqtt.setClient(wifiClient);
-            Log.println(F("[WIFI] Connected after portal, will use WiFi for MQTT"));
-            initDashboard();
-        } else {
-            Log.println(F("[WIFI] Still not available, will use GPRS for MQTT"));
-        }
     }
+#endif
 
     // Configure MQTT
     mqtt.setServer(runtimeCfg.mqttHost, runtimeCfg.mqttPort);
     mqtt.setCallback(mqttCallback);
-    mqtt.setKeepAlive(60);
+    mqtt.setKeepAlive(MQTT_KEEPALIVE_S);
     mqtt.setBufferSize(JSON_BUFFER_SIZE);
 
-    Log.println(F("\n--- Initialization Complete ---"));
-    Log.println(F("Starting main loop...\n"));
+    Log.println(F("\n--- Starting Tasks ---"));
+    // Subscribed after loadConfig(): only later changes need applying
+    netEvents = createEventQueue(NET_EVENT_QUEUE_LEN);
+    subscribeEventQueue(EVENT_MASK(EVT_CONFIG), netEvents);
+    smsJob = netSched.add("sms", smsPollJob, nullptr, runtimeCfg.smsCheckInterval,
+                          NET_SMS_DEADLINE_MS, 1);
+    publishJob = netSched.add("publish", publishJobFn, nullptr, runtimeCfg.publishInterval,
+                              NET_PUBLISH_DEADLINE_MS, 0);
+    netSched.add("diag", diagJob, nullptr, DIAG_PUBLISH_INTERVAL, NET_DIAG_DEADLINE_MS, 2);
+    netSched.add("mem", memJob, nullptr, MEM_SAMPLE_INTERVAL_MS, MEM_SAMPLE_DEADLINE_MS, 3);
+    netSched.setMissHook(onDeadlineMiss);
+
+    startPinnedTask(sensingTask, "sense", SENSE_TASK_STACK, SENSE_TASK_PRIO, SENSE_TASK_CORE);
+    startPinnedTask(networkTask, "net", NET_TASK_STACK, NET_TASK_PRIO, NET_TASK_CORE);
+    startControl();
+    bootMark(BOOT_TASKS);
+
+    // From here on only the supervisor feeds the hardware watchdog
+    setSupervisorRecovery(SUP_PUBLISH, abortMQTTTransport);
+    setSupervisorRecovery(SUP_GSM, abortModemExchange);
+    setSupervisorRecovery(SUP_DASHBOARD, abortDashboardClient);
+    startSupervisor();
 
+    Log.println(F("\n--- Initialization Complete ---"));
     startupComplete = true;
-
-    // Take initial reading
-    esp_task_wdt_reset();
-    currentData = readAllSensors();
-    printSensorData(currentData);
+    ledSet(LED_BOOTING, false);
+    bootMark(BOOT_SETUP_DONE);
+    logBootProfile();
 }
 
 // =============================================================================
-// MAIN LOOP
+// SENSING TASK (high priority, application core)
 // =============================================================================
 
-void loop() {
-    unsigned long currentMillis = millis();
+/**
+ * @brief Read sensors on a fixed period and evaluate alerts
+ *
+ * Wakes are scheduled on absolute ticks so the period does not drift;
+ * the deviation of every wake from its schedule is recorded as jitter.
+ * Each reading is published as EVT_READING; subscribers forward it to the
+ * network task and the latest-reading snapshot.
+ */
+static void sensingTask(void* arg) {
+#if FAST_BOOT
+    // The first reading used a short zero-bias calibration; refine it
+    {
+        PowerBusy busy;
+        calibrateCurrentZero(CURRENT_ZERO_SAMPLES);
+    }
+#endif
 
-    // Feed watchdog
-    esp_task_wdt_reset();
+    // Start on a tick boundary so the schedule and the tick grid agree
+    vTaskDelay(1);
+    TickType_t wake = xTaskGetTickCount();
+    int64_t scheduledUs = esp_timer_get_time();
+
+    for (;;) {
+        uint32_t periodMs = runtimeCfg.sensorReadInterval;
+        wake += pdMS_TO_TICKS(periodMs);
+        scheduledUs += (int64_t)periodMs * 1000;
+        sleepUntilTick(wake, SUP_SENSE);
+
+        int64_t nowUs = esp_timer_get_time();
+        int64_t deviationUs = nowUs - scheduledUs;
+        if (deviationUs > (int64_t)periodMs * 1000) {
+            // Overran a whole period: resynchronise instead of catching up
+            wake = xTaskGetTickCount();
+            scheduledUs = nowUs;
+        }
+        recordSensorJitter((int32_t)deviationUs);
 
-    // Heartbeat LED blink
-    if (currentMillis - lastBlink >= 5000) {
-        lastBlink = currentMillis;
-        blinkLED(1, 50);
+        LOG_D(MAIN, "Reading sensors...\n");
+        {
+            PowerBusy busy;  // Full clock, no light sleep mid-sampling
+            LatencyScope timer(LAT_SENSOR_READ);
+            currentData = readAllSensors();
+        }
+        printSensorData(currentData);
+
+        checkAllAlerts(currentData);
+        publishReadingEvent(currentData);
     }
+}
 
-    // =========================================================
-    // TASK 1: Read sensors (every SENSOR_READ_INTERVAL)
-    // =========================================================
-    if (currentMillis - lastSensorRead >= SENSOR_READ_INTERVAL) {
-        lastSensorRead = currentMillis;
+// =============================================================================
+// NETWORK TASK (protocol core)
+// =============================================================================
 
-        Log.println(F("\n[MAIN] Reading sensors..."));
-        currentData = readAllSensors();
-        printSensorData(currentData);
+/**
+ * @brief Own the transports, MQTT, the modem and the offline buffer
+ */
+static void networkTask(void* arg) {
+    SystemData reading;
+    OutgoingSMS sms;
+
+    for (;;) {
+        supervisorCheckIn(SUP_NET);
+
+        // Sleep until the next job release (or a queued reading); the chip
+        // can light-sleep here when every other task is blocked too
+        uint32_t idleMs = powerIdleWait(netSched.msUntilNext(), POWER_NET_IDLE_MAX_MS);
+        bool gotReading = receiveReading(reading, pdMS_TO_TICKS(idleMs));
+
+        // Everything below runs at full clock with light sleep blocked
+        // (modem AT exchanges must not lose UART bytes)
+        PowerBusy busy;
+        uint32_t passStart = micros();
+
+        // Buffer queued readings
+        while (gotReading) {
+            bufferData(reading);
+            printBufferStatus();
+            gotReading = receiveReading(reading, 0);
+        }
 
-        if (networkReady) {
-            checkAllAlerts(currentData);
+        // Restart the modem if the supervisor asked for it, then send SMS
+        // queued by the alert checks
+        serviceModemRestart();
+        while (receiveSMS(sms)) {
+            SupervisedOp op(SUP_GSM);
+            sendQueuedSMS(sms);
         }
 
-        bufferData(currentData);
-        printBufferStatus();
-    }
+        // Answer control commands once the control task has applied them
+        ControlResult ctrl;
+        while (receiveControlResult(ctrl)) {
+            SupervisedOp op(SUP_PUBLISH);
+            publishControlResponse(ctrl);
+        }
 
-    // =========================================================
-    // TASK 2: Check for SMS commands (every SMS_CHECK_INTERVAL)
-    // =========================================================
-    if (networkReady && (currentMillis - lastSMSCheck >= SMS_CHECK_INTERVAL)) {
-        lastSMSCheck = currentMillis;
+        // Apply config changes saved by the portal or an MQTT command
+        uint8_t changed = 0;
+        Event ev;
+        while (xQueueReceive(netEvents, &ev, 0) == pdTRUE) {
+            changed |= ev.configChanged;
+        }
+        if (changed) {
+            // The portal saves from the UI task and leaves runtimeCfg
+            // alone; this task takes the saved values over itself
+            readSavedConfig(runtimeCfg);
+            if (changed & CFG_SECTION_INTERVALS) {
+                netSched.setPeriod(smsJob, runtimeCfg.smsCheckInterval);
+                netSched.setPeriod(publishJob, runtimeCfg.publishInterval);
+            }
+            if (changed & CFG_SECTION_NETWORK) {
+                applyNetworkConfig();
+            }
+        }
+
+        // SMS poll and MQTT publish, earliest deadline first
+        netSched.runOnce();
 
-        SMSMessage msg;
-        if (checkIncomingSMS(msg)) {
-            handleSMSCommand(msg);
+        // =========================================================
+        // Maintain MQTT connection
+        // =========================================================
+        serviceWiFiLink();
+        if (activeConnection == CONN_WIFI && !isWiFiConnected()) {
+            Log.println(F("[MAIN] WiFi dropped, resetting MQTT transport"));
+            disconnectMQTT();
+            setTransport(CONN_NONE);
+        } else if (activeConnection == CONN_GPRS && !isGPRSConnected()) {
+            Log.println(F("[MAIN] GPRS dropped, resetting MQTT transport"));
+            disconnectMQTT();
+            setTransport(CONN_NONE);
+        }
+        {
+            SupervisedOp op(SUP_PUBLISH);
+            mqttLoop();
         }
+        latencyRecord(LAT_NET_PASS, micros() - passStart);
     }
+}
 
-    // =========================================================
-    // TASK 3: MQTT publish (every MQTT_PUBLISH_INTERVAL)
-    // =========================================================
-    if (currentMillis - lastMQTTPublish >= MQTT_PUBLISH_INTERVAL) {
-        lastMQTTPublish = currentMillis;
+// =============================================================================
+// SCHEDULED JOBS
+// =============================================================================
 
-        Log.println(F("\n[MAIN] MQTT publish cycle..."));
+/**
+ * @brief Poll the modem for SMS commands (net task)
+ */
+static void smsPollJob(void* ctx) {
+    if (!networkReady) return;
 
-        ensureMQTTTransport(currentMillis);
+    SupervisedOp op(SUP_GSM);
+    SMSMessage msg;
+    if (checkIncomingSMS(msg)) {
+        handleSMSCommand(msg);
+    }
+}
 
-        if (activeConnection != CONN_NONE) {
-            if (connectMQTT()) {
-                publishBufferedData();
-            }
-        } else {
-            Log.println(F("[MAIN] No transport available - skipping MQTT"));
+/**
+ * @brief Bring up a transport and flush the offline buffer (net task)
+ */
+static void publishJobFn(void* ctx) {
+    SupervisedOp op(SUP_PUBLISH);
+    LatencyScope timer(LAT_PUBLISH_CYCLE);
+    LOG_D(MAIN, "MQTT publish cycle...\n");
+
+    ensureMQTTTransport(millis());
+
+    if (wifiBootCheck) {
+        // Deferred boot connect: same fallback as a failed connect in setup()
+        wifiBootCheck = false;
+        if (activeConnection != CONN_WIFI) {
+            Log.println(F("[WIFI] Not available, portal running in background for credential fix"));
+            portalRequested.store(true);
         }
     }
 
-    // =========================================================
-    // TASK 4: Maintain MQTT connection
-    // =========================================================
-    if (activeConnection == CONN_WIFI && !isWiFiConnected()) {
-        Log.println(F("[MAIN] WiFi dropped, resetting MQTT transport"));
-        disconnectMQTT();
-        stopDashboard();
-        activeConnection = CONN_NONE;
-    } else if (activeConnection == CONN_GPRS && !isGPRSConnected()) {
-        Log.println(F("[MAIN] GPRS dropped, resetting MQTT transport"));
-        disconnectMQTT();
-        activeConnection = CONN_NONE;
+    if (activeConnection != CONN_NONE) {
+        if (connectMQTT()) {
+            publishBufferedData();
+        }
+    } else {
+        Log.println(F("[MAIN] No transport available - skipping MQTT"));
     }
-    mqttLoop();
-    handleDashboard();
+}
+
+/**
+ * @brief Publish latency histograms, scheduler accounting and memory
+ * telemetry (net task)
+ */
+static void diagJob(void* ctx) {
+    SupervisedOp op(SUP_PUBLISH);
+    publishDiagnostics();
+    publishMemoryStats();
+}
 
-    // Small delay to prevent watchdog issues and reduce power
-    delay(10);
+/**
+ * @brief Sample heap and task stacks; raises ALERT_MEMORY (net task)
+ */
+static void memJob(void* ctx) {
+    sampleMemStats();
+}
+
+static void onDeadlineMiss(const SchedJob& job, int32_t lateMs) {
+    LOG_W(MAIN, "Job %s missed its deadline by %d ms (%u misses)\n",
+          job.name, (int)lateMs, (unsigned int)job.misses);
 }
 
 // =============================================================================
-// WIFI HELPERS
+// UI TASK (Arduino loop(), lowest priority)
 // =============================================================================
 
-static bool connectWiFi() {
-    Log.print(F("[WIFI] Connecting to "));
-    Log.println(runtimeCfg.wifiSSID);
+void loop() {
+    uint32_t passStart = micros();
 
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(runtimeCfg.wifiSSID, runtimeCfg.wifiPass);
+    supervisorCheckIn(SUP_DASHBOARD);
 
-    unsigned long start = millis();
-    while (WiFi.status() != WL_CONNECTED && millis() - start < WIFI_CONNECT_TIMEOUT) {
-        delay(250);
-        Log.print(F("."));
+    if (portalRequested.exchange(false)) {
+        // From the saved values: runtimeCfg belongs to the network task
+        RuntimeConfig saved;
+        readSavedConfig(saved);
+        startProvisioningPortal(saved);
     }
-    Log.println();
+    updatePowerMode(isPortalActive(), activeConnection);
+    ledSet(LED_PORTAL, isPortalActive());
+
+    // The dashboard owns port 80 whenever WiFi is up and the portal is not
+    if (isWiFiConnected() && !isPortalActive()) {
+        initDashboard();
+    } else {
+        stopDashboard();
+    }
+    handleDashboard();
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Log.print(F("[WIFI] Connected, IP: "));
-        Log.println(WiFi.localIP());
-        return true;
+    // Service provisioning portal (while active)
+    if (isPortalActive()) {
+        handleProvisioningPortal();
     }
 
-    Log.println(F("[WIFI] Connection failed"));
-    WiFi.disconnect(true);
-    return false;
+    latencyRecord(LAT_UI_PASS, micros() - passStart);
+
+    // Poll often only while a server needs servicing (the status LED runs
+    // from its own timer)
+    bool serving = isPortalActive() || isWiFiConnected();
+    delay(serving ? POWER_UI_POLL_MS : POWER_UI_IDLE_MAX_MS);
 }
 
-static bool isWiFiConnected() {
-    return WiFi.status() == WL_CONNECTED;
+// =============================================================================
+// WIFI HELPERS
+// =============================================================================
+
+/**
+ * @brief Switch the MQTT transport and announce it on the event bus
+ * (network task only)
+ */
+static void setTransport(ConnectionType conn) {
+    if (conn == activeConnection) return;
+
+    ConnectionType prev = activeConnection;
+    activeConnection = conn;
+    if (conn != CONN_NONE) bootMark(BOOT_TRANSPORT);
+    publishTransportEvent(conn, prev);
+}
+
+/**
+ * @brief Drop any existing link so the next publish cycle reconnects with
+ * the new WiFi/MQTT credentials (network task only)
+ */
+static void applyNetworkConfig() {
+    Log.println(F("[MAIN] Network config changed, reconnecting"));
+    disconnectMQTT();
+    mqtt.setServer(runtimeCfg.mqttHost, runtimeCfg.mqttPort);
+    if (activeConnection == CONN_WIFI) {
+        WiFi.disconnect();
+        setTransport(CONN_NONE);
+    }
+    // Retry WiFi immediately rather than waiting WIFI_RETRY_INTERVAL
+    lastWiFiAttempt = millis() - WIFI_RETRY_INTERVAL;
+    netSched.trigger(publishJob);
 }
 
 /**
@@ -386,7 +636,7 @@ static void ensureMQTTTransport(unsigned long currentMillis) {
             Log.println(F("[MAIN] Switching MQTT transport to WiFi"));
             disconnectMQTT();
             mqtt.setClient(wifiClient);
-            activeConnection = CONN_WIFI;
+            setTransport(CONN_WIFI);
         }
         return;
     }
@@ -398,8 +648,7 @@ static void ensureMQTTTransport(unsigned long currentMillis) {
             Log.println(F("[MAIN] Switching MQTT transport to WiFi"));
             disconnectMQTT();
             mqtt.setClient(wifiClient);
-            activeConnection = CONN_WIFI;
-            initDashboard();
+            setTransport(CONN_WIFI);
             return;
         }
     }
@@ -410,7 +659,7 @@ static void ensureMQTTTransport(unsigned long currentMillis) {
             Log.println(F("[MAIN] Switching MQTT transport to GPRS"));
             disconnectMQTT();
             mqtt.setClient(gsmClient);
-            activeConnection = CONN_GPRS;
+            setTransport(CONN_GPRS);
         }
         return;
     }
@@ -418,17 +667,18 @@ static void ensureMQTTTransport(unsigned long currentMillis) {
     // GPRS not connected — attempt reconnect if retry interval passed
     if (currentMillis - lastGPRSAttempt >= GPRS_RETRY_INTERVAL) {
         lastGPRSAttempt = currentMillis;
+        SupervisedOp op(SUP_GSM);
         if (connectGPRS()) {
             Log.println(F("[MAIN] Switching MQTT transport to GPRS"));
             disconnectMQTT();
             mqtt.setClient(gsmClient);
-            activeConnection = CONN_GPRS;
+            setTransport(CONN_GPRS);
             return;
         }
     }
 
     // Neither transport available
-    activeConnection = CONN_NONE;
+    setTransport(CONN_NONE);
 }
 
 // =============================================================================
@@ -466,7 +716,8 @@ static void handleSMSCommand(const SMSMessage& msg) {
 }
 
 static void handleStatusCommand(const String& sender) {
-    SystemData data = readAllSensors();
+    SystemData data;
+    getLatestReading(data);
 
     char statusMsg[SMS_BUFFER_SIZE];
     char bufferStatus[32];
@@ -493,21 +744,7 @@ static void handleResetCommand() {
 static void handleWiFiResetCommand(const String& sender) {
     sendSMS(sender.c_str(), "WiFi config cleared.\nRestarting into setup portal...");
     clearConfig();
+    forgetWiFiLink();
     delay(2000);  // Allow SMS to send
     ESP.restart();
 }
-
-// =============================================================================
-// UTILITY FUNCTIONS
-// =============================================================================
-
-static void blinkLED(int times, int duration) {
-    for (int i = 0; i < times; i++) {
-        digitalWrite(PIN_STATUS_LED, HIGH);
-        delay(duration);
-        digitalWrite(PIN_STATUS_LED, LOW);
-        if (i < times - 1) {
-            delay(duration);
-        }
-    }
-}
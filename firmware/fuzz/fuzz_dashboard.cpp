@@ -0,0 +1,40 @@
+/**
+ * @file fuzz_dashboard.cpp
+ * @brief Fuzz target: raw HTTP requests through handleDashboard()
+ *
+ * The input is everything a browser (or anyone on the LAN) sends on one
+ * connection to port 80: routing, the /api/log position and the
+ * /api/loglevel query parsing all see it. The log ring is pre-filled so
+ * /api/log has text and token frames to escape. Seeds: corpus/dashboard.
+ */
+
+#include <string.h>
+#include <string>
+#include <WiFi.h>
+#include "dashboard.h"
+#include "globals.h"
+#include "host_hooks.h"
+#include "log_level.h"
+
+static uint8_t defaultLevels[LOG_MOD_COUNT];
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv) {
+    // handleDashboard() waits up to 200 ms for a request: use virtual time
+    hostClockManual(1000000);
+    memcpy(defaultLevels, logModuleLevel, sizeof(defaultLevels));
+
+    for (int i = 0; i < 200; i++) {
+        Log.printf("[SENSORS] V=%d.%d I=7.25 \"T\"=45.7\t\\ %c\r\n", 220 + i % 20, i % 10,
+                   (char)(0x80 + i % 0x80));
+    }
+    initDashboard();
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    WiFiServer::hostAccept(80, std::string((const char*)data, size));
+    handleDashboard();
+
+    memcpy(logModuleLevel, defaultLevels, sizeof(defaultLevels));
+    return 0;
+}
@@ -0,0 +1,344 @@
+/**
+ * @file fuzz_main.cpp
+ * @brief Standalone driver for the fuzz targets when libFuzzer is not used
+ *
+ * Links against any LLVMFuzzerTestOneInput() target and accepts the same
+ * command line as a libFuzzer binary, so scripts and ctest work with
+ * either build:
+ *
+ *   fuzz_sms corpus/sms                 replay every file once
+ *   fuzz_sms -runs=100000 corpus/sms    then mutate the corpus at random
+ *   fuzz_sms -bench=50 -json=b.json corpus/sms
+ *                                       time corpus replays (throughput)
+ *   afl-fuzz -i corpus/sms -o out -- ./fuzz_sms
+ *                                       no path: one input from stdin
+ *
+ * The mutator is blind (no coverage feedback); it catches shallow bugs
+ * under the sanitizers in CI. Build with clang and FUZZ_LIBFUZZER, or
+ * with afl-clang-fast++, for coverage-guided runs.
+ *
+ * An input that crashes is written to crash-<run> in the working
+ * directory before the process dies.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+extern "C" __attribute__((weak)) int LLVMFuzzerInitialize(int* argc, char*** argv);
+extern "C" __attribute__((weak)) void __sanitizer_set_death_callback(void (*callback)());
+
+typedef std::vector<uint8_t> Input;
+
+// =============================================================================
+// CRASH CAPTURE
+// =============================================================================
+
+static const Input* currentInput = nullptr;
+static unsigned long currentRun = 0;
+
+/**
+ * @brief Save the input being executed (async-signal-safe)
+ */
+static void dumpCurrentInput() {
+    if (currentInput == nullptr) return;
+
+    char name[32] = "crash-";
+    char digits[20];
+    int n = 0;
+    unsigned long v = currentRun;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    for (int i = 0; i < n; i++) name[6 + i] = digits[n - 1 - i];
+    name[6 + n] = '\0';
+
+    int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        ssize_t ignored = write(fd, currentInput->data(), currentInput->size());
+        (void)ignored;
+        close(fd);
+    }
+    static const char msg[] = "[FUZZ] crashing input saved\n";
+    ssize_t ignored = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+    (void)ignored;
+    currentInput = nullptr;
+}
+
+static struct sigaction previousAction[NSIG];
+
+/**
+ * @brief Save the input, then hand the signal back to its previous owner
+ *
+ * Returning re-delivers it: a fault repeats and abort() raises again, so
+ * ASan still prints its report for a SEGV.
+ */
+static void onFatalSignal(int sig) {
+    dumpCurrentInput();
+    sigaction(sig, &previousAction[sig], nullptr);
+}
+
+static void installCrashHandlers() {
+    static const int signals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGBUS};
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onFatalSignal;
+    for (int sig : signals) sigaction(sig, &sa, &previousAction[sig]);
+    if (__sanitizer_set_death_callback) __sanitizer_set_death_callback(dumpCurrentInput);
+}
+
+/**
+ * @brief UBSan findings abort (and so reach onFatalSignal)
+ *
+ * The gcc UBSan runtime exits without calling the death callback.
+ */
+extern "C" const char* __ubsan_default_options() {
+    return "halt_on_error=1:abort_on_error=1:print_stacktrace=1";
+}
+
+static void runOne(const Input& in, unsigned long run) {
+    currentInput = &in;
+    currentRun = run;
+    LLVMFuzzerTestOneInput(in.data(), in.size());
+    currentInput = nullptr;
+}
+
+// =============================================================================
+// CORPUS
+// =============================================================================
+
+static bool readFile(const std::string& path, Input& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    out.clear();
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+static void loadPath(const std::string& path, size_t maxLen, std::vector<Input>& corpus) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        fprintf(stderr, "[FUZZ] %s: not found\n", path.c_str());
+        exit(2);
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        Input in;
+        if (readFile(path, in)) {
+            if (in.size() > maxLen) in.resize(maxLen);
+            corpus.push_back(in);
+        }
+        return;
+    }
+
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (dir == nullptr) return;
+    while (struct dirent* e = readdir(dir)) {
+        if (e->d_name[0] != '.') names.push_back(e->d_name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());  // Stable order across filesystems
+    for (const std::string& n : names) loadPath(path + "/" + n, maxLen, corpus);
+}
+
+// =============================================================================
+// MUTATOR
+// =============================================================================
+
+/** @brief Bytes that delimit fields in the formats under test */
+static const char SPECIALS[] = "\"\r\n,:;&=%+?{}[] \\\0\xff";
+
+static void mutate(Input& in, const std::vector<Input>& corpus, size_t maxLen, std::mt19937& rng) {
+    int steps = 1 + rng() % 4;
+    for (int s = 0; s < steps; s++) {
+        size_t n = in.size();
+        switch (rng() % 7) {
+            case 0:  // Flip a bit
+                if (n) in[rng() % n] ^= (uint8_t)(1u << (rng() % 8));
+                break;
+            case 1:  // Random byte
+                if (n) in[rng() % n] = (uint8_t)rng();
+                break;
+            case 2:  // Insert a delimiter
+                if (n < maxLen) {
+                    in.insert(in.begin() + (n ? rng() % (n + 1) : 0),
+                              (uint8_t)SPECIALS[rng() % (sizeof(SPECIALS) - 1)]);
+                }
+                break;
+            case 3:  // Erase a range
+                if (n) {
+                    size_t at = rng() % n;
+                    size_t len = 1 + rng() % std::min<size_t>(n - at, 16);
+                    in.erase(in.begin() + at, in.begin() + at + len);
+                }
+                break;
+            case 4:  // Repeat a range (long fields, many separators)
+                if (n) {
+                    size_t at = rng() % n;
+                    size_t len = 1 + rng() % std::min<size_t>(n - at, 32);
+                    Input chunk(in.begin() + at, in.begin() + at + len);
+                    int times = 1 + rng() % 8;
+                    for (int t = 0; t < times && in.size() + len <= maxLen; t++) {
+                        in.insert(in.begin() + at, chunk.begin(), chunk.end());
+                    }
+                }
+                break;
+            case 5:  // Splice the tail of another input
+                if (!corpus.empty()) {
+                    const Input& other = corpus[rng() % corpus.size()];
+                    size_t cut = n ? rng() % n : 0;
+                    size_t from = other.empty() ? 0 : rng() % other.size();
+                    in.resize(cut);
+                    in.insert(in.end(), other.begin() + from, other.end());
+                }
+                break;
+            case 6:  // Truncate
+                if (n) in.resize(rng() % n);
+                break;
+        }
+        if (in.size() > maxLen) in.resize(maxLen);
+    }
+}
+
+// =============================================================================
+// BENCHMARK
+// =============================================================================
+
+/**
+ * @brief Replay the corpus `passes` times; report ns per input
+ *
+ * JSON matches bench_firmware --json, so tools/bench_compare.py can
+ * compare a parser before and after a rewrite.
+ */
+static void bench(const char* name, const std::vector<Input>& corpus, int passes, const char* jsonPath) {
+    size_t bytes = 0;
+    for (const Input& in : corpus) bytes += in.size();
+
+    std::vector<double> nsPerInput;
+    for (int p = 0; p < passes + 1; p++) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (const Input& in : corpus) runOne(in, 0);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        if (p > 0) nsPerInput.push_back(ns / corpus.size());  // First pass warms up
+    }
+
+    std::sort(nsPerInput.begin(), nsPerInput.end());
+    double mean = 0;
+    for (double v : nsPerInput) mean += v;
+    mean /= nsPerInput.size();
+    double var = 0;
+    for (double v : nsPerInput) var += (v - mean) * (v - mean);
+    double stddev = sqrt(var / nsPerInput.size());
+    double median = nsPerInput[nsPerInput.size() / 2];
+    double p90 = nsPerInput[std::min(nsPerInput.size() - 1, nsPerInput.size() * 9 / 10)];
+    double mbPerS = bytes / (median * corpus.size() / 1e9) / 1e6;
+
+    printf("[FUZZ] %s: %zu inputs, %zu bytes; median %.0f ns/input (%.0f execs/s, %.1f MB/s)\n",
+           name, corpus.size(), bytes, median, 1e9 / median, mbPerS);
+
+    if (jsonPath != nullptr) {
+        FILE* f = fopen(jsonPath, "w");
+        if (f == nullptr) {
+            perror(jsonPath);
+            exit(2);
+        }
+        fprintf(f, "{\"suite\":\"fuzz\",\"platform\":\"host\",\"timer\":\"steady_clock\",\"results\":["
+                   "{\"name\":\"%s\",\"batch\":%zu,\"samples\":%zu,\"min_ns\":%.1f,\"median_ns\":%.1f,"
+                   "\"mean_ns\":%.1f,\"p90_ns\":%.1f,\"stddev_ns\":%.1f,\"mb_per_s\":%.2f}]}\n",
+                name, corpus.size(), nsPerInput.size(), nsPerInput.front(), median, mean, p90, stddev,
+                mbPerS);
+        fclose(f);
+    }
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+static long optValue(const char* arg, const char* name) {
+    size_t n = strlen(name);
+    return strncmp(arg, name, n) == 0 && arg[n] == '=' ? atol(arg + n + 1) : -1;
+}
+
+int main(int argc, char** argv) {
+    if (LLVMFuzzerInitialize) LLVMFuzzerInitialize(&argc, &argv);
+
+    long runs = 0;
+    long seed = 1;
+    long maxLen = 4096;
+    long benchPasses = 0;
+    const char* jsonPath = nullptr;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        long v;
+        if ((v = optValue(a, "-runs")) >= 0) runs = v;
+        else if ((v = optValue(a, "-seed")) >= 0) seed = v;
+        else if ((v = optValue(a, "-max_len")) > 0) maxLen = v;
+        else if ((v = optValue(a, "-bench")) >= 0) benchPasses = v;
+        else if (strncmp(a, "-json=", 6) == 0) jsonPath = a + 6;
+        else if (a[0] == '-') continue;  // Other libFuzzer flags: ignored
+        else paths.push_back(a);
+    }
+
+    installCrashHandlers();
+
+    if (paths.empty()) {
+        // AFL without @@, or a quick manual repro: one input from stdin
+        Input in;
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0 && in.size() < (size_t)maxLen) {
+            in.insert(in.end(), buf, buf + n);
+        }
+        if (in.size() > (size_t)maxLen) in.resize(maxLen);
+        runOne(in, 0);
+        return 0;
+    }
+
+    std::vector<Input> corpus;
+    for (const std::string& p : paths) loadPath(p, maxLen, corpus);
+    if (corpus.empty()) corpus.push_back(Input());
+
+    const char* name = strrchr(argv[0], '/') ? strrchr(argv[0], '/') + 1 : argv[0];
+    if (benchPasses > 0) {
+        bench(name, corpus, (int)benchPasses, jsonPath);
+        return 0;
+    }
+
+    for (size_t i = 0; i < corpus.size(); i++) runOne(corpus[i], i);
+    printf("[FUZZ] %s: replayed %zu inputs\n", name, corpus.size());
+
+    if (runs > 0) {
+        std::mt19937 rng((uint32_t)seed);
+        auto t0 = std::chrono::steady_clock::now();
+        Input in;
+        for (long r = 0; r < runs; r++) {
+            in = corpus[rng() % corpus.size()];
+            mutate(in, corpus, maxLen, rng);
+            runOne(in, corpus.size() + r);
+        }
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        printf("[FUZZ] %s: %ld mutated runs in %.1f s (%.0f execs/s), seed %ld\n", name, runs, s,
+               s > 0 ? runs / s : 0.0, seed);
+    }
+    return 0;
+}
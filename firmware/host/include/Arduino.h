@@ -0,0 +1,109 @@
+/**
+ * @file Arduino.h
+ * @brief Host (Linux) stand-in for the ESP32 Arduino core
+ *
+ * Only what the firmware core uses is provided. Time, analog inputs and
+ * GPIO are backed by host_hooks.h so tests can drive them: by default
+ * millis()/micros() follow the host monotonic clock; with a manual clock
+ * they only move when a test (or delay()) advances them.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "esp_system.h"
+
+// =============================================================================
+// CORE MACROS AND TYPES
+// =============================================================================
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PSTR(s) (s)
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+#define ESP_ARDUINO_VERSION_VAL(major, minor, patch) (((major) << 16) | ((minor) << 8) | (patch))
+#define ESP_ARDUINO_VERSION ESP_ARDUINO_VERSION_VAL(2, 0, 17)
+
+#define LOW    0
+#define HIGH   1
+#define INPUT  0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+enum adc_attenuation_t { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db };
+
+// =============================================================================
+// TIME
+// =============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// =============================================================================
+// GPIO / ADC
+// =============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetAttenuation(adc_attenuation_t atten);
+
+// =============================================================================
+// MATH
+// =============================================================================
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::isnan;
+using std::isinf;
+
+// =============================================================================
+// ESP OBJECT
+// =============================================================================
+
+class EspClass {
+public:
+    uint32_t getCycleCount();
+    uint32_t getFreeHeap();
+    uint32_t getCpuFreqMHz() { return 240; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,19 @@
+/**
+ * @file Client.h
+ * @brief Host Arduino Client interface
+ */
+
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include "Stream.h"
+
+class Client : public Stream {
+public:
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual uint8_t connected() = 0;
+    virtual void stop() = 0;
+    virtual operator bool() { return connected(); }
+};
+
+#endif // HOST_CLIENT_H
@@ -0,0 +1,18 @@
+/**
+ * @file DNSServer.h
+ * @brief Host captive-portal DNS: answers nothing
+ */
+
+#ifndef HOST_DNSSERVER_H
+#define HOST_DNSSERVER_H
+
+#include "WiFi.h"
+
+class DNSServer {
+public:
+    bool start(uint16_t port, const String& domain, const IPAddress& ip) { return true; }
+    void stop() {}
+    void processNextRequest() {}
+};
+
+#endif // HOST_DNSSERVER_H
@@ -0,0 +1,37 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Host UART: output goes to stdout (or nowhere), input is scripted
+ *
+ * Serial discards output unless echo is on. Serial2 (the modem UART)
+ * records it, so tests can check the AT commands sent.
+ */
+
+#ifndef HOST_HARDWARESERIAL_H
+#define HOST_HARDWARESERIAL_H
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial : public HostStream {
+    bool _echo;
+    bool _record;
+public:
+    HardwareSerial(bool echo, bool record) : _echo(echo), _record(record) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1,
+               int8_t rxPin = -1, int8_t txPin = -1) {}
+    void end() {}
+    /** @brief Copy output to stdout (Serial only; off by default in tests) */
+    void setEcho(bool echo) { _echo = echo; }
+    operator bool() const { return true; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+#endif // HOST_HARDWARESERIAL_H
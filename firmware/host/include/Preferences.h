@@ -0,0 +1,58 @@
+/**
+ * @file Preferences.h
+ * @brief Host NVS: an in-memory key/value store shared by all instances
+ *
+ * Contents survive end()/begin() within one process, like flash survives
+ * a reboot; hostNvsErase() (host_hooks.h) wipes it between tests.
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include "WString.h"
+
+class Preferences {
+    std::string _ns;
+    bool _open = false;
+    bool _readOnly = false;
+
+    std::string* find(const char* key);
+    bool put(const char* key, const void* value, size_t len);
+    template <typename T>
+    T getScalar(const char* key, T defaultValue) {
+        std::string* v = find(key);
+        if (v == nullptr || v->size() != sizeof(T)) return defaultValue;
+        T out;
+        memcpy(&out, v->data(), sizeof(T));
+        return out;
+    }
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key) { return find(key) != nullptr; }
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+    size_t putBool(const char* key, bool value) { return put(key, &value, sizeof(value)) ? 1 : 0; }
+    size_t putUShort(const char* key, uint16_t value) { return put(key, &value, sizeof(value)) ? 2 : 0; }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, &value, sizeof(value)) ? 4 : 0; }
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+
+    bool getBool(const char* key, bool defaultValue = false) { return getScalar(key, defaultValue); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return getScalar(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getScalar(key, defaultValue); }
+    String getString(const char* key, const String& defaultValue = String());
+    /** @return Bytes copied including the terminator, 0 if missing or too long */
+    size_t getString(const char* key, char* value, size_t maxLen);
+};
+
+#endif // HOST_PREFERENCES_H
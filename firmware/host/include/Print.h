@@ -0,0 +1,65 @@
+/**
+ * @file Print.h
+ * @brief Host implementation of the Arduino Print base class
+ */
+
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Printable;
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t size);
+    virtual void flush() {}
+    virtual int availableForWrite() { return 0; }
+
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t write(const char* buf, size_t size) { return write((const uint8_t*)buf, size); }
+
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const __FlashStringHelper* s);
+    size_t print(const String& s);
+    size_t print(const char* s);
+    size_t print(char c);
+    size_t print(unsigned char v, int base = DEC);
+    size_t print(int v, int base = DEC);
+    size_t print(unsigned int v, int base = DEC);
+    size_t print(long v, int base = DEC);
+    size_t print(unsigned long v, int base = DEC);
+    size_t print(long long v, int base = DEC);
+    size_t print(unsigned long long v, int base = DEC);
+    size_t print(double v, int digits = 2);
+    size_t print(const Printable& p);
+
+    size_t println();
+    template <typename T>
+    size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T>
+    size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+};
+
+/**
+ * @brief Objects that can print themselves (e.g. IPAddress)
+ */
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+#endif // HOST_PRINT_H
@@ -0,0 +1,97 @@
+/**
+ * @file PubSubClient.h
+ * @brief Host MQTT client that records traffic instead of sending it
+ *
+ * connect() succeeds unless a test sets setConnectResult(false). Every
+ * publish, streamed or not, lands in published(); deliver() feeds an
+ * inbound message to the registered callback.
+ */
+
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "Client.h"
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+#define MQTT_MAX_PACKET_SIZE 256
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+/**
+ * @brief One recorded publish
+ */
+struct HostMqttMessage {
+    std::string topic;
+    std::string payload;
+    bool retained;
+};
+
+class PubSubClient {
+    Client* _client = nullptr;
+    MQTT_CALLBACK_SIGNATURE;
+    std::string _host;
+    uint16_t _port = 0;
+    uint16_t _bufferSize = MQTT_MAX_PACKET_SIZE;
+    int _state = MQTT_DISCONNECTED;
+    bool _connectResult = true;
+    bool _publishResult = true;
+    std::vector<HostMqttMessage> _published;
+    std::vector<std::string> _subscriptions;
+    HostMqttMessage _streaming;
+    size_t _streamRemaining = 0;
+public:
+    PubSubClient() {}
+    explicit PubSubClient(Client& client) : _client(&client) {}
+
+    PubSubClient& setClient(Client& client) { _client = &client; return *this; }
+    PubSubClient& setServer(const char* host, uint16_t port) { _host = host; _port = port; return *this; }
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) { this->callback = callback; return *this; }
+    PubSubClient& setKeepAlive(uint16_t keepAlive) { return *this; }
+    PubSubClient& setSocketTimeout(uint16_t timeout) { return *this; }
+    bool setBufferSize(uint16_t size) { _bufferSize = size; return true; }
+    uint16_t getBufferSize() { return _bufferSize; }
+
+    bool connect(const char* id);
+    bool connect(const char* id, const char* user, const char* pass);
+    bool connect(const char* id, const char* user, const char* pass,
+                 const char* willTopic, uint8_t willQos, bool willRetain, const char* willMessage);
+    void disconnect();
+    bool connected() { return _state == MQTT_CONNECTED; }
+    int state() { return _state; }
+    bool loop() { return connected(); }
+
+    bool publish(const char* topic, const char* payload, bool retained = false);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false);
+    bool beginPublish(const char* topic, unsigned int length, bool retained);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size);
+    int endPublish();
+
+    bool subscribe(const char* topic, uint8_t qos = 0);
+    bool unsubscribe(const char* topic);
+
+    // ---- Host test hooks ----
+
+    void setConnectResult(bool ok) { _connectResult = ok; }
+    void setPublishResult(bool ok) { _publishResult = ok; }
+    /** @brief Drop the connection as if the broker went away */
+    void dropConnection() { _state = MQTT_CONNECTION_LOST; }
+    const std::vector<HostMqttMessage>& published() const { return _published; }
+    const std::vector<std::string>& subscriptions() const { return _subscriptions; }
+    const std::string& host() const { return _host; }
+    uint16_t port() const { return _port; }
+    void clearPublished() { _published.clear(); }
+    /** @brief Hand an inbound message to the callback (like loop() would) */
+    void deliver(const char* topic, const std::string& payload);
+};
+
+#endif // HOST_PUBSUBCLIENT_H
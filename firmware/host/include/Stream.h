@@ -0,0 +1,52 @@
+/**
+ * @file Stream.h
+ * @brief Host implementation of the Arduino Stream class, plus a scripted
+ * in-memory stream for modem and client tests
+ */
+
+#ifndef HOST_STREAM_H
+#define HOST_STREAM_H
+
+#include <string>
+#include "Print.h"
+
+class Stream : public Print {
+protected:
+    unsigned long _timeout = 1000;
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    String readStringUntil(char terminator);
+    String readString();
+    size_t readBytes(char* buf, size_t length);
+};
+
+/**
+ * @brief Stream whose input is fed by a test and whose output is recorded
+ */
+class HostStream : public Stream {
+    std::string _rx;
+    size_t _rxPos = 0;
+    std::string _tx;
+public:
+    /** @brief Queue bytes for the firmware to read */
+    void feed(const std::string& data) { _rx += data; }
+    /** @brief Everything the firmware wrote so far */
+    const std::string& written() const { return _tx; }
+    void clear() { _rx.clear(); _rxPos = 0; _tx.clear(); }
+
+    int available() override { return (int)(_rx.size() - _rxPos); }
+    int read() override { return _rxPos < _rx.size() ? (uint8_t)_rx[_rxPos++] : -1; }
+    int peek() override { return _rxPos < _rx.size() ? (uint8_t)_rx[_rxPos] : -1; }
+    size_t write(uint8_t c) override { _tx += (char)c; return 1; }
+    size_t write(const uint8_t* buf, size_t size) override {
+        _tx.append((const char*)buf, size);
+        return size;
+    }
+    using Print::write;
+};
+
+#endif // HOST_STREAM_H
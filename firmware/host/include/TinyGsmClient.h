@@ -0,0 +1,86 @@
+/**
+ * @file TinyGsmClient.h
+ * @brief Host SIM800 modem: a scripted state model over a Stream
+ *
+ * Network/GPRS state and the results of restart(), sendSMS() etc. are
+ * plain fields a test sets. Raw AT traffic (SMS polling) goes through
+ * `stream` (modemUart over Serial2): the test feeds the modem's reply to
+ * Serial2, and the commands written by the firmware are recorded there.
+ */
+
+#ifndef HOST_TINYGSMCLIENT_H
+#define HOST_TINYGSMCLIENT_H
+
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "Client.h"
+
+/**
+ * @brief One SMS handed to sendSMS()
+ */
+struct HostSms {
+    std::string phone;
+    std::string text;
+};
+
+class TinyGsm {
+public:
+    explicit TinyGsm(Stream& s) : stream(s) {}
+
+    Stream& stream;
+
+    // ---- Scripted state (host only) ----
+    bool restartOk = true;
+    bool initOk = true;
+    bool networkConnected = false;
+    bool gprsConnected = false;
+    bool gprsConnectOk = true;
+    bool smsOk = true;
+    int signalQuality = 99;
+    int simStatus = 3;
+    String operatorName = "HOST";
+    String localIP = "10.0.0.2";
+    std::vector<HostSms> sentSms;
+    unsigned int restarts = 0;
+
+    bool restart() { restarts++; return restartOk; }
+    bool init() { return initOk; }
+    String getModemInfo() { return "SIM800 R14.18 (host)"; }
+    int getSimStatus() { return simStatus; }
+    bool simUnlock(const char* pin) { return true; }
+    bool isNetworkConnected() { return networkConnected; }
+    bool waitForNetwork(uint32_t timeout = 60000L) { return networkConnected; }
+    bool isGprsConnected() { return gprsConnected; }
+    bool gprsConnect(const char* apn, const char* user = nullptr, const char* pass = nullptr) {
+        gprsConnected = networkConnected && gprsConnectOk;
+        return gprsConnected;
+    }
+    bool gprsDisconnect() { gprsConnected = false; return true; }
+    int16_t getSignalQuality() { return (int16_t)signalQuality; }
+    String getOperator() { return operatorName; }
+    String getLocalIP() { return localIP; }
+    bool sendSMS(const String& phone, const String& text) {
+        if (smsOk) sentSms.push_back({phone.c_str(), text.c_str()});
+        return smsOk;
+    }
+};
+
+/**
+ * @brief TCP-over-GPRS client stand-in; never connects
+ */
+class TinyGsmClient : public Client {
+public:
+    explicit TinyGsmClient(TinyGsm& modem) {}
+    int connect(const char* host, uint16_t port) override { return 0; }
+    uint8_t connected() override { return 0; }
+    void stop() override {}
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    size_t write(uint8_t c) override { return 0; }
+    size_t write(const uint8_t* buf, size_t size) override { return 0; }
+    using Print::write;
+};
+
+#endif // HOST_TINYGSMCLIENT_H
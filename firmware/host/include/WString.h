@@ -0,0 +1,83 @@
+/**
+ * @file WString.h
+ * @brief Host implementation of the Arduino String class (subset)
+ */
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+    std::string _s;
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const __FlashStringHelper* s) : _s(reinterpret_cast<const char*>(s)) {}
+    String(const std::string& s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(int v, unsigned char base = 10);
+    explicit String(unsigned int v, unsigned char base = 10);
+    explicit String(long v, unsigned char base = 10);
+    explicit String(unsigned long v, unsigned char base = 10);
+    explicit String(float v, unsigned int decimals = 2);
+    explicit String(double v, unsigned int decimals = 2);
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    const char* c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size) { _s.reserve(size); return true; }
+    bool isEmpty() const { return _s.empty(); }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _s[index]; }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const char* s, unsigned int from = 0) const;
+    int indexOf(const String& s, unsigned int from = 0) const { return indexOf(s.c_str(), from); }
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+
+    bool startsWith(const String& prefix) const;
+    bool startsWith(const char* prefix) const { return startsWith(String(prefix)); }
+    bool endsWith(const String& suffix) const;
+    bool equals(const String& other) const { return _s == other._s; }
+    bool equalsIgnoreCase(const String& other) const;
+
+    void trim();
+    void toUpperCase();
+    void toLowerCase();
+    void replace(const String& find, const String& with);
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+
+    long toInt() const;
+    float toFloat() const;
+
+    bool concat(const String& s) { _s += s._s; return true; }
+    bool concat(const char* s) { if (s) _s += s; return true; }
+    bool concat(char c) { _s += c; return true; }
+
+    String& operator+=(const String& s) { _s += s._s; return *this; }
+    String& operator+=(const char* s) { if (s) _s += s; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+    String& operator+=(int v) { return *this += String(v); }
+    String& operator+=(unsigned long v) { return *this += String(v); }
+
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return _s != o._s; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool operator<(const String& o) const { return _s < o._s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._s); }
+    friend String operator+(const String& a, char c) { return String(a._s + c); }
+};
+
+#endif // HOST_WSTRING_H
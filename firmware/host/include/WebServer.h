@@ -0,0 +1,91 @@
+/**
+ * @file WebServer.h
+ * @brief Host synchronous HTTP server with the ESP32 WebServer interface
+ *
+ * handleClient() takes the next connection queued with
+ * WiFiServer::hostAccept(), parses the request line, headers and body the
+ * way the ESP32 library does (query and urlencoded form arguments, '+'
+ * and %XX decoded), runs the matching handler and closes the connection.
+ * Responses are written unchunked, even with CONTENT_LENGTH_UNKNOWN.
+ */
+
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include <functional>
+#include <vector>
+#include "WiFi.h"
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+#define WEBSERVER_MAX_ARGS     32
+#define WEBSERVER_MAX_BODY     4096
+
+enum HTTPMethod {
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+class WebServer {
+public:
+    typedef std::function<void()> THandlerFunction;
+
+    explicit WebServer(uint16_t port = 80) : _server(port) {}
+
+    void begin() { _server.begin(); }
+    void stop() { _server.stop(); }
+    void handleClient();
+
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn) {
+        _routes.push_back({uri, method, fn});
+    }
+    void onNotFound(THandlerFunction fn) { _notFound = fn; }
+
+    // ---- Current request ----
+    HTTPMethod method() const { return _method; }
+    String uri() const { return _uri; }
+    int args() const { return (int)_args.size(); }
+    bool hasArg(const String& name) const;
+    String arg(const String& name) const;
+
+    // ---- Response ----
+    void setContentLength(size_t len) { _contentLength = len; }
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void sendContent(const String& content) { sendContent(content.c_str()); }
+    void sendContent(const char* content);
+    void sendContent_P(const char* content) { sendContent(content); }
+
+private:
+    struct Route {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+    };
+    struct Arg {
+        String name;
+        String value;
+    };
+
+    bool parseRequest();
+    void parseArgs(const String& data);
+
+    WiFiServer _server;
+    WiFiClient _client;
+    std::vector<Route> _routes;
+    THandlerFunction _notFound;
+
+    HTTPMethod _method = HTTP_ANY;
+    String _uri;
+    std::vector<Arg> _args;
+    String _headers;
+    size_t _contentLength = CONTENT_LENGTH_NOT_SET;
+};
+
+#endif // HOST_WEBSERVER_H
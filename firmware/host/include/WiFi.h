@@ -0,0 +1,139 @@
+/**
+ * @file WiFi.h
+ * @brief Host WiFi: an offline station, a scriptable scan and AP, and
+ * TCP clients/servers backed by in-memory streams
+ *
+ * A WiFiClient is either socketless (the default, as used for MQTT) or
+ * bound to a HostStream. WiFiServer::hostAccept() queues an incoming
+ * connection carrying a request; the next available() on that port hands
+ * it to the firmware, and the stream records the response.
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "Client.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+/**
+ * @brief The fields of the ESP-IDF scan record the firmware reads
+ */
+typedef struct {
+    uint8_t ssid[33];
+    int8_t rssi;
+} wifi_ap_record_t;
+
+class IPAddress : public Printable {
+    uint8_t _b[4];
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _b{a, b, c, d} {}
+    uint8_t operator[](int i) const { return _b[i]; }
+    size_t printTo(Print& p) const override {
+        return p.printf("%u.%u.%u.%u", _b[0], _b[1], _b[2], _b[3]);
+    }
+};
+
+/**
+ * @brief TCP client stand-in
+ *
+ * Default-constructed it never connects and owns no file descriptor.
+ * Bound to a HostStream it reads the queued request and writes the
+ * response into it until stop().
+ */
+class WiFiClient : public Client {
+    std::shared_ptr<HostStream> _conn;
+public:
+    WiFiClient() {}
+    /** @brief Host only: a connected client over conn */
+    explicit WiFiClient(std::shared_ptr<HostStream> conn) : _conn(std::move(conn)) {}
+
+    int connect(const char* host, uint16_t port) override { return 0; }
+    uint8_t connected() override { return _conn != nullptr; }
+    void stop() override { _conn.reset(); }
+    int available() override { return _conn ? _conn->available() : 0; }
+    int read() override { return _conn ? _conn->read() : -1; }
+    int peek() override { return _conn ? _conn->peek() : -1; }
+    size_t write(uint8_t c) override { return _conn ? _conn->write(c) : 0; }
+    size_t write(const uint8_t* buf, size_t size) override {
+        return _conn ? _conn->write(buf, size) : 0;
+    }
+    using Print::write;
+    int fd() const { return -1; }
+};
+
+class WiFiServer {
+    uint16_t _port;
+public:
+    explicit WiFiServer(uint16_t port) : _port(port) {}
+    void begin() {}
+    void stop() {}
+    /** @brief Next queued connection on this port, or a disconnected client */
+    WiFiClient available();
+
+    /**
+     * @brief Host only: queue a connection to port that sends request
+     * @return The connection's stream; written() holds the response
+     */
+    static std::shared_ptr<HostStream> hostAccept(uint16_t port, const std::string& request);
+    /** @brief Host only: drop every queued connection */
+    static void hostResetPending();
+};
+
+class WiFiClass {
+    wl_status_t _status = WL_DISCONNECTED;
+    wifi_mode_t _mode = WIFI_STA;
+    std::vector<wifi_ap_record_t> _scan;
+    bool _scanDone = false;
+public:
+    wl_status_t status() const { return _status; }
+    /** @brief Host only: set what status() reports */
+    void setStatus(wl_status_t status) { _status = status; }
+
+    IPAddress localIP() const { return IPAddress(); }
+
+    // ---- Access point ----
+    bool mode(wifi_mode_t m) { _mode = m; return true; }
+    wifi_mode_t getMode() const { return _mode; }
+    bool softAP(const char* ssid, const char* pass = nullptr) { return true; }
+    bool softAPdisconnect(bool wifiOff = false) { return true; }
+    IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+
+    // ---- Scanning (completes immediately with the scripted networks) ----
+    int16_t scanNetworks(bool async = false, bool showHidden = false) {
+        _scanDone = true;
+        return async ? WIFI_SCAN_RUNNING : (int16_t)_scan.size();
+    }
+    int16_t scanComplete() const { return _scanDone ? (int16_t)_scan.size() : WIFI_SCAN_FAILED; }
+    void* getScanInfoByIndex(int i) {
+        return i >= 0 && i < (int)_scan.size() ? &_scan[i] : nullptr;
+    }
+    void scanDelete() { _scanDone = false; }
+    /** @brief Host only: networks the next scan reports */
+    void setScanResults(const std::vector<wifi_ap_record_t>& aps) { _scan = aps; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,37 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host heap capabilities: a scripted heap for memory telemetry
+ *
+ * Reports whatever hostSetHeap() last set (default: 200 KB free in one
+ * block), tracking the minimum like the ESP-IDF allocator does. Host
+ * malloc() is not affected.
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT    (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+typedef struct {
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+typedef void (*esp_alloc_failed_hook_t)(size_t size, uint32_t caps, const char* function_name);
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+int heap_caps_register_failed_alloc_callback(esp_alloc_failed_hook_t callback);
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,31 @@
+/**
+ * @file esp_system.h
+ * @brief Host esp_system: reset reasons and restart
+ */
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <stdint.h>
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason();
+uint32_t esp_get_free_heap_size();
+
+/** @brief Terminates the host process (restart has no host equivalent) */
+[[noreturn]] void esp_restart();
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,13 @@
+/**
+ * @file esp_timer.h
+ * @brief Host esp_timer: microseconds on the host clock (host_hooks.h)
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,35 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host FreeRTOS base types (1 tick = 1 ms)
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+#define tskNO_AFFINITY     0x7FFFFFFF
+
+/** @brief Spinlock stand-in; a recursive mutex keeps nesting legal */
+typedef std::recursive_mutex portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define portENTER_CRITICAL(mux) (mux)->lock()
+#define portEXIT_CRITICAL(mux)  (mux)->unlock()
+#define portENTER_CRITICAL_ISR(mux) (mux)->lock()
+#define portEXIT_CRITICAL_ISR(mux)  (mux)->unlock()
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,29 @@
+/**
+ * @file queue.h
+ * @brief Host FreeRTOS queues (mutex + condition variable, copy semantics)
+ */
+
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+struct HostQueue;
+typedef HostQueue* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t wait);
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+#define xQueueSendFromISR(q, item, woken) xQueueSend((q), (item), 0)
+#define xQueueOverwriteFromISR(q, item, woken) xQueueOverwrite((q), (item))
+
+#endif // HOST_FREERTOS_QUEUE_H
@@ -0,0 +1,35 @@
+/**
+ * @file task.h
+ * @brief Host FreeRTOS tasks (one detached std::thread per task)
+ *
+ * Priorities and core affinity are recorded but not enforced. Task delays
+ * always sleep in real time, also with the manual clock (host_hooks.h), so
+ * background tasks never spin.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* arg);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                       void* arg, UBaseType_t prio, TaskHandle_t* handle);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                                   void* arg, UBaseType_t prio, TaskHandle_t* handle,
+                                   BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+const char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+void taskYIELD();
+
+#endif // HOST_FREERTOS_TASK_H
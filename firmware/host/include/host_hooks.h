@@ -0,0 +1,64 @@
+/**
+ * @file host_hooks.h
+ * @brief Test controls for the host build: clock, analog inputs, NVS
+ *
+ * The clock starts in real mode (millis()/micros() follow the host's
+ * monotonic clock, delay() sleeps). hostClockManual() freezes it: time then
+ * only moves through hostAdvanceMs()/hostAdvanceUs() and delay() /
+ * delayMicroseconds(), which advance it instantly. That makes cooldowns
+ * and sampling loops deterministic and fast.
+ *
+ * Analog pins read a voltage, either fixed or a function of micros() (for
+ * AC waveforms). analogRead() converts it at the configured resolution.
+ *
+ * The heap seen through esp_heap_caps.h and ESP.getFreeHeap() is scripted
+ * and independent of host malloc().
+ */
+
+#ifndef HOST_HOOKS_H
+#define HOST_HOOKS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+// ---- Clock ----
+
+/** @brief Freeze the clock at startUs (manual mode) */
+void hostClockManual(uint64_t startUs = 0);
+/** @brief Return to the real monotonic clock */
+void hostClockReal();
+bool hostClockIsManual();
+void hostAdvanceUs(uint64_t us);
+inline void hostAdvanceMs(uint64_t ms) { hostAdvanceUs(ms * 1000ULL); }
+
+// ---- Analog inputs ----
+
+typedef std::function<float(uint64_t us)> HostWaveform;
+
+/** @brief Pin reads a constant voltage */
+void hostSetPinVolts(uint8_t pin, float volts);
+/** @brief Pin reads volts(micros()) on every sample */
+void hostSetPinWaveform(uint8_t pin, HostWaveform volts);
+/** @brief All pins back to 0 V */
+void hostResetPins();
+/** @brief Last level written by digitalWrite() */
+int hostDigitalLevel(uint8_t pin);
+
+// ---- Heap ----
+
+#define HOST_HEAP_FREE_DEFAULT (200 * 1024)
+
+/** @brief Heap state reported from now on; the minimum-ever follows it */
+void hostSetHeap(size_t freeBytes, size_t largestBlock, size_t allocatedBlocks = 0);
+/** @brief Back to HOST_HEAP_FREE_DEFAULT in one block, minimum cleared */
+void hostHeapReset();
+/** @brief Report a failed allocation to the registered callback */
+void hostFailAlloc(size_t size);
+
+// ---- NVS ----
+
+/** @brief Wipe every Preferences namespace */
+void hostNvsErase();
+
+#endif // HOST_HOOKS_H
@@ -0,0 +1,12 @@
+/**
+ * @file sockets.h
+ * @brief Host lwIP socket API: the POSIX one
+ */
+
+#ifndef HOST_LWIP_SOCKETS_H
+#define HOST_LWIP_SOCKETS_H
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif // HOST_LWIP_SOCKETS_H
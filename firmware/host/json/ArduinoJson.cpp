@@ -0,0 +1,827 @@
+/**
+ * @file ArduinoJson.cpp
+ * @brief Host ArduinoJson subset: tree, serializer and parser
+ */
+
+#include "ArduinoJson.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <errno.h>
+#include <limits>
+
+// =============================================================================
+// NODE
+// =============================================================================
+
+JsonNode* JsonNode::member(const char* key) {
+    if (type != OBJECT) return nullptr;
+    for (auto& m : members) {
+        if (m.first == key) return m.second.get();
+    }
+    return nullptr;
+}
+
+void JsonNode::clear() {
+    type = NUL;
+    singlePrecision = false;
+    u = 0;
+    s.clear();
+    members.clear();
+    items.clear();
+}
+
+// =============================================================================
+// DOCUMENT
+// =============================================================================
+
+JsonDocument::JsonDocument(size_t capacity)
+    : _capacity(capacity), _used(0), _overflowed(false) {
+    _root.doc = this;
+}
+
+bool JsonDocument::reserve(size_t bytes) {
+    if (_used + bytes > _capacity) {
+        _overflowed = true;
+        return false;
+    }
+    _used += bytes;
+    return true;
+}
+
+void JsonDocument::clear() {
+    _root.clear();
+    _used = 0;
+    _overflowed = false;
+}
+
+template <>
+JsonObject JsonDocument::to<JsonObject>() {
+    clear();
+    _root.type = JsonNode::OBJECT;
+    return JsonObject(&_root);
+}
+
+template <>
+JsonArray JsonDocument::to<JsonArray>() {
+    clear();
+    _root.type = JsonNode::ARRAY;
+    return JsonArray(&_root);
+}
+
+// =============================================================================
+// VARIANT
+// =============================================================================
+
+JsonNode* JsonVariant::resolve() const {
+    if (_node) return _node;
+    if (_parent) return _parent->member(_key.c_str());
+    return nullptr;
+}
+
+bool JsonVariant::reserveSlot(JsonNode* n) {
+    return n->doc == nullptr || n->doc->reserve(JSON_SLOT_SIZE);
+}
+
+JsonNode* JsonVariant::materialize() {
+    JsonNode* n = resolve();
+    if (n) return _node = n;
+    if (!_parent) return nullptr;
+
+    if (_parent->type == JsonNode::NUL) _parent->type = JsonNode::OBJECT;
+    if (_parent->type != JsonNode::OBJECT || !reserveSlot(_parent)) return nullptr;
+
+    std::unique_ptr<JsonNode> child(new JsonNode());
+    child->doc = _parent->doc;
+    _node = child.get();
+    _parent->members.emplace_back(_key, std::move(child));
+    return _node;
+}
+
+JsonVariant JsonVariant::operator[](const char* key) const {
+    JsonNode* n = resolve();
+    if (n && (n->type == JsonNode::OBJECT || n->type == JsonNode::NUL)) {
+        return JsonVariant(n, key);
+    }
+    return JsonVariant();
+}
+
+JsonVariant JsonVariant::operator[](int index) const {
+    JsonNode* n = resolve();
+    if (n && n->type == JsonNode::ARRAY && index >= 0 && (size_t)index < n->items.size()) {
+        return JsonVariant(n->items[index].get());
+    }
+    return JsonVariant();
+}
+
+bool JsonVariant::containsKey(const char* key) const {
+    JsonNode* n = resolve();
+    return n && n->member(key) != nullptr;
+}
+
+size_t JsonVariant::size() const {
+    JsonNode* n = resolve();
+    if (!n) return 0;
+    if (n->type == JsonNode::OBJECT) return n->members.size();
+    if (n->type == JsonNode::ARRAY) return n->items.size();
+    return 0;
+}
+
+JsonVariant::operator JsonObject() const { return as<JsonObject>(); }
+JsonVariant::operator JsonArray() const { return as<JsonArray>(); }
+
+JsonVariant& JsonVariant::operator=(const char* v) {
+    JsonNode* n = materialize();
+    if (!n) return *this;
+    n->clear();
+    if (v) {
+        // Stored by pointer on the device: no capacity charge
+        n->type = JsonNode::STRING;
+        n->s = v;
+    }
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(const String& v) {
+    JsonNode* n = materialize();
+    if (!n) return *this;
+    n->clear();
+    if (n->doc && !n->doc->reserve(v.length() + 1)) return *this;
+    n->type = JsonNode::STRING;
+    n->s = v.c_str();
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(const JsonVariant& v) {
+    if (this == &v) return *this;
+    const JsonNode* src = v.resolve();
+    JsonNode* n = materialize();
+    if (!n || n == src) return *this;
+    if (src == nullptr) {
+        n->clear();
+        return *this;
+    }
+    // Copy first: src may be a descendant of n
+    JsonNode tmp;
+    tmp.doc = n->doc;
+    copyFrom(src, &tmp);
+    n->clear();
+    n->type = tmp.type;
+    n->singlePrecision = tmp.singlePrecision;
+    n->u = tmp.u;
+    n->s.swap(tmp.s);
+    n->members.swap(tmp.members);
+    n->items.swap(tmp.items);
+    return *this;
+}
+
+void JsonVariant::copyFrom(const JsonNode* src, JsonNode* dst) {
+    dst->type = src->type;
+    dst->singlePrecision = src->singlePrecision;
+    dst->u = src->u;
+    dst->s = src->s;
+    for (const auto& m : src->members) {
+        if (dst->doc && !dst->doc->reserve(JSON_SLOT_SIZE)) return;
+        std::unique_ptr<JsonNode> child(new JsonNode());
+        child->doc = dst->doc;
+        copyFrom(m.second.get(), child.get());
+        dst->members.emplace_back(m.first, std::move(child));
+    }
+    for (const auto& it : src->items) {
+        if (dst->doc && !dst->doc->reserve(JSON_SLOT_SIZE)) return;
+        std::unique_ptr<JsonNode> child(new JsonNode());
+        child->doc = dst->doc;
+        copyFrom(it.get(), child.get());
+        dst->items.push_back(std::move(child));
+    }
+}
+
+JsonVariant& JsonVariant::operator=(bool v) {
+    JsonNode* n = materialize();
+    if (!n) return *this;
+    n->clear();
+    n->type = JsonNode::BOOL;
+    n->b = v;
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(float v) {
+    JsonNode* n = materialize();
+    if (!n) return *this;
+    n->clear();
+    n->type = JsonNode::FLOAT;
+    n->singlePrecision = true;
+    n->f = v;
+    return *this;
+}
+
+JsonVariant& JsonVariant::operator=(double v) {
+    JsonNode* n = materialize();
+    if (!n) return *this;
+    n->clear();
+    n->type = JsonNode::FLOAT;
+    n->f = v;
+    return *this;
+}
+
+void JsonVariant::setSigned(int64_t v) {
+    JsonNode* n = materialize();
+    if (!n) return;
+    n->clear();
+    n->type = JsonNode::INT;
+    n->i = v;
+}
+
+void JsonVariant::setUnsigned(uint64_t v) {
+    JsonNode* n = materialize();
+    if (!n) return;
+    n->clear();
+    n->type = JsonNode::UINT;
+    n->u = v;
+}
+
+JsonObject JsonVariant::createNestedObject(const char* key) {
+    JsonNode* self = materialize();
+    if (!self) return JsonObject();
+    if (self->type == JsonNode::NUL) self->type = JsonNode::OBJECT;
+    if (self->type != JsonNode::OBJECT) return JsonObject();
+
+    JsonVariant slot(self, key);
+    JsonNode* child = slot.materialize();
+    if (!child) return JsonObject();
+    child->clear();
+    child->type = JsonNode::OBJECT;
+    return JsonObject(child);
+}
+
+JsonArray JsonVariant::createNestedArray(const char* key) {
+    JsonNode* self = materialize();
+    if (!self) return JsonArray();
+    if (self->type == JsonNode::NUL) self->type = JsonNode::OBJECT;
+    if (self->type != JsonNode::OBJECT) return JsonArray();
+
+    JsonVariant slot(self, key);
+    JsonNode* child = slot.materialize();
+    if (!child) return JsonArray();
+    child->clear();
+    child->type = JsonNode::ARRAY;
+    return JsonArray(child);
+}
+
+// ---- Type queries ----
+
+static bool isNumber(const JsonNode* n) {
+    return n && (n->type == JsonNode::INT || n->type == JsonNode::UINT || n->type == JsonNode::FLOAT);
+}
+
+template <typename T>
+static bool integerFits(const JsonNode* n) {
+    if (!n) return false;
+    if (n->type == JsonNode::INT) {
+        return n->i >= (int64_t)std::numeric_limits<T>::min() &&
+               (n->i < 0 || (uint64_t)n->i <= (uint64_t)std::numeric_limits<T>::max());
+    }
+    if (n->type == JsonNode::UINT) return n->u <= (uint64_t)std::numeric_limits<T>::max();
+    return false;
+}
+
+template <> bool JsonVariant::is<const char*>() const { JsonNode* n = resolve(); return n && n->type == JsonNode::STRING; }
+template <> bool JsonVariant::is<bool>() const { JsonNode* n = resolve(); return n && n->type == JsonNode::BOOL; }
+template <> bool JsonVariant::is<int>() const { return integerFits<int>(resolve()); }
+template <> bool JsonVariant::is<long>() const { return integerFits<long>(resolve()); }
+template <> bool JsonVariant::is<unsigned int>() const { return integerFits<unsigned int>(resolve()); }
+template <> bool JsonVariant::is<unsigned long>() const { return integerFits<unsigned long>(resolve()); }
+template <> bool JsonVariant::is<float>() const { return isNumber(resolve()); }
+template <> bool JsonVariant::is<double>() const { return isNumber(resolve()); }
+template <> bool JsonVariant::is<JsonObject>() const { JsonNode* n = resolve(); return n && n->type == JsonNode::OBJECT; }
+template <> bool JsonVariant::is<JsonArray>() const { JsonNode* n = resolve(); return n && n->type == JsonNode::ARRAY; }
+
+// ---- Conversions ----
+
+static double numberValue(const JsonNode* n) {
+    if (!n) return 0;
+    switch (n->type) {
+        case JsonNode::INT:   return (double)n->i;
+        case JsonNode::UINT:  return (double)n->u;
+        case JsonNode::FLOAT: return n->f;
+        case JsonNode::BOOL:  return n->b ? 1 : 0;
+        default:              return 0;
+    }
+}
+
+static int64_t integerValue(const JsonNode* n) {
+    if (!n) return 0;
+    switch (n->type) {
+        case JsonNode::INT:   return n->i;
+        case JsonNode::UINT:  return (int64_t)n->u;
+        case JsonNode::FLOAT: return isfinite(n->f) ? (int64_t)n->f : 0;
+        case JsonNode::BOOL:  return n->b ? 1 : 0;
+        default:              return 0;
+    }
+}
+
+template <> const char* JsonVariant::as<const char*>() const {
+    JsonNode* n = resolve();
+    return n && n->type == JsonNode::STRING ? n->s.c_str() : nullptr;
+}
+
+template <> String JsonVariant::as<String>() const {
+    JsonNode* n = resolve();
+    if (n && n->type == JsonNode::STRING) return String(n->s.c_str());
+    String out;
+    serializeJson(*this, out);
+    return out;
+}
+
+template <> bool JsonVariant::as<bool>() const {
+    JsonNode* n = resolve();
+    if (n && n->type == JsonNode::BOOL) return n->b;
+    return integerValue(n) != 0;
+}
+
+template <> int JsonVariant::as<int>() const { return (int)integerValue(resolve()); }
+template <> long JsonVariant::as<long>() const { return (long)integerValue(resolve()); }
+template <> long long JsonVariant::as<long long>() const { return (long long)integerValue(resolve()); }
+template <> unsigned int JsonVariant::as<unsigned int>() const { return (unsigned int)integerValue(resolve()); }
+template <> unsigned long JsonVariant::as<unsigned long>() const { return (unsigned long)integerValue(resolve()); }
+template <> float JsonVariant::as<float>() const { return (float)numberValue(resolve()); }
+template <> double JsonVariant::as<double>() const { return numberValue(resolve()); }
+
+template <> JsonObject JsonVariant::as<JsonObject>() const {
+    JsonNode* n = resolve();
+    return n && n->type == JsonNode::OBJECT ? JsonObject(n) : JsonObject();
+}
+
+template <> JsonArray JsonVariant::as<JsonArray>() const {
+    JsonNode* n = resolve();
+    return n && n->type == JsonNode::ARRAY ? JsonArray(n) : JsonArray();
+}
+
+// =============================================================================
+// OBJECT / ARRAY
+// =============================================================================
+
+JsonObject::iterator JsonObject::begin() const {
+    JsonNode* n = resolve();
+    return iterator(n, 0);
+}
+
+JsonObject::iterator JsonObject::end() const {
+    JsonNode* n = resolve();
+    return iterator(n, n && n->type == JsonNode::OBJECT ? n->members.size() : 0);
+}
+
+void JsonObject::remove(const char* key) {
+    JsonNode* n = resolve();
+    if (!n || n->type != JsonNode::OBJECT) return;
+    for (auto it = n->members.begin(); it != n->members.end(); ++it) {
+        if (it->first == key) {
+            n->members.erase(it);
+            return;
+        }
+    }
+}
+
+JsonArray::iterator JsonArray::begin() const {
+    return iterator(resolve(), 0);
+}
+
+JsonArray::iterator JsonArray::end() const {
+    JsonNode* n = resolve();
+    return iterator(n, n && n->type == JsonNode::ARRAY ? n->items.size() : 0);
+}
+
+JsonVariant JsonArray::add() {
+    JsonNode* self = materialize();
+    if (!self) return JsonVariant();
+    if (self->type == JsonNode::NUL) self->type = JsonNode::ARRAY;
+    if (self->type != JsonNode::ARRAY || !reserveSlot(self)) return JsonVariant();
+
+    std::unique_ptr<JsonNode> item(new JsonNode());
+    item->doc = self->doc;
+    JsonNode* raw = item.get();
+    self->items.push_back(std::move(item));
+    return JsonVariant(raw);
+}
+
+JsonObject JsonArray::createNestedObject() {
+    JsonVariant slot = add();
+    JsonNode* n = slot.node();
+    if (!n) return JsonObject();
+    n->type = JsonNode::OBJECT;
+    return JsonObject(n);
+}
+
+// =============================================================================
+// SERIALIZATION
+// =============================================================================
+
+static void writeString(std::string& out, const std::string& s) {
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char esc[8];
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out += esc;
+                } else {
+                    out += (char)c;
+                }
+        }
+    }
+    out += '"';
+}
+
+static void writeNode(std::string& out, const JsonNode* n) {
+    char num[32];
+    if (n == nullptr) {
+        out += "null";
+        return;
+    }
+    switch (n->type) {
+        case JsonNode::NUL:
+            out += "null";
+            break;
+        case JsonNode::BOOL:
+            out += n->b ? "true" : "false";
+            break;
+        case JsonNode::INT:
+            snprintf(num, sizeof(num), "%lld", (long long)n->i);
+            out += num;
+            break;
+        case JsonNode::UINT:
+            snprintf(num, sizeof(num), "%llu", (unsigned long long)n->u);
+            out += num;
+            break;
+        case JsonNode::FLOAT:
+            // ArduinoJson writes NaN/Inf as null (ARDUINOJSON_ENABLE_NAN=0)
+            if (!isfinite(n->f)) {
+                out += "null";
+            } else {
+                snprintf(num, sizeof(num), n->singlePrecision ? "%.9g" : "%.15g", n->f);
+                out += num;
+            }
+            break;
+        case JsonNode::STRING:
+            writeString(out, n->s);
+            break;
+        case JsonNode::OBJECT: {
+            out += '{';
+            bool first = true;
+            for (const auto& m : n->members) {
+                if (!first) out += ',';
+                first = false;
+                writeString(out, m.first);
+                out += ':';
+                writeNode(out, m.second.get());
+            }
+            out += '}';
+            break;
+        }
+        case JsonNode::ARRAY: {
+            out += '[';
+            bool first = true;
+            for (const auto& it : n->items) {
+                if (!first) out += ',';
+                first = false;
+                writeNode(out, it.get());
+            }
+            out += ']';
+            break;
+        }
+    }
+}
+
+size_t serializeJson(const JsonVariant& v, char* buf, size_t size) {
+    std::string out;
+    writeNode(out, v.node());
+    if (size == 0) return 0;
+    size_t n = out.size() < size - 1 ? out.size() : size - 1;
+    memcpy(buf, out.data(), n);
+    buf[n] = '\0';
+    return n;
+}
+
+size_t serializeJson(const JsonVariant& v, String& out) {
+    std::string s;
+    writeNode(s, v.node());
+    out = String(s);
+    return s.size();
+}
+
+size_t serializeJson(const JsonVariant& v, Print& out) {
+    std::string s;
+    writeNode(s, v.node());
+    return out.write((const uint8_t*)s.data(), s.size());
+}
+
+size_t measureJson(const JsonVariant& v) {
+    std::string s;
+    writeNode(s, v.node());
+    return s.size();
+}
+
+const char* DeserializationError::c_str() const {
+    switch (_code) {
+        case Ok:              return "Ok";
+        case EmptyInput:      return "EmptyInput";
+        case IncompleteInput: return "IncompleteInput";
+        case InvalidInput:    return "InvalidInput";
+        case NoMemory:        return "NoMemory";
+        case TooDeep:         return "TooDeep";
+    }
+    return "???";
+}
+
+// =============================================================================
+// PARSER
+// =============================================================================
+
+namespace {
+
+class Parser {
+    const char* _p;
+    const char* _end;
+    JsonDocument& _doc;
+    bool _copyStrings;
+public:
+    Parser(const char* input, size_t length, JsonDocument& doc, bool copyStrings)
+        : _p(input), _end(input + length), _doc(doc), _copyStrings(copyStrings) {}
+
+    DeserializationError::Code run(JsonNode* root) {
+        skipSpace();
+        if (_p >= _end) return DeserializationError::EmptyInput;
+        return parseValue(root, ARDUINOJSON_DEFAULT_NESTING_LIMIT);
+    }
+
+private:
+    void skipSpace() {
+        while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) _p++;
+    }
+
+    DeserializationError::Code chargeString(size_t len) {
+        if (_copyStrings && !_doc.reserve(len + 1)) return DeserializationError::NoMemory;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError::Code parseValue(JsonNode* n, int depth) {
+        skipSpace();
+        if (_p >= _end) return DeserializationError::IncompleteInput;
+
+        switch (*_p) {
+            case '{': return depth > 0 ? parseObject(n, depth - 1) : DeserializationError::TooDeep;
+            case '[': return depth > 0 ? parseArray(n, depth - 1) : DeserializationError::TooDeep;
+            case '"':
+            case '\'': {
+                DeserializationError::Code err = parseString(n->s);
+                if (err) return err;
+                n->type = JsonNode::STRING;
+                return chargeString(n->s.size());
+            }
+            case 't': return parseLiteral("true", n, JsonNode::BOOL, true);
+            case 'f': return parseLiteral("false", n, JsonNode::BOOL, false);
+            case 'n': return parseLiteral("null", n, JsonNode::NUL, false);
+            default:  return parseNumber(n);
+        }
+    }
+
+    DeserializationError::Code parseLiteral(const char* word, JsonNode* n, JsonNode::Type type, bool value) {
+        size_t len = strlen(word);
+        for (size_t i = 0; i < len; i++) {
+            if (_p + i >= _end) return DeserializationError::IncompleteInput;
+            if (_p[i] != word[i]) return DeserializationError::InvalidInput;
+        }
+        _p += len;
+        n->type = type;
+        if (type == JsonNode::BOOL) n->b = value;
+        return DeserializationError::Ok;
+    }
+
+    DeserializationError::Code parseNumber(JsonNode* n) {
+        const char* start = _p;
+        bool isFloat = false;
+        if (_p < _end && (*_p == '-' || *_p == '+')) _p++;
+        while (_p < _end) {
+            char c = *_p;
+            if (c >= '0' && c <= '9') {
+                _p++;
+            } else if (c == '.' || c == 'e' || c == 'E' ||
+                       ((c == '-' || c == '+') && (_p[-1] == 'e' || _p[-1] == 'E'))) {
+                isFloat = true;
+                _p++;
+            } else {
+                break;
+            }
+        }
+        if (_p == start) return DeserializationError::InvalidInput;
+
+        std::string text(start, _p);
+        char* endp = nullptr;
+        if (!isFloat) {
+            errno = 0;
+            if (text[0] == '-') {
+                long long v = strtoll(text.c_str(), &endp, 10);
+                if (errno == 0 && *endp == '\0') {
+                    n->type = JsonNode::INT;
+                    n->i = v;
+                    return DeserializationError::Ok;
+                }
+            } else {
+                unsigned long long v = strtoull(text.c_str(), &endp, 10);
+                if (errno == 0 && *endp == '\0') {
+                    if (v <= (unsigned long long)LLONG_MAX) {
+                        n->type = JsonNode::INT;
+                        n->i = (int64_t)v;
+                    } else {
+                        n->type = JsonNode::UINT;
+                        n->u = v;
+                    }
+                    return DeserializationError::Ok;
+                }
+            }
+        }
+        double d = strtod(text.c_str(), &endp);
+        if (endp == text.c_str() || *endp != '\0') return DeserializationError::InvalidInput;
+        n->type = JsonNode::FLOAT;
+        n->f = d;
+        return DeserializationError::Ok;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += (char)cp;
+        } else if (cp < 0x800) {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else {
+            out += (char)(0xF0 | (cp >> 18));
+            out += (char)(0x80 | ((cp >> 12) & 0x3F));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& out) {
+        if (_end - _p < 4) return false;
+        out = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *_p++;
+            out <<= 4;
+            if (c >= '0' && c <= '9') out |= c - '0';
+            else if (c >= 'a' && c <= 'f') out |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') out |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    DeserializationError::Code parseString(std::string& out) {
+        char quote = *_p++;
+        out.clear();
+        while (_p < _end) {
+            char c = *_p++;
+            if (c == quote) return DeserializationError::Ok;
+            if (c == '\0') return DeserializationError::IncompleteInput;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (_p >= _end) return DeserializationError::IncompleteInput;
+            char e = *_p++;
+            switch (e) {
+                case '"':  out += '"'; break;
+                case '\'': out += '\''; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    uint32_t cp;
+                    if (!parseHex4(cp)) return DeserializationError::InvalidInput;
+                    if (cp >= 0xD800 && cp < 0xDC00 && _end - _p >= 6 && _p[0] == '\\' && _p[1] == 'u') {
+                        _p += 2;
+                        uint32_t lo;
+                        if (!parseHex4(lo)) return DeserializationError::InvalidInput;
+                        if (lo >= 0xDC00 && lo < 0xE000) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        }
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return DeserializationError::InvalidInput;
+            }
+        }
+        return DeserializationError::IncompleteInput;
+    }
+
+    DeserializationError::Code parseObject(JsonNode* n, int depth) {
+        _p++;  // '{'
+        n->type = JsonNode::OBJECT;
+        skipSpace();
+        if (_p < _end && *_p == '}') {
+            _p++;
+            return DeserializationError::Ok;
+        }
+        for (;;) {
+            skipSpace();
+            if (_p >= _end) return DeserializationError::IncompleteInput;
+            if (*_p != '"' && *_p != '\'') return DeserializationError::InvalidInput;
+
+            std::string key;
+            DeserializationError::Code err = parseString(key);
+            if (err) return err;
+            skipSpace();
+            if (_p >= _end) return DeserializationError::IncompleteInput;
+            if (*_p++ != ':') return DeserializationError::InvalidInput;
+
+            JsonNode* child = n->member(key.c_str());
+            if (child == nullptr) {
+                if (!_doc.reserve(JSON_SLOT_SIZE)) return DeserializationError::NoMemory;
+                err = chargeString(key.size());
+                if (err) return err;
+                std::unique_ptr<JsonNode> fresh(new JsonNode());
+                fresh->doc = &_doc;
+                child = fresh.get();
+                n->members.emplace_back(key, std::move(fresh));
+            } else {
+                child->clear();
+            }
+            err = parseValue(child, depth);
+            if (err) return err;
+
+            skipSpace();
+            if (_p >= _end) return DeserializationError::IncompleteInput;
+            char c = *_p++;
+            if (c == '}') return DeserializationError::Ok;
+            if (c != ',') return DeserializationError::InvalidInput;
+        }
+    }
+
+    DeserializationError::Code parseArray(JsonNode* n, int depth) {
+        _p++;  // '['
+        n->type = JsonNode::ARRAY;
+        skipSpace();
+        if (_p < _end && *_p == ']') {
+            _p++;
+            return DeserializationError::Ok;
+        }
+        for (;;) {
+            if (!_doc.reserve(JSON_SLOT_SIZE)) return DeserializationError::NoMemory;
+            std::unique_ptr<JsonNode> item(new JsonNode());
+            item->doc = &_doc;
+            JsonNode* raw = item.get();
+            n->items.push_back(std::move(item));
+            DeserializationError::Code err = parseValue(raw, depth);
+            if (err) return err;
+
+            skipSpace();
+            if (_p >= _end) return DeserializationError::IncompleteInput;
+            char c = *_p++;
+            if (c == ']') return DeserializationError::Ok;
+            if (c != ',') return DeserializationError::InvalidInput;
+        }
+    }
+};
+
+} // namespace
+
+static DeserializationError parseInto(JsonDocument& doc, const char* input, size_t length, bool copyStrings) {
+    doc.clear();
+    if (input == nullptr) return DeserializationError::EmptyInput;
+
+    JsonNode* root = doc.root().node();
+    Parser parser(input, length, doc, copyStrings);
+    DeserializationError::Code err = parser.run(root);
+    if (err) doc.clear();
+    return err;
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+    return parseInto(doc, input, input ? strlen(input) : 0, true);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+    return parseInto(doc, input, length, true);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, char* input) {
+    return parseInto(doc, input, input ? strlen(input) : 0, false);
+}
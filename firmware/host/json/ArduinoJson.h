@@ -0,0 +1,326 @@
+/**
+ * @file ArduinoJson.h
+ * @brief Host subset of the ArduinoJson 6 API used by the firmware
+ *
+ * Used only when the real library is not found (see CMakeLists.txt). The
+ * document is a heap-allocated tree, but capacity is accounted the way
+ * ArduinoJson does on a 32-bit target (JSON_SLOT_SIZE per value, string
+ * bytes when copied), so an undersized StaticJsonDocument fails here as
+ * it would on the device: deserializeJson() returns NoMemory and writes
+ * past capacity are dropped.
+ */
+
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include "WString.h"
+#include "Print.h"
+
+#define ARDUINOJSON_VERSION "6.21.0-host"
+#define JSON_SLOT_SIZE 16
+#define JSON_OBJECT_SIZE(n) ((n) * JSON_SLOT_SIZE)
+#define JSON_ARRAY_SIZE(n) ((n) * JSON_SLOT_SIZE)
+#define ARDUINOJSON_DEFAULT_NESTING_LIMIT 10
+
+class JsonDocument;
+class JsonVariant;
+class JsonObject;
+class JsonArray;
+
+/**
+ * @brief One value in the tree
+ */
+struct JsonNode {
+    enum Type : uint8_t { NUL, BOOL, INT, UINT, FLOAT, STRING, OBJECT, ARRAY } type = NUL;
+    bool singlePrecision = false;
+    union {
+        bool b;
+        int64_t i;
+        uint64_t u;
+        double f;
+    };
+    std::string s;
+    std::vector<std::pair<std::string, std::unique_ptr<JsonNode>>> members;
+    std::vector<std::unique_ptr<JsonNode>> items;
+    JsonDocument* doc = nullptr;
+
+    JsonNode() : u(0) {}
+    JsonNode* member(const char* key);
+    void clear();
+};
+
+// =============================================================================
+// VARIANT
+// =============================================================================
+
+/**
+ * @brief Reference to a value, or to a not-yet-existing object member
+ *
+ * Reading a missing member yields null without creating it; assigning to
+ * it creates it (like ArduinoJson's MemberProxy).
+ */
+class JsonVariant {
+protected:
+    JsonNode* _node;
+    JsonNode* _parent;
+    std::string _key;
+
+    JsonNode* resolve() const;
+    JsonNode* materialize();
+    bool reserveSlot(JsonNode* n);
+public:
+    JsonVariant() : _node(nullptr), _parent(nullptr) {}
+    explicit JsonVariant(JsonNode* node) : _node(node), _parent(nullptr) {}
+    JsonVariant(JsonNode* parent, const char* key) : _node(nullptr), _parent(parent), _key(key) {}
+
+    bool isNull() const { JsonNode* n = resolve(); return n == nullptr || n->type == JsonNode::NUL; }
+
+    template <typename T> bool is() const;
+    template <typename T> T as() const;
+
+    operator const char*() const;
+    operator JsonObject() const;
+    operator JsonArray() const;
+
+    JsonVariant operator[](const char* key) const;
+    JsonVariant operator[](const String& key) const { return (*this)[key.c_str()]; }
+    JsonVariant operator[](int index) const;
+
+    bool containsKey(const char* key) const;
+    size_t size() const;
+
+    /** @brief ArduinoJson's "value or default" */
+    const char* operator|(const char* def) const;
+    int operator|(int def) const;
+    float operator|(float def) const;
+    bool operator|(bool def) const;
+
+    JsonVariant& operator=(const char* v);
+    JsonVariant& operator=(char* v) { return *this = (const char*)v; }
+    JsonVariant& operator=(const String& v);
+    JsonVariant& operator=(const JsonVariant& v);
+    JsonVariant& operator=(bool v);
+    JsonVariant& operator=(float v);
+    JsonVariant& operator=(double v);
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, JsonVariant&>::type
+    operator=(T v) {
+        if (std::is_signed<T>::value) setSigned((int64_t)v);
+        else setUnsigned((uint64_t)v);
+        return *this;
+    }
+
+    JsonObject createNestedObject(const char* key);
+    JsonArray createNestedArray(const char* key);
+    bool set(const JsonVariant& v) { *this = v; return true; }
+
+    JsonNode* node() const { return resolve(); }
+
+private:
+    void setSigned(int64_t v);
+    void setUnsigned(uint64_t v);
+    void copyFrom(const JsonNode* src, JsonNode* dst);
+};
+
+template <> bool JsonVariant::is<const char*>() const;
+template <> bool JsonVariant::is<bool>() const;
+template <> bool JsonVariant::is<int>() const;
+template <> bool JsonVariant::is<long>() const;
+template <> bool JsonVariant::is<unsigned int>() const;
+template <> bool JsonVariant::is<unsigned long>() const;
+template <> bool JsonVariant::is<float>() const;
+template <> bool JsonVariant::is<double>() const;
+template <> bool JsonVariant::is<JsonObject>() const;
+template <> bool JsonVariant::is<JsonArray>() const;
+
+template <> const char* JsonVariant::as<const char*>() const;
+template <> String JsonVariant::as<String>() const;
+template <> bool JsonVariant::as<bool>() const;
+template <> int JsonVariant::as<int>() const;
+template <> long JsonVariant::as<long>() const;
+template <> long long JsonVariant::as<long long>() const;
+template <> unsigned int JsonVariant::as<unsigned int>() const;
+template <> unsigned long JsonVariant::as<unsigned long>() const;
+template <> float JsonVariant::as<float>() const;
+template <> double JsonVariant::as<double>() const;
+template <> JsonObject JsonVariant::as<JsonObject>() const;
+template <> JsonArray JsonVariant::as<JsonArray>() const;
+
+inline JsonVariant::operator const char*() const { return as<const char*>(); }
+inline const char* JsonVariant::operator|(const char* def) const {
+    const char* s = as<const char*>();
+    return s ? s : def;
+}
+inline int JsonVariant::operator|(int def) const { return is<int>() ? as<int>() : def; }
+inline float JsonVariant::operator|(float def) const { return is<float>() ? as<float>() : def; }
+inline bool JsonVariant::operator|(bool def) const { return is<bool>() ? as<bool>() : def; }
+
+typedef JsonVariant JsonVariantConst;
+
+// =============================================================================
+// OBJECT / ARRAY
+// =============================================================================
+
+class JsonString {
+    const char* _s;
+public:
+    explicit JsonString(const char* s) : _s(s) {}
+    const char* c_str() const { return _s; }
+    operator const char*() const { return _s; }
+};
+
+class JsonPair {
+    JsonString _key;
+    JsonVariant _value;
+public:
+    JsonPair(const char* key, JsonNode* value) : _key(key), _value(value) {}
+    JsonString key() const { return _key; }
+    JsonVariant value() const { return _value; }
+};
+
+class JsonObject : public JsonVariant {
+public:
+    JsonObject() {}
+    explicit JsonObject(JsonNode* node) : JsonVariant(node) {}
+
+    class iterator {
+        JsonNode* _obj;
+        size_t _i;
+    public:
+        iterator(JsonNode* obj, size_t i) : _obj(obj), _i(i) {}
+        JsonPair operator*() const {
+            return JsonPair(_obj->members[_i].first.c_str(), _obj->members[_i].second.get());
+        }
+        iterator& operator++() { _i++; return *this; }
+        bool operator!=(const iterator& o) const { return _i != o._i; }
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    void remove(const char* key);
+    JsonObject& operator=(const JsonObject& o) { _node = o._node; _parent = o._parent; _key = o._key; return *this; }
+};
+
+class JsonArray : public JsonVariant {
+public:
+    JsonArray() {}
+    explicit JsonArray(JsonNode* node) : JsonVariant(node) {}
+
+    class iterator {
+        JsonNode* _arr;
+        size_t _i;
+    public:
+        iterator(JsonNode* arr, size_t i) : _arr(arr), _i(i) {}
+        JsonVariant operator*() const { return JsonVariant(_arr->items[_i].get()); }
+        iterator& operator++() { _i++; return *this; }
+        bool operator!=(const iterator& o) const { return _i != o._i; }
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    /** @brief Append a null element and return it for assignment */
+    JsonVariant add();
+    template <typename T>
+    bool add(const T& v) { JsonVariant slot = add(); if (!slot.node()) return false; slot = v; return true; }
+    JsonObject createNestedObject();
+    JsonArray& operator=(const JsonArray& o) { _node = o._node; _parent = o._parent; _key = o._key; return *this; }
+};
+
+// =============================================================================
+// DOCUMENT
+// =============================================================================
+
+class DeserializationError {
+public:
+    enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+    DeserializationError(Code code = Ok) : _code(code) {}
+    Code code() const { return _code; }
+    const char* c_str() const;
+    explicit operator bool() const { return _code != Ok; }
+    bool operator==(Code c) const { return _code == c; }
+    bool operator!=(Code c) const { return _code != c; }
+private:
+    Code _code;
+};
+
+class JsonDocument {
+    JsonNode _root;
+    size_t _capacity;
+    size_t _used;
+    bool _overflowed;
+public:
+    explicit JsonDocument(size_t capacity);
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    /**
+     * @brief Account for memory a new value (or copied string) needs
+     * @return false (and overflowed() true) if capacity is exhausted
+     */
+    bool reserve(size_t bytes);
+    void clear();
+    size_t capacity() const { return _capacity; }
+    size_t memoryUsage() const { return _used; }
+    bool overflowed() const { return _overflowed; }
+
+    JsonVariant root() { return JsonVariant(&_root); }
+    JsonVariant operator[](const char* key) { return root()[key]; }
+    JsonVariant operator[](const String& key) { return root()[key.c_str()]; }
+    JsonVariant operator[](int index) { return root()[index]; }
+    bool containsKey(const char* key) { return root().containsKey(key); }
+    bool isNull() { return root().isNull(); }
+    size_t size() { return root().size(); }
+    template <typename T> T as() { return root().as<T>(); }
+    template <typename T> bool is() { return root().is<T>(); }
+
+    JsonObject createNestedObject(const char* key) { return root().createNestedObject(key); }
+    JsonArray createNestedArray(const char* key) { return root().createNestedArray(key); }
+    template <typename T> T to();
+    operator JsonVariant() { return root(); }
+};
+
+template <> JsonObject JsonDocument::to<JsonObject>();
+template <> JsonArray JsonDocument::to<JsonArray>();
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {
+public:
+    StaticJsonDocument() : JsonDocument(N) {}
+};
+
+class DynamicJsonDocument : public JsonDocument {
+public:
+    explicit DynamicJsonDocument(size_t capacity) : JsonDocument(capacity) {}
+};
+
+// =============================================================================
+// SERIALIZATION
+// =============================================================================
+
+/** @brief Parse a read-only input; strings are copied into the document */
+DeserializationError deserializeJson(JsonDocument& doc, const char* input);
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length);
+/** @brief Parse a writable input; strings are not charged (zero-copy on device) */
+DeserializationError deserializeJson(JsonDocument& doc, char* input);
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+    return deserializeJson(doc, input.c_str(), input.length());
+}
+
+/** @return Bytes written, excluding the terminator (output is truncated to fit) */
+size_t serializeJson(const JsonVariant& v, char* buf, size_t size);
+size_t serializeJson(const JsonVariant& v, String& out);
+size_t serializeJson(const JsonVariant& v, Print& out);
+size_t measureJson(const JsonVariant& v);
+inline size_t serializeJson(JsonDocument& doc, char* buf, size_t size) { return serializeJson(doc.root(), buf, size); }
+inline size_t serializeJson(JsonDocument& doc, String& out) { return serializeJson(doc.root(), out); }
+inline size_t serializeJson(JsonDocument& doc, Print& out) { return serializeJson(doc.root(), out); }
+inline size_t measureJson(JsonDocument& doc) { return measureJson(doc.root()); }
+
+#endif // HOST_ARDUINOJSON_H
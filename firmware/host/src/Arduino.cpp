@@ -0,0 +1,465 @@
+/**
+ * @file Arduino.cpp
+ * @brief Host Arduino core: clock, GPIO/ADC, Print/Stream/String, Serial
+ */
+
+#include "Arduino.h"
+#include "host_hooks.h"
+#include "esp_heap_caps.h"
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// =============================================================================
+// CLOCK
+// =============================================================================
+
+static const std::chrono::steady_clock::time_point hostEpoch = std::chrono::steady_clock::now();
+static std::atomic<bool> manualClock(false);
+static std::atomic<uint64_t> manualUs(0);
+
+static uint64_t realUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hostEpoch).count();
+}
+
+static uint64_t nowUs() {
+    return manualClock.load() ? manualUs.load() : realUs();
+}
+
+void hostClockManual(uint64_t startUs) {
+    manualUs.store(startUs);
+    manualClock.store(true);
+}
+
+void hostClockReal() {
+    manualClock.store(false);
+}
+
+bool hostClockIsManual() {
+    return manualClock.load();
+}
+
+void hostAdvanceUs(uint64_t us) {
+    manualUs.fetch_add(us);
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(nowUs() / 1000ULL);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)nowUs();
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)nowUs();
+}
+
+void delay(uint32_t ms) {
+    if (manualClock.load()) {
+        hostAdvanceUs(ms * 1000ULL);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void delayMicroseconds(uint32_t us) {
+    if (manualClock.load()) {
+        hostAdvanceUs(us);
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+// =============================================================================
+// GPIO / ADC
+// =============================================================================
+
+static std::mutex pinLock;
+static std::map<uint8_t, HostWaveform> pinVolts;
+static std::map<uint8_t, int> pinLevels;
+static uint8_t adcBits = 12;
+
+void hostSetPinVolts(uint8_t pin, float volts) {
+    hostSetPinWaveform(pin, [volts](uint64_t) { return volts; });
+}
+
+void hostSetPinWaveform(uint8_t pin, HostWaveform volts) {
+    std::lock_guard<std::mutex> lock(pinLock);
+    pinVolts[pin] = volts;
+}
+
+void hostResetPins() {
+    std::lock_guard<std::mutex> lock(pinLock);
+    pinVolts.clear();
+    pinLevels.clear();
+}
+
+int hostDigitalLevel(uint8_t pin) {
+    std::lock_guard<std::mutex> lock(pinLock);
+    auto it = pinLevels.find(pin);
+    return it == pinLevels.end() ? LOW : it->second;
+}
+
+static float pinVoltage(uint8_t pin) {
+    HostWaveform fn;
+    {
+        std::lock_guard<std::mutex> lock(pinLock);
+        auto it = pinVolts.find(pin);
+        if (it == pinVolts.end()) return 0.0f;
+        fn = it->second;
+    }
+    float v = fn(nowUs());
+    if (v < 0.0f) v = 0.0f;
+    if (v > 3.3f) v = 3.3f;
+    return v;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    std::lock_guard<std::mutex> lock(pinLock);
+    pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return hostDigitalLevel(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    uint32_t maxCode = (1UL << adcBits) - 1;
+    return (uint16_t)lroundf(pinVoltage(pin) / 3.3f * maxCode);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    return (uint32_t)lroundf(pinVoltage(pin) * 1000.0f);
+}
+
+void analogReadResolution(uint8_t bits) {
+    adcBits = bits;
+}
+
+void analogSetAttenuation(adc_attenuation_t atten) {}
+
+// =============================================================================
+// MATH
+// =============================================================================
+
+static std::mt19937 rng(1);
+static std::mutex rngLock;
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    std::lock_guard<std::mutex> lock(rngLock);
+    return (long)(rng() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    std::lock_guard<std::mutex> lock(rngLock);
+    rng.seed((uint32_t)seed);
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// =============================================================================
+// ESP
+// =============================================================================
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(nowUs() * getCpuFreqMHz());
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return esp_get_free_heap_size();
+}
+
+void EspClass::restart() {
+    esp_restart();
+}
+
+esp_reset_reason_t esp_reset_reason() {
+    return ESP_RST_POWERON;
+}
+
+uint32_t esp_get_free_heap_size() {
+    return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+}
+
+// =============================================================================
+// HEAP
+// =============================================================================
+
+static std::mutex heapMutex;
+static multi_heap_info_t heapInfo;
+static esp_alloc_failed_hook_t allocFailedHook = nullptr;
+
+static void setHeapLocked(size_t freeBytes, size_t largestBlock, size_t allocatedBlocks) {
+    heapInfo.total_free_bytes = freeBytes;
+    heapInfo.largest_free_block = largestBlock;
+    heapInfo.allocated_blocks = allocatedBlocks;
+    heapInfo.free_blocks = largestBlock < freeBytes ? 2 : 1;
+    heapInfo.total_blocks = heapInfo.allocated_blocks + heapInfo.free_blocks;
+    if (freeBytes < heapInfo.minimum_free_bytes) heapInfo.minimum_free_bytes = freeBytes;
+}
+
+static struct HeapInit {
+    HeapInit() { hostHeapReset(); }
+} heapInit;
+
+void hostSetHeap(size_t freeBytes, size_t largestBlock, size_t allocatedBlocks) {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    setHeapLocked(freeBytes, largestBlock, allocatedBlocks);
+}
+
+void hostHeapReset() {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    heapInfo = multi_heap_info_t();
+    heapInfo.minimum_free_bytes = SIZE_MAX;
+    setHeapLocked(HOST_HEAP_FREE_DEFAULT, HOST_HEAP_FREE_DEFAULT, 0);
+}
+
+void hostFailAlloc(size_t size) {
+    if (allocFailedHook) allocFailedHook(size, MALLOC_CAP_DEFAULT, "malloc");
+}
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps) {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    *info = heapInfo;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    return heapInfo.total_free_bytes;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    return heapInfo.largest_free_block;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    std::lock_guard<std::mutex> lock(heapMutex);
+    return heapInfo.minimum_free_bytes;
+}
+
+int heap_caps_register_failed_alloc_callback(esp_alloc_failed_hook_t callback) {
+    allocFailedHook = callback;
+    return 0;
+}
+
+void esp_restart() {
+    fprintf(stderr, "[HOST] esp_restart()\n");
+    exit(0);
+}
+
+// =============================================================================
+// STRING
+// =============================================================================
+
+static std::string formatInteger(unsigned long long v, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    std::string out;
+    do {
+        int d = (int)(v % base);
+        out.insert(out.begin(), (char)(d < 10 ? '0' + d : 'a' + d - 10));
+        v /= base;
+    } while (v);
+    if (negative) out.insert(out.begin(), '-');
+    return out;
+}
+
+static std::string formatSigned(long long v, unsigned char base) {
+    if (base == 10 && v < 0) return formatInteger(0ULL - (unsigned long long)v, true, base);
+    return formatInteger((unsigned long long)v, false, base);
+}
+
+static std::string formatFloat(double v, unsigned int decimals) {
+    if (isnan(v)) return "nan";
+    if (isinf(v)) return "inf";
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    return buf;
+}
+
+String::String(int v, unsigned char base) : _s(formatSigned(v, base)) {}
+String::String(unsigned int v, unsigned char base) : _s(formatInteger(v, false, base)) {}
+String::String(long v, unsigned char base) : _s(formatSigned(v, base)) {}
+String::String(unsigned long v, unsigned char base) : _s(formatInteger(v, false, base)) {}
+String::String(float v, unsigned int decimals) : _s(formatFloat(v, decimals)) {}
+String::String(double v, unsigned int decimals) : _s(formatFloat(v, decimals)) {}
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= _s.size()) return -1;
+    size_t pos = _s.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const char* s, unsigned int from) const {
+    if (from >= _s.size() || s == nullptr) return -1;
+    size_t pos = _s.find(s, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = _s.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+    return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= _s.size()) return String();
+    if (to > _s.size()) to = (unsigned int)_s.size();
+    return String(_s.substr(from, to - from));
+}
+
+bool String::startsWith(const String& prefix) const {
+    return _s.compare(0, prefix._s.size(), prefix._s) == 0 && _s.size() >= prefix._s.size();
+}
+
+bool String::endsWith(const String& suffix) const {
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (_s.size() != other._s.size()) return false;
+    for (size_t i = 0; i < _s.size(); i++) {
+        if (tolower((unsigned char)_s[i]) != tolower((unsigned char)other._s[i])) return false;
+    }
+    return true;
+}
+
+void String::trim() {
+    size_t start = 0;
+    while (start < _s.size() && isspace((unsigned char)_s[start])) start++;
+    size_t end = _s.size();
+    while (end > start && isspace((unsigned char)_s[end - 1])) end--;
+    _s = _s.substr(start, end - start);
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) c = (char)tolower((unsigned char)c);
+}
+
+void String::replace(const String& find, const String& with) {
+    if (find._s.empty()) return;
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.size(), with._s);
+        pos += with._s.size();
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index >= _s.size()) return;
+    _s.erase(index, count);
+}
+
+long String::toInt() const {
+    return strtol(_s.c_str(), nullptr, 10);
+}
+
+float String::toFloat() const {
+    return strtof(_s.c_str(), nullptr);
+}
+
+// =============================================================================
+// PRINT / STREAM
+// =============================================================================
+
+size_t Print::write(const uint8_t* buf, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buf++);
+    return n;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char small[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(small)) return write((const uint8_t*)small, len);
+
+    std::string big(len + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&big[0], big.size(), fmt, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), len);
+}
+
+size_t Print::print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+size_t Print::print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+size_t Print::print(const char* s) { return write(s); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char v, int base) { return print((unsigned long)v, base); }
+size_t Print::print(int v, int base) { return print((long)v, base); }
+size_t Print::print(unsigned int v, int base) { return print((unsigned long)v, base); }
+size_t Print::print(long v, int base) { return print(String(v, (unsigned char)base)); }
+size_t Print::print(unsigned long v, int base) { return print(String(v, (unsigned char)base)); }
+size_t Print::print(long long v, int base) { return print(String(formatSigned(v, (unsigned char)base))); }
+size_t Print::print(unsigned long long v, int base) {
+    return print(String(formatInteger(v, false, (unsigned char)base)));
+}
+size_t Print::print(double v, int digits) { return print(String(v, (unsigned int)digits)); }
+size_t Print::print(const Printable& p) { return p.printTo(*this); }
+size_t Print::println() { return write((const uint8_t*)"\r\n", 2); }
+
+String Stream::readStringUntil(char terminator) {
+    String out;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) out += (char)c;
+    return out;
+}
+
+String Stream::readString() {
+    String out;
+    int c;
+    while ((c = read()) >= 0) out += (char)c;
+    return out;
+}
+
+size_t Stream::readBytes(char* buf, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) buf[n++] = (char)c;
+    return n;
+}
+
+// =============================================================================
+// SERIAL
+// =============================================================================
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t size) {
+    if (_echo) fwrite(buf, 1, size, stdout);
+    if (_record) HostStream::write(buf, size);
+    return size;
+}
+
+// Constructed before any other global (e.g. LogCapture Log(Serial)) and
+// destroyed after them
+HardwareSerial Serial __attribute__((init_priority(101)))(false, false);
+HardwareSerial Serial2 __attribute__((init_priority(101)))(false, true);
@@ -0,0 +1,98 @@
+/**
+ * @file Preferences.cpp
+ * @brief Host NVS store
+ */
+
+#include "Preferences.h"
+#include "host_hooks.h"
+#include <string.h>
+#include <map>
+#include <mutex>
+
+#define NVS_KEY_MAX 15  ///< NVS key length limit on the device
+
+static std::mutex nvsLock;
+static std::map<std::string, std::map<std::string, std::string>> nvs;
+
+void hostNvsErase() {
+    std::lock_guard<std::mutex> lock(nvsLock);
+    nvs.clear();
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (name == nullptr || strlen(name) > NVS_KEY_MAX) return false;
+    _ns = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+std::string* Preferences::find(const char* key) {
+    if (!_open || key == nullptr) return nullptr;
+    std::lock_guard<std::mutex> lock(nvsLock);
+    auto ns = nvs.find(_ns);
+    if (ns == nvs.end()) return nullptr;
+    auto it = ns->second.find(key);
+    return it == ns->second.end() ? nullptr : &it->second;
+}
+
+bool Preferences::put(const char* key, const void* value, size_t len) {
+    if (!_open || _readOnly || key == nullptr || strlen(key) > NVS_KEY_MAX) return false;
+    std::lock_guard<std::mutex> lock(nvsLock);
+    nvs[_ns][key] = std::string((const char*)value, len);
+    return true;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvsLock);
+    nvs.erase(_ns);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly || key == nullptr) return false;
+    std::lock_guard<std::mutex> lock(nvsLock);
+    auto ns = nvs.find(_ns);
+    return ns != nvs.end() && ns->second.erase(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    return put(key, value, len) ? len : 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    std::string* v = find(key);
+    return v ? v->size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    std::string* v = find(key);
+    if (v == nullptr || v->size() > maxLen) return 0;
+    memcpy(buf, v->data(), v->size());
+    return v->size();
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    if (value == nullptr) return 0;
+    size_t len = strlen(value);
+    return put(key, value, len + 1) ? len : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    std::string* v = find(key);
+    if (v == nullptr || v->empty()) return defaultValue;
+    return String(v->c_str());
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+    std::string* v = find(key);
+    if (v == nullptr || v->empty() || v->size() > maxLen) return 0;
+    memcpy(value, v->data(), v->size());
+    value[v->size() - 1] = '\0';
+    return v->size();
+}
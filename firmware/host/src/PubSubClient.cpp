@@ -0,0 +1,85 @@
+/**
+ * @file PubSubClient.cpp
+ * @brief Host MQTT client recorder
+ */
+
+#include "PubSubClient.h"
+
+bool PubSubClient::connect(const char* id) {
+    return connect(id, nullptr, nullptr, nullptr, 0, false, nullptr);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass) {
+    return connect(id, user, pass, nullptr, 0, false, nullptr);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass,
+                           const char* willTopic, uint8_t willQos, bool willRetain,
+                           const char* willMessage) {
+    // Clean session: the broker forgets subscriptions on every connect
+    _subscriptions.clear();
+    _state = _connectResult ? MQTT_CONNECTED : MQTT_CONNECT_FAILED;
+    return _connectResult;
+}
+
+void PubSubClient::disconnect() {
+    _state = MQTT_DISCONNECTED;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+    return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int length,
+                           bool retained) {
+    // Header + topic + payload must fit the client buffer, as on the device
+    size_t packet = 5 + 2 + strlen(topic) + length;
+    if (!connected() || !_publishResult || packet > _bufferSize) return false;
+    _published.push_back({topic, std::string((const char*)payload, length), retained});
+    return true;
+}
+
+bool PubSubClient::beginPublish(const char* topic, unsigned int length, bool retained) {
+    if (!connected() || !_publishResult) return false;
+    _streaming = {topic, std::string(), retained};
+    _streaming.payload.reserve(length);
+    _streamRemaining = length;
+    return true;
+}
+
+size_t PubSubClient::write(const uint8_t* buf, size_t size) {
+    if (!connected()) return 0;
+    if (size > _streamRemaining) size = _streamRemaining;
+    _streaming.payload.append((const char*)buf, size);
+    _streamRemaining -= size;
+    return size;
+}
+
+int PubSubClient::endPublish() {
+    if (!connected() || _streamRemaining != 0) return 0;
+    _published.push_back(_streaming);
+    return 1;
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos) {
+    if (!connected()) return false;
+    _subscriptions.push_back(topic);
+    return true;
+}
+
+bool PubSubClient::unsubscribe(const char* topic) {
+    for (auto it = _subscriptions.begin(); it != _subscriptions.end(); ++it) {
+        if (*it == topic) {
+            _subscriptions.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PubSubClient::deliver(const char* topic, const std::string& payload) {
+    if (!callback) return;
+    std::string t(topic);
+    std::string p(payload);
+    callback(&t[0], (uint8_t*)&p[0], (unsigned int)p.size());
+}
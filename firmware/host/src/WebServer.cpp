@@ -0,0 +1,204 @@
+/**
+ * @file WebServer.cpp
+ * @brief Host HTTP request parsing and response writing
+ */
+
+#include "WebServer.h"
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief '+' to space and %XX to the byte; malformed escapes are kept
+ */
+static String urlDecode(const String& in) {
+    std::string out;
+    const char* s = in.c_str();
+    size_t n = in.length();
+    out.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] == '+') {
+            out += ' ';
+        } else if (s[i] == '%' && i + 2 < n && hexValue(s[i + 1]) >= 0 && hexValue(s[i + 2]) >= 0) {
+            out += (char)(hexValue(s[i + 1]) << 4 | hexValue(s[i + 2]));
+            i += 2;
+        } else {
+            out += s[i];
+        }
+    }
+    return String(out);
+}
+
+static String readLine(WiFiClient& client) {
+    String line = client.readStringUntil('\n');
+    if (line.length() > 0 && line.c_str()[line.length() - 1] == '\r') {
+        line = line.substring(0, line.length() - 1);
+    }
+    return line;
+}
+
+static HTTPMethod parseMethod(const String& m) {
+    if (m == "GET") return HTTP_GET;
+    if (m == "HEAD") return HTTP_HEAD;
+    if (m == "POST") return HTTP_POST;
+    if (m == "PUT") return HTTP_PUT;
+    if (m == "PATCH") return HTTP_PATCH;
+    if (m == "DELETE") return HTTP_DELETE;
+    if (m == "OPTIONS") return HTTP_OPTIONS;
+    return HTTP_ANY;
+}
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 302: return "Found";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        default:  return "";
+    }
+}
+
+// =============================================================================
+// REQUEST
+// =============================================================================
+
+void WebServer::parseArgs(const String& data) {
+    unsigned int pos = 0;
+    while (pos < data.length() && _args.size() < WEBSERVER_MAX_ARGS) {
+        int amp = data.indexOf('&', pos);
+        unsigned int end = amp < 0 ? data.length() : (unsigned int)amp;
+        String pair = data.substring(pos, end);
+        pos = end + 1;
+        if (pair.length() == 0) continue;
+
+        int eq = pair.indexOf('=');
+        if (eq < 0) {
+            _args.push_back({urlDecode(pair), String()});
+        } else {
+            _args.push_back({urlDecode(pair.substring(0, eq)), urlDecode(pair.substring(eq + 1))});
+        }
+    }
+}
+
+bool WebServer::parseRequest() {
+    _args.clear();
+    _headers = String();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+
+    // "METHOD /path?query HTTP/1.1"
+    String line = readLine(_client);
+    int sp1 = line.indexOf(' ');
+    int sp2 = line.lastIndexOf(' ');
+    if (sp1 <= 0 || sp2 <= sp1) return false;
+
+    _method = parseMethod(line.substring(0, sp1));
+    String target = line.substring(sp1 + 1, sp2);
+    int q = target.indexOf('?');
+    _uri = q < 0 ? target : target.substring(0, q);
+    if (q >= 0) parseArgs(target.substring(q + 1));
+
+    size_t bodyLen = 0;
+    bool form = false;
+    for (;;) {
+        String header = readLine(_client);
+        if (header.length() == 0) break;
+        int colon = header.indexOf(':');
+        if (colon <= 0) continue;
+
+        String name = header.substring(0, colon);
+        String value = header.substring(colon + 1);
+        value.trim();
+        if (name.equalsIgnoreCase("Content-Length")) {
+            long n = value.toInt();
+            bodyLen = n > 0 ? std::min((size_t)n, (size_t)WEBSERVER_MAX_BODY) : 0;
+        } else if (name.equalsIgnoreCase("Content-Type")) {
+            form = value.startsWith("application/x-www-form-urlencoded");
+        }
+    }
+
+    if (bodyLen > 0) {
+        std::string body(bodyLen, '\0');
+        body.resize(_client.readBytes(&body[0], bodyLen));
+        if (form) {
+            parseArgs(String(body));
+        } else if (_args.size() < WEBSERVER_MAX_ARGS) {
+            _args.push_back({String("plain"), String(body)});
+        }
+    }
+    return true;
+}
+
+bool WebServer::hasArg(const String& name) const {
+    for (const Arg& a : _args) {
+        if (a.name == name) return true;
+    }
+    return false;
+}
+
+String WebServer::arg(const String& name) const {
+    for (const Arg& a : _args) {
+        if (a.name == name) return a.value;
+    }
+    return String();
+}
+
+void WebServer::handleClient() {
+    _client = _server.available();
+    if (!_client) return;
+
+    if (parseRequest()) {
+        THandlerFunction fn = _notFound;
+        for (const Route& r : _routes) {
+            if (r.uri == _uri && (r.method == HTTP_ANY || r.method == _method)) {
+                fn = r.fn;
+                break;
+            }
+        }
+        if (fn) {
+            fn();
+        } else {
+            send(404, "text/plain", "Not found");
+        }
+    }
+    _client.stop();
+}
+
+// =============================================================================
+// RESPONSE
+// =============================================================================
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line = name + ": " + value + "\r\n";
+    _headers = first ? line + _headers : _headers + line;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    _client.printf("HTTP/1.1 %d %s\r\n", code, statusText(code));
+    if (contentType != nullptr && contentType[0] != '\0') {
+        _client.printf("Content-Type: %s\r\n", contentType);
+    }
+    if (_contentLength == CONTENT_LENGTH_UNKNOWN) {
+        _client.print("Connection: close\r\n");
+    } else {
+        size_t len = _contentLength == CONTENT_LENGTH_NOT_SET ? content.length() : _contentLength;
+        _client.printf("Content-Length: %u\r\n", (unsigned int)len);
+    }
+    _client.print(_headers);
+    _client.print("\r\n");
+    _client.print(content);
+
+    _headers = String();
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+}
+
+void WebServer::sendContent(const char* content) {
+    _client.print(content);
+}
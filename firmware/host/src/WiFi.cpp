@@ -0,0 +1,48 @@
+/**
+ * @file WiFi.cpp
+ * @brief Host WiFi station and scripted TCP connections
+ */
+
+#include "WiFi.h"
+#include <deque>
+#include <mutex>
+
+WiFiClass WiFi;
+
+// =============================================================================
+// PENDING CONNECTIONS
+// =============================================================================
+
+struct PendingConnection {
+    uint16_t port;
+    std::shared_ptr<HostStream> conn;
+};
+
+static std::mutex pendingLock;
+static std::deque<PendingConnection> pending;
+
+WiFiClient WiFiServer::available() {
+    std::lock_guard<std::mutex> lock(pendingLock);
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+        if (it->port == _port) {
+            WiFiClient client(it->conn);
+            pending.erase(it);
+            return client;
+        }
+    }
+    return WiFiClient();
+}
+
+std::shared_ptr<HostStream> WiFiServer::hostAccept(uint16_t port, const std::string& request) {
+    auto conn = std::make_shared<HostStream>();
+    conn->feed(request);
+
+    std::lock_guard<std::mutex> lock(pendingLock);
+    pending.push_back({port, conn});
+    return conn;
+}
+
+void WiFiServer::hostResetPending() {
+    std::lock_guard<std::mutex> lock(pendingLock);
+    pending.clear();
+}
@@ -0,0 +1,218 @@
+/**
+ * @file freertos.cpp
+ * @brief Host FreeRTOS queues and tasks on the C++ standard library
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+unsigned long millis();
+
+// =============================================================================
+// QUEUES
+// =============================================================================
+
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    size_t length;
+    size_t itemSize;
+};
+
+/**
+ * @brief Wait on cv until ready() or the tick timeout passes (lock held)
+ */
+template <typename Pred>
+static bool waitFor(HostQueue* q, std::unique_lock<std::mutex>& lock, TickType_t wait, Pred ready) {
+    if (ready()) return true;
+    if (wait == 0) return false;
+    if (wait == portMAX_DELAY) {
+        q->changed.wait(lock, ready);
+        return true;
+    }
+    return q->changed.wait_for(lock, std::chrono::milliseconds(wait), ready);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) return nullptr;
+    HostQueue* q = new HostQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+static BaseType_t queueSend(QueueHandle_t q, const void* item, TickType_t wait, bool front) {
+    if (q == nullptr) return pdFAIL;
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitFor(q, lock, wait, [q] { return q->items.size() < q->length; })) return pdFAIL;
+
+    const uint8_t* p = (const uint8_t*)item;
+    std::vector<uint8_t> copy(p, p + q->itemSize);
+    if (front) q->items.push_front(std::move(copy));
+    else q->items.push_back(std::move(copy));
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait) {
+    return queueSend(queue, item, wait, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t wait) {
+    return queueSend(queue, item, wait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t wait) {
+    return queueSend(queue, item, wait, true);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void* item) {
+    if (q == nullptr) return pdFAIL;
+    std::lock_guard<std::mutex> lock(q->lock);
+    const uint8_t* p = (const uint8_t*)item;
+    q->items.clear();
+    q->items.emplace_back(p, p + q->itemSize);
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+static BaseType_t queueTake(QueueHandle_t q, void* item, TickType_t wait, bool remove) {
+    if (q == nullptr) return pdFAIL;
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitFor(q, lock, wait, [q] { return !q->items.empty(); })) return pdFAIL;
+
+    memcpy(item, q->items.front().data(), q->itemSize);
+    if (remove) {
+        q->items.pop_front();
+        q->changed.notify_all();
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+    return queueTake(queue, item, wait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t wait) {
+    return queueTake(queue, item, wait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->lock);
+    return (UBaseType_t)q->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->lock);
+    return (UBaseType_t)(q->length - q->items.size());
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->lock);
+    q->items.clear();
+    q->changed.notify_all();
+    return pdPASS;
+}
+
+// =============================================================================
+// TASKS
+// =============================================================================
+
+struct HostTask {
+    std::string name;
+    TaskFunction_t fn;
+    void* arg;
+    UBaseType_t prio;
+    BaseType_t core;
+    uint32_t stackBytes;
+};
+
+/** @brief Thrown by vTaskDelete(nullptr) to unwind the calling task */
+struct HostTaskExit {};
+
+static thread_local HostTask* currentTask = nullptr;
+
+static void taskMain(HostTask* task) {
+    currentTask = task;
+    try {
+        task->fn(task->arg);
+    } catch (const HostTaskExit&) {
+    }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                                   void* arg, UBaseType_t prio, TaskHandle_t* handle,
+                                   BaseType_t core) {
+    // Tasks live for the rest of the process, like most firmware tasks
+    HostTask* task = new HostTask{name ? name : "", fn, arg, prio, core, stackBytes};
+    std::thread(taskMain, task).detach();
+    if (handle) *handle = task;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                       void* arg, UBaseType_t prio, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackBytes, arg, prio, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Another task's thread cannot be stopped from outside; only self-delete
+    if (task == nullptr || task == currentTask) throw HostTaskExit();
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks ? ticks : 0));
+    if (ticks == 0) std::this_thread::yield();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    TickType_t target = *previousWake + increment;
+    TickType_t now = xTaskGetTickCount();
+    *previousWake = target;
+    if ((int32_t)(target - now) <= 0) return pdFALSE;
+    vTaskDelay(target - now);
+    return pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    xTaskDelayUntil(previousWake, increment);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    return task ? task->name.c_str() : "main";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    return task ? task->stackBytes / 2 : 4096;
+}
+
+BaseType_t xPortGetCoreID() {
+    return currentTask && currentTask->core != tskNO_AFFINITY ? currentTask->core : 1;
+}
+
+void taskYIELD() {
+    std::this_thread::yield();
+}
@@ -0,0 +1,74 @@
+/**
+ * @file globals.cpp
+ * @brief Host definitions of the firmware.ino globals, plus stand-ins for
+ * the modules that are not built on the host
+ *
+ * postmortem, power, supervisor and wifi_link are tied to ESP-IDF internals
+ * (RTC memory, esp_pm, the task watchdog, the station driver); the core
+ * only needs their reporting functions, so those are stubbed here with the
+ * same signatures.
+ */
+
+#include "../../src/globals.h"
+#include "../../src/gsm.h"
+#include "../../src/postmortem.h"
+#include "../../src/power.h"
+#include "../../src/supervisor.h"
+#include "../../src/wifi_link.h"
+
+// =============================================================================
+// GLOBAL OBJECT DEFINITIONS (as in firmware.ino)
+// =============================================================================
+
+LogCapture Log(Serial);
+ModemStream modemUart(Serial2);
+TinyGsm modem(modemUart);
+TinyGsmClient gsmClient(modem);
+GSMState gsmState = GSM_UNINITIALIZED;
+PubSubClient mqtt(gsmClient);
+SystemData currentData;
+bool networkReady = false;
+bool startupComplete = false;
+WiFiClient wifiClient;
+ConnectionType activeConnection = CONN_NONE;
+RuntimeConfig runtimeCfg;
+
+// =============================================================================
+// POSTMORTEM STAND-IN
+// =============================================================================
+
+const char* resetReasonName(uint8_t reason) {
+    return reason == ESP_RST_POWERON ? "poweron" : "unknown";
+}
+
+uint8_t getResetReason() {
+    return ESP_RST_POWERON;
+}
+
+const PostMortemRecord* getPendingPostMortem() {
+    return nullptr;
+}
+
+void clearPostMortem() {}
+
+// =============================================================================
+// POWER / SUPERVISOR STAND-INS
+// =============================================================================
+
+size_t formatPowerJson(char* buf, size_t size) {
+    return size ? snprintf(buf, size, "{\"mode\":\"host\"}") : 0;
+}
+
+size_t formatSupervisorJson(char* buf, size_t size) {
+    return size ? snprintf(buf, size, "{}") : 0;
+}
+
+void supervisorCheckIn(SupervisedId id) {}
+
+// =============================================================================
+// WIFI LINK STAND-IN
+// =============================================================================
+
+size_t formatWiFiLinkJson(char* buf, size_t size) {
+    return size ? snprintf(buf, size, "{}") : 0;
+}
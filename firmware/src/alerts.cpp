@@ -5,13 +5,84 @@
 
 #include "alerts.h"
 #include "globals.h"
-#include "gsm.h"
+#include "events.h"
+#include <atomic>
 
 // =============================================================================
 // PRIVATE DATA
 // =============================================================================
 
 static AlertCooldown alertCooldowns;
+static AlertLevel lastLevel[ALERT_TYPE_COUNT];  ///< Level at the previous check
+
+/// SMS queued and not yet sent or failed (set by the notifier, cleared on
+/// the network task); holds reminders so a slow send is not queued twice
+static std::atomic<bool> smsPending[ALERT_TYPE_COUNT];
+
+/**
+ * @brief Thresholds in effect, reloaded from RuntimeConfig on change
+ */
+static struct {
+    float voltageHighCritical = VOLTAGE_HIGH_CRITICAL;
+    float voltageHighWarning = VOLTAGE_HIGH_WARNING;
+    float voltageLowWarning = VOLTAGE_LOW_WARNING;
+    float voltageLowCritical = VOLTAGE_LOW_CRITICAL;
+    float compTempCritical = COMP_TEMP_CRITICAL;
+    float compTempWarning = COMP_TEMP_WARNING;
+    float pressureHighCritical = PRESSURE_HIGH_CRITICAL;
+    float pressureHighWarning = PRESSURE_HIGH_WARNING;
+    float pressureLowCritical = PRESSURE_LOW_CRITICAL;
+    float pressureLowWarning = PRESSURE_LOW_WARNING;
+    float currentCritical = CURRENT_CRITICAL;
+    float currentWarning = CURRENT_WARNING;
+    unsigned long cooldown = ALERT_COOLDOWN;
+} limits;
+
+static void onAlertConfigChanged(const RuntimeConfig& cfg, uint8_t changed) {
+    if (!(changed & (CFG_SECTION_ALERTS | CFG_SECTION_INTERVALS))) return;
+
+    limits.voltageHighCritical = cfg.voltageHighCritical;
+    limits.voltageHighWarning = cfg.voltageHighWarning;
+    limits.voltageLowWarning = cfg.voltageLowWarning;
+    limits.voltageLowCritical = cfg.voltageLowCritical;
+    limits.compTempCritical = cfg.compTempCritical;
+    limits.compTempWarning = cfg.compTempWarning;
+    limits.pressureHighCritical = cfg.pressureHighCritical;
+    limits.pressureHighWarning = cfg.pressureHighWarning;
+    limits.pressureLowCritical = cfg.pressureLowCritical;
+    limits.pressureLowWarning = cfg.pressureLowWarning;
+    limits.currentCritical = cfg.currentCritical;
+    limits.currentWarning = cfg.currentWarning;
+    limits.cooldown = cfg.alertCooldown;
+}
+
+/**
+ * @brief Track one alert's level and announce changes on the event bus
+ *
+ * Every level change is published. A critical level is published again
+ * (level == prevLevel) at every check while canSendAlert() allows it, so
+ * notifiers can repeat it. The cooldown starts only when the notifier
+ * reports the SMS sent (recordAlertSent()); until then an SMS that could
+ * not be queued or sent is retried at the next check, as before.
+ */
+static void updateAlert(AlertType type, AlertLevel level, float value) {
+    AlertLevel prev = lastLevel[type];
+    lastLevel[type] = level;
+
+    if (level == ALERT_CRITICAL) {
+        alertCooldowns.alertActive[type] = true;
+        if (canSendAlert(type)) {
+            publishAlertEvent(type, level, prev, value);
+            return;
+        }
+    }
+    if (level == prev) return;
+
+    if (level == ALERT_OK) {
+        resetAlertCooldown(type);
+    }
+    publishAlertEvent(type, level, prev, value);
+}
 
 // =============================================================================
 // IMPLEMENTATION
@@ -21,27 +92,30 @@ void initAlerts() {
     for (int i = 0; i < ALERT_TYPE_COUNT; i++) {
         alertCooldowns.lastAlertTime[i] = 0;
         alertCooldowns.alertActive[i] = false;
+        lastLevel[i] = ALERT_OK;
+        smsPending[i] = false;
     }
+    subscribeConfig(onAlertConfigChanged);
     Log.println(F("[ALERTS] Initialized"));
 }
 
 AlertLevel checkVoltage(float voltage, bool* isHigh) {
     // Check high voltage
-    if (voltage >= VOLTAGE_HIGH_CRITICAL) {
+    if (voltage >= limits.voltageHighCritical) {
         *isHigh = true;
         return ALERT_CRITICAL;
     }
-    if (voltage >= VOLTAGE_HIGH_WARNING) {
+    if (voltage >= limits.voltageHighWarning) {
         *isHigh = true;
         return ALERT_WARNING;
     }
 
     // Check low voltage
-    if (voltage <= VOLTAGE_LOW_CRITICAL) {
+    if (voltage <= limits.voltageLowCritical) {
         *isHigh = false;
         return ALERT_CRITICAL;
     }
-    if (voltage <= VOLTAGE_LOW_WARNING) {
+    if (voltage <= limits.voltageLowWarning) {
         *isHigh = false;
         return ALERT_WARNING;
     }
@@ -50,40 +124,40 @@ AlertLevel checkVoltage(float voltage, bool* isHigh) {
 }
 
 AlertLevel checkCompressorTemp(float temp) {
-    if (temp >= COMP_TEMP_CRITICAL) {
+    if (temp >= limits.compTempCritical) {
         return ALERT_CRITICAL;
     }
-    if (temp >= COMP_TEMP_WARNING) {
+    if (temp >= limits.compTempWarning) {
         return ALERT_WARNING;
     }
     return ALERT_OK;
 }
 
 AlertLevel checkPressureHigh(float pressure) {
-    if (pressure >= PRESSURE_HIGH_CRITICAL) {
+    if (pressure >= limits.pressureHighCritical) {
         return ALERT_CRITICAL;
     }
-    if (pressure >= PRESSURE_HIGH_WARNING) {
+    if (pressure >= limits.pressureHighWarning) {
         return ALERT_WARNING;
     }
     return ALERT_OK;
 }
 
 AlertLevel checkPressureLow(float pressure) {
-    if (pressure <= PRESSURE_LOW_CRITICAL) {
+    if (pressure <= limits.pressureLowCritical) {
         return ALERT_CRITICAL;
     }
-    if (pressure <= PRESSURE_LOW_WARNING) {
+    if (pressure <= limits.pressureLowWarning) {
         return ALERT_WARNING;
     }
     return ALERT_OK;
 }
 
 AlertLevel checkCurrent(float current) {
-    if (current >= CURRENT_CRITICAL) {
+    if (current >= limits.currentCritical) {
         return ALERT_CRITICAL;
     }
-    if (current >= CURRENT_WARNING) {
+    if (current >= limits.currentWarning) {
         return ALERT_WARNING;
     }
     return ALERT_OK;
@@ -94,16 +168,20 @@ bool canSendAlert(AlertType type) {
         return false;
     }
 
-    unsigned long now = millis();
-    unsigned long lastAlert = alertCooldowns.lastAlertTime[type];
-
-    // Handle millis() overflow
-    if (now < lastAlert) {
-        alertCooldowns.lastAlertTime[type] = 0;
-        return true;
+    if (smsPending[type]) {
+        return false;
     }
 
-    return (now - lastAlert) >= ALERT_COOLDOWN;
+    // Unsigned 32-bit difference stays correct across the millis() wrap
+    uint32_t elapsed = (uint32_t)(millis() - alertCooldowns.lastAlertTime[type]);
+    return elapsed >= limits.cooldown;
+}
+
+void markAlertQueued(AlertType type) {
+    if (type >= ALERT_TYPE_COUNT) {
+        return;
+    }
+    smsPending[type] = true;
 }
 
 void recordAlertSent(AlertType type) {
@@ -112,12 +190,19 @@ void recordAlertSent(AlertType type) {
     }
 
     alertCooldowns.lastAlertTime[type] = millis();
-    alertCooldowns.alertActive[type] = true;
+    smsPending[type] = false;   // After the timestamp: canSendAlert() sees both
 
     Log.print(F("[ALERTS] Alert recorded: "));
     Log.println(getAlertTypeName(type));
 }
 
+void recordAlertFailed(AlertType type) {
+    if (type >= ALERT_TYPE_COUNT) {
+        return;
+    }
+    smsPending[type] = false;
+}
+
 void resetAlertCooldown(AlertType type) {
     if (type >= ALERT_TYPE_COUNT) {
         return;
@@ -151,6 +236,10 @@ size_t formatAlertMessage(AlertType type, AlertLevel level, float value,
         case ALERT_OVERCURRENT:
             unit = "A";
             break;
+        case ALERT_MEMORY:
+            unit = "KB";  // Largest free heap block
+            precision = 0;
+            break;
         default:
             break;
     }
@@ -181,83 +270,36 @@ size_t formatAlertMessage(AlertType type, AlertLevel level, float value,
 }
 
 void checkAllAlerts(SystemData& data) {
-    bool isHighVoltage;
-    char alertBuffer[SMS_BUFFER_SIZE];
+    bool isHighVoltage = false;   // Not set by checkVoltage() when OK
 
     // ---- VOLTAGE CHECK ----
     AlertLevel voltageAlert = checkVoltage(data.voltage.value, &isHighVoltage);
     data.voltage.alertLevel = voltageAlert;
-
-    if (voltageAlert != ALERT_OK) {
-        AlertType alertType = isHighVoltage ? ALERT_VOLTAGE_HIGH : ALERT_VOLTAGE_LOW;
-
-        if (voltageAlert == ALERT_CRITICAL && canSendAlert(alertType)) {
-            formatAlertMessage(alertType, voltageAlert, data.voltage.value,
-                               alertBuffer, sizeof(alertBuffer));
-            if (sendSMS(ADMIN_PHONE, alertBuffer)) {
-                recordAlertSent(alertType);
-            }
-        }
-    } else {
-        resetAlertCooldown(ALERT_VOLTAGE_HIGH);
-        resetAlertCooldown(ALERT_VOLTAGE_LOW);
-    }
+    updateAlert(ALERT_VOLTAGE_HIGH, isHighVoltage ? voltageAlert : ALERT_OK, data.voltage.value);
+    updateAlert(ALERT_VOLTAGE_LOW, isHighVoltage ? ALERT_OK : voltageAlert, data.voltage.value);
 
     // ---- COMPRESSOR TEMPERATURE CHECK ----
-    AlertLevel tempAlert = checkCompressorTemp(data.tempCompressor.value);
-    data.tempCompressor.alertLevel = tempAlert;
-
-    if (tempAlert == ALERT_CRITICAL && canSendAlert(ALERT_COMPRESSOR_TEMP)) {
-        formatAlertMessage(ALERT_COMPRESSOR_TEMP, tempAlert, data.tempCompressor.value,
-                           alertBuffer, sizeof(alertBuffer));
-        if (sendSMS(ADMIN_PHONE, alertBuffer)) {
-            recordAlertSent(ALERT_COMPRESSOR_TEMP);
-        }
-    } else if (tempAlert == ALERT_OK) {
-        resetAlertCooldown(ALERT_COMPRESSOR_TEMP);
-    }
+    data.tempCompressor.alertLevel = checkCompressorTemp(data.tempCompressor.value);
+    updateAlert(ALERT_COMPRESSOR_TEMP, data.tempCompressor.alertLevel, data.tempCompressor.value);
 
     // ---- HIGH PRESSURE CHECK ----
-    AlertLevel highPressureAlert = checkPressureHigh(data.pressureHigh.value);
-    data.pressureHigh.alertLevel = highPressureAlert;
-
-    if (highPressureAlert == ALERT_CRITICAL && canSendAlert(ALERT_PRESSURE_HIGH)) {
-        formatAlertMessage(ALERT_PRESSURE_HIGH, highPressureAlert, data.pressureHigh.value,
-                           alertBuffer, sizeof(alertBuffer));
-        if (sendSMS(ADMIN_PHONE, alertBuffer)) {
-            recordAlertSent(ALERT_PRESSURE_HIGH);
-        }
-    } else if (highPressureAlert == ALERT_OK) {
-        resetAlertCooldown(ALERT_PRESSURE_HIGH);
-    }
+    data.pressureHigh.alertLevel = checkPressureHigh(data.pressureHigh.value);
+    updateAlert(ALERT_PRESSURE_HIGH, data.pressureHigh.alertLevel, data.pressureHigh.value);
 
     // ---- LOW PRESSURE CHECK ----
-    AlertLevel lowPressureAlert = checkPressureLow(data.pressureLow.value);
-    data.pressureLow.alertLevel = lowPressureAlert;
-
-    if (lowPressureAlert == ALERT_CRITICAL && canSendAlert(ALERT_PRESSURE_LOW)) {
-        formatAlertMessage(ALERT_PRESSURE_LOW, lowPressureAlert, data.pressureLow.value,
-                           alertBuffer, sizeof(alertBuffer));
-        if (sendSMS(ADMIN_PHONE, alertBuffer)) {
-            recordAlertSent(ALERT_PRESSURE_LOW);
-        }
-    } else if (lowPressureAlert == ALERT_OK) {
-        resetAlertCooldown(ALERT_PRESSURE_LOW);
-    }
+    data.pressureLow.alertLevel = checkPressureLow(data.pressureLow.value);
+    updateAlert(ALERT_PRESSURE_LOW, data.pressureLow.alertLevel, data.pressureLow.value);
 
     // ---- OVERCURRENT CHECK ----
-    AlertLevel currentAlert = checkCurrent(data.current.value);
-    data.current.alertLevel = currentAlert;
-
-    if (currentAlert == ALERT_CRITICAL && canSendAlert(ALERT_OVERCURRENT)) {
-        formatAlertMessage(ALERT_OVERCURRENT, currentAlert, data.current.value,
-                           alertBuffer, sizeof(alertBuffer));
-        if (sendSMS(ADMIN_PHONE, alertBuffer)) {
-            recordAlertSent(ALERT_OVERCURRENT);
-        }
-    } else if (currentAlert == ALERT_OK) {
-        resetAlertCooldown(ALERT_OVERCURRENT);
+    data.current.alertLevel = checkCurrent(data.current.value);
+    updateAlert(ALERT_OVERCURRENT, data.current.alertLevel, data.current.value);
+}
+
+void raiseInternalAlert(AlertType type, AlertLevel level, float value) {
+    if (type >= ALERT_TYPE_COUNT) {
+        return;
     }
+    updateAlert(type, level, value);
 }
 
 size_t getAlertSummary(char* buffer, size_t bufferSize) {
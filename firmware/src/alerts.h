@@ -3,7 +3,8 @@
  * @brief Alert management interface
  *
  * Handles threshold checking for all sensors and manages alert cooldowns
- * to prevent SMS spam.
+ * to prevent SMS spam. Alert changes are published on the event bus
+ * (events.h); the SMS notifier is one of its subscribers.
  */
 
 #ifndef ALERTS_H
@@ -12,6 +13,7 @@
 #include <Arduino.h>
 #include "../config.h"
 #include "types.h"
+#include "config_store.h"
 
 // =============================================================================
 // FUNCTION DECLARATIONS
@@ -19,6 +21,7 @@
 
 /**
  * @brief Initialize the alert system
+ * @note Subscribes to config changes; thresholds follow RuntimeConfig live
  */
 void initAlerts();
 
@@ -61,16 +64,30 @@ AlertLevel checkCurrent(float current);
 /**
  * @brief Check if an alert can be sent (cooldown check)
  * @param type Alert type to check
- * @return true if cooldown period has passed
+ * @return true if cooldown period has passed and no SMS for it is in flight
  */
 bool canSendAlert(AlertType type);
 
 /**
- * @brief Record that an alert was sent
+ * @brief Note that an SMS for an alert was queued (call before queueing)
+ *
+ * Holds reminders until the sender calls recordAlertSent() or
+ * recordAlertFailed().
+ */
+void markAlertQueued(AlertType type);
+
+/**
+ * @brief Record that an alert SMS was sent; starts the cooldown
  * @param type Alert type that was sent
  */
 void recordAlertSent(AlertType type);
 
+/**
+ * @brief Record that an alert SMS was dropped or failed; retried at the
+ *        next check
+ */
+void recordAlertFailed(AlertType type);
+
 /**
  * @brief Reset cooldown when condition clears
  * @param type Alert type to reset
@@ -90,11 +107,22 @@ size_t formatAlertMessage(AlertType type, AlertLevel level, float value,
                           char* buffer, size_t bufferSize);
 
 /**
- * @brief Check all sensors and send alerts if needed
+ * @brief Check all sensors and publish alert level changes
  * @param data System data to check (alertLevel fields will be updated)
+ * @note Publishes EVT_ALERT on every level change, and again for a
+ *       critical level still present after the cooldown. Delivery (SMS,
+ *       ...) is up to the event subscribers.
  */
 void checkAllAlerts(SystemData& data);
 
+/**
+ * @brief Track an alert the firmware raises about itself (not a sensor)
+ * @param value Reported value (unit per type, see formatAlertMessage())
+ * @note Same publishing and cooldown rules as checkAllAlerts(). Each type
+ *       must be raised from a single task.
+ */
+void raiseInternalAlert(AlertType type, AlertLevel level, float value);
+
 /**
  * @brief Get summary of active alerts
  * @param buffer Output buffer
@@ -0,0 +1,273 @@
+/**
+ * @file bench_suite.cpp
+ * @brief Firmware micro-benchmark cases
+ *
+ * Each case exercises one hot path with fixed inputs and no I/O, so the
+ * same numbers can be compared across builds on the same platform.
+ */
+
+#include "bench_suite.h"
+#include "globals.h"
+#include "buffer.h"
+#include "config_store.h"
+#include "events.h"
+#include "gsm.h"
+#include "latency.h"
+#include "mqtt.h"
+#include "scheduler.h"
+#include "sensors.h"
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// =============================================================================
+// FIXTURES
+// =============================================================================
+
+static SystemData benchReading() {
+    SystemData d;
+    d.readingTime = 123456;
+    d.tempInlet.value = 40.2f;
+    d.tempOutlet.value = 45.7f;
+    d.tempAmbient.value = 12.4f;
+    d.tempCompressor.value = 71.9f;
+    d.voltage.value = 229.8f;
+    d.current.value = 7.25f;
+    d.power = 1666.1f;
+    d.pressureHigh.value = 281.0f;
+    d.pressureLow.value = 68.0f;
+    d.compressorRunning = true;
+    return d;
+}
+
+#define BENCH_NVS_NS "hpbench"   ///< Scratch namespace; the real config is not touched
+
+/**
+ * @brief Store the same settings as a config blob and as the legacy keys
+ */
+static void seedConfigLayouts() {
+    RuntimeConfig cfg;
+    Preferences prefs;
+    prefs.begin(BENCH_NVS_NS, false);
+    prefs.clear();
+    writeConfigBlob(prefs, cfg);
+    prefs.putBool("configured", true);
+    prefs.putString("wifi_ssid", "bench-ssid");
+    prefs.putString("wifi_pass", "bench-password");
+    prefs.putString("mqtt_host", "broker.example.net");
+    prefs.putUShort("mqtt_port", 1883);
+    prefs.putString("mqtt_user", "heatpump");
+    prefs.putString("mqtt_pass", "mqtt-password");
+    prefs.end();
+}
+
+static const char LOG_LINE[] = "[SENSORS] V=229.8 I=7.25 T=45.7\n";
+
+#define BENCH_LOG_WRITERS 4   ///< Most concurrent Log writers (caller + helper tasks)
+
+/** @brief Go (operation count) and done signals of the helper writer tasks */
+static QueueHandle_t writerGo[BENCH_LOG_WRITERS - 1];
+static QueueHandle_t writerDone;
+
+static void logWriterTask(void* arg) {
+    QueueHandle_t go = (QueueHandle_t)arg;
+    uint32_t n;
+    for (;;) {
+        xQueueReceive(go, &n, portMAX_DELAY);
+        for (uint32_t i = 0; i < n; i++) {
+            Log.write((const uint8_t*)LOG_LINE, sizeof(LOG_LINE) - 1);
+        }
+        xQueueSend(writerDone, &n, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Park the helper writers; they block on their go queue between samples
+ */
+static void startLogWriters() {
+    writerDone = xQueueCreate(BENCH_LOG_WRITERS, sizeof(uint32_t));
+    for (int i = 0; i < BENCH_LOG_WRITERS - 1; i++) {
+        writerGo[i] = xQueueCreate(1, sizeof(uint32_t));
+        xTaskCreate(logWriterTask, "benchlog", 4096, writerGo[i], 1, nullptr);
+    }
+}
+
+/**
+ * @brief n Log writes split over `writers` concurrent writers, the caller
+ * being one of them
+ */
+static void runLogWriters(uint32_t n, int writers) {
+    uint32_t share = n / writers;
+    for (int i = 0; i < writers - 1; i++) {
+        xQueueSend(writerGo[i], &share, portMAX_DELAY);
+    }
+    for (uint32_t i = 0; i < n - share * (writers - 1); i++) {
+        Log.write((const uint8_t*)LOG_LINE, sizeof(LOG_LINE) - 1);
+    }
+    uint32_t done;
+    for (int i = 0; i < writers - 1; i++) {
+        xQueueReceive(writerDone, &done, portMAX_DELAY);
+    }
+}
+
+static void onBenchReading(const Event& ev, void*) {
+    benchSink += ev.reading->readingTime;
+}
+
+/** @brief Virtual clock for the scheduler cases; advanced by hand */
+static uint32_t benchClockMs = 0;
+
+static uint32_t benchMillis() { return benchClockMs; }
+static uint32_t benchMicros() { return benchClockMs * 1000UL; }
+
+static void benchNoop(void*) {}
+
+static const char SMS_LISTING[] =
+    "\r\n+CMGL: 1,\"REC UNREAD\",\"+911234567890\",,\"24/01/01,10:00:00+22\"\r\n"
+    "STATUS\r\n\r\nOK\r\n";
+
+// =============================================================================
+// CASES
+// =============================================================================
+
+static void benchJsonPayload(uint32_t n) {
+    static SystemData d = benchReading();
+    char buf[JSON_BUFFER_SIZE];
+    for (uint32_t i = 0; i < n; i++) {
+        d.readingTime = i;
+        benchSink += buildJsonPayload(d, buf, sizeof(buf));
+    }
+}
+
+static void benchNtcMath(uint32_t n) {
+    float acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += ntcTemperature(0.5f + (i & 63) * 0.035f);
+    }
+    benchSink += (uint32_t)acc;
+}
+
+static void benchBufferData(uint32_t n) {
+    static SystemData d = benchReading();
+    for (uint32_t i = 0; i < n; i++) {
+        d.readingTime = i;
+        bufferData(d);
+        markDataPublished();  // Stay below capacity: no overflow warning
+    }
+}
+
+static void benchLogWrite(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        Log.write((const uint8_t*)LOG_LINE, sizeof(LOG_LINE) - 1);
+    }
+}
+
+// Same lines from 2 and 4 writers at once: ns per line over all writers,
+// so contention on the ring shows as a rise over log_write
+static void benchLogWrite2(uint32_t n) {
+    runLogWriters(n, 2);
+}
+
+static void benchLogWrite4(uint32_t n) {
+    runLogWriters(n, 4);
+}
+
+static void benchSmsParse(uint32_t n) {
+    static const String response(SMS_LISTING);
+    SMSMessage msg;
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += parseSMSListing(response, msg);
+    }
+}
+
+static void benchLatencyRecord(uint32_t n) {
+    uint32_t us = 1;
+    for (uint32_t i = 0; i < n; i++) {
+        latencyRecord(LAT_PUBLISH, us & 0xFFFFF);
+        us = us * 1103515245UL + 12345UL;
+    }
+}
+
+// One reading through the bus to one direct subscriber
+static void benchPublishReading(uint32_t n) {
+    static SystemData d = benchReading();
+    for (uint32_t i = 0; i < n; i++) {
+        d.readingTime = i;
+        benchSink += publishReadingEvent(d);
+    }
+}
+
+// One millisecond tick: every job released in it is dispatched. Periods
+// are 10..17 ms, so a tick mostly costs the EDF scan over the table.
+static void benchSchedTick(Scheduler& sched, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchClockMs++;
+        while (sched.runOnce()) {
+        }
+    }
+}
+
+static void benchSchedRun2(uint32_t n) {
+    static Scheduler sched("bench2", benchMillis, benchMicros);
+    if (sched.count() == 0) {
+        for (uint8_t i = 0; i < 2; i++) sched.add("job", benchNoop, nullptr, 10 + i, 0, i);
+    }
+    benchSchedTick(sched, n);
+}
+
+static void benchSchedRun8(uint32_t n) {
+    static Scheduler sched("bench8", benchMillis, benchMicros);
+    if (sched.count() == 0) {
+        for (uint8_t i = 0; i < SCHED_MAX_JOBS; i++) sched.add("job", benchNoop, nullptr, 10 + i, 0, i);
+    }
+    benchSchedTick(sched, n);
+}
+
+// Whole config in one read (25 fields) vs the 1.0.0 layout, one key per
+// field (network fields only)
+static void benchConfigBlob(uint32_t n) {
+    Preferences prefs;
+    prefs.begin(BENCH_NVS_NS, true);
+    RuntimeConfig cfg;
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += readConfigBlob(prefs, cfg);
+    }
+    prefs.end();
+}
+
+static void benchConfigPerKey(uint32_t n) {
+    Preferences prefs;
+    prefs.begin(BENCH_NVS_NS, true);
+    RuntimeConfig cfg;
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += readLegacyConfig(prefs, cfg);
+    }
+    prefs.end();
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void registerBenchSuite() {
+    initBuffer();
+    initLatency();
+    seedConfigLayouts();
+    startLogWriters();
+    subscribeEvent(EVT_READING, onBenchReading);
+
+    benchAdd("json_payload", benchJsonPayload);
+    benchAdd("ntc_math", benchNtcMath);
+    benchAdd("buffer_data", benchBufferData);
+    benchAdd("log_write", benchLogWrite);
+    benchAdd("log_write_2w", benchLogWrite2);
+    benchAdd("log_write_4w", benchLogWrite4);
+    benchAdd("sms_parse", benchSmsParse);
+    benchAdd("latency_record", benchLatencyRecord);
+    benchAdd("event_reading", benchPublishReading);
+    benchAdd("sched_tick_2", benchSchedRun2);
+    benchAdd("sched_tick_8", benchSchedRun8);
+    benchAdd("config_blob", benchConfigBlob);
+    benchAdd("config_per_key", benchConfigPerKey);
+}
@@ -0,0 +1,20 @@
+/**
+ * @file bench_suite.h
+ * @brief Firmware micro-benchmark cases (BENCH_BUILD on target, bench_firmware on host)
+ */
+
+#ifndef BENCH_SUITE_H
+#define BENCH_SUITE_H
+
+#include "microbench.h"
+
+/**
+ * @brief Register the firmware cases with the harness
+ *
+ * Resets the buffer and latency state the cases touch, rewrites the
+ * "hpbench" NVS namespace, subscribes to readings and starts three idle
+ * Log writer tasks; never call it on a device that is also monitoring.
+ */
+void registerBenchSuite();
+
+#endif // BENCH_SUITE_H
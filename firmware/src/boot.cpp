@@ -0,0 +1,61 @@
+/**
+ * @file boot.cpp
+ * @brief Boot-phase timestamp implementation
+ */
+
+#include "boot.h"
+#include "globals.h"
+#include <esp_timer.h>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "setup", "log", "config", "first_reading", "tasks", "setup_done",
+    "transport", "mqtt"
+};
+
+/// Phases are marked from different tasks, but each by one task only
+static volatile uint32_t markUs[BOOT_PHASE_COUNT];
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void bootMark(BootPhase phase) {
+    if (phase >= BOOT_PHASE_COUNT || markUs[phase] != 0) return;
+
+    uint32_t us = (uint32_t)esp_timer_get_time();
+    markUs[phase] = us ? us : 1;
+}
+
+uint32_t getBootMarkUs(BootPhase phase) {
+    return phase < BOOT_PHASE_COUNT ? markUs[phase] : 0;
+}
+
+void logBootProfile() {
+    Log.print(F("[BOOT] Profile (ms):"));
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        if (markUs[i] == 0) continue;
+        Log.printf(" %s=%u.%u", PHASE_NAMES[i], (unsigned int)(markUs[i] / 1000),
+                   (unsigned int)(markUs[i] % 1000 / 100));
+    }
+    Log.println();
+}
+
+size_t formatBootJson(char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size, "{\"fast_boot\":%s,\"ms\":{",
+                        FAST_BOOT ? "true" : "false");
+    bool first = true;
+    for (int i = 0; i < BOOT_PHASE_COUNT && w < size; i++) {
+        if (markUs[i] == 0) continue;
+        w += snprintf(buf + w, size - w, "%s\"%s\":%.1f", first ? "" : ",",
+                      PHASE_NAMES[i], markUs[i] / 1000.0f);
+        first = false;
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "}}");
+    return w < size ? w : size - 1;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file boot.h
+ * @brief Boot-phase timestamps
+ *
+ * bootMark() records when each boot milestone is first reached, in
+ * microseconds of esp_timer time (counted from early app startup; the
+ * ROM and second-stage bootloader, typically ~300 ms, come before it).
+ * The profile is logged once setup() finishes and published once on the
+ * first MQTT connection (<base>/diag/boot).
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+/**
+ * @brief Boot milestones, roughly in the order they are reached
+ */
+enum BootPhase {
+    BOOT_SETUP = 0,      ///< setup() entered
+    BOOT_LOG,            ///< Log and post-mortem ready
+    BOOT_CONFIG,         ///< Runtime config loaded from NVS
+    BOOT_FIRST_READING,  ///< First reading taken and queued
+    BOOT_TASKS,          ///< Sensing and network tasks started
+    BOOT_SETUP_DONE,     ///< setup() returned
+    BOOT_TRANSPORT,      ///< First MQTT transport (WiFi/GPRS) up
+    BOOT_MQTT,           ///< First MQTT connection
+    BOOT_PHASE_COUNT     ///< Must be last - used for array sizing
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Record a milestone (only the first call per phase counts)
+ */
+void bootMark(BootPhase phase);
+
+/**
+ * @brief Microseconds at which a phase was reached (0: not yet)
+ */
+uint32_t getBootMarkUs(BootPhase phase);
+
+/**
+ * @brief Log all milestones reached so far, one line
+ */
+void logBootProfile();
+
+/**
+ * @brief Write the milestones as JSON: {"fast_boot":..,"ms":{"setup":..}}
+ * @return Bytes written (excluding the terminator)
+ */
+size_t formatBootJson(char* buf, size_t size);
+
+#endif // BOOT_H
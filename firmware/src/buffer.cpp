@@ -5,6 +5,7 @@
 
 #include "buffer.h"
 #include "globals.h"
+#include "log_level.h"
 
 // =============================================================================
 // PRIVATE DATA
@@ -12,34 +13,60 @@
 
 static DataBuffer dataBuffer;
 
+// =============================================================================
+// INSTANCE OPERATIONS
+// =============================================================================
+
+void bufferReset(DataBuffer& buf) {
+    buf.head = 0;
+    buf.tail = 0;
+    buf.count = 0;
+    buf.overflow = false;
+}
+
+bool bufferPush(DataBuffer& buf, const SystemData& data) {
+    bool kept = true;
+    if (buf.count >= BUFFER_SIZE) {
+        // Buffer full - overwrite oldest data
+        buf.overflow = true;
+        buf.tail = (buf.tail + 1) % BUFFER_SIZE;
+        buf.count--;
+        kept = false;
+    }
+
+    // Add new data at head position
+    buf.readings[buf.head] = data;
+    buf.head = (buf.head + 1) % BUFFER_SIZE;
+    buf.count++;
+    return kept;
+}
+
+SystemData* bufferPeek(DataBuffer& buf) {
+    return buf.count > 0 ? &buf.readings[buf.tail] : nullptr;
+}
+
+void bufferPop(DataBuffer& buf) {
+    if (buf.count > 0) {
+        buf.tail = (buf.tail + 1) % BUFFER_SIZE;
+        buf.count--;
+    }
+}
+
 // =============================================================================
 // IMPLEMENTATION
 // =============================================================================
 
 void initBuffer() {
-    dataBuffer.head = 0;
-    dataBuffer.tail = 0;
-    dataBuffer.count = 0;
-    dataBuffer.overflow = false;
+    bufferReset(dataBuffer);
 
     Log.print(F("[BUFFER] Initialized, capacity: "));
     Log.println(BUFFER_SIZE);
 }
 
 bool bufferData(const SystemData& data) {
-    if (dataBuffer.count >= BUFFER_SIZE) {
-        // Buffer full - overwrite oldest data
-        dataBuffer.overflow = true;
-        dataBuffer.tail = (dataBuffer.tail + 1) % BUFFER_SIZE;
-        dataBuffer.count--;
-        Log.println(F("[BUFFER] Overflow - oldest data overwritten"));
+    if (!bufferPush(dataBuffer, data)) {
+        LOG_W(BUFFER, "Overflow - oldest data overwritten\n");
     }
-
-    // Add new data at head position
-    dataBuffer.readings[dataBuffer.head] = data;
-    dataBuffer.head = (dataBuffer.head + 1) % BUFFER_SIZE;
-    dataBuffer.count++;
-
     return true;
 }
 
@@ -52,24 +79,15 @@ uint16_t bufferCount() {
 }
 
 SystemData* getNextBufferedData() {
-    if (dataBuffer.count == 0) {
-        return nullptr;
-    }
-    return &dataBuffer.readings[dataBuffer.tail];
+    return bufferPeek(dataBuffer);
 }
 
 void markDataPublished() {
-    if (dataBuffer.count > 0) {
-        dataBuffer.tail = (dataBuffer.tail + 1) % BUFFER_SIZE;
-        dataBuffer.count--;
-    }
+    bufferPop(dataBuffer);
 }
 
 void clearBuffer() {
-    dataBuffer.head = 0;
-    dataBuffer.tail = 0;
-    dataBuffer.count = 0;
-    dataBuffer.overflow = false;
+    bufferReset(dataBuffer);
     Log.println(F("[BUFFER] Cleared"));
 }
 
@@ -95,16 +113,7 @@ size_t getBufferStatus(char* buffer, size_t bufferSize) {
 }
 
 void printBufferStatus() {
-    Log.print(F("[BUFFER] Count: "));
-    Log.print(dataBuffer.count);
-    Log.print(F("/"));
-    Log.print(BUFFER_SIZE);
-    Log.print(F(" | Head: "));
-    Log.print(dataBuffer.head);
-    Log.print(F(" | Tail: "));
-    Log.print(dataBuffer.tail);
-    if (dataBuffer.overflow) {
-        Log.print(F(" | OVERFLOW!"));
-    }
-    Log.println();
+    LOG_D(BUFFER, "Count: %u/%d | Head: %u | Tail: %u%s\n",
+          dataBuffer.count, BUFFER_SIZE, dataBuffer.head, dataBuffer.tail,
+          dataBuffer.overflow ? " | OVERFLOW!" : "");
 }
@@ -29,6 +29,37 @@ struct DataBuffer {
     bool overflow;      ///< True if buffer has overflowed (oldest data lost)
 };
 
+// =============================================================================
+// INSTANCE OPERATIONS
+// =============================================================================
+
+/**
+ * The functions below operate on any DataBuffer, silently. The device has
+ * one (the functions further down); the host fleet simulator keeps one
+ * per simulated device.
+ */
+
+/**
+ * @brief Empty a buffer and clear its overflow flag
+ */
+void bufferReset(DataBuffer& buf);
+
+/**
+ * @brief Append a reading, overwriting the oldest when full
+ * @return false if the oldest reading was overwritten
+ */
+bool bufferPush(DataBuffer& buf, const SystemData& data);
+
+/**
+ * @brief Oldest reading, or nullptr if empty
+ */
+SystemData* bufferPeek(DataBuffer& buf);
+
+/**
+ * @brief Drop the oldest reading (no-op if empty)
+ */
+void bufferPop(DataBuffer& buf);
+
 // =============================================================================
 // FUNCTION DECLARATIONS
 // =============================================================================
@@ -0,0 +1,408 @@
+/**
+ * @file config_store.cpp
+ * @brief Versioned single-blob configuration store implementation
+ */
+
+#include "config_store.h"
+#include "globals.h"
+#include "events.h"
+#include <Preferences.h>
+#include <stddef.h>
+
+// =============================================================================
+// SCHEMA TABLE
+// =============================================================================
+
+enum ConfigFieldType : uint8_t {
+    CFG_STR,
+    CFG_U16,
+    CFG_U32,
+    CFG_F32
+};
+
+/**
+ * @brief One named, typed field of RuntimeConfig
+ *
+ * Numeric fields are range-checked against min..max (inclusive), both
+ * when set remotely and when loaded from NVS. Strings ignore the range.
+ */
+struct ConfigField {
+    const char* name;
+    uint16_t offset;
+    uint8_t size;
+    ConfigFieldType type;
+    uint8_t section;
+    float min;
+    float max;
+};
+
+#define CFG_FIELD(member, name, type, section, lo, hi) \
+    { name, offsetof(RuntimeConfig, member), sizeof(((RuntimeConfig*)0)->member), type, section, lo, hi }
+
+static const ConfigField CONFIG_FIELDS[] = {
+    CFG_FIELD(wifiSSID,             "wifi_ssid",          CFG_STR, CFG_SECTION_NETWORK, 0, 0),
+    CFG_FIELD(wifiPass,             "wifi_pass",          CFG_STR, CFG_SECTION_NETWORK, 0, 0),
+    CFG_FIELD(mqttHost,             "mqtt_host",          CFG_STR, CFG_SECTION_NETWORK, 0, 0),
+    CFG_FIELD(mqttPort,             "mqtt_port",          CFG_U16, CFG_SECTION_NETWORK, 1, 65535),
+    CFG_FIELD(mqttUser,             "mqtt_user",          CFG_STR, CFG_SECTION_NETWORK, 0, 0),
+    CFG_FIELD(mqttPass,             "mqtt_pass",          CFG_STR, CFG_SECTION_NETWORK, 0, 0),
+
+    // The sensing period also sizes the control engine's stale-reading
+    // window (CONTROL_STALE_READINGS periods), so it is kept short
+    CFG_FIELD(sensorReadInterval,   "sensor_interval_ms", CFG_U32, CFG_SECTION_INTERVALS, 500, 60000),
+    CFG_FIELD(publishInterval,      "publish_interval_ms", CFG_U32, CFG_SECTION_INTERVALS, 1000, 3600000),
+    CFG_FIELD(smsCheckInterval,     "sms_interval_ms",    CFG_U32, CFG_SECTION_INTERVALS, 1000, 600000),
+    CFG_FIELD(alertCooldown,        "alert_cooldown_ms",  CFG_U32, CFG_SECTION_INTERVALS, 10000, 86400000),
+
+    CFG_FIELD(voltageHighCritical,  "volt_high_crit",     CFG_F32, CFG_SECTION_ALERTS, 100, 300),
+    CFG_FIELD(voltageHighWarning,   "volt_high_warn",     CFG_F32, CFG_SECTION_ALERTS, 100, 300),
+    CFG_FIELD(voltageLowWarning,    "volt_low_warn",      CFG_F32, CFG_SECTION_ALERTS, 100, 300),
+    CFG_FIELD(voltageLowCritical,   "volt_low_crit",      CFG_F32, CFG_SECTION_ALERTS, 100, 300),
+    CFG_FIELD(compTempCritical,     "comp_temp_crit",     CFG_F32, CFG_SECTION_ALERTS, 20, 150),
+    CFG_FIELD(compTempWarning,      "comp_temp_warn",     CFG_F32, CFG_SECTION_ALERTS, 20, 150),
+    CFG_FIELD(pressureHighCritical, "press_high_crit",    CFG_F32, CFG_SECTION_ALERTS, 0, 600),
+    CFG_FIELD(pressureHighWarning,  "press_high_warn",    CFG_F32, CFG_SECTION_ALERTS, 0, 600),
+    CFG_FIELD(pressureLowCritical,  "press_low_crit",     CFG_F32, CFG_SECTION_ALERTS, 0, 600),
+    CFG_FIELD(pressureLowWarning,   "press_low_warn",     CFG_F32, CFG_SECTION_ALERTS, 0, 600),
+    CFG_FIELD(currentCritical,      "current_crit",       CFG_F32, CFG_SECTION_ALERTS, 0.5f, 50),
+    CFG_FIELD(currentWarning,       "current_warn",       CFG_F32, CFG_SECTION_ALERTS, 0.5f, 50),
+
+    CFG_FIELD(voltageScale,         "cal_voltage_scale",  CFG_F32, CFG_SECTION_CALIBRATION, 1, 1000),
+    CFG_FIELD(ntcSeriesResistance,  "cal_ntc_series",     CFG_F32, CFG_SECTION_CALIBRATION, 100, 1000000),
+    CFG_FIELD(currentNoiseFloor,    "cal_current_floor",  CFG_F32, CFG_SECTION_CALIBRATION, 0, 5),
+};
+
+static const size_t CONFIG_FIELD_COUNT = sizeof(CONFIG_FIELDS) / sizeof(CONFIG_FIELDS[0]);
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static ConfigListener listeners[CONFIG_MAX_LISTENERS];
+static uint8_t listenerCount = 0;
+static bool provisioned = false;
+static RuntimeConfig storedCfg;  ///< Last loaded/saved image, for change diffing
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint8_t diffSections(const RuntimeConfig& a, const RuntimeConfig& b) {
+    uint8_t changed = 0;
+    for (size_t i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        const ConfigField& f = CONFIG_FIELDS[i];
+        if (memcmp((const uint8_t*)&a + f.offset, (const uint8_t*)&b + f.offset, f.size) != 0) {
+            changed |= f.section;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief Copy a string into a fixed field, truncating and always terminating
+ */
+static void copyString(char* out, size_t outSize, const char* in) {
+    size_t n = strnlen(in, outSize - 1);
+    memcpy(out, in, n);
+    out[n] = '\0';
+}
+
+static float fieldValue(const RuntimeConfig& cfg, const ConfigField& f) {
+    const uint8_t* p = (const uint8_t*)&cfg + f.offset;
+    switch (f.type) {
+        case CFG_U16: return *(const uint16_t*)p;
+        case CFG_U32: return (float)*(const uint32_t*)p;
+        case CFG_F32: return *(const float*)p;
+        default:      return 0;
+    }
+}
+
+static bool fieldInRange(const RuntimeConfig& cfg, const ConfigField& f) {
+    if (f.type == CFG_STR) return true;
+    float v = fieldValue(cfg, f);
+    return isfinite(v) && v >= f.min && v <= f.max;
+}
+
+/**
+ * @brief Warning thresholds must trip before their critical ones
+ */
+static bool thresholdsOrdered(const RuntimeConfig& cfg) {
+    return cfg.voltageLowCritical < cfg.voltageLowWarning &&
+           cfg.voltageLowWarning < cfg.voltageHighWarning &&
+           cfg.voltageHighWarning < cfg.voltageHighCritical &&
+           cfg.compTempWarning < cfg.compTempCritical &&
+           cfg.pressureHighWarning < cfg.pressureHighCritical &&
+           cfg.pressureLowCritical < cfg.pressureLowWarning &&
+           cfg.pressureLowWarning < cfg.pressureHighWarning &&
+           cfg.currentWarning < cfg.currentCritical;
+}
+
+/**
+ * @brief Put a stored config back in range before anything uses it
+ *
+ * A blob saved by older firmware (before range checks) may hold values
+ * that stall a task or disable a trip; those fields, or the whole alert
+ * section if the thresholds are out of order, revert to the defaults.
+ */
+static void sanitizeConfig(RuntimeConfig& cfg) {
+    const RuntimeConfig defaults;
+    for (size_t i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        const ConfigField& f = CONFIG_FIELDS[i];
+        if (!fieldInRange(cfg, f)) {
+            memcpy((uint8_t*)&cfg + f.offset, (const uint8_t*)&defaults + f.offset, f.size);
+            Log.printf("[CFG] Stored %s out of range, using default\n", f.name);
+        }
+    }
+    if (!thresholdsOrdered(cfg)) {
+        for (size_t i = 0; i < CONFIG_FIELD_COUNT; i++) {
+            const ConfigField& f = CONFIG_FIELDS[i];
+            if (f.section == CFG_SECTION_ALERTS) {
+                memcpy((uint8_t*)&cfg + f.offset, (const uint8_t*)&defaults + f.offset, f.size);
+            }
+        }
+        Log.println(F("[CFG] Stored alert thresholds out of order, using defaults"));
+    }
+}
+
+static void notifyListeners(const RuntimeConfig& cfg, uint8_t changed) {
+    if (changed == 0) return;
+    for (uint8_t i = 0; i < listenerCount; i++) {
+        listeners[i](cfg, changed);
+    }
+    publishConfigEvent(changed);
+}
+
+/**
+ * @brief Apply version-specific fix-ups to a blob written by older firmware
+ *
+ * Appended fields are default-filled by the caller; this hook is for
+ * changes in meaning or units. Cases fall through so migrations chain.
+ */
+static void migrateConfig(RuntimeConfig& cfg, uint16_t fromVersion) {
+    (void)cfg;
+    switch (fromVersion) {
+        case 0:   // Pre-blob per-key layout, handled by readLegacyConfig()
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Read one legacy string key, keeping the default if empty or missing
+ */
+static void loadLegacyString(Preferences& prefs, const char* key, char* out, size_t outSize) {
+    char tmp[64];
+    if (prefs.getString(key, tmp, sizeof(tmp)) > 1) {
+        copyString(out, outSize, tmp);
+    }
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void writeConfigBlob(Preferences& prefs, const RuntimeConfig& cfg) {
+    uint8_t blob[sizeof(ConfigBlobHeader) + sizeof(RuntimeConfig)];
+    ConfigBlobHeader hdr;
+    hdr.magic = CONFIG_BLOB_MAGIC;
+    hdr.version = CONFIG_SCHEMA_VERSION;
+    hdr.size = sizeof(RuntimeConfig);
+    hdr.crc = crc32((const uint8_t*)&cfg, sizeof(RuntimeConfig));
+    memcpy(blob, &hdr, sizeof(hdr));
+    memcpy(blob + sizeof(hdr), &cfg, sizeof(RuntimeConfig));
+    prefs.putBytes(CONFIG_NVS_KEY, blob, sizeof(blob));
+}
+
+ConfigBlobStatus readConfigBlob(Preferences& prefs, RuntimeConfig& cfg) {
+    size_t len = prefs.getBytesLength(CONFIG_NVS_KEY);
+    if (len < sizeof(ConfigBlobHeader)) return CFG_BLOB_NONE;
+
+    // Blob from newer firmware may be larger than ours
+    uint8_t local[sizeof(ConfigBlobHeader) + sizeof(RuntimeConfig)];
+    uint8_t* blob = len <= sizeof(local) ? local : (uint8_t*)malloc(len);
+    ConfigBlobStatus status = CFG_BLOB_INVALID;
+
+    if (blob != nullptr && prefs.getBytes(CONFIG_NVS_KEY, blob, len) == len) {
+        ConfigBlobHeader hdr;
+        memcpy(&hdr, blob, sizeof(hdr));
+        const uint8_t* payload = blob + sizeof(hdr);
+
+        if (hdr.magic != CONFIG_BLOB_MAGIC || sizeof(hdr) + hdr.size > len) {
+            Log.println(F("[CFG] Blob header invalid, using defaults"));
+        } else if (crc32(payload, hdr.size) != hdr.crc) {
+            Log.println(F("[CFG] Blob CRC mismatch, using defaults"));
+        } else {
+            // Shorter (older) blobs leave newer fields at their defaults
+            size_t n = hdr.size < sizeof(RuntimeConfig) ? hdr.size : sizeof(RuntimeConfig);
+            memcpy(&cfg, payload, n);
+            if (hdr.version < CONFIG_SCHEMA_VERSION) {
+                migrateConfig(cfg, hdr.version);
+            }
+            status = CFG_BLOB_OK;
+            if (hdr.version != CONFIG_SCHEMA_VERSION || hdr.size != sizeof(RuntimeConfig)) {
+                Log.print(F("[CFG] Migrating blob from schema v"));
+                Log.println(hdr.version);
+                status = CFG_BLOB_STALE;
+            }
+        }
+    }
+    if (blob != local) free(blob);
+    return status;
+}
+
+bool readLegacyConfig(Preferences& prefs, RuntimeConfig& cfg) {
+    if (!prefs.getBool("configured", false)) return false;
+
+    loadLegacyString(prefs, "wifi_ssid", cfg.wifiSSID, sizeof(cfg.wifiSSID));
+    loadLegacyString(prefs, "wifi_pass", cfg.wifiPass, sizeof(cfg.wifiPass));
+    loadLegacyString(prefs, "mqtt_host", cfg.mqttHost, sizeof(cfg.mqttHost));
+    cfg.mqttPort = prefs.getUShort("mqtt_port", cfg.mqttPort);
+    loadLegacyString(prefs, "mqtt_user", cfg.mqttUser, sizeof(cfg.mqttUser));
+    loadLegacyString(prefs, "mqtt_pass", cfg.mqttPass, sizeof(cfg.mqttPass));
+    return true;
+}
+
+void loadConfig(RuntimeConfig& cfg) {
+    unsigned long t0 = micros();
+    cfg.setDefaults();
+
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, false);
+
+    ConfigBlobStatus status = readConfigBlob(prefs, cfg);
+    bool loaded = status == CFG_BLOB_OK || status == CFG_BLOB_STALE;
+    if (status == CFG_BLOB_STALE) {
+        writeConfigBlob(prefs, cfg);
+    } else if (status == CFG_BLOB_NONE && readLegacyConfig(prefs, cfg)) {
+        prefs.clear();
+        writeConfigBlob(prefs, cfg);
+        loaded = true;
+        Log.println(F("[CFG] Migrated per-key config to blob"));
+    }
+    prefs.end();
+
+    sanitizeConfig(cfg);
+    provisioned = loaded;
+    storedCfg = cfg;
+
+    if (loaded) {
+        Log.print(F("[CFG] Config loaded from NVS in "));
+        Log.print(micros() - t0);
+        Log.println(F(" us"));
+        Log.print(F("[CFG]   WiFi SSID: "));
+        Log.println(cfg.wifiSSID);
+        Log.print(F("[CFG]   MQTT Host: "));
+        Log.print(cfg.mqttHost);
+        Log.print(F(":"));
+        Log.println(cfg.mqttPort);
+    } else {
+        Log.println(F("[CFG] No stored config, using compile-time defaults"));
+    }
+
+    notifyListeners(cfg, CFG_SECTION_ALL);
+}
+
+void saveConfig(const RuntimeConfig& cfg) {
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, false);
+    writeConfigBlob(prefs, cfg);
+    prefs.end();
+
+    uint8_t changed = diffSections(storedCfg, cfg);
+    storedCfg = cfg;
+    provisioned = true;
+
+    Log.print(F("[CFG] Config saved to NVS, changed sections: 0x"));
+    Log.println(changed, HEX);
+
+    notifyListeners(cfg, changed);
+}
+
+bool readSavedConfig(RuntimeConfig& cfg) {
+    RuntimeConfig saved;
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, true);
+    ConfigBlobStatus status = readConfigBlob(prefs, saved);
+    prefs.end();
+    if (status != CFG_BLOB_OK && status != CFG_BLOB_STALE) return false;
+
+    sanitizeConfig(saved);
+    cfg = saved;
+    return true;
+}
+
+void clearConfig() {
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, false);
+    prefs.clear();
+    prefs.end();
+    provisioned = false;
+    Log.println(F("[CFG] NVS config cleared"));
+}
+
+bool isProvisioned() {
+    return provisioned;
+}
+
+bool subscribeConfig(ConfigListener listener) {
+    if (listenerCount >= CONFIG_MAX_LISTENERS) {
+        return false;
+    }
+    listeners[listenerCount++] = listener;
+    return true;
+}
+
+bool validateConfig(const RuntimeConfig& cfg) {
+    for (size_t i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        if (!fieldInRange(cfg, CONFIG_FIELDS[i])) return false;
+    }
+    return thresholdsOrdered(cfg);
+}
+
+bool setConfigField(RuntimeConfig& cfg, const char* name, const char* value) {
+    for (size_t i = 0; i < CONFIG_FIELD_COUNT; i++) {
+        const ConfigField& f = CONFIG_FIELDS[i];
+        if (strcmp(f.name, name) != 0) continue;
+
+        uint8_t* p = (uint8_t*)&cfg + f.offset;
+        if (f.type == CFG_STR) {
+            copyString((char*)p, f.size, value);
+            return true;
+        }
+
+        // Whole value must parse; strtoul would wrap "-1" to ULONG_MAX
+        while (isspace((unsigned char)*value)) value++;
+        if (f.type != CFG_F32 && *value == '-') return false;
+        char* end = nullptr;
+        unsigned long u = 0;
+        double v;
+        if (f.type == CFG_F32) {
+            v = strtof(value, &end);
+        } else {
+            u = strtoul(value, &end, 10);
+            v = (double)u;
+        }
+        if (end == value || *end != '\0' || !isfinite(v) || v < f.min || v > f.max) {
+            return false;
+        }
+
+        switch (f.type) {
+            case CFG_U16: *(uint16_t*)p = (uint16_t)u; break;
+            case CFG_U32: *(uint32_t*)p = (uint32_t)u; break;
+            default:      *(float*)p = (float)v; break;
+        }
+        return true;
+    }
+    return false;
+}
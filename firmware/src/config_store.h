@@ -0,0 +1,236 @@
+/**
+ * @file config_store.h
+ * @brief Versioned runtime configuration stored as a single NVS blob
+ *
+ * RuntimeConfig holds connectivity settings from the provisioning portal
+ * plus the runtime tunables (intervals, alert thresholds, calibration).
+ * It is persisted as one CRC-checked binary blob so a load is a single
+ * NVS read. Fields are only ever appended: an older, shorter blob is
+ * copied over the compile-time defaults, so new fields are default-filled.
+ *
+ * Modules that cache config values register a ConfigListener and are
+ * notified with a bitmask of changed sections whenever the config is
+ * loaded or saved, so changes apply live without a reboot. The same mask
+ * is published as an EVT_CONFIG event for modules that only need to know
+ * that something changed (or live on another task).
+ */
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// STORE CONFIGURATION
+// =============================================================================
+
+#define CONFIG_NVS_NS          "hpcfg"       ///< NVS namespace for config
+#define CONFIG_NVS_KEY         "blob"        ///< Key holding the config blob
+#define CONFIG_BLOB_MAGIC      0x48504346UL  ///< "HPCF"
+#define CONFIG_SCHEMA_VERSION  1             ///< Bump when field semantics change
+#define CONFIG_MAX_LISTENERS   8             ///< Change subscribers
+
+/**
+ * @brief Config sections, used as a bitmask in change notifications
+ */
+enum ConfigSection {
+    CFG_SECTION_NETWORK     = 1 << 0,  ///< WiFi / MQTT connectivity
+    CFG_SECTION_INTERVALS   = 1 << 1,  ///< Task periods and cooldowns
+    CFG_SECTION_ALERTS      = 1 << 2,  ///< Alert thresholds
+    CFG_SECTION_CALIBRATION = 1 << 3,  ///< Sensor calibration
+    CFG_SECTION_ALL         = 0xFF
+};
+
+// =============================================================================
+// RUNTIME CONFIGURATION
+// =============================================================================
+
+/**
+ * @brief Runtime configuration loaded from NVS (or config.h defaults)
+ * @note Append new fields at the end only - the stored blob layout is
+ *       this struct's memory image.
+ */
+struct RuntimeConfig {
+    // ---- Network ----
+    char wifiSSID[64];
+    char wifiPass[64];
+    char mqttHost[64];
+    uint16_t mqttPort;
+    char mqttUser[32];
+    char mqttPass[64];
+
+    // ---- Intervals (ms) ----
+    uint32_t sensorReadInterval;
+    uint32_t publishInterval;
+    uint32_t smsCheckInterval;
+    uint32_t alertCooldown;
+
+    // ---- Alert thresholds ----
+    float voltageHighCritical;
+    float voltageHighWarning;
+    float voltageLowWarning;
+    float voltageLowCritical;
+    float compTempCritical;
+    float compTempWarning;
+    float pressureHighCritical;
+    float pressureHighWarning;
+    float pressureLowCritical;
+    float pressureLowWarning;
+    float currentCritical;
+    float currentWarning;
+
+    // ---- Calibration ----
+    float voltageScale;
+    float ntcSeriesResistance;
+    float currentNoiseFloor;
+
+    RuntimeConfig() {
+        setDefaults();
+    }
+
+    void setDefaults() {
+        memset(this, 0, sizeof(*this));
+        strncpy(wifiSSID, WIFI_SSID, sizeof(wifiSSID) - 1);
+        strncpy(wifiPass, WIFI_PASS_KEY, sizeof(wifiPass) - 1);
+        strncpy(mqttHost, MQTT_BROKER, sizeof(mqttHost) - 1);
+        mqttPort = MQTT_PORT;
+        strncpy(mqttUser, MQTT_USER, sizeof(mqttUser) - 1);
+        strncpy(mqttPass, MQTT_PASS, sizeof(mqttPass) - 1);
+
+        sensorReadInterval = SENSOR_READ_INTERVAL;
+        publishInterval = MQTT_PUBLISH_INTERVAL;
+        smsCheckInterval = SMS_CHECK_INTERVAL;
+        alertCooldown = ALERT_COOLDOWN;
+
+        voltageHighCritical = VOLTAGE_HIGH_CRITICAL;
+        voltageHighWarning = VOLTAGE_HIGH_WARNING;
+        voltageLowWarning = VOLTAGE_LOW_WARNING;
+        voltageLowCritical = VOLTAGE_LOW_CRITICAL;
+        compTempCritical = COMP_TEMP_CRITICAL;
+        compTempWarning = COMP_TEMP_WARNING;
+        pressureHighCritical = PRESSURE_HIGH_CRITICAL;
+        pressureHighWarning = PRESSURE_HIGH_WARNING;
+        pressureLowCritical = PRESSURE_LOW_CRITICAL;
+        pressureLowWarning = PRESSURE_LOW_WARNING;
+        currentCritical = CURRENT_CRITICAL;
+        currentWarning = CURRENT_WARNING;
+
+        voltageScale = VOLTAGE_SCALE_FACTOR;
+        ntcSeriesResistance = NTC_SERIES_RESISTANCE;
+        currentNoiseFloor = CURRENT_NOISE_FLOOR;
+    }
+};
+
+/**
+ * @brief Header stored in front of the RuntimeConfig image
+ */
+struct ConfigBlobHeader {
+    uint32_t magic;    ///< CONFIG_BLOB_MAGIC
+    uint16_t version;  ///< CONFIG_SCHEMA_VERSION at write time
+    uint16_t size;     ///< Payload bytes that follow
+    uint32_t crc;      ///< CRC-32 of the payload
+};
+
+/**
+ * @brief Result of readConfigBlob()
+ */
+enum ConfigBlobStatus {
+    CFG_BLOB_NONE,     ///< No blob stored
+    CFG_BLOB_INVALID,  ///< Bad header or CRC; cfg untouched
+    CFG_BLOB_OK,       ///< Loaded
+    CFG_BLOB_STALE     ///< Loaded from an older layout; rewrite it
+};
+
+class Preferences;
+
+/**
+ * @brief Change callback
+ * @param cfg Configuration after the change
+ * @param changed Bitmask of ConfigSection values that changed
+ */
+typedef void (*ConfigListener)(const RuntimeConfig& cfg, uint8_t changed);
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Load configuration from NVS into cfg. Falls back to config.h defaults.
+ *
+ * Migrates the legacy per-key layout to the blob on first boot after an
+ * upgrade. Stored values that fail validateConfig() revert to their
+ * defaults. Notifies all listeners with CFG_SECTION_ALL.
+ */
+void loadConfig(RuntimeConfig& cfg);
+
+/**
+ * @brief Save configuration to NVS and notify listeners of changed sections
+ */
+void saveConfig(const RuntimeConfig& cfg);
+
+/**
+ * @brief Read the saved blob into cfg without notifying listeners
+ *
+ * For a task that owns its copy of the config: an EVT_CONFIG event tells
+ * it that another task saved, and it picks the values up here.
+ *
+ * @return false if no valid blob is stored (cfg unchanged)
+ */
+bool readSavedConfig(RuntimeConfig& cfg);
+
+/**
+ * @brief Clear all stored configuration from NVS.
+ */
+void clearConfig();
+
+/**
+ * @brief Check if NVS contains a saved configuration.
+ * @return true if a config has been saved via the portal or saveConfig()
+ * @note Answered from state cached by loadConfig() - no NVS access
+ */
+bool isProvisioned();
+
+/**
+ * @brief Register a change listener (called after load and every save)
+ * @return false if CONFIG_MAX_LISTENERS is exhausted
+ */
+bool subscribeConfig(ConfigListener listener);
+
+/**
+ * @brief Write cfg as the blob (header + image) to an open namespace
+ * @note loadConfig()/saveConfig() use CONFIG_NVS_NS; the benchmark suite
+ *       times the layouts on a scratch namespace.
+ */
+void writeConfigBlob(Preferences& prefs, const RuntimeConfig& cfg);
+
+/**
+ * @brief Read and check the blob from an open namespace into cfg
+ */
+ConfigBlobStatus readConfigBlob(Preferences& prefs, RuntimeConfig& cfg);
+
+/**
+ * @brief Read the pre-blob per-key layout (firmware 1.0.0: network fields only)
+ * @return true if a legacy config was found
+ */
+bool readLegacyConfig(Preferences& prefs, RuntimeConfig& cfg);
+
+/**
+ * @brief Set one field by its schema name (e.g. "alert_cooldown_ms")
+ * @param cfg Config to modify (not saved - call saveConfig() after)
+ * @param name Field name from the schema table
+ * @param value Field value as text; numbers must parse completely
+ * @return true if the name is known and the value parsed and is within
+ *         the field's range (cfg is unchanged otherwise)
+ * @note Cross-field rules are checked by validateConfig()
+ */
+bool setConfigField(RuntimeConfig& cfg, const char* name, const char* value);
+
+/**
+ * @brief Check every numeric field's range and that each warning
+ *        threshold lies inside its critical one
+ * @return true if cfg is safe to save
+ */
+bool validateConfig(const RuntimeConfig& cfg);
+
+#endif // CONFIG_STORE_H
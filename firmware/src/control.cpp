@@ -0,0 +1,401 @@
+/**
+ * @file control.cpp
+ * @brief Relay control engine implementation
+ */
+
+#include "control.h"
+#include "globals.h"
+#include "tasks.h"
+#include "latency.h"
+#include "log_level.h"
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static const uint8_t RELAY_PINS[RELAY_COUNT] = {
+    PIN_RELAY_COMPRESSOR, PIN_RELAY_FAN_LOW, PIN_RELAY_FAN_MED, PIN_RELAY_FAN_HIGH,
+    PIN_RELAY_VALVE_COOL, PIN_RELAY_VALVE_HEAT, PIN_RELAY_DEFROST, PIN_RELAY_ESTOP
+};
+
+static const char* const MODE_NAMES[MODE_COUNT] = {
+    "off", "cooling", "heating", "fan_only"
+};
+
+static const char* const FAN_NAMES[FAN_SPEED_COUNT] = {
+    "off", "low", "medium", "high", "auto"
+};
+
+/** @brief Also the "error_code" of an MQTT response */
+static const char* const RESULT_NAMES[] = {
+    "success", "interlock", "cooldown", "invalid", "safety", "failed"
+};
+
+static QueueHandle_t cmdQueue = nullptr;
+static QueueHandle_t resultQueue = nullptr;
+static QueueHandle_t statusQueue = nullptr;   ///< Length 1, overwritten
+
+// Owned by the control task
+static RelayState relays;
+static OperatingMode mode = MODE_OFF;
+static FanSpeed fanSpeed = FAN_AUTO;
+static bool emergencyStop = false;
+static uint16_t trips = 0;
+static bool defrostRequested = false;
+static uint32_t defrostStartMs = 0;
+static bool thermoCall = true;        ///< Outlet loop wants the compressor
+static uint32_t thermoNextMs = 0;
+static uint32_t thermoLastUs = 0;     ///< Start of the previous loop step
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint8_t blockedRelays() {
+    return emergencyStop ? RELAYS_ALL : tripBlocks(trips);
+}
+
+/**
+ * @brief Relays the requested state runs once every interlock allows
+ */
+static uint8_t targetRelays(uint32_t nowMs) {
+    if (emergencyStop) return 0;
+
+    uint8_t target = modeRelays(mode, fanSpeed) | RELAY_BIT(RELAY_ESTOP);
+    if (!thermoCall) target &= ~RELAY_BIT(RELAY_COMPRESSOR);
+    if (defrostRequested) {
+        if (nowMs - defrostStartMs < DEFROST_TRIGGER_MS) {
+            target |= RELAY_BIT(RELAY_DEFROST);
+        } else {
+            defrostRequested = false;
+        }
+    }
+    return target;
+}
+
+static ControlStatus currentStatus() {
+    ControlStatus s;
+    s.mode = mode;
+    s.fanSpeed = fanSpeed;
+    s.emergencyStop = emergencyStop;
+    s.relays = relays.on;
+    s.blocked = blockedRelays();
+    s.trips = trips;
+    s.setpoint = getThermostatSetpoint(mode);
+    s.demand = getThermostatStatus().demand;
+    return s;
+}
+
+/**
+ * @brief Write the pins that change (the level before pinMode at init)
+ */
+static void writeRelays(uint8_t next, uint32_t nowMs) {
+    uint8_t changed = relays.on ^ next;
+    if (!changed) return;
+
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        if (changed & RELAY_BIT(r)) {
+            digitalWrite(RELAY_PINS[r], (next & RELAY_BIT(r)) ? RELAY_ACTIVE : RELAY_INACTIVE);
+        }
+    }
+    LOG_D(CTRL, "Relays 0x%02X -> 0x%02X\n", (unsigned int)relays.on, (unsigned int)next);
+    commitRelays(relays, next, nowMs);
+}
+
+static void logTrips(uint16_t prev, uint16_t now) {
+    uint16_t changed = prev ^ now;
+    for (uint8_t i = 0; i <= TRIP_STALE_INDEX; i++) {
+        uint16_t bit = (uint16_t)(1u << i);
+        if (!(changed & bit)) continue;
+        if (now & bit) {
+            LOG_W(CTRL, "Trip %s active\n", getTripName(i));
+        } else {
+            LOG_I(CTRL, "Trip %s cleared\n", getTripName(i));
+        }
+    }
+}
+
+/**
+ * @brief Validate a command against the interlock tables and apply it
+ *
+ * Relays the current request already runs are exempt from the blocked
+ * and off-time checks: they were accepted earlier and simply wait.
+ */
+static CommandResult applyCommand(const ControlCommand& cmd, uint32_t nowMs) {
+    uint8_t accepted = modeRelays(mode, fanSpeed);
+    uint8_t blocked = blockedRelays();
+    CommandResult result;
+
+    switch (cmd.type) {
+        case CTRL_CMD_SET_MODE:
+            if (cmd.mode >= MODE_COUNT) return CMD_REJECTED_INVALID;
+            if (emergencyStop && cmd.mode != MODE_OFF) return CMD_REJECTED_INTERLOCK;
+            result = checkRelayRequest(modeRelays(cmd.mode, fanSpeed), accepted, blocked,
+                                       relays, nowMs);
+            if (result == CMD_SUCCESS) mode = cmd.mode;
+            return result;
+
+        case CTRL_CMD_SET_FAN:
+            if (cmd.fanSpeed >= FAN_SPEED_COUNT) return CMD_REJECTED_INVALID;
+            if (emergencyStop) return CMD_REJECTED_INTERLOCK;
+            result = checkRelayRequest(modeRelays(mode, cmd.fanSpeed), accepted, blocked,
+                                       relays, nowMs);
+            if (result == CMD_SUCCESS) fanSpeed = cmd.fanSpeed;
+            return result;
+
+        case CTRL_CMD_DEFROST:
+            // A trigger for the unit's defrost board: heating, compressor running
+            if (emergencyStop || !(relays.on & RELAY_BIT(RELAY_COMPRESSOR))) {
+                return CMD_REJECTED_INTERLOCK;
+            }
+            result = checkRelayRequest(accepted | RELAY_BIT(RELAY_DEFROST), accepted, blocked,
+                                       relays, nowMs);
+            if (result == CMD_SUCCESS) {
+                defrostRequested = true;
+                defrostStartMs = nowMs;
+            }
+            return result;
+
+        case CTRL_CMD_EMERGENCY_STOP:
+            if (cmd.activate != emergencyStop) {
+                LOG_W(CTRL, "Emergency stop %s\n", cmd.activate ? "activated" : "released");
+            }
+            emergencyStop = cmd.activate;
+            if (!emergencyStop) mode = MODE_OFF;  // Restart needs a new set_mode
+            defrostRequested = false;
+            return CMD_SUCCESS;
+
+        case CTRL_CMD_STATUS:
+            return CMD_SUCCESS;
+
+        case CTRL_CMD_SET_SETPOINT:
+            return setThermostatSetpoint(cmd.mode == MODE_OFF ? mode : cmd.mode, cmd.setpoint)
+                       ? CMD_SUCCESS : CMD_REJECTED_INVALID;
+
+        default:
+            return CMD_REJECTED_INVALID;
+    }
+}
+
+/**
+ * @brief Outlet loop on its own fixed-rate schedule within the tick
+ */
+static void stepThermostat(const SystemData* reading, uint32_t nowMs) {
+    if ((int32_t)(nowMs - thermoNextMs) < 0) return;
+
+    uint32_t startUs = micros();
+    if (thermoLastUs != 0) {
+        int32_t errorUs = (int32_t)(startUs - thermoLastUs - THERMO_PERIOD_MS * 1000UL);
+        latencyRecord(LAT_THERMO_JITTER, (uint32_t)abs(errorUs));
+    }
+    thermoLastUs = startUs;
+
+    uint8_t comp = RELAY_BIT(RELAY_COMPRESSOR);
+    thermoCall = thermostatStep(reading, mode, relays.on & comp, !(blockedRelays() & comp));
+    latencyRecord(LAT_THERMO_STEP, micros() - startUs);
+
+    thermoNextMs += THERMO_PERIOD_MS;
+    if ((int32_t)(nowMs - thermoNextMs) >= 0) {
+        thermoNextMs = nowMs + THERMO_PERIOD_MS;  // Fell a whole period behind
+    }
+}
+
+/**
+ * @brief Control task: controlTick() on absolute ticks
+ */
+static void controlTask(void* arg) {
+    vTaskDelay(1);
+    TickType_t wake = xTaskGetTickCount();
+
+    for (;;) {
+        wake += pdMS_TO_TICKS(CONTROL_TICK_MS);
+        sleepUntilTick(wake, SUP_CONTROL);
+        if ((int32_t)(xTaskGetTickCount() - wake) > (int32_t)pdMS_TO_TICKS(CONTROL_TICK_MS)) {
+            wake = xTaskGetTickCount();  // Overran a whole tick: resynchronise
+        }
+        controlTick();
+    }
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void initControl() {
+    // Level first, so enabling the output never glitches a relay on
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        digitalWrite(RELAY_PINS[r], RELAY_INACTIVE);
+        pinMode(RELAY_PINS[r], OUTPUT);
+    }
+
+    if (cmdQueue == nullptr) {
+        cmdQueue = xQueueCreate(CONTROL_CMD_QUEUE_LEN, sizeof(ControlCommand));
+        resultQueue = xQueueCreate(CONTROL_RESULT_QUEUE_LEN, sizeof(ControlResult));
+        statusQueue = xQueueCreate(1, sizeof(ControlStatus));
+    } else {
+        xQueueReset(cmdQueue);
+        xQueueReset(resultQueue);
+    }
+
+    // The compressor may have been running before a reset: treat it as
+    // just stopped so a reset loop cannot short-cycle it
+    uint32_t now = millis();
+    relays.on = 0;
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        relays.changedMs[r] = now;
+    }
+    mode = MODE_OFF;
+    fanSpeed = FAN_AUTO;
+    emergencyStop = false;
+    trips = 0;
+    defrostRequested = false;
+    initThermostat();
+    thermoCall = true;
+    thermoNextMs = now + THERMO_PERIOD_MS;
+    thermoLastUs = 0;
+
+    ControlStatus s = currentStatus();
+    xQueueOverwrite(statusQueue, &s);
+    Log.printf("[CTRL] Relays off, compressor restart delay %lu s\n",
+               (unsigned long)(COMPRESSOR_RESTART_DELAY_MS / 1000));
+}
+
+void startControl() {
+    startPinnedTask(controlTask, "ctrl", CONTROL_TASK_STACK, CONTROL_TASK_PRIO, CONTROL_TASK_CORE);
+}
+
+void controlTick() {
+    uint32_t startUs = micros();
+    uint32_t now = millis();
+
+    // Trips from the latest reading (or the stale trip without one)
+    SystemData reading;
+    bool fresh = getLatestReading(reading) &&
+                 now - reading.readingTime <= CONTROL_STALE_READINGS * runtimeCfg.sensorReadInterval;
+    uint16_t prevTrips = trips;
+    trips = evaluateTrips(fresh ? &reading : nullptr, trips);
+    if (trips != prevTrips) logTrips(prevTrips, trips);
+
+    // Commands; results go out once the outputs reflect them
+    ControlResult results[CONTROL_CMD_QUEUE_LEN];
+    uint32_t postedUs[CONTROL_CMD_QUEUE_LEN];
+    uint8_t count = 0;
+    ControlCommand cmd;
+    while (count < CONTROL_CMD_QUEUE_LEN && xQueueReceive(cmdQueue, &cmd, 0) == pdTRUE) {
+        ControlResult& r = results[count];
+        memcpy(r.commandId, cmd.commandId, sizeof(r.commandId));
+        r.type = cmd.type;
+        r.result = applyCommand(cmd, now);
+        postedUs[count] = cmd.postedUs;
+        if (r.result != CMD_SUCCESS) {
+            LOG_I(CTRL, "Command %s rejected: %s\n", cmd.commandId, getCommandResultName(r.result));
+        }
+        count++;
+    }
+
+    stepThermostat(fresh ? &reading : nullptr, now);
+    writeRelays(nextRelays(targetRelays(now), blockedRelays(), relays, now), now);
+
+    uint32_t actuatedUs = micros();
+    ControlStatus status = currentStatus();
+    for (uint8_t i = 0; i < count; i++) {
+        ControlResult& r = results[i];
+        if (r.result == CMD_SUCCESS && r.type != CTRL_CMD_STATUS) {
+            latencyRecord(LAT_CONTROL_CMD, actuatedUs - postedUs[i]);
+        }
+        r.status = status;
+        if (xQueueSend(resultQueue, &r, 0) != pdTRUE) {
+            LOG_W(CTRL, "Result queue full, response to %s dropped\n", r.commandId);
+        }
+    }
+    xQueueOverwrite(statusQueue, &status);
+
+    latencyRecord(LAT_CONTROL_TICK, micros() - startUs);
+}
+
+bool postControlCommand(ControlCommand& cmd) {
+    if (cmdQueue == nullptr) return false;
+    cmd.commandId[sizeof(cmd.commandId) - 1] = '\0';
+    cmd.postedUs = micros();
+    return xQueueSend(cmdQueue, &cmd, 0) == pdTRUE;
+}
+
+bool receiveControlResult(ControlResult& result) {
+    return resultQueue != nullptr && xQueueReceive(resultQueue, &result, 0) == pdTRUE;
+}
+
+ControlStatus getControlStatus() {
+    ControlStatus s;
+    if (statusQueue == nullptr || xQueuePeek(statusQueue, &s, 0) != pdTRUE) {
+        memset(&s, 0, sizeof(s));
+    }
+    return s;
+}
+
+size_t formatControlJson(const ControlStatus& s, char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size,
+        "{\"mode\":\"%s\",\"fan_speed\":\"%s\",\"compressor\":%s,\"defrost\":%s,"
+        "\"emergency_stop\":%s,\"relays\":[",
+        getModeName(s.mode), getFanSpeedName(s.fanSpeed),
+        (s.relays & RELAY_BIT(RELAY_COMPRESSOR)) ? "true" : "false",
+        (s.relays & RELAY_BIT(RELAY_DEFROST)) ? "true" : "false",
+        s.emergencyStop ? "true" : "false");
+
+    bool first = true;
+    for (uint8_t r = 0; r < RELAY_COUNT && w < size; r++) {
+        if (!(s.relays & RELAY_BIT(r))) continue;
+        w += snprintf(buf + w, size - w, "%s\"%s\"", first ? "" : ",", getRelayName((Relay)r));
+        first = false;
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "],\"trips\":[");
+    first = true;
+    for (uint8_t i = 0; i <= TRIP_STALE_INDEX && w < size; i++) {
+        if (!(s.trips & (1u << i))) continue;
+        w += snprintf(buf + w, size - w, "%s\"%s\"", first ? "" : ",", getTripName(i));
+        first = false;
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "],\"setpoint\":");
+    if (w < size) w += isnan(s.setpoint) ? snprintf(buf + w, size - w, "null")
+                                         : snprintf(buf + w, size - w, "%.1f", s.setpoint);
+    if (w < size) w += snprintf(buf + w, size - w, ",\"demand\":");
+    if (w < size) w += isnan(s.demand) ? snprintf(buf + w, size - w, "null")
+                                       : snprintf(buf + w, size - w, "%.2f", s.demand);
+    if (w < size) w += snprintf(buf + w, size - w, "}");
+    return w < size ? w : size - 1;
+}
+
+const char* getModeName(OperatingMode m) {
+    return m < MODE_COUNT ? MODE_NAMES[m] : "unknown";
+}
+
+const char* getFanSpeedName(FanSpeed speed) {
+    return speed < FAN_SPEED_COUNT ? FAN_NAMES[speed] : "unknown";
+}
+
+const char* getCommandResultName(CommandResult result) {
+    return result <= CMD_FAILED ? RESULT_NAMES[result] : "unknown";
+}
+
+bool parseMode(const char* name, OperatingMode& m) {
+    if (name == nullptr) return false;
+    for (int i = 0; i < MODE_COUNT; i++) {
+        if (strcmp(name, MODE_NAMES[i]) == 0) {
+            m = (OperatingMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseFanSpeed(const char* name, FanSpeed& speed) {
+    if (name == nullptr) return false;
+    for (int i = 0; i < FAN_SPEED_COUNT; i++) {
+        if (strcmp(name, FAN_NAMES[i]) == 0) {
+            speed = (FanSpeed)i;
+            return true;
+        }
+    }
+    return false;
+}
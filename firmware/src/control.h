@@ -0,0 +1,158 @@
+/**
+ * @file control.h
+ * @brief Stage 2 relay control engine: fixed-tick task, commands, outputs
+ *
+ * A dedicated task above the sensing task runs controlTick() every
+ * CONTROL_TICK_MS on absolute ticks. Each tick:
+ * 1. re-evaluates the sensor trips (interlocks.h) against the latest
+ *    reading snapshot; no reading within CONTROL_STALE_READINGS sensor
+ *    periods counts as a trip of its own
+ * 2. validates and applies queued commands. Validation walks only the
+ *    fixed interlock tables, so it takes constant time and a rejected
+ *    command never touches the outputs
+ * 3. every THERMO_PERIOD_MS, steps the outlet temperature loop
+ *    (thermostat.h), which decides whether heating or cooling needs the
+ *    compressor
+ * 4. steps the relays toward the requested mode as far as the interlocks
+ *    allow (fan pre-run, valve settle, restart delay, post-run) and
+ *    writes the pins that changed
+ *
+ * Commands reach the engine through a queue (postControlCommand(), any
+ * task, never blocks) and every command gets a ControlResult back on a
+ * second queue, which the network task turns into an MQTT response.
+ * Command-to-actuation latency (queued until the tick that applies it
+ * has written the outputs) and the tick's own run time are recorded in
+ * the latency histograms as control_cmd and control_tick; the loop step
+ * and its period error as thermo_step and thermo_jitter.
+ *
+ * At boot every relay is off, the safety chain open and the compressor
+ * treated as just stopped, so a reset loop cannot short-cycle it. A trip
+ * switches its relays off on the tick it is seen, regardless of minimum
+ * run times; once it clears, the requested mode resumes through the
+ * normal start sequence.
+ */
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+#include "interlocks.h"
+#include "thermostat.h"
+
+// =============================================================================
+// ENGINE CONFIGURATION
+// =============================================================================
+
+#define CONTROL_TICK_MS          100    ///< Engine period
+#define CONTROL_TASK_STACK       3072
+#define CONTROL_TASK_PRIO        6      ///< Above sensing: actuation never waits for a read
+#define CONTROL_TASK_CORE        1
+#define CONTROL_CMD_QUEUE_LEN    4
+#define CONTROL_RESULT_QUEUE_LEN 4
+#define CONTROL_STALE_READINGS   3      ///< Missed sensor periods before the stale trip
+#define CONTROL_ID_LEN           40     ///< Command id (UUID) including the terminator
+#define CONTROL_JSON_MAX         320    ///< Buffer for formatControlJson()
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief One command for the engine
+ */
+struct ControlCommand {
+    char commandId[CONTROL_ID_LEN];
+    ControlCommandType type;
+    OperatingMode mode;         ///< CTRL_CMD_SET_MODE; CTRL_CMD_SET_SETPOINT (MODE_OFF = current)
+    FanSpeed fanSpeed;          ///< CTRL_CMD_SET_FAN
+    bool activate;              ///< CTRL_CMD_EMERGENCY_STOP
+    float setpoint;             ///< CTRL_CMD_SET_SETPOINT, NAN = the unit's own thermostat
+    uint32_t postedUs;          ///< micros() when queued (set by postControlCommand)
+};
+
+/**
+ * @brief Engine state as other tasks see it
+ */
+struct ControlStatus {
+    OperatingMode mode;         ///< Requested mode
+    FanSpeed fanSpeed;          ///< Requested fan speed
+    bool emergencyStop;
+    uint8_t relays;             ///< Energised relays (RELAY_BIT mask)
+    uint8_t blocked;            ///< Held off by trips or the E-stop
+    uint16_t trips;             ///< Active trips (bit = interlock row, TRIP_STALE_BIT)
+    float setpoint;             ///< Outlet setpoint of the mode, NAN without one
+    float demand;               ///< Outlet loop demand 0..1, NAN when not closing the loop
+};
+
+/**
+ * @brief Outcome of one command
+ */
+struct ControlResult {
+    char commandId[CONTROL_ID_LEN];
+    ControlCommandType type;
+    CommandResult result;
+    ControlStatus status;       ///< After the command was applied
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Drive every relay to its off level, create the queues, reset state
+ * @note Call early in setup(), before any other code can touch the pins
+ */
+void initControl();
+
+/**
+ * @brief Start the control task
+ */
+void startControl();
+
+/**
+ * @brief One engine step: trips, commands, outlet loop, outputs
+ * @note Called by the control task; host tests call it directly
+ */
+void controlTick();
+
+/**
+ * @brief Queue a command for the engine (any task, never blocks)
+ * @return false if the queue is full or the engine is not initialised
+ */
+bool postControlCommand(ControlCommand& cmd);
+
+/**
+ * @brief Take the next command result (never blocks)
+ */
+bool receiveControlResult(ControlResult& result);
+
+/**
+ * @brief Latest engine state (any task)
+ */
+ControlStatus getControlStatus();
+
+/**
+ * @brief Write a status as a JSON object
+ * @return Characters written (truncated to size - 1)
+ */
+size_t formatControlJson(const ControlStatus& status, char* buf, size_t size);
+
+const char* getModeName(OperatingMode mode);
+const char* getFanSpeedName(FanSpeed speed);
+const char* getCommandResultName(CommandResult result);
+
+/**
+ * @brief Parse a mode name ("off", "cooling", "heating", "fan_only")
+ * @return false if unknown
+ */
+bool parseMode(const char* name, OperatingMode& mode);
+
+/**
+ * @brief Parse a fan speed name ("off", "low", "medium", "high", "auto")
+ * @return false if unknown
+ */
+bool parseFanSpeed(const char* name, FanSpeed& speed);
+
+#endif // CONTROL_H
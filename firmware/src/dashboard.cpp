@@ -4,11 +4,23 @@
  *
  * Serves a dark-themed <pre> log viewer that polls /api/log every 2s,
  * appends new text, and auto-scrolls. Reads from the LogCapture ring buffer.
+ * Also serves /api/loglevel (runtime log levels), /api/sched (scheduler
+ * accounting and deadline misses), /api/latency (latency histograms) and
+ * /api/power (power mode and residency), /api/supervisor (subsystem
+ * stalls and recoveries) and /api/mem (heap, stacks and fragmentation).
  */
 
 #include "dashboard.h"
 #include "globals.h"
+#include "log_level.h"
+#include "scheduler.h"
+#include "latency.h"
+#include "power.h"
+#include "supervisor.h"
+#include "memstats.h"
 #include <WiFi.h>
+#include <lwip/sockets.h>
+#include <atomic>
 
 // =============================================================================
 // SERVER STATE
@@ -16,6 +28,7 @@
 
 static WiFiServer* dashServer = nullptr;
 static bool dashRunning = false;
+static std::atomic<int> activeFd(-1);  ///< Socket being served, for aborts
 
 // =============================================================================
 // LOG VIEWER HTML (PROGMEM)
@@ -49,7 +62,7 @@ function poll(){
 fetch('/api/log?pos='+pos).then(function(r){return r.json();}).then(function(d){
   if(d.text.length>0){el.textContent+=d.text;if(auto)el.scrollTop=el.scrollHeight;}
   pos=d.pos;
-  bar.textContent='pos: '+pos+' | heap: '+d.heap+' B';
+  bar.textContent='pos: '+pos+' | heap: '+d.heap+' B | serial dropped: '+d.dropped+' B | max write: '+d.wmax+' us';
 }).catch(function(){bar.textContent='Connection lost - retrying...';});
 }
 poll();setInterval(poll,2000);
@@ -119,8 +132,8 @@ static void handleLogAPI(WiFiClient& client, const String& requestLine) {
     char logBuf[2048];
     size_t bytesRead = Log.readLog(logBuf, sizeof(logBuf), fromPos);
 
-    // Build JSON response with escaped text
-    size_t respCapacity = bytesRead * 2 + 128;
+    // Build JSON response with escaped text (token frames need \u00XX)
+    size_t respCapacity = bytesRead * (LOG_TOKENIZED ? 6 : 2) + 160;
     char* resp = (char*)malloc(respCapacity);
     if (!resp) {
         const char* err = "{\"error\":\"oom\"}";
@@ -128,17 +141,25 @@ static void handleLogAPI(WiFiClient& client, const String& requestLine) {
         return;
     }
 
-    size_t w = snprintf(resp, respCapacity, "{\"pos\":%u,\"heap\":%u,\"text\":\"",
-                        (unsigned int)head, (unsigned int)ESP.getFreeHeap());
+    LogCaptureStats st = Log.getStats();
+    size_t w = snprintf(resp, respCapacity,
+                        "{\"pos\":%u,\"heap\":%u,\"dropped\":%u,\"wmax\":%u,\"text\":\"",
+                        (unsigned int)head, (unsigned int)ESP.getFreeHeap(),
+                        (unsigned int)st.dropped, (unsigned int)st.maxWriteUs);
 
     // JSON-escape the log text
-    for (size_t i = 0; i < bytesRead && w < respCapacity - 4; i++) {
+    for (size_t i = 0; i < bytesRead && w < respCapacity - 8; i++) {
         char c = logBuf[i];
         if (c == '"')       { resp[w++] = '\\'; resp[w++] = '"'; }
         else if (c == '\\') { resp[w++] = '\\'; resp[w++] = '\\'; }
         else if (c == '\n') { resp[w++] = '\\'; resp[w++] = 'n'; }
         else if (c == '\r') { resp[w++] = '\\'; resp[w++] = 'r'; }
         else if (c == '\t') { resp[w++] = '\\'; resp[w++] = 't'; }
+        else if (LOG_TOKENIZED && ((uint8_t)c < 0x20 || (uint8_t)c >= 0x7F)) {
+            // Binary token frames: keep every byte so log_decode.py can
+            // rebuild the text from the JSON string's code points
+            w += snprintf(resp + w, respCapacity - w, "\\u%04x", (uint8_t)c);
+        }
         else if ((uint8_t)c >= 0x20) { resp[w++] = c; }
     }
 
@@ -148,6 +169,137 @@ static void handleLogAPI(WiFiClient& client, const String& requestLine) {
     free(resp);
 }
 
+// =============================================================================
+// LOG LEVEL API HANDLER
+// =============================================================================
+
+/**
+ * @brief Copy a query parameter value from the request line
+ * @return true if the parameter was present
+ */
+static bool getQueryParam(const String& requestLine, const char* key, char* out, size_t outSize) {
+    char pattern[16];
+    snprintf(pattern, sizeof(pattern), "%s=", key);
+    int idx = requestLine.indexOf(pattern);
+    if (idx < 0 || outSize == 0) return false;
+
+    const char* p = requestLine.c_str() + idx + strlen(pattern);
+    size_t n = 0;
+    while (p[n] != '\0' && p[n] != '&' && p[n] != ' ' && n < outSize - 1) {
+        out[n] = p[n];
+        n++;
+    }
+    out[n] = '\0';
+    return true;
+}
+
+/**
+ * @brief GET /api/loglevel[?mod=MQTT&level=debug] - read or set levels
+ */
+static void handleLogLevelAPI(WiFiClient& client, const String& requestLine) {
+    char mod[16];
+    char level[12];
+    if (getQueryParam(requestLine, "level", level, sizeof(level))) {
+        if (!getQueryParam(requestLine, "mod", mod, sizeof(mod))) {
+            strcpy(mod, "*");
+        }
+        int m = parseLogModule(mod);
+        int l = parseLogLevel(level);
+        if (m < 0 || l < 0) {
+            const char* err = "{\"error\":\"bad mod or level\"}";
+            sendResponse(client, "400 Bad Request", "application/json", err, strlen(err));
+            return;
+        }
+        setLogLevel((LogModule)m, (uint8_t)l);
+        LOG_I(DASH, "Log level %s = %d\n", mod, l);
+    }
+
+    char body[192];
+    size_t len = formatLogLevels(body, sizeof(body));
+    sendResponse(client, "200 OK", "application/json", body, len);
+}
+
+// =============================================================================
+// DIAGNOSTICS API HANDLERS
+// =============================================================================
+
+/**
+ * @brief GET /api/sched - per-job run time, deadline misses and skips
+ * @note Counters are read without locking while their tasks run; a
+ *       value may be one update stale.
+ */
+static void handleSchedAPI(WiFiClient& client) {
+    const size_t perSched = 1536;
+    size_t capacity = schedulerCount() * perSched + 32;
+    char* body = (char*)malloc(capacity);
+    if (!body) {
+        const char* err = "{\"error\":\"oom\"}";
+        sendResponse(client, "500 Internal Server Error", "application/json", err, strlen(err));
+        return;
+    }
+
+    size_t w = snprintf(body, capacity, "{\"schedulers\":[");
+    for (uint8_t i = 0; i < schedulerCount(); i++) {
+        if (i) body[w++] = ',';
+        w += schedulerAt(i)->toJson(body + w, perSched);
+    }
+    w += snprintf(body + w, capacity - w, "]}");
+
+    sendResponse(client, "200 OK", "application/json", body, w);
+    free(body);
+}
+
+/**
+ * @brief GET /api/latency - histogram summaries and non-empty buckets
+ */
+static void handleLatencyAPI(WiFiClient& client) {
+    const size_t capacity = LAT_JSON_MAX;
+    char* body = (char*)malloc(capacity);
+    if (!body) {
+        const char* err = "{\"error\":\"oom\"}";
+        sendResponse(client, "500 Internal Server Error", "application/json", err, strlen(err));
+        return;
+    }
+
+    size_t len = formatLatencyJson(body, capacity, true);
+    sendResponse(client, "200 OK", "application/json", body, len);
+    free(body);
+}
+
+/**
+ * @brief GET /api/power - current power mode and time spent in each
+ */
+static void handlePowerAPI(WiFiClient& client) {
+    char body[192];
+    size_t len = formatPowerJson(body, sizeof(body));
+    sendResponse(client, "200 OK", "application/json", body, len);
+}
+
+/**
+ * @brief GET /api/supervisor - per-subsystem stall and recovery counters
+ */
+static void handleSupervisorAPI(WiFiClient& client) {
+    char body[320];
+    size_t len = formatSupervisorJson(body, sizeof(body));
+    sendResponse(client, "200 OK", "application/json", body, len);
+}
+
+/**
+ * @brief GET /api/mem - heap, task stacks, fragmentation and hourly trend
+ */
+static void handleMemAPI(WiFiClient& client) {
+    char* body = (char*)malloc(MEM_JSON_MAX);
+    if (!body) {
+        const char* err = "{\"error\":\"oom\"}";
+        sendResponse(client, "500 Internal Server Error", "application/json", err, strlen(err));
+        return;
+    }
+
+    size_t len = formatMemJson(body, MEM_JSON_MAX);
+    sendResponse(client, "200 OK", "application/json", body, len);
+    free(body);
+}
+
 // =============================================================================
 // SERVER IMPLEMENTATION
 // =============================================================================
@@ -180,6 +332,7 @@ void handleDashboard() {
 
     WiFiClient client = dashServer->available();
     if (!client) return;
+    activeFd.store(client.fd());
 
     // Wait briefly for data
     unsigned long start = millis();
@@ -188,6 +341,7 @@ void handleDashboard() {
     }
 
     if (!client.available()) {
+        activeFd.store(-1);
         client.stop();
         return;
     }
@@ -203,7 +357,19 @@ void handleDashboard() {
     }
 
     // Route request
-    if (requestLine.startsWith("GET /api/log")) {
+    if (requestLine.startsWith("GET /api/sched")) {
+        handleSchedAPI(client);
+    } else if (requestLine.startsWith("GET /api/latency")) {
+        handleLatencyAPI(client);
+    } else if (requestLine.startsWith("GET /api/power")) {
+        handlePowerAPI(client);
+    } else if (requestLine.startsWith("GET /api/supervisor")) {
+        handleSupervisorAPI(client);
+    } else if (requestLine.startsWith("GET /api/mem")) {
+        handleMemAPI(client);
+    } else if (requestLine.startsWith("GET /api/loglevel")) {
+        handleLogLevelAPI(client, requestLine);
+    } else if (requestLine.startsWith("GET /api/log")) {
         handleLogAPI(client, requestLine);
     } else if (requestLine.startsWith("GET / ") || requestLine.startsWith("GET / HTTP") ||
                requestLine == "GET /") {
@@ -213,5 +379,16 @@ void handleDashboard() {
         sendResponse(client, "404 Not Found", "text/plain", notFound, strlen(notFound));
     }
 
+    activeFd.store(-1);
     client.stop();
 }
+
+void abortDashboardClient() {
+    int fd = activeFd.exchange(-1);
+    if (fd >= 0) {
+        // Fails the blocked read/write in handleDashboard(); the UI task
+        // still owns and closes the socket
+        shutdown(fd, SHUT_RDWR);
+        Log.println(F("[DASH] Aborted stalled client"));
+    }
+}
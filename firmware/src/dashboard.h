@@ -30,4 +30,11 @@ void handleDashboard();
  */
 void stopDashboard();
 
+/**
+ * @brief Abort the client currently being served, if any
+ * @note Safe from any task (used as the supervisor's dashboard recovery
+ *       hook) - a slow or stalled client unblocks the UI task
+ */
+void abortDashboardClient();
+
 #endif // DASHBOARD_H
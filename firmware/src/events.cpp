@@ -0,0 +1,113 @@
+/**
+ * @file events.cpp
+ * @brief Event bus implementation
+ */
+
+#include "events.h"
+#include <atomic>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+struct HandlerSlot {
+    EventHandler fn;
+    void* ctx;
+};
+
+struct QueueSlot {
+    uint32_t mask;
+    QueueHandle_t queue;
+};
+
+static HandlerSlot handlers[EVT_TYPE_COUNT][EVENT_MAX_HANDLERS];
+static uint8_t handlerCount[EVT_TYPE_COUNT];
+static QueueSlot queues[EVENT_MAX_QUEUES];
+static uint8_t queueCount = 0;
+static std::atomic<uint32_t> drops(0);
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+bool subscribeEvent(EventType type, EventHandler handler, void* ctx) {
+    if (type >= EVT_TYPE_COUNT || handler == nullptr) return false;
+    if (handlerCount[type] >= EVENT_MAX_HANDLERS) return false;
+
+    handlers[type][handlerCount[type]++] = {handler, ctx};
+    return true;
+}
+
+bool subscribeEventQueue(uint32_t mask, QueueHandle_t queue) {
+    if (queue == nullptr || queueCount >= EVENT_MAX_QUEUES) return false;
+
+    queues[queueCount++] = {mask, queue};
+    return true;
+}
+
+QueueHandle_t createEventQueue(uint8_t length) {
+    return xQueueCreate(length, sizeof(Event));
+}
+
+bool publishEvent(Event& ev) {
+    if (ev.type >= EVT_TYPE_COUNT) return false;
+    ev.timeMs = millis();
+
+    const HandlerSlot* slot = handlers[ev.type];
+    for (uint8_t i = 0; i < handlerCount[ev.type]; i++) {
+        slot[i].fn(ev, slot[i].ctx);
+    }
+
+    bool delivered = true;
+    uint32_t bit = EVENT_MASK(ev.type);
+    for (uint8_t i = 0; i < queueCount; i++) {
+        if (!(queues[i].mask & bit)) continue;
+
+        if (ev.type == EVT_READING) {
+            // The reading lives on the publisher's stack
+            Event copy = ev;
+            copy.reading = nullptr;
+            delivered &= xQueueSend(queues[i].queue, &copy, 0) == pdTRUE;
+        } else {
+            delivered &= xQueueSend(queues[i].queue, &ev, 0) == pdTRUE;
+        }
+    }
+    if (!delivered) drops.fetch_add(1, std::memory_order_relaxed);
+    return delivered;
+}
+
+uint32_t getEventDrops() {
+    return drops.load(std::memory_order_relaxed);
+}
+
+bool publishReadingEvent(const SystemData& data) {
+    Event ev;
+    ev.type = EVT_READING;
+    ev.reading = &data;
+    return publishEvent(ev);
+}
+
+bool publishAlertEvent(AlertType type, AlertLevel level, AlertLevel prevLevel, float value) {
+    Event ev;
+    ev.type = EVT_ALERT;
+    ev.alert.type = (uint8_t)type;
+    ev.alert.level = (uint8_t)level;
+    ev.alert.prevLevel = (uint8_t)prevLevel;
+    ev.alert.value = value;
+    return publishEvent(ev);
+}
+
+bool publishTransportEvent(ConnectionType conn, ConnectionType prev) {
+    Event ev;
+    ev.type = EVT_TRANSPORT;
+    ev.transport.conn = (uint8_t)conn;
+    ev.transport.prev = (uint8_t)prev;
+    return publishEvent(ev);
+}
+
+bool publishConfigEvent(uint8_t changed) {
+    Event ev;
+    ev.type = EVT_CONFIG;
+    ev.configChanged = changed;
+    return publishEvent(ev);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file events.h
+ * @brief Statically allocated publish/subscribe event bus
+ *
+ * Modules announce state changes as typed events instead of calling each
+ * other: a new reading, an alert level change, the MQTT transport going
+ * up or down, a config change. Any number of consumers (SMS notifier,
+ * metrics, local control) attach by subscribing; the producer does not
+ * know they exist.
+ *
+ * Two kinds of subscription:
+ * - handler: called synchronously on the publishing task, in subscription
+ *   order. Dispatch is a loop over a fixed table of function pointers,
+ *   no locks and no allocation. Handlers must be short and must not block.
+ * - queue: the event is copied into a FreeRTOS queue (never blocks; a full
+ *   queue drops the event) for a consumer on another task.
+ *
+ * Subscriptions are made during setup(), before the tasks start; the
+ * tables are not locked, so subscribing at runtime is not supported.
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+
+// =============================================================================
+// BUS CONFIGURATION
+// =============================================================================
+
+#define EVENT_MAX_HANDLERS   6   ///< Handler subscriptions per event type
+#define EVENT_MAX_QUEUES     4   ///< Queue subscriptions (all types)
+
+/**
+ * @brief Event types
+ */
+enum EventType {
+    EVT_READING = 0,   ///< New sensor reading (sensing task)
+    EVT_ALERT,         ///< Alert level changed, or critical alert re-armed
+    EVT_TRANSPORT,     ///< MQTT transport changed (network task)
+    EVT_CONFIG,        ///< Runtime config loaded or saved
+    EVT_TYPE_COUNT     ///< Must be last - used for array sizing
+};
+
+#define EVENT_MASK(type) (1UL << (type))
+
+/**
+ * @brief Alert transition payload
+ * @note level == prevLevel == ALERT_CRITICAL is a reminder: the condition
+ *       persisted past the alert cooldown, or the last SMS for it was not
+ *       sent
+ */
+struct AlertEvent {
+    uint8_t type;       ///< AlertType
+    uint8_t level;      ///< AlertLevel now
+    uint8_t prevLevel;  ///< AlertLevel at the previous reading
+    float value;        ///< Sensor value that triggered the change
+};
+
+/**
+ * @brief One event; small enough to copy into a queue
+ */
+struct Event {
+    uint8_t type;       ///< EventType
+    uint32_t timeMs;    ///< millis() at publish
+    union {
+        /// EVT_READING. Valid only during synchronous dispatch - queue
+        /// subscribers receive nullptr and read getLatestReading()
+        const SystemData* reading;
+        AlertEvent alert;                                   ///< EVT_ALERT
+        struct { uint8_t conn; uint8_t prev; } transport;   ///< EVT_TRANSPORT (ConnectionType)
+        uint8_t configChanged;                              ///< EVT_CONFIG (ConfigSection mask)
+    };
+};
+
+/**
+ * @brief Synchronous event handler
+ * @param ev Event being dispatched
+ * @param ctx Pointer given at subscription
+ */
+typedef void (*EventHandler)(const Event& ev, void* ctx);
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Call handler on the publishing task for every event of a type
+ * @return false if EVENT_MAX_HANDLERS is exhausted for this type
+ */
+bool subscribeEvent(EventType type, EventHandler handler, void* ctx = nullptr);
+
+/**
+ * @brief Copy every event whose type is in mask into a queue
+ * @param mask OR of EVENT_MASK() values
+ * @param queue Queue created with createEventQueue()
+ * @return false if EVENT_MAX_QUEUES is exhausted
+ */
+bool subscribeEventQueue(uint32_t mask, QueueHandle_t queue);
+
+/**
+ * @brief Create a queue sized for Event items
+ */
+QueueHandle_t createEventQueue(uint8_t length);
+
+/**
+ * @brief Dispatch an event to all subscribers of its type
+ * @return false if a queue subscriber was full and missed the event
+ */
+bool publishEvent(Event& ev);
+
+/**
+ * @brief Events dropped because a subscriber queue was full (since boot)
+ */
+uint32_t getEventDrops();
+
+// ---- Typed publishers ----
+
+bool publishReadingEvent(const SystemData& data);
+bool publishAlertEvent(AlertType type, AlertLevel level, AlertLevel prevLevel, float value);
+bool publishTransportEvent(ConnectionType conn, ConnectionType prev);
+bool publishConfigEvent(uint8_t changed);
+
+#endif // EVENTS_H
@@ -4,6 +4,8 @@
  */
 
 #include "gsm.h"
+#include "latency.h"
+#include <atomic>
 
 // =============================================================================
 // PRIVATE CONSTANTS
@@ -13,6 +15,12 @@ static const char AT_CMGF[] PROGMEM = "AT+CMGF=1";           // Text mode
 static const char AT_CMGL[] PROGMEM = "AT+CMGL=\"REC UNREAD\"";  // List unread
 static const char AT_CMGD[] PROGMEM = "AT+CMGD=1,4";         // Delete all
 
+static std::atomic<bool> restartRequested(false);
+
+/// Reply to every command line while the modem stream is aborted
+static const char ABORT_REPLY[] = "\r\nERROR\r\n";
+static const uint8_t ABORT_REPLY_LEN = sizeof(ABORT_REPLY) - 1;
+
 // =============================================================================
 // PRIVATE HELPER FUNCTIONS
 // =============================================================================
@@ -48,6 +56,64 @@ static bool safeSubstring(const String& str, int startIdx, int endIdx, String& o
     return true;
 }
 
+// =============================================================================
+// MODEM STREAM
+// =============================================================================
+
+ModemStream::ModemStream(Stream& uart)
+    : _uart(uart), _aborted(false), _replyPos(ABORT_REPLY_LEN) {}
+
+void ModemStream::abort() {
+    _replyPos.store(ABORT_REPLY_LEN);
+    _aborted.store(true);
+}
+
+void ModemStream::resume() {
+    _aborted.store(false);
+    while (_uart.available() > 0) {
+        _uart.read();   // Late output of the aborted exchange
+    }
+}
+
+int ModemStream::available() {
+    if (!_aborted.load()) return _uart.available();
+    while (_uart.available() > 0) {
+        _uart.read();
+    }
+    return ABORT_REPLY_LEN - _replyPos.load();
+}
+
+int ModemStream::read() {
+    if (!_aborted.load()) return _uart.read();
+    uint8_t pos = _replyPos.load();
+    if (pos >= ABORT_REPLY_LEN) return -1;
+    _replyPos.store(pos + 1);
+    return (uint8_t)ABORT_REPLY[pos];
+}
+
+int ModemStream::peek() {
+    if (!_aborted.load()) return _uart.peek();
+    uint8_t pos = _replyPos.load();
+    return pos < ABORT_REPLY_LEN ? (uint8_t)ABORT_REPLY[pos] : -1;
+}
+
+size_t ModemStream::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t ModemStream::write(const uint8_t* buf, size_t size) {
+    if (!_aborted.load()) return _uart.write(buf, size);
+    // Each command line (or SMS body, ended by Ctrl-Z) gets an ERROR
+    if (memchr(buf, '\r', size) || memchr(buf, '\n', size) || memchr(buf, 0x1A, size)) {
+        _replyPos.store(0);
+    }
+    return size;
+}
+
+void ModemStream::flush() {
+    if (!_aborted.load()) _uart.flush();
+}
+
 // =============================================================================
 // IMPLEMENTATION
 // =============================================================================
@@ -169,6 +235,8 @@ bool sendSMS(const char* phone, const char* message) {
 }
 
 bool checkIncomingSMS(SMSMessage& msg) {
+    LatencyScope timer(LAT_SMS_CHECK);
+
     // Set text mode
     modem.stream.println(F("AT+CMGF=1"));
     delay(100);
@@ -187,11 +255,31 @@ bool checkIncomingSMS(SMSMessage& msg) {
         delay(10);
     }
 
-    // Check if we got a message
+    SMSParseResult result = parseSMSListing(response, msg);
+    if (result == SMS_PARSE_NONE) {
+        return false;  // No unread messages
+    }
+    if (result == SMS_PARSE_ERROR) {
+        deleteAllSMS();
+        return false;
+    }
+
+    Log.print(F("[GSM] SMS from: "));
+    Log.println(msg.sender);
+    Log.print(F("[GSM] Content: "));
+    Log.println(msg.content);
+
+    // Delete read messages to free memory
+    deleteAllSMS();
+
+    return true;
+}
+
+SMSParseResult parseSMSListing(const String& response, SMSMessage& msg) {
     // Response format: +CMGL: <index>,"REC UNREAD","<phone>",,"<timestamp>"\r\n<message>\r\n
     int cmglPos = safeFindSubstring(response, "+CMGL:");
     if (cmglPos < 0) {
-        return false;  // No unread messages
+        return SMS_PARSE_NONE;
     }
 
     // Parse phone number - find the pattern: ","<phone>","
@@ -199,30 +287,26 @@ bool checkIncomingSMS(SMSMessage& msg) {
     int firstQuote = safeFindSubstring(response, "\",\"", cmglPos);
     if (firstQuote < 0) {
         Log.println(F("[GSM] SMS parse error: phone start not found"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     int phoneStart = firstQuote + 3;  // Skip past ",\"
     int phoneEnd = safeFindSubstring(response, "\"", phoneStart);
     if (phoneEnd < 0 || phoneEnd <= phoneStart) {
         Log.println(F("[GSM] SMS parse error: phone end not found"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     if (!safeSubstring(response, phoneStart, phoneEnd, msg.sender)) {
         Log.println(F("[GSM] SMS parse error: phone extraction failed"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     // Find message content - it's on the line after the header
     int headerEnd = safeFindSubstring(response, "\r\n", cmglPos);
     if (headerEnd < 0) {
         Log.println(F("[GSM] SMS parse error: header end not found"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     int msgStart = headerEnd + 2;  // Skip past \r\n
@@ -234,28 +318,17 @@ bool checkIncomingSMS(SMSMessage& msg) {
 
     if (msgStart >= msgEnd || msgStart >= (int)response.length()) {
         Log.println(F("[GSM] SMS parse error: message extraction failed"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     if (!safeSubstring(response, msgStart, msgEnd, msg.content)) {
         Log.println(F("[GSM] SMS parse error: content extraction failed"));
-        deleteAllSMS();
-        return false;
+        return SMS_PARSE_ERROR;
     }
 
     msg.content.trim();
     msg.isNew = true;
-
-    Log.print(F("[GSM] SMS from: "));
-    Log.println(msg.sender);
-    Log.print(F("[GSM] Content: "));
-    Log.println(msg.content);
-
-    // Delete read messages to free memory
-    deleteAllSMS();
-
-    return true;
+    return SMS_PARSE_OK;
 }
 
 SMSCommand parseSMSCommand(const String& message) {
@@ -335,3 +408,29 @@ size_t formatStatusMessage(const SystemData& data, char* buffer, size_t bufferSi
         data.compressorRunning ? "ON" : "OFF"
     );
 }
+
+void requestModemRestart() {
+    restartRequested.store(true);
+}
+
+void abortModemExchange() {
+    modemUart.abort();
+    requestModemRestart();
+    Log.println(F("[GSM] Modem exchange aborted"));
+}
+
+bool serviceModemRestart() {
+    if (!restartRequested.exchange(false)) return false;
+
+    modemUart.resume();
+    Log.println(F("[GSM] Restarting modem (supervisor request)"));
+    gsmState = GSM_INITIALIZING;
+    if (modem.restart() || modem.init()) {
+        gsmState = GSM_READY;
+        Log.println(F("[GSM] Modem restarted"));
+    } else {
+        gsmState = GSM_STATE_ERROR;
+        Log.println(F("[GSM] Modem restart failed"));
+    }
+    return true;
+}
@@ -13,6 +13,46 @@
 #include "../config.h"
 #include "types.h"
 #include "globals.h"
+#include <atomic>
+
+// =============================================================================
+// MODEM UART
+// =============================================================================
+
+/**
+ * @brief The modem's UART, with an abort switch for the supervisor
+ *
+ * TinyGSM waits for a reply by polling the UART until its own timeout
+ * (up to 60 s), so a stalled exchange cannot be cut short from the task
+ * running it, and the modem's PWRKEY is not wired for a power cycle.
+ * abort() makes the exchange fail instead: while aborted, output is
+ * dropped, the UART's input is discarded and every command line written
+ * is answered with "ERROR", which ends any TinyGSM wait at once. The
+ * network task resumes the stream when it restarts the modem.
+ */
+class ModemStream : public Stream {
+    Stream& _uart;
+    std::atomic<bool> _aborted;
+    std::atomic<uint8_t> _replyPos;   ///< Into the ERROR reply; its length when none due
+public:
+    explicit ModemStream(Stream& uart);
+
+    /** @brief Fail the current and later exchanges (any task) */
+    void abort();
+    /** @brief Pass traffic through again */
+    void resume();
+    bool aborted() const { return _aborted.load(); }
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    void flush() override;
+    using Print::write;
+};
+
+extern ModemStream modemUart;   ///< Stream TinyGsm modem talks through
 
 // =============================================================================
 // FUNCTION DECLARATIONS
@@ -57,6 +97,15 @@ bool sendSMS(const char* phone, const char* message);
  */
 bool checkIncomingSMS(SMSMessage& msg);
 
+/**
+ * @brief Extract the first message from an AT+CMGL response
+ * @param response Raw modem response
+ * @param msg Output structure (sender and trimmed content)
+ * @return SMS_PARSE_NONE if no message is listed, SMS_PARSE_ERROR if the
+ *         entry is malformed
+ */
+SMSParseResult parseSMSListing(const String& response, SMSMessage& msg);
+
 /**
  * @brief Parse SMS content to determine command
  * @param message SMS message content
@@ -93,6 +142,29 @@ int getSignalQuality();
  */
 String getOperatorName();
 
+/**
+ * @brief Ask the network task to restart the modem on its next pass
+ * @note Safe from any task; the modem itself is only touched by
+ *       serviceModemRestart()
+ */
+void requestModemRestart();
+
+/**
+ * @brief Fail the modem exchange in progress and restart the modem
+ * @note The supervisor's GSM recovery hook: runs on the supervisor task
+ *       while the network task is stuck in the exchange. Aborts
+ *       modemUart so the exchange returns, then requests a restart.
+ */
+void abortModemExchange();
+
+/**
+ * @brief Restart the modem if a restart was requested (network task only)
+ *
+ * Resumes an aborted modemUart first.
+ * @return true if a restart was performed
+ */
+bool serviceModemRestart();
+
 /**
  * @brief Format system data as status message for SMS
  * @param data System data to format
@@ -0,0 +1,221 @@
+/**
+ * @file interlocks.cpp
+ * @brief Interlock tables and their evaluation
+ */
+
+#include "interlocks.h"
+
+// =============================================================================
+// INTERLOCK TABLES
+// =============================================================================
+
+/**
+ * @brief Sensor trips (Stage 2 plan, 5.4 Safety Interlocks)
+ *
+ * Trips at the critical alert level and releases at the warning level.
+ * Pressure transducers are optional, so a missing one does not trip.
+ */
+static const SensorTrip SENSOR_TRIPS[] = {
+    // name           sensor                         compare     limit                   clear                  failSafe blocks
+    {"pressure_high", &SystemData::pressureHigh,   TRIP_ABOVE, PRESSURE_HIGH_CRITICAL, PRESSURE_HIGH_WARNING, false,   RELAYS_COMP_CIRCUIT},
+    {"pressure_low",  &SystemData::pressureLow,    TRIP_BELOW, PRESSURE_LOW_CRITICAL,  PRESSURE_LOW_WARNING,  false,   RELAYS_COMP_CIRCUIT},
+    {"comp_temp",     &SystemData::tempCompressor, TRIP_ABOVE, COMP_TEMP_CRITICAL,     COMP_TEMP_WARNING,     true,    RELAYS_COMP_CIRCUIT},
+    {"overcurrent",   &SystemData::current,        TRIP_ABOVE, CURRENT_CRITICAL,       CURRENT_WARNING,       true,    RELAYS_COMP_CIRCUIT},
+    {"voltage_high",  &SystemData::voltage,        TRIP_ABOVE, VOLTAGE_HIGH_CRITICAL,  VOLTAGE_HIGH_WARNING,  true,    RELAYS_ALL},
+    {"voltage_low",   &SystemData::voltage,        TRIP_BELOW, VOLTAGE_LOW_CRITICAL,   VOLTAGE_LOW_WARNING,   true,    RELAYS_ALL},
+};
+
+#define TRIP_COUNT (sizeof(SENSOR_TRIPS) / sizeof(SENSOR_TRIPS[0]))
+static_assert(TRIP_COUNT <= INTERLOCK_MAX_TRIPS, "Trip bits overlap TRIP_STALE_BIT");
+
+/** @brief No fresh reading: pressures and current are unknown */
+#define STALE_BLOCKS RELAYS_COMP_CIRCUIT
+
+static const RelayTiming RELAY_TIMINGS[] = {
+    // relay           minOnMs                minOffMs
+    {RELAY_COMPRESSOR, COMPRESSOR_MIN_RUN_MS, COMPRESSOR_RESTART_DELAY_MS},
+};
+
+static const RelayDependency RELAY_DEPENDENCIES[] = {
+    // relay           requires                        leadMs                    holdMs                locked
+    {RELAY_COMPRESSOR, RELAYS_FAN,                     FAN_PRERUN_DELAY_MS,      FAN_POSTRUN_DELAY_MS, false},
+    {RELAY_COMPRESSOR, RELAYS_VALVE,                   MODE_TRANSITION_DELAY_MS, 0,                    true},
+    {RELAY_DEFROST,    RELAY_BIT(RELAY_COMPRESSOR),    0,                        0,                    false},
+    {RELAY_DEFROST,    RELAY_BIT(RELAY_VALVE_HEAT),    0,                        0,                    false},
+};
+
+static const uint8_t EXCLUSIVE_GROUPS[] = {
+    RELAYS_VALVE,
+    RELAYS_FAN,
+};
+
+/** @brief Relays each mode runs, before the fan */
+static const uint8_t MODE_RELAYS[MODE_COUNT] = {
+    0,                                                        // MODE_OFF
+    RELAY_BIT(RELAY_COMPRESSOR) | RELAY_BIT(RELAY_VALVE_COOL),  // MODE_COOLING
+    RELAY_BIT(RELAY_COMPRESSOR) | RELAY_BIT(RELAY_VALVE_HEAT),  // MODE_HEATING
+    0,                                                        // MODE_FAN_ONLY
+};
+
+static const uint8_t FAN_RELAYS[FAN_SPEED_COUNT] = {
+    0,                            // FAN_OFF
+    RELAY_BIT(RELAY_FAN_LOW),     // FAN_LOW
+    RELAY_BIT(RELAY_FAN_MED),     // FAN_MEDIUM
+    RELAY_BIT(RELAY_FAN_HIGH),    // FAN_HIGH
+    RELAY_BIT(RELAY_FAN_MED),     // FAN_AUTO
+};
+
+static const char* const RELAY_NAMES[RELAY_COUNT] = {
+    "compressor", "fan_low", "fan_med", "fan_high", "valve_cool", "valve_heat", "defrost", "estop"
+};
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint32_t minOnMs(Relay relay) {
+    for (const RelayTiming& t : RELAY_TIMINGS) {
+        if (t.relay == relay) return t.minOnMs;
+    }
+    return 0;
+}
+
+/**
+ * @brief True if any relay of group has been on in both cur and next for
+ * at least leadMs
+ */
+static bool groupReady(uint8_t group, const RelayState& rs, uint8_t next,
+                       uint32_t leadMs, uint32_t nowMs) {
+    uint8_t on = group & rs.on & next;
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        if ((on & RELAY_BIT(r)) && nowMs - rs.changedMs[r] >= leadMs) return true;
+    }
+    return false;
+}
+
+static bool isTripped(const SensorTrip& t, const SensorReading& r, bool active) {
+    if (!r.valid) return t.failSafe;
+    if (t.compare == TRIP_ABOVE) {
+        return active ? r.value > t.clear : r.value > t.limit;
+    }
+    return active ? r.value < t.clear : r.value < t.limit;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+uint8_t modeRelays(OperatingMode mode, FanSpeed fan) {
+    if (mode <= MODE_OFF || mode >= MODE_COUNT || fan >= FAN_SPEED_COUNT) return 0;
+    return MODE_RELAYS[mode] | FAN_RELAYS[fan];
+}
+
+uint16_t evaluateTrips(const SystemData* reading, uint16_t active) {
+    if (reading == nullptr) return active | TRIP_STALE_BIT;
+
+    uint16_t trips = 0;
+    for (uint8_t i = 0; i < TRIP_COUNT; i++) {
+        const SensorTrip& t = SENSOR_TRIPS[i];
+        if (isTripped(t, reading->*(t.sensor), active & (1u << i))) {
+            trips |= (uint16_t)(1u << i);
+        }
+    }
+    return trips;
+}
+
+uint8_t tripBlocks(uint16_t trips) {
+    uint8_t blocks = (trips & TRIP_STALE_BIT) ? STALE_BLOCKS : 0;
+    for (uint8_t i = 0; i < TRIP_COUNT; i++) {
+        if (trips & (1u << i)) blocks |= SENSOR_TRIPS[i].blocks;
+    }
+    return blocks;
+}
+
+CommandResult checkRelayRequest(uint8_t want, uint8_t accepted, uint8_t blocked,
+                                const RelayState& rs, uint32_t nowMs) {
+    for (uint8_t group : EXCLUSIVE_GROUPS) {
+        if (__builtin_popcount(want & group) > 1) return CMD_REJECTED_INVALID;
+    }
+    for (const RelayDependency& d : RELAY_DEPENDENCIES) {
+        if ((want & RELAY_BIT(d.relay)) && !(want & d.requires)) return CMD_REJECTED_INTERLOCK;
+    }
+    uint8_t added = want & ~accepted;
+    if (added & blocked) return CMD_REJECTED_SAFETY;
+    for (const RelayTiming& t : RELAY_TIMINGS) {
+        uint8_t bit = RELAY_BIT(t.relay);
+        if ((added & bit) && !(rs.on & bit) && nowMs - rs.changedMs[t.relay] < t.minOffMs) {
+            return CMD_REJECTED_COOLDOWN;
+        }
+    }
+    return CMD_SUCCESS;
+}
+
+uint8_t nextRelays(uint8_t target, uint8_t blocked, const RelayState& rs, uint32_t nowMs) {
+    const uint8_t cur = rs.on;
+    uint8_t next = target & ~blocked;
+
+    // Minimum on/off times; a trip or the E-stop still switches off at once
+    for (const RelayTiming& t : RELAY_TIMINGS) {
+        uint8_t bit = RELAY_BIT(t.relay);
+        uint32_t elapsed = nowMs - rs.changedMs[t.relay];
+        if ((cur & bit) && !(next & bit) && !(blocked & bit) && elapsed < t.minOnMs) {
+            next |= bit;
+        } else if (!(cur & bit) && (next & bit) && elapsed < t.minOffMs) {
+            next &= ~bit;
+        }
+    }
+
+    for (const RelayDependency& d : RELAY_DEPENDENCIES) {
+        uint8_t bit = RELAY_BIT(d.relay);
+        uint32_t elapsed = nowMs - rs.changedMs[d.relay];
+
+        if (!(cur & bit) && (next & bit)) {
+            // Starting: the group must already be on and settled
+            if (!groupReady(d.requires, rs, next, d.leadMs, nowMs)) next &= ~bit;
+        } else if ((cur & bit) && (next & bit)) {
+            // Running: a locked group only changes once the relay has stopped
+            if (d.locked && (next & d.requires) != (cur & d.requires)) {
+                next = (next & ~d.requires) | (cur & d.requires);
+                if (elapsed >= minOnMs(d.relay)) next &= ~bit;
+            }
+            if (!(next & d.requires)) next |= cur & d.requires;
+        } else if ((cur & bit) || elapsed < d.holdMs) {
+            // Stopping, or stopped within the hold time: keep the group on
+            if (d.holdMs && !(next & d.requires)) next |= cur & d.requires;
+        }
+    }
+
+    // Break before make: a new member waits until the old one is off
+    for (uint8_t group : EXCLUSIVE_GROUPS) {
+        uint8_t want = next & group;
+        if (want & (want - 1)) {
+            next &= ~group;  // Never built that way; fail safe
+        } else if ((want & ~cur) && (cur & group & ~want)) {
+            next &= ~want;
+        }
+    }
+
+    return next & ~blocked;
+}
+
+void commitRelays(RelayState& rs, uint8_t next, uint32_t nowMs) {
+    uint8_t changed = rs.on ^ next;
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        if (changed & RELAY_BIT(r)) rs.changedMs[r] = nowMs;
+    }
+    rs.on = next;
+}
+
+uint8_t getTripCount() {
+    return TRIP_COUNT;
+}
+
+const char* getTripName(uint8_t index) {
+    if (index < TRIP_COUNT) return SENSOR_TRIPS[index].name;
+    if (index == TRIP_STALE_INDEX) return "stale";
+    return "unknown";
+}
+
+const char* getRelayName(Relay relay) {
+    return relay < RELAY_COUNT ? RELAY_NAMES[relay] : "unknown";
+}
@@ -0,0 +1,179 @@
+/**
+ * @file interlocks.h
+ * @brief Declarative safety interlocks for the Stage 2 relay outputs
+ *
+ * Every rule the relays must obey is a row in one of four constant tables
+ * (interlocks.cpp), evaluated by the same few loops:
+ * - sensor trips: a SystemData field past a limit holds a set of relays
+ *   off until it comes back past a release value (hysteresis). Invalid
+ *   readings trip the fail-safe rows.
+ * - relay timing: minimum on and off times (compressor restart delay)
+ * - dependencies: a relay may only start once another group has been on
+ *   for a lead time (fan pre-run, valve settle), keeps that group on for
+ *   a hold time after it stops (fan post-run), and optionally locks the
+ *   group while it runs (no valve change under a running compressor)
+ * - exclusive groups: at most one member on (valves, fan speeds),
+ *   switched break-before-make
+ *
+ * The functions here are pure: they take the relay state and the time and
+ * return a decision, so the control task, the command validator and the
+ * host tests all run the same code. Limits are compile-time constants on
+ * purpose; the alert thresholds in RuntimeConfig can be changed over MQTT,
+ * the trips cannot.
+ */
+
+#ifndef INTERLOCKS_H
+#define INTERLOCKS_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+
+// =============================================================================
+// RELAYS
+// =============================================================================
+
+/**
+ * @brief Control outputs (bit positions in a relay mask)
+ */
+enum Relay {
+    RELAY_COMPRESSOR = 0,
+    RELAY_FAN_LOW,
+    RELAY_FAN_MED,
+    RELAY_FAN_HIGH,
+    RELAY_VALVE_COOL,
+    RELAY_VALVE_HEAT,
+    RELAY_DEFROST,
+    RELAY_ESTOP,        ///< Safety chain: energised = chain closed
+    RELAY_COUNT         ///< Must be last - used for array sizing
+};
+
+#define RELAY_BIT(r)        ((uint8_t)(1u << (r)))
+#define RELAYS_FAN          (RELAY_BIT(RELAY_FAN_LOW) | RELAY_BIT(RELAY_FAN_MED) | RELAY_BIT(RELAY_FAN_HIGH))
+#define RELAYS_VALVE        (RELAY_BIT(RELAY_VALVE_COOL) | RELAY_BIT(RELAY_VALVE_HEAT))
+#define RELAYS_COMP_CIRCUIT (RELAY_BIT(RELAY_COMPRESSOR) | RELAY_BIT(RELAY_DEFROST))
+#define RELAYS_ALL          ((uint8_t)0xFF)
+
+#define INTERLOCK_MAX_TRIPS 15              ///< Table rows (bits below TRIP_STALE_INDEX)
+#define TRIP_STALE_INDEX    15
+#define TRIP_STALE_BIT      ((uint16_t)(1u << TRIP_STALE_INDEX))
+
+// =============================================================================
+// TABLE ROWS
+// =============================================================================
+
+enum TripCompare {
+    TRIP_ABOVE = 0,     ///< Trips when value > limit, releases at <= clear
+    TRIP_BELOW          ///< Trips when value < limit, releases at >= clear
+};
+
+/**
+ * @brief A sensor limit that holds relays off
+ */
+struct SensorTrip {
+    const char* name;
+    SensorReading SystemData::* sensor;
+    TripCompare compare;
+    float limit;        ///< Trips past this
+    float clear;        ///< Releases back past this
+    bool failSafe;      ///< An invalid reading trips as well
+    uint8_t blocks;     ///< Relays held off while tripped
+};
+
+/**
+ * @brief Minimum on/off times of one relay
+ */
+struct RelayTiming {
+    Relay relay;
+    uint32_t minOnMs;   ///< Not switched off sooner, except by a trip or E-stop
+    uint32_t minOffMs;  ///< Not switched on sooner
+};
+
+/**
+ * @brief A relay that needs one of a group of relays on
+ */
+struct RelayDependency {
+    Relay relay;
+    uint8_t requires;   ///< Any one of these must be on
+    uint32_t leadMs;    ///< ...for this long before the relay starts
+    uint32_t holdMs;    ///< Group kept on this long after the relay stops
+    bool locked;        ///< Group may not change while the relay runs
+};
+
+/**
+ * @brief Relay state the rules are evaluated against
+ */
+struct RelayState {
+    uint8_t on;                        ///< Energised relays
+    uint32_t changedMs[RELAY_COUNT];   ///< millis() of each relay's last switch
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Relays an operating mode runs at a fan speed (without the chain)
+ */
+uint8_t modeRelays(OperatingMode mode, FanSpeed fan);
+
+/**
+ * @brief Update the active trips from a reading
+ * @param reading Latest reading, or nullptr if there is no fresh one
+ *        (sets TRIP_STALE_BIT, which holds the compressor circuit off)
+ * @param active Trips active until now (bit i = table row i)
+ */
+uint16_t evaluateTrips(const SystemData* reading, uint16_t active);
+
+/**
+ * @brief Union of the relays held off by a set of trips
+ */
+uint8_t tripBlocks(uint16_t trips);
+
+/**
+ * @brief Check that a requested relay set may be run (constant time)
+ *
+ * Only the fixed-size tables are walked, so the cost does not depend on
+ * the state or the history.
+ * @param want Relays the request would run
+ * @param accepted Relays an earlier request already runs; exempt from
+ *        the blocked and off-time checks (they wait in nextRelays())
+ * @param blocked Relays held off (trips, E-stop)
+ * @return CMD_REJECTED_INVALID (two members of an exclusive group),
+ *         CMD_REJECTED_INTERLOCK (a dependency missing),
+ *         CMD_REJECTED_SAFETY (a relay is blocked),
+ *         CMD_REJECTED_COOLDOWN (a minimum off time not yet over)
+ *         or CMD_SUCCESS
+ */
+CommandResult checkRelayRequest(uint8_t want, uint8_t accepted, uint8_t blocked,
+                                const RelayState& rs, uint32_t nowMs);
+
+/**
+ * @brief Relays to energise this tick
+ *
+ * Moves from rs.on toward target as far as the timing, dependency and
+ * exclusion rules allow; blocked relays are always off.
+ */
+uint8_t nextRelays(uint8_t target, uint8_t blocked, const RelayState& rs, uint32_t nowMs);
+
+/**
+ * @brief Record a new relay mask and stamp the relays that switched
+ */
+void commitRelays(RelayState& rs, uint8_t next, uint32_t nowMs);
+
+/**
+ * @brief Number of sensor trip rows
+ */
+uint8_t getTripCount();
+
+/**
+ * @brief Name of a trip bit ("stale" for TRIP_STALE_INDEX)
+ */
+const char* getTripName(uint8_t index);
+
+/**
+ * @brief Short relay name ("compressor", "fan_low", ...)
+ */
+const char* getRelayName(Relay relay);
+
+#endif // INTERLOCKS_H
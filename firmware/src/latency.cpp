@@ -0,0 +1,178 @@
+/**
+ * @file latency.cpp
+ * @brief Latency histogram implementation
+ */
+
+#include "latency.h"
+#include <stdarg.h>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static LatencyHistogram histograms[LAT_COUNT];
+static uint32_t recordNs = 0;
+
+static const char* const LATENCY_NAMES[LAT_COUNT] = {
+    "sensor_read",
+    "publish",
+    "publish_cycle",
+    "mqtt_connect",
+    "sms_check",
+    "net_pass",
+    "ui_pass",
+    "control_cmd",
+    "control_tick",
+    "thermo_step",
+    "thermo_jitter"
+};
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint32_t bucketHigh(uint16_t bucket) {
+    return bucket + 1 < LAT_BUCKETS ? latencyBucketLow(bucket + 1) - 1 : UINT32_MAX;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+uint32_t latencyBucketLow(uint16_t bucket) {
+    if (bucket < LAT_SUB_COUNT) return bucket;
+    uint32_t msb = bucket / LAT_SUB_COUNT + LAT_SUB_BITS - 1;
+    uint32_t sub = bucket % LAT_SUB_COUNT;
+    return (LAT_SUB_COUNT + sub) << (msb - LAT_SUB_BITS);
+}
+
+void latencyRecord(LatencyId id, uint32_t us) {
+    LatencyHistogram& h = histograms[id];
+    h.buckets[latencyBucket(us)]++;
+    h.count++;
+    h.sumUs += us;
+    if (us > h.maxUs) h.maxUs = us;
+}
+
+uint32_t latencyPercentile(LatencyId id, float pct) {
+    const LatencyHistogram& h = histograms[id];
+    if (h.count == 0) return 0;
+
+    uint32_t target = (uint32_t)(h.count * pct / 100.0f + 0.999f);
+    if (target == 0) target = 1;
+
+    uint32_t seen = 0;
+    for (uint16_t b = 0; b < LAT_BUCKETS; b++) {
+        seen += h.buckets[b];
+        if (seen >= target) {
+            uint32_t high = bucketHigh(b);
+            return high < h.maxUs ? high : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+uint32_t latencyCountAbove(LatencyId id, uint32_t us) {
+    const LatencyHistogram& h = histograms[id];
+    uint32_t n = 0;
+    for (uint16_t b = latencyBucket(us) + 1; b < LAT_BUCKETS; b++) {
+        n += h.buckets[b];
+    }
+    return n;
+}
+
+const LatencyHistogram& getLatencyHistogram(LatencyId id) {
+    return histograms[id];
+}
+
+const char* getLatencyName(LatencyId id) {
+    return id < LAT_COUNT ? LATENCY_NAMES[id] : "unknown";
+}
+
+void initLatency() {
+    const uint32_t n = 64;
+    uint32_t c0 = ESP.getCycleCount();
+    for (uint32_t i = 0; i < n; i++) {
+        latencyRecord(LAT_UI_PASS, i * 997);
+    }
+    uint32_t cycles = ESP.getCycleCount() - c0;
+    recordNs = cycles * 1000UL / (n * ESP.getCpuFreqMHz());
+    memset(&histograms[LAT_UI_PASS], 0, sizeof(LatencyHistogram));
+}
+
+/**
+ * @brief snprintf at buf + w that still counts once the buffer is full
+ * @return w plus the untruncated length
+ */
+static size_t appendf(char* buf, size_t size, size_t w, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = w < size ? vsnprintf(buf + w, size - w, fmt, ap) : vsnprintf(nullptr, 0, fmt, ap);
+    va_end(ap);
+    return w + (n > 0 ? n : 0);
+}
+
+/**
+ * @brief Write one op's object (with its leading comma)
+ * @return Length of the whole object; it did not fit if that is >= size
+ */
+static size_t formatOpJson(char* buf, size_t size, int i, bool withBuckets) {
+    LatencyId id = (LatencyId)i;
+    const LatencyHistogram& h = histograms[i];
+    size_t w = appendf(buf, size, 0,
+        "%s\"%s\":{\"n\":%u,\"mean_us\":%u,\"max_us\":%u,\"p50_us\":%u,"
+        "\"p90_us\":%u,\"p99_us\":%u,\"slow\":%u",
+        i ? "," : "", LATENCY_NAMES[i], (unsigned int)h.count,
+        (unsigned int)(h.count ? h.sumUs / h.count : 0), (unsigned int)h.maxUs,
+        (unsigned int)latencyPercentile(id, 50), (unsigned int)latencyPercentile(id, 90),
+        (unsigned int)latencyPercentile(id, 99),
+        (unsigned int)latencyCountAbove(id, LAT_SLOW_LOOP_US));
+
+    if (withBuckets) {
+        w = appendf(buf, size, w, ",\"b\":[");
+        bool first = true;
+        for (uint16_t b = 0; b < LAT_BUCKETS; b++) {
+            if (h.buckets[b] == 0) continue;
+            w = appendf(buf, size, w, "%s[%u,%u]", first ? "" : ",",
+                        (unsigned int)latencyBucketLow(b), (unsigned int)h.buckets[b]);
+            first = false;
+        }
+        w = appendf(buf, size, w, "]");
+    }
+    return appendf(buf, size, w, "}");
+}
+
+size_t formatLatencyJson(char* buf, size_t size, bool withBuckets) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size, "{\"uptime_s\":%u,\"record_ns\":%u,\"ops\":{",
+                        (unsigned int)(millis() / 1000), (unsigned int)recordNs);
+
+    // Summaries come first: an op gets its buckets only if every later
+    // summary and the closing "}}" still fit after them. Output stops
+    // before a summary that does not fit, so it is always complete JSON.
+    size_t summaries = 0;
+    for (int i = 0; i < LAT_COUNT; i++) summaries += formatOpJson(nullptr, 0, i, false);
+
+    const size_t tail = 3;
+    for (int i = 0; i < LAT_COUNT && w + tail < size; i++) {
+        size_t own = formatOpJson(nullptr, 0, i, false);
+        size_t rest = summaries - own;
+        summaries = rest;
+
+        if (withBuckets && w + tail + rest < size) {
+            size_t room = size - w - tail - rest;
+            size_t n = formatOpJson(buf + w, room, i, true);
+            if (n < room) {
+                w += n;
+                continue;
+            }
+        }
+        size_t room = size - w - tail;
+        size_t n = formatOpJson(buf + w, room, i, false);
+        if (n >= room) break;
+        w += n;
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "}}");
+    return w < size ? w : size - 1;
+}
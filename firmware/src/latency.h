@@ -0,0 +1,138 @@
+/**
+ * @file latency.h
+ * @brief Fixed-bucket log-linear latency histograms
+ *
+ * Each instrumented operation has one histogram of microsecond durations.
+ * Buckets are log-linear: 4 linear sub-buckets per power of two, so any
+ * recorded value is within 25% of its bucket bound, from 1 us up to
+ * ~2 minutes, in LAT_BUCKETS counters. Recording is a count-leading-zeros
+ * and three increments - no floating point, no allocation, no locks.
+ * Each histogram is meant to have a single writer task.
+ *
+ * Durations come from micros() (esp_timer, 64-bit underneath). The CPU
+ * cycle counter would give finer resolution but wraps every ~18 s at
+ * 240 MHz, which a GPRS publish can exceed; it is used instead to measure
+ * the cost of recording itself (reported as record_ns).
+ *
+ * Usage:
+ *   { LatencyScope t(LAT_SENSOR_READ); data = readAllSensors(); }
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// HISTOGRAM CONFIGURATION
+// =============================================================================
+
+#define LAT_SUB_BITS     2                      ///< log2(sub-buckets per octave)
+#define LAT_SUB_COUNT    (1 << LAT_SUB_BITS)
+#define LAT_MAX_MSB      26                     ///< Top octave: 2^26 us (~67 s)
+#define LAT_BUCKETS      ((LAT_MAX_MSB - LAT_SUB_BITS + 2) * LAT_SUB_COUNT)
+#define LAT_SLOW_LOOP_US 100000UL               ///< "Slow pass" threshold
+
+// Worst-case formatLatencyJson() output: every bucket of every op non-empty
+#define LAT_JSON_OP_MAX     224                 ///< One op's summary fields
+#define LAT_JSON_BUCKET_MAX 24                  ///< One ",[low_us,count]" pair
+#define LAT_JSON_MAX        (64 + LAT_COUNT * (LAT_JSON_OP_MAX + LAT_BUCKETS * LAT_JSON_BUCKET_MAX))
+
+/**
+ * @brief Instrumented operations
+ */
+enum LatencyId {
+    LAT_SENSOR_READ = 0,  ///< readAllSensors()
+    LAT_PUBLISH,          ///< publishSensorData(), one reading
+    LAT_PUBLISH_CYCLE,    ///< Publish job: transport + connect + flush buffer
+    LAT_MQTT_CONNECT,     ///< connectMQTT() when a connect is attempted
+    LAT_SMS_CHECK,        ///< checkIncomingSMS()
+    LAT_NET_PASS,         ///< One network task pass (excluding idle wait)
+    LAT_UI_PASS,          ///< One loop() pass (excluding delay)
+    LAT_CONTROL_CMD,      ///< Control command queued until its tick wrote the relays
+    LAT_CONTROL_TICK,     ///< One controlTick()
+    LAT_THERMO_STEP,      ///< One outlet temperature loop step
+    LAT_THERMO_JITTER,    ///< Loop period error, |actual - THERMO_PERIOD_MS|
+    LAT_COUNT             ///< Must be last - used for array sizing
+};
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+struct LatencyHistogram {
+    uint32_t buckets[LAT_BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t sumUs;
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Bucket index for a duration (values past the top octave clamp)
+ */
+static inline uint16_t latencyBucket(uint32_t us) {
+    if (us < LAT_SUB_COUNT) return (uint16_t)us;
+    uint32_t msb = 31 - __builtin_clz(us);
+    if (msb > LAT_MAX_MSB) return LAT_BUCKETS - 1;
+    uint32_t sub = (us >> (msb - LAT_SUB_BITS)) & (LAT_SUB_COUNT - 1);
+    return (uint16_t)((msb - LAT_SUB_BITS + 1) * LAT_SUB_COUNT + sub);
+}
+
+/**
+ * @brief Smallest duration that falls in a bucket
+ */
+uint32_t latencyBucketLow(uint16_t bucket);
+
+/**
+ * @brief Record one duration
+ */
+void latencyRecord(LatencyId id, uint32_t us);
+
+/**
+ * @brief Duration at or below which pct percent of samples fall
+ * @return Upper bound of the bucket containing the percentile (0 if empty)
+ */
+uint32_t latencyPercentile(LatencyId id, float pct);
+
+/**
+ * @brief Number of samples above a threshold (bucket resolution)
+ */
+uint32_t latencyCountAbove(LatencyId id, uint32_t us);
+
+const LatencyHistogram& getLatencyHistogram(LatencyId id);
+
+const char* getLatencyName(LatencyId id);
+
+/**
+ * @brief Measure the cost of latencyRecord() with the cycle counter
+ * @note Call once at boot; records into and then clears a scratch histogram
+ */
+void initLatency();
+
+/**
+ * @brief Write summaries (count, mean, max, p50/p90/p99, slow count) as JSON
+ * @param withBuckets Also include non-empty buckets as [low_us, count] pairs
+ * @return Characters written (at most size - 1)
+ * @note Always complete JSON once size fits the header: an op's buckets
+ *       are left out when they do not fit, then the remaining ops.
+ *       LAT_JSON_MAX holds everything.
+ */
+size_t formatLatencyJson(char* buf, size_t size, bool withBuckets);
+
+/**
+ * @brief Times its own lifetime into one histogram
+ */
+class LatencyScope {
+    LatencyId _id;
+    uint32_t _start;
+public:
+    explicit LatencyScope(LatencyId id) : _id(id), _start(micros()) {}
+    ~LatencyScope() { latencyRecord(_id, micros() - _start); }
+};
+
+#endif // LATENCY_H
@@ -0,0 +1,136 @@
+/**
+ * @file led.cpp
+ * @brief Status LED pattern driver implementation
+ */
+
+#include "led.h"
+#include "events.h"
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <atomic>
+
+// =============================================================================
+// PATTERNS
+// =============================================================================
+
+static const LedPattern PATTERNS[LED_STATE_COUNT] = {
+    {1000,   0, 1,    0},   // OTA: steady on
+    { 125, 125, 1,  125},   // ALERT: fast flash (4 Hz)
+    { 500, 500, 1,  500},   // PORTAL: slow flash (1 Hz)
+    { 100, 100, 1,  100},   // BOOTING: flicker (5 Hz)
+    {  50, 200, 3, 2500},   // OFFLINE: triple blink
+    {  50, 200, 2, 2700},   // GPRS: double blink
+    {  50,   0, 1, 2950},   // WIFI: single blink
+};
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static esp_timer_handle_t ledTimer = nullptr;
+static std::atomic<uint32_t> activeMask(0);  ///< Bit per LedState
+
+// Timer callback only
+static uint8_t playing = LED_STATE_COUNT;
+static uint8_t phase = 0;
+
+// EVT_ALERT: sensor alerts on the sensing task, ALERT_MEMORY on the network task
+static std::atomic<uint32_t> alertTypes(0);
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint8_t topState(uint32_t mask) {
+    return mask ? (uint8_t)__builtin_ctz(mask) : LED_STATE_COUNT;
+}
+
+/**
+ * @brief Play one LED edge and arm the timer for the next
+ *
+ * Runs on the esp_timer task. Picks up a changed top state at the next
+ * edge; ledSet() forces an early edge so the switch is immediate.
+ */
+static void onLedTimer(void* arg) {
+    uint8_t want = topState(activeMask.load());
+    if (want != playing) {
+        playing = want;
+        phase = 0;
+    }
+
+    if (playing >= LED_STATE_COUNT) {
+        digitalWrite(PIN_STATUS_LED, LOW);
+        return;
+    }
+
+    const LedPattern& p = PATTERNS[playing];
+    if (p.offMs == 0 && p.pauseMs == 0) {
+        digitalWrite(PIN_STATUS_LED, HIGH);  // Steady: no further edges
+        return;
+    }
+
+    bool on = (phase & 1) == 0;
+    uint8_t segments = p.count * 2;
+    uint32_t ms = on ? p.onMs : (phase == segments - 1 ? p.pauseMs : p.offMs);
+    digitalWrite(PIN_STATUS_LED, on ? HIGH : LOW);
+    phase = (phase + 1) % segments;
+    esp_timer_start_once(ledTimer, (uint64_t)ms * 1000);
+}
+
+/**
+ * @brief Restart the pattern now
+ * @note If the callback re-arms concurrently the start fails and the new
+ *       pattern begins at the next scheduled edge instead
+ */
+static void kick() {
+    if (ledTimer == nullptr) return;
+    esp_timer_stop(ledTimer);
+    esp_timer_start_once(ledTimer, 1);
+}
+
+static void onTransportEvent(const Event& ev, void* ctx) {
+    ledSet(LED_WIFI, ev.transport.conn == CONN_WIFI);
+    ledSet(LED_GPRS, ev.transport.conn == CONN_GPRS);
+    ledSet(LED_OFFLINE, ev.transport.conn == CONN_NONE);
+}
+
+static void onAlertEvent(const Event& ev, void* ctx) {
+    uint32_t bit = 1UL << ev.alert.type;
+    uint32_t types = ev.alert.level == ALERT_OK ? alertTypes.fetch_and(~bit) & ~bit
+                                                : alertTypes.fetch_or(bit) | bit;
+    ledSet(LED_ALERT, types != 0);
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void initLed() {
+    pinMode(PIN_STATUS_LED, OUTPUT);
+    digitalWrite(PIN_STATUS_LED, LOW);
+#if SOC_GPIO_SUPPORT_SLP_SWITCH
+    // Keep the driven level through light sleep
+    gpio_sleep_sel_dis((gpio_num_t)PIN_STATUS_LED);
+#endif
+
+    esp_timer_create_args_t args = {};
+    args.callback = onLedTimer;
+    args.name = "led";
+    esp_timer_create(&args, &ledTimer);
+
+    activeMask.store((1UL << LED_BOOTING) | (1UL << LED_OFFLINE));
+    subscribeEvent(EVT_TRANSPORT, onTransportEvent);
+    subscribeEvent(EVT_ALERT, onAlertEvent);
+    kick();
+}
+
+void ledSet(LedState state, bool active) {
+    if (state >= LED_STATE_COUNT) return;
+
+    uint32_t bit = 1UL << state;
+    uint32_t before = active ? activeMask.fetch_or(bit) : activeMask.fetch_and(~bit);
+    uint32_t after = active ? (before | bit) : (before & ~bit);
+    if (topState(before) != topState(after)) {
+        kick();
+    }
+}
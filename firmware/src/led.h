@@ -0,0 +1,62 @@
+/**
+ * @file led.h
+ * @brief Non-blocking status LED pattern driver
+ *
+ * The status LED plays a blink pattern for the most important active
+ * state. Patterns are stepped by a one-shot esp_timer re-armed at each
+ * LED edge, so nothing polls or delays. Between edges the chip can
+ * light-sleep.
+ *
+ * Transport and alert states follow the event bus (EVT_TRANSPORT,
+ * EVT_ALERT). Other states are set with ledSet(). Setting a state is a
+ * few atomic operations. A change of the displayed pattern restarts it
+ * immediately.
+ */
+
+#ifndef LED_H
+#define LED_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+/**
+ * @brief LED states, highest display priority first
+ */
+enum LedState {
+    LED_OTA = 0,    ///< Firmware update in progress (reserved for the updater)
+    LED_ALERT,      ///< Any alert at warning or critical
+    LED_PORTAL,     ///< Provisioning AP up
+    LED_BOOTING,    ///< setup() running
+    LED_OFFLINE,    ///< No MQTT transport, readings being buffered
+    LED_GPRS,       ///< MQTT over GPRS
+    LED_WIFI,       ///< MQTT over WiFi
+    LED_STATE_COUNT ///< Must be last - used for array sizing
+};
+
+/**
+ * @brief One blink pattern: count x (on, off), with the last off replaced
+ * by pauseMs. offMs == pauseMs == 0 means steady on.
+ */
+struct LedPattern {
+    uint16_t onMs;
+    uint16_t offMs;
+    uint8_t count;
+    uint16_t pauseMs;
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Configure the LED pin and timer and start the booting pattern
+ * @note Call first thing in setup(); subscribes to the event bus
+ */
+void initLed();
+
+/**
+ * @brief Set or clear a state (any task, never blocks)
+ */
+void ledSet(LedState state, bool active);
+
+#endif // LED_H
@@ -5,37 +5,150 @@
 
 #include "log_capture.h"
 
-LogCapture::LogCapture(HardwareSerial& s) : _serial(s), _head(0) {}
+LogCapture::LogCapture(HardwareSerial& s)
+    : _serial(s), _reserved(0), _committed(0), _published(0),
+      _mirror(nullptr), _mirrorMask(0), _mirrorHead(nullptr),
+      _serialPos(0), _serialDropped(0), _maxWriteUs(0), _drainTask(nullptr) {}
 
 void LogCapture::begin(unsigned long baud) {
     _serial.begin(baud);
+#if LOG_ASYNC_SERIAL
+    xTaskCreate(serialTask, "logtx", LOG_SERIAL_TASK_STACK, this,
+                LOG_SERIAL_TASK_PRIO, &_drainTask);
+#endif
+}
+
+void LogCapture::capture(const uint8_t* buf, size_t size) {
+    if (size == 0) return;
+
+    // Reserve our span; concurrent writers get disjoint spans
+    size_t pos = _reserved.fetch_add(size, std::memory_order_relaxed);
+
+    // Only the tail of an oversized write can survive in the ring
+    size_t skip = size > LOG_RING_SIZE ? size - LOG_RING_SIZE : 0;
+    size_t start = (pos + skip) & LOG_RING_MASK;
+    size_t len = size - skip;
+    size_t first = LOG_RING_SIZE - start;
+    if (first > len) first = len;
+    memcpy(_ring + start, buf + skip, first);
+    if (len > first) {
+        memcpy(_ring, buf + skip + first, len - first);
+    }
+
+    if (_mirror != nullptr) {
+        size_t mskip = size > _mirrorMask ? size - _mirrorMask - 1 : 0;
+        for (size_t i = mskip; i < size; i++) {
+            _mirror[(pos + i) & _mirrorMask] = (char)buf[i];
+        }
+        *_mirrorHead = (uint32_t)(pos + size);
+    }
+
+    // Commit. If every reservation so far has committed, everything up to
+    // that point is complete: publish it (monotonic max).
+    size_t done = _committed.fetch_add(size, std::memory_order_acq_rel) + size;
+    if (done == _reserved.load(std::memory_order_acquire)) {
+        size_t cur = _published.load(std::memory_order_relaxed);
+        while (cur < done &&
+               !_published.compare_exchange_weak(cur, done, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+    }
 }
 
 size_t LogCapture::write(uint8_t c) {
-    _serial.write(c);
-    _ring[_head % LOG_RING_SIZE] = (char)c;
-    _head++;
-    return 1;
+    return write(&c, 1);
 }
 
 size_t LogCapture::write(const uint8_t* buf, size_t size) {
+    uint32_t t0 = micros();
+#if !LOG_ASYNC_SERIAL
     _serial.write(buf, size);
-    for (size_t i = 0; i < size; i++) {
-        _ring[(_head + i) % LOG_RING_SIZE] = (char)buf[i];
-    }
-    _head += size;
+#endif
+    capture(buf, size);
+
+    // Racy max across writers; good enough for a diagnostic
+    uint32_t dt = micros() - t0;
+    if (dt > _maxWriteUs) _maxWriteUs = dt;
     return size;
 }
 
+void LogCapture::flush() {
+#if LOG_ASYNC_SERIAL
+    unsigned long start = millis();
+    while (_serialPos.load(std::memory_order_relaxed) < getHead() &&
+           millis() - start < LOG_FLUSH_TIMEOUT_MS) {
+        delay(1);
+    }
+#endif
+    _serial.flush();
+}
+
+/**
+ * @brief Send the next chunk of published bytes to Serial
+ * @return Bytes written (0 when caught up)
+ * @note Only called from the drain task
+ */
+size_t LogCapture::drainSerial() {
+    char chunk[LOG_SERIAL_CHUNK];
+    size_t pos = _serialPos.load(std::memory_order_relaxed);
+    size_t from = pos;
+    size_t n = copyOut(chunk, sizeof(chunk), from);
+
+    // copyOut() skips ahead past anything writers have overwritten
+    _serialDropped += from - pos;
+    if (n > 0) {
+        _serial.write((const uint8_t*)chunk, n);
+    }
+    _serialPos.store(from + n, std::memory_order_relaxed);
+    return n;
+}
+
+void LogCapture::serialTask(void* arg) {
+    LogCapture* self = (LogCapture*)arg;
+    uint32_t idleMs = LOG_SERIAL_POLL_MS;
+    for (;;) {
+        if (self->drainSerial() > 0) {
+            idleMs = LOG_SERIAL_POLL_MS;
+            continue;
+        }
+        // Back off while quiet so the drain task does not keep the chip
+        // out of light sleep
+        vTaskDelay(pdMS_TO_TICKS(idleMs));
+        if (idleMs < LOG_SERIAL_IDLE_MAX_MS) idleMs *= 2;
+    }
+}
+
+void LogCapture::setMirror(char* buf, size_t size, volatile uint32_t* head) {
+    _mirrorMask = size - 1;
+    _mirrorHead = head;
+    _mirror = buf;
+}
+
 size_t LogCapture::getHead() {
-    return _head;
+    return _published.load(std::memory_order_acquire);
 }
 
-size_t LogCapture::readLog(char* out, size_t outSize, size_t fromPos) {
-    size_t head = _head;
+LogCaptureStats LogCapture::getStats() {
+    LogCaptureStats st;
+    size_t head = getHead();
+    size_t pos = _serialPos.load(std::memory_order_relaxed);
+    st.dropped = _serialDropped;
+    st.backlog = head > pos ? (uint32_t)(head - pos) : 0;
+    st.maxWriteUs = _maxWriteUs;
+    return st;
+}
+
+/**
+ * @brief Copy up to n published bytes starting at fromPos
+ * @param fromPos In: requested start. Out: actual start, moved forward
+ *        past any bytes already overwritten by writers
+ * @return Bytes copied
+ */
+size_t LogCapture::copyOut(char* out, size_t n, size_t& fromPos) {
+    size_t head = _published.load(std::memory_order_acquire);
 
     // Nothing new
-    if (fromPos >= head) return 0;
+    if (fromPos >= head || n == 0) return 0;
 
     size_t available = head - fromPos;
 
@@ -45,15 +158,40 @@ size_t LogCapture::readLog(char* out, size_t outSize, size_t fromPos) {
         available = LOG_RING_SIZE;
     }
 
-    // Clamp to output buffer size (leave room for null terminator)
     size_t toRead = available;
-    if (toRead > outSize - 1) toRead = outSize - 1;
+    if (toRead > n) toRead = n;
+
+    // Copy bytes from ring buffer in at most two segments
+    size_t start = fromPos & LOG_RING_MASK;
+    size_t first = LOG_RING_SIZE - start;
+    if (first > toRead) first = toRead;
+    memcpy(out, _ring + start, first);
+    if (toRead > first) {
+        memcpy(out + first, _ring, toRead - first);
+    }
 
-    // Copy bytes from ring buffer, handling wrap
-    for (size_t i = 0; i < toRead; i++) {
-        out[i] = _ring[(fromPos + i) % LOG_RING_SIZE];
+    // Writers may have lapped us while copying; drop any clobbered prefix
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t reserved = _reserved.load(std::memory_order_acquire);
+    if (reserved > fromPos + LOG_RING_SIZE) {
+        size_t lost = reserved - LOG_RING_SIZE - fromPos;
+        if (lost >= toRead) {
+            toRead = 0;
+        } else {
+            memmove(out, out + lost, toRead - lost);
+            toRead -= lost;
+        }
+        fromPos += lost;
     }
-    out[toRead] = '\0';
 
     return toRead;
 }
+
+size_t LogCapture::readLog(char* out, size_t outSize, size_t fromPos) {
+    if (outSize == 0) return 0;
+
+    // Leave room for the null terminator
+    size_t n = copyOut(out, outSize - 1, fromPos);
+    out[n] = '\0';
+    return n;
+}
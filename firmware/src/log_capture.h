@@ -5,26 +5,96 @@
  * Replaces direct Serial usage across the codebase. Every byte written
  * goes to the real HardwareSerial AND a 4KB ring buffer that the
  * dashboard log viewer reads via /api/log.
+ *
+ * The ring is lock-free and safe for concurrent writers on either core:
+ * each write() reserves its span with an atomic fetch-add, copies in at
+ * most two memcpy segments, then commits. Readers only see bytes up to
+ * the published mark, which advances when every reserved span below it
+ * has committed, so a write is never observed half-copied.
+ *
+ * With LOG_ASYNC_SERIAL the Serial copy is also taken from the ring: a
+ * low-priority task drains published bytes to the UART, so callers never
+ * block on a full TX FIFO. If the UART falls more than a ring behind, the
+ * lapped bytes are skipped and counted in LogCaptureStats::dropped.
  */
 
 #ifndef LOG_CAPTURE_H
 #define LOG_CAPTURE_H
 
 #include <Arduino.h>
+#include <atomic>
+#include "../config.h"
 
 #define LOG_RING_SIZE 4096
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+#define LOG_SERIAL_TASK_STACK 2048  ///< Drain task stack (bytes)
+#define LOG_SERIAL_TASK_PRIO  1     ///< Same as loop(); it mostly sleeps
+#define LOG_SERIAL_CHUNK      128   ///< Bytes per UART write (one FIFO)
+#define LOG_SERIAL_POLL_MS    5     ///< Poll period right after output
+#define LOG_SERIAL_IDLE_MAX_MS 160  ///< Poll period after a quiet spell
+#define LOG_FLUSH_TIMEOUT_MS  500   ///< flush() gives up after this
+
+static_assert((LOG_RING_SIZE & LOG_RING_MASK) == 0, "LOG_RING_SIZE must be a power of two");
+
+/**
+ * @brief Logging cost and loss counters
+ */
+struct LogCaptureStats {
+    uint32_t dropped;     ///< Bytes never sent to Serial (UART lapped by the ring)
+    uint32_t backlog;     ///< Bytes published but not yet sent to Serial
+    uint32_t maxWriteUs;  ///< Slowest single write() seen by a caller
+};
 
 class LogCapture : public Print {
     HardwareSerial& _serial;
     char _ring[LOG_RING_SIZE];
-    volatile size_t _head;   // next write position (monotonic)
+    std::atomic<size_t> _reserved;   // next free position (monotonic)
+    std::atomic<size_t> _committed;  // total bytes fully copied in
+    std::atomic<size_t> _published;  // readers may read up to here
+    char* _mirror;                   // optional tail copy (e.g. RTC memory)
+    size_t _mirrorMask;
+    volatile uint32_t* _mirrorHead;
+    std::atomic<size_t> _serialPos;  // next byte to send to Serial
+    uint32_t _serialDropped;
+    uint32_t _maxWriteUs;
+    TaskHandle_t _drainTask;
+
+    void capture(const uint8_t* buf, size_t size);
+    size_t copyOut(char* out, size_t n, size_t& fromPos);
+    size_t drainSerial();
+    static void serialTask(void* arg);
 public:
     LogCapture(HardwareSerial& s);
     void begin(unsigned long baud);
     size_t write(uint8_t c) override;
     size_t write(const uint8_t* buf, size_t size) override;
+
+    /**
+     * @brief Wait (bounded) until queued output has reached the UART
+     */
+    void flush() override;
+
     size_t getHead();
     size_t readLog(char* out, size_t outSize, size_t fromPos);
+
+    /**
+     * @brief Also copy every write into a second, smaller ring
+     * @param buf Mirror storage (size must be a power of two)
+     * @param size Mirror size in bytes
+     * @param head Receives the total bytes written after each write
+     */
+    void setMirror(char* buf, size_t size, volatile uint32_t* head);
+
+    /**
+     * @brief Drop and write-latency counters since boot
+     */
+    LogCaptureStats getStats();
+
+    /**
+     * @brief Serial drain task (nullptr without LOG_ASYNC_SERIAL)
+     */
+    TaskHandle_t drainTask() const { return _drainTask; }
 };
 
 #endif // LOG_CAPTURE_H
@@ -0,0 +1,70 @@
+/**
+ * @file log_level.cpp
+ * @brief Runtime per-module log level state
+ */
+
+#include "log_level.h"
+#include <strings.h>
+
+uint8_t logModuleLevel[LOG_MOD_COUNT] = {
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL,
+    LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL
+};
+
+static_assert(LOG_MOD_COUNT == 11, "Update logModuleLevel and MODULE_NAMES");
+
+static const char* const MODULE_NAMES[LOG_MOD_COUNT] = {
+    "MAIN", "SENSORS", "ALERTS", "BUFFER", "MQTT", "GSM", "WIFI", "PROV", "DASH", "CFG", "CTRL"
+};
+
+static const char* const LEVEL_NAMES[] = {
+    "none", "error", "warn", "info", "debug", "verbose"
+};
+
+void setLogLevel(LogModule mod, uint8_t level) {
+    if (level > LOG_LEVEL_VERBOSE) level = LOG_LEVEL_VERBOSE;
+    if (mod >= LOG_MOD_COUNT) {
+        for (int i = 0; i < LOG_MOD_COUNT; i++) {
+            logModuleLevel[i] = level;
+        }
+        return;
+    }
+    logModuleLevel[mod] = level;
+}
+
+int parseLogModule(const char* name) {
+    if (name == nullptr) return -1;
+    if (strcmp(name, "*") == 0) return LOG_MOD_COUNT;
+    for (int i = 0; i < LOG_MOD_COUNT; i++) {
+        if (strcasecmp(name, MODULE_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int parseLogLevel(const char* name) {
+    if (name == nullptr) return -1;
+    if (name[0] >= '0' && name[0] <= '5' && name[1] == '\0') return name[0] - '0';
+    for (int i = 0; i <= LOG_LEVEL_VERBOSE; i++) {
+        if (strcasecmp(name, LEVEL_NAMES[i]) == 0) return i;
+    }
+    return -1;
+}
+
+const char* getLogModuleName(LogModule mod) {
+    return mod < LOG_MOD_COUNT ? MODULE_NAMES[mod] : "UNKNOWN";
+}
+
+size_t formatLogLevels(char* buffer, size_t bufferSize) {
+    if (bufferSize == 0) return 0;
+
+    size_t w = snprintf(buffer, bufferSize, "{");
+    for (int i = 0; i < LOG_MOD_COUNT && w < bufferSize; i++) {
+        w += snprintf(buffer + w, bufferSize - w, "%s\"%s\":%u",
+                      i ? "," : "", MODULE_NAMES[i], logModuleLevel[i]);
+    }
+    if (w < bufferSize) {
+        w += snprintf(buffer + w, bufferSize - w, "}");
+    }
+    return w < bufferSize ? w : bufferSize - 1;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file log_level.h
+ * @brief Leveled, module-tagged logging macros
+ *
+ * LOG_E/W/I/D/V(MODULE, fmt, ...) log through LOGT() with a "[MODULE] "
+ * prefix. Levels above LOG_COMPILE_LEVEL expand to nothing, so neither
+ * the call nor its arguments are compiled in. Levels that are compiled
+ * in are filtered at runtime per module (before argument evaluation);
+ * the per-module level can be changed over MQTT or the dashboard.
+ *
+ * Usage:
+ *   LOG_I(MQTT, "Connected to %s\n", host);
+ *   LOG_D(SENSORS, "Inlet %.1f\n", t);
+ */
+
+#ifndef LOG_LEVEL_H
+#define LOG_LEVEL_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "log_token.h"
+
+// =============================================================================
+// LEVELS AND MODULES
+// =============================================================================
+
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_WARN    2
+#define LOG_LEVEL_INFO    3
+#define LOG_LEVEL_DEBUG   4
+#define LOG_LEVEL_VERBOSE 5
+
+/**
+ * @brief Log source modules (names match the "[TAG]" prefixes)
+ */
+enum LogModule {
+    LOG_MOD_MAIN = 0,
+    LOG_MOD_SENSORS,
+    LOG_MOD_ALERTS,
+    LOG_MOD_BUFFER,
+    LOG_MOD_MQTT,
+    LOG_MOD_GSM,
+    LOG_MOD_WIFI,
+    LOG_MOD_PROV,
+    LOG_MOD_DASH,
+    LOG_MOD_CFG,
+    LOG_MOD_CTRL,
+    LOG_MOD_COUNT  ///< Must be last - used for array sizing
+};
+
+/** @brief Runtime level per module; messages above it are skipped */
+extern uint8_t logModuleLevel[LOG_MOD_COUNT];
+
+// =============================================================================
+// MACROS
+// =============================================================================
+
+#define LOG_AT(level, mod, fmt, ...)                                  \
+    do {                                                              \
+        if ((level) <= logModuleLevel[LOG_MOD_##mod]) {               \
+            LOGT("[" #mod "] " fmt, ##__VA_ARGS__);                   \
+        }                                                             \
+    } while (0)
+
+#define LOG_NOP(...) do {} while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(mod, fmt, ...) LOG_AT(LOG_LEVEL_ERROR, mod, fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(...) LOG_NOP()
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(mod, fmt, ...) LOG_AT(LOG_LEVEL_WARN, mod, fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(...) LOG_NOP()
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(mod, fmt, ...) LOG_AT(LOG_LEVEL_INFO, mod, fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(...) LOG_NOP()
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(mod, fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, mod, fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(...) LOG_NOP()
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOG_V(mod, fmt, ...) LOG_AT(LOG_LEVEL_VERBOSE, mod, fmt, ##__VA_ARGS__)
+#else
+#define LOG_V(...) LOG_NOP()
+#endif
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Set the runtime level of one module, or all if mod == LOG_MOD_COUNT
+ */
+void setLogLevel(LogModule mod, uint8_t level);
+
+/**
+ * @brief Parse a module tag ("MQTT", case-insensitive; "*" = all)
+ * @return Module, LOG_MOD_COUNT for "*", or -1 if unknown
+ */
+int parseLogModule(const char* name);
+
+/**
+ * @brief Parse a level name ("debug") or digit ("4")
+ * @return Level 0-5, or -1 if unknown
+ */
+int parseLogLevel(const char* name);
+
+/**
+ * @brief Get the tag of a module
+ */
+const char* getLogModuleName(LogModule mod);
+
+/**
+ * @brief Write current levels as JSON, e.g. {"MAIN":3,"MQTT":4,...}
+ * @return Characters written (clamped to bufferSize - 1)
+ */
+size_t formatLogLevels(char* buffer, size_t bufferSize);
+
+#endif // LOG_LEVEL_H
@@ -0,0 +1,48 @@
+/**
+ * @file log_token.cpp
+ * @brief Tokenized log frame encoder
+ */
+
+#include "log_token.h"
+
+#define ARGC_OFFSET 5   ///< 0x1E | id:u32 | argc
+
+LogTokenFrame::LogTokenFrame(uint32_t id) : _len(0), _mark(0), _argc(0), _overflow(false) {
+    put(LOG_TOKEN_FRAME_START);
+    put((uint8_t)id);
+    put((uint8_t)(id >> 8));
+    put((uint8_t)(id >> 16));
+    put((uint8_t)(id >> 24));
+    put(0);
+}
+
+void LogTokenFrame::end() {
+    if (_overflow) {
+        // A partial argument would desync the decoder: drop it whole
+        _len = _mark;
+        _buf[ARGC_OFFSET] = _argc | LOG_TOKEN_TRUNCATED;
+        return;
+    }
+    _buf[ARGC_OFFSET] = ++_argc;
+}
+
+void LogTokenFrame::putFloat(float v) {
+    if (!begin('f')) return;
+    uint8_t raw[sizeof(float)];
+    memcpy(raw, &v, sizeof(raw));
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        put(raw[i]);
+    }
+    end();
+}
+
+void LogTokenFrame::putString(const char* s) {
+    if (!begin('s')) return;
+    if (s == nullptr) s = "";
+    size_t n = strnlen(s, LOG_TOKEN_MAX_STR);
+    put((uint8_t)n);
+    for (size_t i = 0; i < n; i++) {
+        put((uint8_t)s[i]);
+    }
+    end();
+}
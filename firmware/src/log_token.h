@@ -0,0 +1,180 @@
+/**
+ * @file log_token.h
+ * @brief Tokenized, deferred-format logging
+ *
+ * LOGT(fmt, ...) logs a printf-style message. With LOG_TOKENIZED set in
+ * config.h, the text is never formatted on the device: the format string
+ * is replaced by a compile-time 32-bit ID and only the ID plus the binary
+ * arguments are written (to Serial and the LogCapture ring) as one frame.
+ * tools/log_decode.py rebuilds the text using the format strings found in
+ * the firmware image. With LOG_TOKENIZED off, LOGT is a plain Log.printf().
+ *
+ * Frame layout (little-endian):
+ *   0x1E | id:u32 | argc:u8 | argc x (tag:u8 | payload)
+ * Tags: 'i' zigzag varint, 'u' varint, 'f' float32, 's' len:u8 + bytes.
+ * Varints carry up to 64 bits, so (unsigned) long long arguments are kept
+ * whole; 32-bit values encode to the same bytes either way.
+ *
+ * An argument that does not fit in LOG_TOKEN_MAX_FRAME is dropped with
+ * every argument after it, and argc then has LOG_TOKEN_TRUNCATED set: it
+ * counts the arguments actually in the frame, so the frame always parses.
+ *
+ * Every format string is also stored in flash prefixed with "\x1FLF" so the
+ * decoder can locate and hash it without a separate string table.
+ *
+ * @note Format strings must be literals under ~500 characters (the hash is
+ *       evaluated recursively at compile time).
+ */
+
+#ifndef LOG_TOKEN_H
+#define LOG_TOKEN_H
+
+#include <Arduino.h>
+#include <type_traits>
+#include "../config.h"
+#include "log_capture.h"
+
+#define LOG_TOKEN_FRAME_START 0x1E   ///< ASCII record separator
+#define LOG_TOKEN_MAX_FRAME   192    ///< Frame bytes; arguments past it are dropped
+#define LOG_TOKEN_TRUNCATED   0x80   ///< argc flag: trailing arguments were dropped
+#define LOG_TOKEN_MAX_STR     48     ///< Max bytes kept per string argument
+
+extern LogCapture Log;
+
+// =============================================================================
+// COMPILE-TIME FORMAT ID
+// =============================================================================
+
+/**
+ * @brief FNV-1a 32-bit hash, usable in constant expressions (C++11)
+ */
+constexpr uint32_t logTokenHash(const char* s, uint32_t h = 2166136261UL) {
+    return *s == '\0' ? h : logTokenHash(s + 1, (h ^ (uint8_t)*s) * 16777619UL);
+}
+
+// =============================================================================
+// FRAME ENCODER
+// =============================================================================
+
+/**
+ * @brief Fixed-size binary frame for one tokenized log call
+ */
+class LogTokenFrame {
+    uint8_t _buf[LOG_TOKEN_MAX_FRAME];
+    size_t _len;
+    size_t _mark;        ///< Frame length before the argument being written
+    uint8_t _argc;
+    bool _overflow;      ///< An argument did not fit; no more are written
+
+    void put(uint8_t b) {
+        if (_len < sizeof(_buf)) _buf[_len++] = b;
+        else _overflow = true;
+    }
+    void putVarint(uint32_t v) {
+        while (v >= 0x80) {
+            put((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        put((uint8_t)v);
+    }
+    void putVarint64(uint64_t v) {
+        while (v >= 0x80) {
+            put((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        put((uint8_t)v);
+    }
+    /** @brief Start an argument; false once one has been dropped */
+    bool begin(uint8_t tag) {
+        if (_overflow) return false;
+        _mark = _len;
+        put(tag);
+        return true;
+    }
+    /** @brief Keep the argument whole or drop it and close the frame */
+    void end();
+public:
+    explicit LogTokenFrame(uint32_t id);
+
+    void putSigned(int32_t v) {
+        if (begin('i')) { putVarint(((uint32_t)v << 1) ^ (uint32_t)(v >> 31)); end(); }
+    }
+    void putUnsigned(uint32_t v) {
+        if (begin('u')) { putVarint(v); end(); }
+    }
+    void putSigned64(int64_t v) {
+        if (begin('i')) { putVarint64(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); end(); }
+    }
+    void putUnsigned64(uint64_t v) {
+        if (begin('u')) { putVarint64(v); end(); }
+    }
+    void putFloat(float v);
+    void putString(const char* s);
+
+    // One overload per fundamental type, so fixed-width typedefs always
+    // resolve regardless of how the toolchain defines int32_t
+    void arg(bool v)               { putUnsigned(v); }
+    void arg(char v)               { putSigned(v); }
+    void arg(signed char v)        { putSigned(v); }
+    void arg(unsigned char v)      { putUnsigned(v); }
+    void arg(short v)              { putSigned(v); }
+    void arg(unsigned short v)     { putUnsigned(v); }
+    void arg(int v)                { putSigned(v); }
+    void arg(unsigned int v)       { putUnsigned(v); }
+    // long is 32 bits on the ESP32 and 64 on LP64 hosts
+    void arg(long v) {
+        if (sizeof(long) > 4) putSigned64(v);
+        else putSigned((int32_t)v);
+    }
+    void arg(unsigned long v) {
+        if (sizeof(long) > 4) putUnsigned64(v);
+        else putUnsigned((uint32_t)v);
+    }
+    void arg(long long v)          { putSigned64(v); }
+    void arg(unsigned long long v) { putUnsigned64(v); }
+    void arg(float v)              { putFloat(v); }
+    void arg(double v)             { putFloat((float)v); }
+    void arg(const char* s)        { putString(s); }
+    void arg(const String& s)      { putString(s.c_str()); }
+
+    /** @brief Arguments in the frame */
+    uint8_t argc() const { return _argc; }
+    /** @brief True if trailing arguments were dropped */
+    bool truncated() const { return _overflow; }
+    const uint8_t* data() const { return _buf; }
+    size_t size() const { return _len; }
+};
+
+/**
+ * @brief Encode one call's arguments and write the frame in a single write()
+ */
+template <typename... Args>
+void logTokenEmit(uint32_t id, const Args&... args) {
+    static_assert(sizeof...(args) < LOG_TOKEN_TRUNCATED, "too many LOGT arguments");
+    LogTokenFrame frame(id);
+    int expand[] = {0, (frame.arg(args), 0)...};
+    (void)expand;
+    Log.write(frame.data(), frame.size());
+}
+
+// =============================================================================
+// LOGGING MACRO
+// =============================================================================
+
+#if LOG_TOKENIZED
+
+#define LOGT(fmt, ...)                                                          \
+    do {                                                                        \
+        __attribute__((used)) static const char logtFmt_[] = "\x1F" "LF" fmt;  \
+        (void)logtFmt_;                                                         \
+        logTokenEmit(std::integral_constant<uint32_t, logTokenHash(fmt)>::value, \
+                     ##__VA_ARGS__);                                            \
+    } while (0)
+
+#else
+
+#define LOGT(fmt, ...) Log.printf(fmt, ##__VA_ARGS__)
+
+#endif
+
+#endif // LOG_TOKEN_H
@@ -0,0 +1,251 @@
+/**
+ * @file memstats.cpp
+ * @brief Memory telemetry implementation
+ */
+
+#include "memstats.h"
+#include "globals.h"
+#include "alerts.h"
+#include <esp_heap_caps.h>
+#include <atomic>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static MemSample latest = {0, 0, 0, 0, 0, 0};
+static AlertLevel alertLevel = ALERT_OK;
+
+static MemTaskStack tasks[MEM_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+static MemTrendPoint trend[MEM_TREND_LEN];
+static uint8_t trendHead = 0;     ///< Next slot to write
+static uint8_t trendCount = 0;
+static MemTrendPoint interval;    ///< Worst values so far in this interval
+static uint32_t intervalStartMs = 0;
+
+// Written by whichever task's allocation failed
+static std::atomic<uint32_t> allocFailures(0);
+static std::atomic<uint32_t> largestFailedAlloc(0);
+static uint32_t failuresSeen = 0;  ///< allocFailures at the previous sample
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+/**
+ * @brief Allocator callback; runs on the failing task, must stay short
+ */
+static void onAllocFailed(size_t size, uint32_t caps, const char* functionName) {
+    allocFailures.fetch_add(1, std::memory_order_relaxed);
+    uint32_t prev = largestFailedAlloc.load(std::memory_order_relaxed);
+    while (size > prev &&
+           !largestFailedAlloc.compare_exchange_weak(prev, (uint32_t)size, std::memory_order_relaxed)) {
+    }
+}
+
+static MemSample readHeap() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+
+    MemSample s;
+    s.freeBytes = (uint32_t)info.total_free_bytes;
+    s.largestBlock = (uint32_t)info.largest_free_block;
+    s.minEverFree = (uint32_t)info.minimum_free_bytes;
+    s.allocatedBlocks = (uint16_t)(info.allocated_blocks < 0xFFFF ? info.allocated_blocks : 0xFFFF);
+    s.freeBlocks = (uint16_t)(info.free_blocks < 0xFFFF ? info.free_blocks : 0xFFFF);
+    s.fragPct = s.freeBytes ? (uint8_t)(100 - (uint64_t)s.largestBlock * 100 / s.freeBytes) : 0;
+    return s;
+}
+
+static void resetInterval() {
+    interval.uptimeS = 0;
+    interval.minFree = UINT32_MAX;
+    interval.minLargest = UINT32_MAX;
+    interval.maxAllocated = 0;
+    interval.maxFragPct = 0;
+    intervalStartMs = millis();
+}
+
+/**
+ * @brief Fold a sample into the interval; close it into the trend when due
+ */
+static void updateTrend(const MemSample& s) {
+    if (s.freeBytes < interval.minFree) interval.minFree = s.freeBytes;
+    if (s.largestBlock < interval.minLargest) interval.minLargest = s.largestBlock;
+    if (s.allocatedBlocks > interval.maxAllocated) interval.maxAllocated = s.allocatedBlocks;
+    if (s.fragPct > interval.maxFragPct) interval.maxFragPct = s.fragPct;
+
+    if ((uint32_t)(millis() - intervalStartMs) < MEM_TREND_INTERVAL_MS) return;
+
+    interval.uptimeS = millis() / 1000;
+    trend[trendHead] = interval;
+    trendHead = (trendHead + 1) % MEM_TREND_LEN;
+    if (trendCount < MEM_TREND_LEN) trendCount++;
+    resetInterval();
+}
+
+static const MemTrendPoint& trendAt(uint8_t i) {
+    return trend[(trendHead + MEM_TREND_LEN - trendCount + i) % MEM_TREND_LEN];
+}
+
+/**
+ * @brief Hours until a trend series falls to floor (-1 if not falling)
+ * @param largest Use minLargest instead of minFree
+ */
+static float projectHours(bool largest, uint32_t floor) {
+    if (trendCount < MEM_TREND_MIN_POINTS) return -1.0f;
+
+    // Least squares in hours since the oldest point (small x: float is fine)
+    float x0 = trendAt(0).uptimeS / 3600.0f;
+    float sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (uint8_t i = 0; i < trendCount; i++) {
+        const MemTrendPoint& p = trendAt(i);
+        float x = p.uptimeS / 3600.0f - x0;
+        float y = (float)(largest ? p.minLargest : p.minFree);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    float n = trendCount;
+    float den = n * sxx - sx * sx;
+    if (den <= 0) return -1.0f;
+    float slope = (n * sxy - sx * sy) / den;  // Bytes per hour
+    if (slope >= 0) return -1.0f;
+
+    const MemTrendPoint& last = trendAt(trendCount - 1);
+    float y = (float)(largest ? last.minLargest : last.minFree);
+    return y <= floor ? 0.0f : (y - floor) / -slope;
+}
+
+/**
+ * @brief Level from the latest sample; a level clears only MEM_HYSTERESIS
+ * past its threshold
+ */
+static AlertLevel evaluate(const MemSample& s, float hoursLeft, bool newFailures,
+                           uint32_t minStackFree) {
+    uint32_t critMargin = alertLevel == ALERT_CRITICAL ? MEM_HYSTERESIS : 0;
+    uint32_t warnMargin = alertLevel != ALERT_OK ? MEM_HYSTERESIS : 0;
+
+    if (newFailures || s.largestBlock < MEM_BLOCK_CRITICAL + critMargin ||
+        s.freeBytes < MEM_FREE_CRITICAL + critMargin) {
+        return ALERT_CRITICAL;
+    }
+    if (s.largestBlock < MEM_BLOCK_WARNING + warnMargin) return ALERT_WARNING;
+    if (hoursLeft >= 0 && hoursLeft < MEM_OOM_HORIZON_H) return ALERT_WARNING;
+    if (minStackFree < MEM_STACK_MIN_FREE) return ALERT_WARNING;
+    return ALERT_OK;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void initMemStats() {
+    heap_caps_register_failed_alloc_callback(onAllocFailed);
+    taskCount = 0;
+    trendHead = 0;
+    trendCount = 0;
+    alertLevel = ALERT_OK;
+    failuresSeen = allocFailures.load(std::memory_order_relaxed);
+    resetInterval();
+    latest = readHeap();
+    Log.printf("[MEM] Heap %u B free, largest block %u B\n",
+               (unsigned int)latest.freeBytes, (unsigned int)latest.largestBlock);
+}
+
+void memRegisterTask(TaskHandle_t handle, const char* name, uint32_t stackBytes) {
+    if (handle == nullptr || taskCount >= MEM_MAX_TASKS) return;
+    tasks[taskCount++] = {handle, name, stackBytes, stackBytes};
+}
+
+void sampleMemStats() {
+    MemSample s = readHeap();
+    latest = s;
+    updateTrend(s);
+
+    // ESP-IDF reports the high-water mark in bytes (StackType_t is uint8_t)
+    uint32_t minStackFree = UINT32_MAX;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        MemTaskStack& t = tasks[i];
+        uint32_t hwm = (uint32_t)uxTaskGetStackHighWaterMark(t.handle);
+        if (hwm < MEM_STACK_MIN_FREE && t.minFreeBytes >= MEM_STACK_MIN_FREE) {
+            Log.printf("[MEM] Task %s stack nearly exhausted: %u of %u B never used\n",
+                       t.name, (unsigned int)hwm, (unsigned int)t.stackBytes);
+        }
+        t.minFreeBytes = hwm;
+        if (hwm < minStackFree) minStackFree = hwm;
+    }
+
+    uint32_t failures = allocFailures.load(std::memory_order_relaxed);
+    bool newFailures = failures != failuresSeen;
+    if (newFailures) {
+        Log.printf("[MEM] %u allocation(s) failed, largest request %u B\n",
+                   (unsigned int)(failures - failuresSeen),
+                   (unsigned int)largestFailedAlloc.load(std::memory_order_relaxed));
+        failuresSeen = failures;
+    }
+
+    float hoursLeft = memHoursToExhaustion();
+    AlertLevel level = evaluate(s, hoursLeft, newFailures, minStackFree);
+    if (level != alertLevel) {
+        Log.printf("[MEM] %s: %u B free, largest block %u B (%u%% fragmented), "
+                   "exhaustion in %.0f h\n",
+                   getAlertLevelName(level), (unsigned int)s.freeBytes,
+                   (unsigned int)s.largestBlock, (unsigned int)s.fragPct, hoursLeft);
+    }
+    alertLevel = level;
+    raiseInternalAlert(ALERT_MEMORY, level, s.largestBlock / 1024.0f);
+}
+
+MemSample getMemSample() {
+    return latest;
+}
+
+float memHoursToExhaustion() {
+    float free = projectHours(false, MEM_FREE_CRITICAL);
+    float largest = projectHours(true, MEM_BLOCK_CRITICAL);
+    if (free < 0) return largest;
+    if (largest < 0) return free;
+    return free < largest ? free : largest;
+}
+
+AlertLevel getMemAlertLevel() {
+    return alertLevel;
+}
+
+size_t formatMemJson(char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    const MemSample& s = latest;
+    size_t w = snprintf(buf, size,
+        "{\"uptime_s\":%u,\"free\":%u,\"largest\":%u,\"min_free\":%u,\"alloc_blocks\":%u,"
+        "\"free_blocks\":%u,\"frag_pct\":%u,\"alloc_failed\":%u,\"hours_left\":%.1f,"
+        "\"level\":\"%s\",\"tasks\":{",
+        (unsigned int)(millis() / 1000), (unsigned int)s.freeBytes,
+        (unsigned int)s.largestBlock, (unsigned int)s.minEverFree,
+        (unsigned int)s.allocatedBlocks, (unsigned int)s.freeBlocks, (unsigned int)s.fragPct,
+        (unsigned int)allocFailures.load(std::memory_order_relaxed), memHoursToExhaustion(),
+        getAlertLevelName(alertLevel));
+
+    for (uint8_t i = 0; i < taskCount && w < size; i++) {
+        const MemTaskStack& t = tasks[i];
+        w += snprintf(buf + w, size - w, "%s\"%s\":{\"stack\":%u,\"min_free\":%u}",
+                      i ? "," : "", t.name, (unsigned int)t.stackBytes,
+                      (unsigned int)t.minFreeBytes);
+    }
+
+    // Oldest first: [uptime_s, min_free, min_largest, max_alloc_blocks, max_frag_pct]
+    if (w < size) w += snprintf(buf + w, size - w, "},\"trend\":[");
+    for (uint8_t i = 0; i < trendCount && w < size; i++) {
+        const MemTrendPoint& p = trendAt(i);
+        w += snprintf(buf + w, size - w, "%s[%u,%u,%u,%u,%u]", i ? "," : "",
+                      (unsigned int)p.uptimeS, (unsigned int)p.minFree,
+                      (unsigned int)p.minLargest, (unsigned int)p.maxAllocated,
+                      (unsigned int)p.maxFragPct);
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "]}");
+    return w < size ? w : size - 1;
+}
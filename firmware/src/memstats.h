@@ -0,0 +1,143 @@
+/**
+ * @file memstats.h
+ * @brief Heap, stack and fragmentation telemetry with an early OOM alert
+ *
+ * Every MEM_SAMPLE_INTERVAL_MS the heap is read with heap_caps_get_info():
+ * free bytes, largest free block, minimum-ever free bytes and the number
+ * of allocated and free blocks. Each registered task's stack high-water
+ * mark is read as well. Failed allocations are counted from the allocator's
+ * callback.
+ *
+ * Free bytes alone hide fragmentation: String churn can leave plenty free
+ * in blocks too small for the diagnostics buffer. So each trend point
+ * (one per MEM_TREND_INTERVAL_MS, MEM_TREND_LEN kept) records the lowest
+ * free bytes and the smallest largest block of its interval. A
+ * least-squares slope over the trend projects when either reaches its
+ * critical floor.
+ *
+ * The result is raised as ALERT_MEMORY on the event bus:
+ * - warning: largest block below MEM_BLOCK_WARNING, projected exhaustion
+ *   within MEM_OOM_HORIZON_H, or a task with less than MEM_STACK_MIN_FREE
+ *   bytes of stack left at its deepest
+ * - critical: largest block below MEM_BLOCK_CRITICAL (the next large
+ *   allocation may fail), free heap below MEM_FREE_CRITICAL, or an
+ *   allocation failed since the last sample
+ *
+ * Sampling walks the heap under its lock (O(blocks), well under a
+ * millisecond) and each task's unused stack, so it runs as a low-priority
+ * network task job rather than on the sensing task.
+ */
+
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+
+// =============================================================================
+// TELEMETRY CONFIGURATION
+// =============================================================================
+
+#define MEM_SAMPLE_INTERVAL_MS  10000UL    ///< Heap and stack sample period
+#define MEM_SAMPLE_DEADLINE_MS  1000
+#define MEM_TREND_INTERVAL_MS   3600000UL  ///< One trend point per hour
+#define MEM_TREND_LEN           24         ///< Trend points kept (a day)
+#define MEM_TREND_MIN_POINTS    6          ///< Points before projecting exhaustion
+#define MEM_OOM_HORIZON_H       48         ///< Warn if exhaustion is projected sooner
+
+#define MEM_BLOCK_CRITICAL      8192       ///< Diagnostics buffer (6 KB) plus headroom
+#define MEM_BLOCK_WARNING       16384
+#define MEM_FREE_CRITICAL       20480
+#define MEM_HYSTERESIS          2048       ///< Extra margin before a level clears
+#define MEM_STACK_MIN_FREE      512        ///< Bytes of stack never touched
+
+#define MEM_MAX_TASKS           8
+#define MEM_JSON_MAX            1792       ///< Buffer for formatMemJson() with a full trend
+
+#ifndef CONFIG_ARDUINO_LOOP_STACK_SIZE
+#define CONFIG_ARDUINO_LOOP_STACK_SIZE 8192
+#endif
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief One heap sample
+ */
+struct MemSample {
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t minEverFree;      ///< Allocator's low-water mark since boot
+    uint16_t allocatedBlocks;
+    uint16_t freeBlocks;
+    uint8_t fragPct;           ///< 100 - largest block as a % of free bytes
+};
+
+/**
+ * @brief Worst values over one trend interval
+ */
+struct MemTrendPoint {
+    uint32_t uptimeS;          ///< End of the interval
+    uint32_t minFree;
+    uint32_t minLargest;
+    uint16_t maxAllocated;
+    uint8_t maxFragPct;
+};
+
+/**
+ * @brief Stack use of one registered task
+ */
+struct MemTaskStack {
+    TaskHandle_t handle;
+    const char* name;
+    uint32_t stackBytes;       ///< Size given at creation
+    uint32_t minFreeBytes;     ///< High-water mark: least stack ever left
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Register the allocation-failure callback and take a first sample
+ * @note Clears registered tasks and the trend; call before memRegisterTask()
+ */
+void initMemStats();
+
+/**
+ * @brief Track a task's stack high-water mark
+ * @note Call during setup() (startPinnedTask() does it for its tasks)
+ */
+void memRegisterTask(TaskHandle_t handle, const char* name, uint32_t stackBytes);
+
+/**
+ * @brief Sample heap and stacks, roll the trend, raise ALERT_MEMORY
+ * @note Call from one task only (the network task's "mem" job)
+ */
+void sampleMemStats();
+
+/**
+ * @brief Latest sample
+ */
+MemSample getMemSample();
+
+/**
+ * @brief Projected hours until the heap reaches a critical floor
+ * @return -1 when there are too few trend points or neither is falling
+ */
+float memHoursToExhaustion();
+
+/**
+ * @brief Level of the last ALERT_MEMORY evaluation
+ */
+AlertLevel getMemAlertLevel();
+
+/**
+ * @brief Write the latest sample, stacks and trend as JSON
+ * @return Characters written (truncated to size - 1)
+ */
+size_t formatMemJson(char* buf, size_t size);
+
+#endif // MEMSTATS_H
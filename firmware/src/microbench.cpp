@@ -0,0 +1,178 @@
+/**
+ * @file microbench.cpp
+ * @brief Micro-benchmark harness implementation
+ */
+
+#include "microbench.h"
+#include <math.h>
+
+#ifdef HOST_BUILD
+#include <chrono>
+#endif
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+struct BenchCase {
+    const char* name;
+    BenchFn fn;
+};
+
+static BenchCase cases[BENCH_MAX_CASES];
+static uint8_t caseCount = 0;
+static BenchResult results[BENCH_MAX_CASES];
+static uint8_t resultCount = 0;
+
+volatile uint32_t benchSink = 0;
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+#ifdef HOST_BUILD
+static const char* const BENCH_PLATFORM = "host";
+static const char* const BENCH_TIMER = "steady_clock";
+
+static inline uint32_t benchTicks() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static float ticksToNs(uint32_t ticks) {
+    return (float)ticks;
+}
+
+static uint32_t cpuMHz() {
+    return 0;  // Not known to the host build
+}
+#else
+static const char* const BENCH_PLATFORM = "esp32";
+static const char* const BENCH_TIMER = "ccount";
+
+static inline uint32_t benchTicks() {
+    return ESP.getCycleCount();
+}
+
+static float ticksToNs(uint32_t ticks) {
+    return ticks * 1000.0f / ESP.getCpuFreqMHz();
+}
+
+static uint32_t cpuMHz() {
+    return ESP.getCpuFreqMHz();
+}
+#endif
+
+/**
+ * @brief Time one batch; unsigned subtraction handles a single wrap
+ */
+static uint32_t timeBatch(BenchFn fn, uint32_t n) {
+    uint32_t t0 = benchTicks();
+    fn(n);
+    return benchTicks() - t0;
+}
+
+/**
+ * @brief Double the batch until one sample lasts BENCH_MIN_SAMPLE_US
+ */
+static uint32_t calibrate(BenchFn fn) {
+    uint32_t n = 1;
+    while (n < BENCH_MAX_BATCH && ticksToNs(timeBatch(fn, n)) < BENCH_MIN_SAMPLE_US * 1000.0f) {
+        n *= 2;
+    }
+    return n;
+}
+
+static void sortFloats(float* v, uint16_t n) {
+    for (uint16_t i = 1; i < n; i++) {
+        float x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+static void runCase(const BenchCase& c, BenchResult& r) {
+    float perOp[BENCH_SAMPLES];
+    uint32_t batch = calibrate(c.fn);
+
+    for (int i = 0; i < BENCH_WARMUP_SAMPLES; i++) {
+        timeBatch(c.fn, batch);
+    }
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        perOp[i] = ticksToNs(timeBatch(c.fn, batch)) / batch;
+    }
+
+    sortFloats(perOp, BENCH_SAMPLES);
+    float sum = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) sum += perOp[i];
+    float mean = sum / BENCH_SAMPLES;
+    float var = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) var += (perOp[i] - mean) * (perOp[i] - mean);
+
+    r.name = c.name;
+    r.batch = batch;
+    r.samples = BENCH_SAMPLES;
+    r.minNs = perOp[0];
+    r.medianNs = perOp[BENCH_SAMPLES / 2];
+    r.meanNs = mean;
+    r.p90Ns = perOp[(BENCH_SAMPLES - 1) * 9 / 10];
+    r.stddevNs = sqrtf(var / (BENCH_SAMPLES - 1));
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+bool benchAdd(const char* name, BenchFn fn) {
+    if (caseCount >= BENCH_MAX_CASES) return false;
+    cases[caseCount].name = name;
+    cases[caseCount].fn = fn;
+    caseCount++;
+    return true;
+}
+
+uint8_t benchRun(const char* filter) {
+    resultCount = 0;
+    for (uint8_t i = 0; i < caseCount; i++) {
+        if (filter != nullptr && strstr(cases[i].name, filter) == nullptr) continue;
+        runCase(cases[i], results[resultCount++]);
+    }
+    return resultCount;
+}
+
+uint8_t benchResultCount() {
+    return resultCount;
+}
+
+const BenchResult& benchResult(uint8_t index) {
+    return results[index];
+}
+
+void printBenchTable(Print& out) {
+    out.printf("%-20s %10s %10s %10s %10s %8s\n",
+               "case", "min ns", "median ns", "p90 ns", "stddev", "batch");
+    for (uint8_t i = 0; i < resultCount; i++) {
+        const BenchResult& r = results[i];
+        out.printf("%-20s %10.1f %10.1f %10.1f %10.1f %8lu\n",
+                   r.name, r.minNs, r.medianNs, r.p90Ns, r.stddevNs, (unsigned long)r.batch);
+    }
+}
+
+void printBenchJson(Print& out) {
+    out.printf("{\"suite\":\"firmware\",\"platform\":\"%s\",\"timer\":\"%s\",\"version\":\"%s\","
+               "\"cpu_mhz\":%lu,\"results\":[",
+               BENCH_PLATFORM, BENCH_TIMER, FIRMWARE_VERSION,
+               (unsigned long)cpuMHz());
+    for (uint8_t i = 0; i < resultCount; i++) {
+        const BenchResult& r = results[i];
+        out.printf("%s{\"name\":\"%s\",\"batch\":%lu,\"samples\":%u,\"min_ns\":%.1f,"
+                   "\"median_ns\":%.1f,\"mean_ns\":%.1f,\"p90_ns\":%.1f,\"stddev_ns\":%.1f}",
+                   i ? "," : "", r.name, (unsigned long)r.batch, r.samples,
+                   r.minNs, r.medianNs, r.meanNs, r.p90Ns, r.stddevNs);
+    }
+    out.println(F("]}"));
+}
@@ -0,0 +1,93 @@
+/**
+ * @file microbench.h
+ * @brief Portable micro-benchmark harness (ESP32 and host)
+ *
+ * A case is a function that runs its operation N times. The harness
+ * calibrates N so one sample lasts at least BENCH_MIN_SAMPLE_US, runs a
+ * few warmup samples, then times BENCH_SAMPLES samples and reports
+ * min/median/mean/p90/stddev in nanoseconds per operation.
+ *
+ * Timing source: the CPU cycle counter on the ESP32 (32-bit, so a single
+ * sample must stay well under the ~18 s wrap at 240 MHz), steady_clock on
+ * the host build.
+ *
+ * Results are printed as one line of JSON for tools/bench_compare.py:
+ *   {"suite":"firmware","platform":"esp32",...,"results":[{"name":...}]}
+ *
+ * Usage:
+ *   static void benchFoo(uint32_t n) { for (uint32_t i = 0; i < n; i++) benchSink += foo(i); }
+ *   benchAdd("foo", benchFoo);
+ *   benchRun(nullptr);
+ *   printBenchJson(Serial);
+ */
+
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// HARNESS CONFIGURATION
+// =============================================================================
+
+#define BENCH_MAX_CASES       16
+#define BENCH_WARMUP_SAMPLES  3
+#define BENCH_SAMPLES         25
+#define BENCH_MIN_SAMPLE_US   2000   ///< Calibrated batch runs at least this long
+#define BENCH_MAX_BATCH       (1UL << 20)
+
+/**
+ * @brief Run the measured operation `iterations` times
+ */
+typedef void (*BenchFn)(uint32_t iterations);
+
+/**
+ * @brief Per-case statistics, nanoseconds per operation
+ */
+struct BenchResult {
+    const char* name;
+    uint32_t batch;     ///< Operations per sample
+    uint16_t samples;
+    float minNs;
+    float medianNs;
+    float meanNs;
+    float p90Ns;
+    float stddevNs;
+};
+
+/**
+ * @brief Sink for benchmark results so the compiler keeps the work
+ */
+extern volatile uint32_t benchSink;
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Register a case (run in registration order)
+ * @return false if BENCH_MAX_CASES is reached
+ */
+bool benchAdd(const char* name, BenchFn fn);
+
+/**
+ * @brief Run all cases whose name contains filter (nullptr = all)
+ * @return Number of cases run
+ */
+uint8_t benchRun(const char* filter);
+
+uint8_t benchResultCount();
+const BenchResult& benchResult(uint8_t index);
+
+/**
+ * @brief Human-readable result table
+ */
+void printBenchTable(Print& out);
+
+/**
+ * @brief Results as a single line of JSON, newline-terminated
+ */
+void printBenchJson(Print& out);
+
+#endif // MICROBENCH_H
@@ -6,7 +6,17 @@
 #include "mqtt.h"
 #include "gsm.h"
 #include "buffer.h"
+#include "log_level.h"
+#include "postmortem.h"
+#include "latency.h"
+#include "memstats.h"
+#include "scheduler.h"
+#include "power.h"
+#include "supervisor.h"
+#include "wifi_link.h"
+#include "boot.h"
 #include <ArduinoJson.h>
+#include <lwip/sockets.h>
 
 // =============================================================================
 // PRIVATE HELPERS
@@ -23,6 +33,195 @@ static size_t buildTopic(const char* suffix, char* buffer, size_t bufferSize) {
     return snprintf(buffer, bufferSize, "%s%s", MQTT_TOPIC_BASE, suffix);
 }
 
+/**
+ * @brief Apply {"command":"config","set":{"<field>":<value>,...}}
+ *
+ * All fields are parsed and range-checked, and the result validated as a
+ * whole, before anything is saved: one bad key or value leaves the config
+ * untouched. Listeners pick up the change live.
+ */
+static void handleConfigCommand(JsonObject set) {
+    if (set.isNull()) {
+        Log.println(F("[MQTT] config: missing \"set\" object"));
+        return;
+    }
+
+    RuntimeConfig next = runtimeCfg;
+    char value[72];
+    for (JsonPair kv : set) {
+        if (kv.value().is<const char*>()) {
+            strncpy(value, kv.value().as<const char*>(), sizeof(value) - 1);
+            value[sizeof(value) - 1] = '\0';
+        } else {
+            serializeJson(kv.value(), value, sizeof(value));
+        }
+        if (!setConfigField(next, kv.key().c_str(), value)) {
+            Log.print(F("[MQTT] config: rejected "));
+            Log.println(kv.key().c_str());
+            return;
+        }
+    }
+    if (!validateConfig(next)) {
+        Log.println(F("[MQTT] config: rejected, thresholds out of order"));
+        return;
+    }
+
+    runtimeCfg = next;
+    saveConfig(runtimeCfg);
+}
+
+/**
+ * @brief Apply {"command":"log_level","module":"MQTT","level":"debug"}
+ *
+ * "module" defaults to "*" (all modules); "level" is a name or 0-5.
+ */
+static void handleLogLevelCommand(const char* module, JsonVariant level) {
+    char levelStr[12];
+    if (level.is<const char*>()) {
+        strncpy(levelStr, level.as<const char*>(), sizeof(levelStr) - 1);
+        levelStr[sizeof(levelStr) - 1] = '\0';
+    } else {
+        snprintf(levelStr, sizeof(levelStr), "%d", level.as<int>());
+    }
+
+    int mod = parseLogModule(module);
+    int lvl = parseLogLevel(levelStr);
+    if (mod < 0 || lvl < 0) {
+        LOG_W(MQTT, "log_level: bad module/level %s/%s\n", module, levelStr);
+        return;
+    }
+    setLogLevel((LogModule)mod, (uint8_t)lvl);
+    LOG_I(MQTT, "Log level %s = %d\n", module, lvl);
+}
+
+/**
+ * @brief Queue {"command_id":"...","command":"set_mode","params":{"mode":"heating"}}
+ * for the control task
+ *
+ * The response goes out on /responses once the engine has applied the
+ * command; malformed parameters and a full queue are answered here.
+ */
+static void handleControlCommand(ControlCommandType type, JsonDocument& doc) {
+    ControlCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    strncpy(cmd.commandId, doc["command_id"] | "", sizeof(cmd.commandId) - 1);
+    cmd.type = type;
+
+    JsonVariant params = doc["params"];
+    bool valid = true;
+    if (type == CTRL_CMD_SET_MODE) {
+        valid = parseMode(params["mode"] | "", cmd.mode);
+    } else if (type == CTRL_CMD_SET_FAN) {
+        valid = parseFanSpeed(params["speed"] | "", cmd.fanSpeed);
+    } else if (type == CTRL_CMD_EMERGENCY_STOP) {
+        cmd.activate = params["activate"] | true;
+    } else if (type == CTRL_CMD_SET_SETPOINT) {
+        // Without "mode" the setpoint is for the current mode (MODE_OFF)
+        const char* modeName = params["mode"] | "";
+        valid = !*modeName || (parseMode(modeName, cmd.mode) && cmd.mode != MODE_OFF);
+        cmd.setpoint = params["setpoint"] | NAN;
+    }
+
+    CommandResult result = CMD_SUCCESS;
+    if (!valid) {
+        result = CMD_REJECTED_INVALID;
+    } else if (!postControlCommand(cmd)) {
+        result = CMD_FAILED;
+    }
+    if (result != CMD_SUCCESS) {
+        ControlResult r;
+        memcpy(r.commandId, cmd.commandId, sizeof(r.commandId));
+        r.type = type;
+        r.result = result;
+        r.status = getControlStatus();
+        publishControlResponse(r);
+    }
+}
+
+/**
+ * @brief Publish a payload larger than the client buffer
+ *
+ * Streams with beginPublish()/endPublish(), so the payload size is not
+ * limited by setBufferSize().
+ */
+static bool publishLarge(const char* suffix, const char* payload, size_t len, bool retained) {
+    char topic[64];
+    buildTopic(suffix, topic, sizeof(topic));
+
+    return mqtt.beginPublish(topic, len, retained) &&
+           mqtt.write((const uint8_t*)payload, len) == len &&
+           mqtt.endPublish();
+}
+
+/**
+ * @brief Publish a pending crash record once, then clear it
+ *
+ * The log tail makes this larger than the client buffer, so the payload
+ * is built on the heap and streamed with publishLarge().
+ */
+static void publishPostMortem() {
+    const PostMortemRecord* rec = getPendingPostMortem();
+    if (rec == nullptr) return;
+
+    size_t capacity = rec->tailLen * 6 + 384;
+    char* payload = (char*)malloc(capacity);
+    if (!payload) return;
+
+    size_t w = snprintf(payload, capacity,
+        "{\"device\":\"%s\",\"boot\":%u,\"reason\":\"%s\",\"uptime_ms\":%u,"
+        "\"culprit\":\"%s\",\"task\":\"%s\",\"pc\":\"0x%08x\",\"backtrace\":[",
+        DEVICE_ID, (unsigned int)rec->bootCount, resetReasonName(rec->reason),
+        (unsigned int)rec->uptimeMs, rec->culprit, rec->task, (unsigned int)rec->pc);
+
+    for (uint8_t i = 0; i < rec->btDepth; i++) {
+        w += snprintf(payload + w, capacity - w, "%s\"0x%08x\"",
+                      i ? "," : "", (unsigned int)rec->backtrace[i]);
+    }
+    w += snprintf(payload + w, capacity - w, "],\"log\":\"");
+
+    // JSON-escape the log tail (control bytes, e.g. token frames, as \u00XX)
+    for (size_t i = 0; i < rec->tailLen && w < capacity - 8; i++) {
+        char c = rec->tail[i];
+        if (c == '"')       { payload[w++] = '\\'; payload[w++] = '"'; }
+        else if (c == '\\') { payload[w++] = '\\'; payload[w++] = '\\'; }
+        else if (c == '\n') { payload[w++] = '\\'; payload[w++] = 'n'; }
+        else if ((uint8_t)c < 0x20 || (uint8_t)c >= 0x7F) {
+            w += snprintf(payload + w, capacity - w, "\\u%04x", (uint8_t)c);
+        }
+        else { payload[w++] = c; }
+    }
+    w += snprintf(payload + w, capacity - w, "\"}");
+
+    bool ok = publishLarge("/diag/postmortem", payload, w, true);
+    free(payload);
+
+    if (ok) {
+        Log.println(F("[MQTT] Crash record uploaded"));
+        clearPostMortem();
+    } else {
+        LOG_W(MQTT, "Crash record upload failed, will retry\n");
+    }
+}
+
+/**
+ * @brief Publish the boot-phase profile once per boot (first connection)
+ */
+static void publishBootProfile() {
+    static bool published = false;
+    if (published) return;
+
+    char payload[320];
+    size_t w = snprintf(payload, sizeof(payload), "{\"device\":\"%s\",\"reason\":\"%s\",\"boot\":",
+                        DEVICE_ID, resetReasonName(getResetReason()));
+    w += formatBootJson(payload + w, sizeof(payload) - w);
+    if (w < sizeof(payload) - 1) {
+        payload[w++] = '}';
+        payload[w] = '\0';
+    }
+
+    published = publishLarge("/diag/boot", payload, w, false);
+}
+
 // =============================================================================
 // IMPLEMENTATION
 // =============================================================================
@@ -34,10 +233,12 @@ bool connectMQTT() {
     }
 
     if (mqtt.connected()) {
-        Log.println(F("[MQTT] Already connected"));
+        LOG_D(MQTT, "Already connected\n");
         return true;
     }
 
+    LatencyScope timer(LAT_MQTT_CONNECT);
+
     Log.print(F("[MQTT] Connecting to "));
     Log.print(runtimeCfg.mqttHost);
     Log.print(F(":"));
@@ -71,6 +272,10 @@ bool connectMQTT() {
         buildTopic("/commands", cmdTopic, sizeof(cmdTopic));
         mqtt.subscribe(cmdTopic);
 
+        bootMark(BOOT_MQTT);
+        publishPostMortem();
+        publishBootProfile();
+
         return true;
     }
 
@@ -97,6 +302,98 @@ bool publishStatus(bool online) {
     return mqtt.publish(topic, online ? "true" : "false", true);  // Retained
 }
 
+/**
+ * @brief Append ,"key": and a section formatter's output at buf + w
+ * @return New length, clamped to size - 1 like the formatters' own
+ */
+static size_t appendDiagSection(char* buf, size_t size, size_t w, const char* key,
+                                size_t (*format)(char*, size_t)) {
+    if (w < size) w += snprintf(buf + w, size - w, ",\"%s\":", key);
+    if (w < size) w += format(buf + w, size - w);
+    return w < size ? w : size - 1;
+}
+
+bool publishDiagnostics() {
+    if (!mqtt.connected()) return false;
+
+    size_t capacity = DIAG_PAYLOAD_MAX;
+    char* payload = (char*)malloc(capacity);
+    if (!payload) return false;
+
+    size_t w = snprintf(payload, capacity, "{\"device\":\"%s\",\"latency\":", DEVICE_ID);
+    if (w < capacity) w += formatLatencyJson(payload + w, capacity - w, true);
+    w = appendDiagSection(payload, capacity, w, "power", formatPowerJson);
+    w = appendDiagSection(payload, capacity, w, "supervisor", formatSupervisorJson);
+    w = appendDiagSection(payload, capacity, w, "wifi", formatWiFiLinkJson);
+    if (w < capacity - 1) w += snprintf(payload + w, capacity - w, ",\"sched\":[");
+    for (uint8_t i = 0; i < schedulerCount() && w < capacity - 1; i++) {
+        if (i) payload[w++] = ',';
+        w += schedulerAt(i)->toJson(payload + w, capacity - w);
+    }
+    if (w < capacity) w += snprintf(payload + w, capacity - w, "]}");
+    if (w >= capacity) w = capacity - 1;
+
+    bool ok = publishLarge("/diag/latency", payload, w, false);
+    free(payload);
+
+    if (ok) {
+        LOG_D(MQTT, "Diagnostics published (%u bytes)\n", (unsigned int)w);
+    } else {
+        LOG_W(MQTT, "Diagnostics publish failed\n");
+    }
+    return ok;
+}
+
+bool publishMemoryStats() {
+    if (!mqtt.connected()) return false;
+
+    char* payload = (char*)malloc(MEM_JSON_MAX);
+    if (!payload) return false;
+
+    size_t w = snprintf(payload, MEM_JSON_MAX, "{\"device\":\"%s\",\"mem\":", DEVICE_ID);
+    w += formatMemJson(payload + w, MEM_JSON_MAX - w - 1);
+    payload[w++] = '}';
+    payload[w] = '\0';
+
+    bool ok = publishLarge("/diag/mem", payload, w, false);
+    free(payload);
+
+    if (!ok) {
+        LOG_W(MQTT, "Memory telemetry publish failed\n");
+    }
+    return ok;
+}
+
+bool publishControlResponse(const ControlResult& r) {
+    if (!mqtt.connected()) {
+        LOG_W(MQTT, "Offline, response to %s dropped\n", r.commandId);
+        return false;
+    }
+
+    static const char* const COMMAND_NAMES[] = {
+        "", "set_mode", "set_fan", "defrost", "emergency_stop", "status", "set_setpoint"
+    };
+    const char* outcome = r.result == CMD_SUCCESS ? "success"
+                        : r.result == CMD_FAILED ? "failed" : "rejected";
+
+    char payload[CONTROL_RESPONSE_MAX];
+    size_t w = snprintf(payload, sizeof(payload),
+        "{\"command_id\":\"%s\",\"command\":\"%s\",\"result\":\"%s\",\"error_code\":",
+        r.commandId, r.type <= CTRL_CMD_SET_SETPOINT ? COMMAND_NAMES[r.type] : "", outcome);
+    if (r.result == CMD_SUCCESS) {
+        w += snprintf(payload + w, sizeof(payload) - w, "null");
+    } else {
+        w += snprintf(payload + w, sizeof(payload) - w, "\"%s\"", getCommandResultName(r.result));
+    }
+    w += snprintf(payload + w, sizeof(payload) - w, ",\"state\":");
+    w += formatControlJson(r.status, payload + w, sizeof(payload) - w);
+    snprintf(payload + w, sizeof(payload) - w, ",\"uptime_ms\":%lu}", (unsigned long)millis());
+
+    char topic[64];
+    buildTopic("/responses", topic, sizeof(topic));
+    return mqtt.publish(topic, payload);
+}
+
 size_t buildJsonPayload(const SystemData& data, char* buffer, size_t bufferSize) {
     StaticJsonDocument<JSON_BUFFER_SIZE> doc;
 
@@ -156,21 +453,20 @@ bool publishSensorData(const SystemData& data) {
         return false;
     }
 
+    LatencyScope timer(LAT_PUBLISH);
+
     char topic[64];
     char payload[JSON_BUFFER_SIZE];
 
     buildTopic("/data", topic, sizeof(topic));
     buildJsonPayload(data, payload, sizeof(payload));
 
-    Log.print(F("[MQTT] Publishing to "));
-    Log.println(topic);
-
     bool success = mqtt.publish(topic, payload);
 
     if (success) {
-        Log.println(F("[MQTT] Published successfully"));
+        LOG_D(MQTT, "Published to %s\n", topic);
     } else {
-        Log.println(F("[MQTT] Publish failed!"));
+        LOG_W(MQTT, "Publish to %s failed!\n", topic);
     }
 
     return success;
@@ -184,13 +480,11 @@ bool publishBufferedData() {
 
     uint16_t count = bufferCount();
     if (count == 0) {
-        Log.println(F("[MQTT] Buffer empty, nothing to publish"));
+        LOG_D(MQTT, "Buffer empty, nothing to publish\n");
         return true;
     }
 
-    Log.print(F("[MQTT] Publishing "));
-    Log.print(count);
-    Log.println(F(" buffered readings..."));
+    LOG_D(MQTT, "Publishing %u buffered readings...\n", count);
 
     uint16_t published = 0;
     uint16_t failed = 0;
@@ -214,39 +508,64 @@ bool publishBufferedData() {
         mqtt.loop();
 
         // Small delay between publishes
-        delay(100);
+        delay(MQTT_BACKLOG_GAP_MS);
     }
 
-    Log.print(F("[MQTT] Published: "));
-    Log.print(published);
-    Log.print(F(", Failed: "));
-    Log.println(failed);
+    LOG_D(MQTT, "Published: %u, Failed: %u\n", published, failed);
 
     return (failed == 0);
 }
 
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-    Log.print(F("[MQTT] Message received on topic: "));
-    Log.println(topic);
+    LOG_D(MQTT, "Message received on topic: %s\n", topic);
 
     // Convert payload to null-terminated string
-    char message[128];
+    char message[MQTT_CMD_BUFFER_SIZE];
     size_t copyLen = (length < sizeof(message) - 1) ? length : sizeof(message) - 1;
     memcpy(message, payload, copyLen);
     message[copyLen] = '\0';
 
-    Log.print(F("[MQTT] Payload: "));
-    Log.println(message);
+    LOG_D(MQTT, "Payload: %s\n", message);
 
     // Parse JSON command if present
-    StaticJsonDocument<128> doc;
+    StaticJsonDocument<MQTT_CMD_BUFFER_SIZE> doc;
     DeserializationError error = deserializeJson(doc, message);
 
     if (!error && doc.containsKey("command")) {
-        const char* command = doc["command"];
+        // Non-string commands (numbers, objects, null) read as ""
+        const char* command = doc["command"] | "";
         Log.print(F("[MQTT] Command: "));
         Log.println(command);
-        // Future: handle MQTT commands here
+
+        if (strcmp(command, "config") == 0) {
+            handleConfigCommand(doc["set"]);
+        } else if (strcmp(command, "log_level") == 0) {
+            handleLogLevelCommand(doc["module"] | "*", doc["level"]);
+        } else if (strcmp(command, "set_mode") == 0) {
+            handleControlCommand(CTRL_CMD_SET_MODE, doc);
+        } else if (strcmp(command, "set_fan") == 0) {
+            handleControlCommand(CTRL_CMD_SET_FAN, doc);
+        } else if (strcmp(command, "defrost") == 0) {
+            handleControlCommand(CTRL_CMD_DEFROST, doc);
+        } else if (strcmp(command, "emergency_stop") == 0) {
+            handleControlCommand(CTRL_CMD_EMERGENCY_STOP, doc);
+        } else if (strcmp(command, "status") == 0) {
+            handleControlCommand(CTRL_CMD_STATUS, doc);
+        } else if (strcmp(command, "set_setpoint") == 0) {
+            handleControlCommand(CTRL_CMD_SET_SETPOINT, doc);
+        }
+    }
+}
+
+void abortMQTTTransport() {
+    if (activeConnection == CONN_WIFI) {
+        int fd = wifiClient.fd();
+        if (fd >= 0) {
+            shutdown(fd, SHUT_RDWR);
+            Log.println(F("[MQTT] Aborted stalled WiFi socket"));
+        }
+    } else if (activeConnection == CONN_GPRS) {
+        abortModemExchange();   // The client's reads are modem exchanges
     }
 }
 
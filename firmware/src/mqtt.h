@@ -14,6 +14,13 @@
 #include "../config.h"
 #include "types.h"
 #include "globals.h"
+#include "control.h"
+#include "latency.h"
+
+#define DIAG_PAYLOAD_MAX (LAT_JSON_MAX + 6144)  ///< Diagnostics message: full latency JSON + the rest
+#define MQTT_KEEPALIVE_S 60     ///< Broker keepalive (PubSubClient default is 15)
+#define MQTT_BACKLOG_GAP_MS 100 ///< Pause between buffered publishes
+#define CONTROL_RESPONSE_MAX 512 ///< Buffer for a /responses message
 
 // =============================================================================
 // FUNCTION DECLARATIONS
@@ -56,6 +63,33 @@ bool publishBufferedData();
  */
 bool publishStatus(bool online);
 
+/**
+ * @brief Publish latency histograms, power-mode residency, supervisor
+ * stall counters, WiFi connect stats and scheduler accounting
+ *
+ * Topic <base>/diag/latency, not retained. Counters are since boot.
+ * @return true if published
+ */
+bool publishDiagnostics();
+
+/**
+ * @brief Publish heap, stack and fragmentation telemetry with its trend
+ *
+ * Topic <base>/diag/mem, not retained. See formatMemJson().
+ * @return true if published
+ */
+bool publishMemoryStats();
+
+/**
+ * @brief Publish the outcome of a control command and the state after it
+ *
+ * Topic <base>/responses, not retained:
+ * {"command_id":"...","command":"set_mode","result":"rejected",
+ *  "error_code":"cooldown","state":{...},"uptime_ms":123456}
+ * @return true if published
+ */
+bool publishControlResponse(const ControlResult& result);
+
 /**
  * @brief MQTT message callback handler
  * @param topic Topic the message was received on
@@ -73,6 +107,17 @@ void mqttCallback(char* topic, byte* payload, unsigned int length);
  */
 size_t buildJsonPayload(const SystemData& data, char* buffer, size_t bufferSize);
 
+/**
+ * @brief Abort the MQTT transport under a blocked publish/connect
+ *
+ * Over WiFi the TCP socket is shut down so the blocked call fails and
+ * PubSubClient reports the connection lost; over GPRS the socket lives in
+ * the modem, so the modem exchange is aborted (abortModemExchange()) and
+ * the modem restarted.
+ * @note Safe from any task (used as the supervisor's publish recovery hook)
+ */
+void abortMQTTTransport();
+
 /**
  * @brief Process MQTT client loop
  * @note Call regularly to maintain connection
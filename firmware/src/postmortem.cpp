@@ -0,0 +1,203 @@
+/**
+ * @file postmortem.cpp
+ * @brief Crash-surviving log tail and reset-reason capture
+ */
+
+#include "postmortem.h"
+#include "globals.h"
+#include <Preferences.h>
+#include <esp_system.h>
+
+#if defined(CONFIG_ESP_COREDUMP_ENABLE_TO_FLASH) && defined(CONFIG_ESP_COREDUMP_DATA_FORMAT_ELF)
+#include <esp_core_dump.h>
+#define POSTMORTEM_HAS_COREDUMP 1
+#else
+#define POSTMORTEM_HAS_COREDUMP 0
+#endif
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+/**
+ * @brief Live crash state; not initialised at boot, so it survives soft resets
+ */
+struct PostMortemRTC {
+    uint32_t magic;
+    uint32_t bootCount;
+    volatile uint32_t uptimeMs;
+    volatile uint32_t head;          ///< Total bytes mirrored (LogCapture position)
+    char culprit[POSTMORTEM_CULPRIT_LEN];
+    char tail[POSTMORTEM_TAIL_SIZE];
+};
+
+RTC_NOINIT_ATTR static PostMortemRTC rtcState;
+
+static PostMortemRecord record;
+static bool recordPending = false;
+static uint8_t resetReason = ESP_RST_UNKNOWN;
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static bool isAbnormalReset(esp_reset_reason_t r) {
+    switch (r) {
+        case ESP_RST_PANIC:
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:
+        case ESP_RST_BROWNOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Copy the RTC ring oldest-first into the record
+ *
+ * Verbatim: tokenized frames (log_token.h) carry binary arguments, zero
+ * bytes included. Only the last `head` bytes were written this boot, so
+ * the length alone tells the tail from the cleared rest of the ring.
+ */
+static void copyTail() {
+    uint32_t head = rtcState.head;
+    size_t len = head < POSTMORTEM_TAIL_SIZE ? head : POSTMORTEM_TAIL_SIZE;
+    uint32_t start = head - len;
+    size_t first = start & (POSTMORTEM_TAIL_SIZE - 1);
+    size_t run = POSTMORTEM_TAIL_SIZE - first < len ? POSTMORTEM_TAIL_SIZE - first : len;
+
+    memcpy(record.tail, rtcState.tail + first, run);
+    memcpy(record.tail + run, rtcState.tail, len - run);
+    record.tailLen = (uint16_t)len;
+}
+
+static void readCoreDump() {
+#if POSTMORTEM_HAS_COREDUMP
+    esp_core_dump_summary_t summary;
+    if (esp_core_dump_get_summary(&summary) != ESP_OK) return;
+
+    strncpy(record.task, summary.exc_task, sizeof(record.task) - 1);
+    record.pc = summary.exc_pc;
+    uint32_t depth = summary.exc_bt_info.depth;
+    if (depth > POSTMORTEM_BT_DEPTH) depth = POSTMORTEM_BT_DEPTH;
+    memcpy(record.backtrace, summary.exc_bt_info.bt, depth * sizeof(uint32_t));
+    record.btDepth = (uint8_t)depth;
+
+    // Report each dump once
+    esp_core_dump_image_erase();
+#endif
+}
+
+// =============================================================================
+// PUBLIC FUNCTIONS
+// =============================================================================
+
+void initPostMortem() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    resetReason = (uint8_t)reason;
+
+    bool rtcValid = rtcState.magic == POSTMORTEM_MAGIC;
+    uint32_t boot = rtcValid ? rtcState.bootCount + 1 : 1;
+
+    Preferences prefs;
+    prefs.begin(POSTMORTEM_NVS_NS, false);
+
+    bool stalled = rtcValid && rtcState.culprit[0] != '\0';
+
+    if (rtcValid && (isAbnormalReset(reason) || stalled)) {
+        memset(&record, 0, sizeof(record));
+        record.magic = POSTMORTEM_MAGIC;
+        record.bootCount = rtcState.bootCount;
+        record.uptimeMs = rtcState.uptimeMs;
+        record.reason = (uint8_t)reason;
+        if (stalled) {
+            memcpy(record.culprit, rtcState.culprit, sizeof(record.culprit));
+            record.culprit[sizeof(record.culprit) - 1] = '\0';
+        }
+        copyTail();
+        readCoreDump();
+
+        // Persist so the record survives until an upload succeeds, even
+        // across further resets or a power cycle
+        prefs.putBytes("rec", &record, sizeof(record));
+        recordPending = true;
+    } else if (prefs.getBytesLength("rec") == sizeof(record)) {
+        prefs.getBytes("rec", &record, sizeof(record));
+        recordPending = record.magic == POSTMORTEM_MAGIC;
+    }
+    prefs.end();
+
+    // Start a fresh tail for this boot
+    rtcState.magic = POSTMORTEM_MAGIC;
+    rtcState.bootCount = boot;
+    rtcState.uptimeMs = 0;
+    rtcState.head = 0;
+    memset(rtcState.culprit, 0, sizeof(rtcState.culprit));
+    memset(rtcState.tail, 0, sizeof(rtcState.tail));
+    Log.setMirror(rtcState.tail, POSTMORTEM_TAIL_SIZE, &rtcState.head);
+
+    Log.print(F("[PM] Boot #"));
+    Log.print(boot);
+    Log.print(F(", reset reason: "));
+    Log.println(resetReasonName(resetReason));
+    if (recordPending) {
+        Log.print(F("[PM] Crash record pending upload (boot #"));
+        Log.print(record.bootCount);
+        Log.print(F(", "));
+        Log.print(resetReasonName(record.reason));
+        if (record.culprit[0]) {
+            Log.print(F(", stalled: "));
+            Log.print(record.culprit);
+        }
+        Log.println(F(")"));
+    }
+}
+
+void postMortemTick() {
+    rtcState.uptimeMs = millis();
+}
+
+void postMortemSetCulprit(const char* name) {
+    if (name == nullptr) {
+        rtcState.culprit[0] = '\0';
+        return;
+    }
+    strncpy(rtcState.culprit, name, sizeof(rtcState.culprit) - 1);
+    rtcState.culprit[sizeof(rtcState.culprit) - 1] = '\0';
+}
+
+const char* resetReasonName(uint8_t reason) {
+    switch ((esp_reset_reason_t)reason) {
+        case ESP_RST_POWERON:   return "POWERON";
+        case ESP_RST_EXT:       return "EXTERNAL";
+        case ESP_RST_SW:        return "SOFTWARE";
+        case ESP_RST_PANIC:     return "PANIC";
+        case ESP_RST_INT_WDT:   return "INT_WDT";
+        case ESP_RST_TASK_WDT:  return "TASK_WDT";
+        case ESP_RST_WDT:       return "WDT";
+        case ESP_RST_DEEPSLEEP: return "DEEPSLEEP";
+        case ESP_RST_BROWNOUT:  return "BROWNOUT";
+        case ESP_RST_SDIO:      return "SDIO";
+        default:                return "UNKNOWN";
+    }
+}
+
+uint8_t getResetReason() {
+    return resetReason;
+}
+
+const PostMortemRecord* getPendingPostMortem() {
+    return recordPending ? &record : nullptr;
+}
+
+void clearPostMortem() {
+    if (!recordPending) return;
+
+    Preferences prefs;
+    prefs.begin(POSTMORTEM_NVS_NS, false);
+    prefs.remove("rec");
+    prefs.end();
+    recordPending = false;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file postmortem.h
+ * @brief Crash-surviving log tail and reset-reason capture
+ *
+ * Every log write is mirrored into a small ring in RTC memory that is not
+ * cleared by soft resets (panic, watchdog, brown-out, ESP.restart). At the
+ * next boot, if the reset was abnormal, that tail is combined with the
+ * reset reason, the previous uptime and - when core dump to flash is
+ * enabled - the crashing task and backtrace, and stored in NVS. The record
+ * is published once to <base>/diag/postmortem on the next MQTT connection
+ * and then cleared.
+ *
+ * The supervisor names the stalled subsystem ("culprit") before it
+ * recovers or resets; a reset with a culprit set counts as abnormal even
+ * though it comes through esp_restart().
+ */
+
+#ifndef POSTMORTEM_H
+#define POSTMORTEM_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// POST-MORTEM CONFIGURATION
+// =============================================================================
+
+#define POSTMORTEM_NVS_NS      "hppm"        ///< NVS namespace for the record
+#define POSTMORTEM_MAGIC       0x504D5232UL  ///< "PMR2" - layout version
+#define POSTMORTEM_TAIL_SIZE   1024          ///< Log tail bytes (power of two)
+#define POSTMORTEM_BT_DEPTH    8             ///< Backtrace frames kept
+#define POSTMORTEM_CULPRIT_LEN 16
+
+static_assert((POSTMORTEM_TAIL_SIZE & (POSTMORTEM_TAIL_SIZE - 1)) == 0,
+              "POSTMORTEM_TAIL_SIZE must be a power of two");
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief One abnormal reset, as stored in NVS
+ */
+struct PostMortemRecord {
+    uint32_t magic;                         ///< POSTMORTEM_MAGIC when valid
+    uint32_t bootCount;                     ///< Boot number that crashed
+    uint32_t uptimeMs;                      ///< Last loop() tick before the reset
+    uint8_t reason;                         ///< esp_reset_reason_t
+    uint8_t btDepth;                        ///< Valid entries in backtrace
+    uint16_t tailLen;                       ///< Valid bytes in tail
+    char task[16];                          ///< Crashing task (core dump only)
+    uint32_t pc;                            ///< Exception PC (core dump only)
+    uint32_t backtrace[POSTMORTEM_BT_DEPTH];
+    char culprit[POSTMORTEM_CULPRIT_LEN];   ///< Stalled subsystem (supervisor)
+    char tail[POSTMORTEM_TAIL_SIZE];        ///< Oldest-first log bytes, verbatim (tailLen)
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Capture the previous boot's crash state and start mirroring the log
+ * @note Call from setup() right after Log.begin() and before anything else
+ *       logs, or the previous tail is overwritten.
+ */
+void initPostMortem();
+
+/**
+ * @brief Record loop liveness (uptime reported for the next crash)
+ */
+void postMortemTick();
+
+/**
+ * @brief Name the subsystem held responsible if the device resets now
+ * @param name Supervised task name, or nullptr to clear after recovery
+ * @note Kept in RTC memory; safe to call from any task
+ */
+void postMortemSetCulprit(const char* name);
+
+/**
+ * @brief Short name for an esp_reset_reason_t value
+ */
+const char* resetReasonName(uint8_t reason);
+
+/**
+ * @brief Reset reason of the current boot
+ */
+uint8_t getResetReason();
+
+/**
+ * @brief Get the stored, not yet uploaded record
+ * @return nullptr if there is none
+ */
+const PostMortemRecord* getPendingPostMortem();
+
+/**
+ * @brief Drop the stored record after a successful upload
+ */
+void clearPostMortem();
+
+#endif // POSTMORTEM_H
@@ -0,0 +1,162 @@
+/**
+ * @file power.cpp
+ * @brief Power manager implementation
+ */
+
+#include "power.h"
+#include "globals.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static PowerStats stats = {PWR_OFFLINE, false, false, {0, 0, 0, 0}};
+static unsigned long lastUpdate = 0;
+static bool radioLockHeld = false;
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t radioLock = nullptr;   ///< NO_LIGHT_SLEEP for AP/GPRS
+static esp_pm_lock_handle_t busyLock = nullptr;    ///< CPU_FREQ_MAX for active work
+static esp_pm_lock_handle_t awakeLock = nullptr;   ///< NO_LIGHT_SLEEP for active work
+#endif
+
+static const char* const MODE_NAMES[PWR_MODE_COUNT] = {
+    "portal", "gprs", "wifi", "offline"
+};
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static bool modeBlocksLightSleep(PowerMode mode) {
+    return mode == PWR_PORTAL || mode == PWR_GPRS;
+}
+
+static void setRadioLock(bool hold) {
+    if (hold == radioLockHeld) return;
+#if CONFIG_PM_ENABLE
+    if (radioLock) {
+        if (hold) esp_pm_lock_acquire(radioLock);
+        else esp_pm_lock_release(radioLock);
+    }
+#endif
+    radioLockHeld = hold;
+}
+
+/**
+ * @brief Wake on the start bit of anything the SIM800 sends, and on RI
+ *
+ * ESP32 UART wake-up only exists for UART0/1 and the modem is on UART2,
+ * so the RX line is used as a low-level GPIO wake source instead. The
+ * first byte of a URC may be lost; SMS are still picked up by polling.
+ */
+static void configureWakeSources() {
+    gpio_wakeup_enable((gpio_num_t)PIN_GSM_RX, GPIO_INTR_LOW_LEVEL);
+#if PIN_GSM_RI >= 0
+    gpio_wakeup_enable((gpio_num_t)PIN_GSM_RI, GPIO_INTR_LOW_LEVEL);
+#endif
+    esp_sleep_enable_gpio_wakeup();
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void initPower() {
+    lastUpdate = millis();
+
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "radio", &radioLock);
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "busy", &busyLock);
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "awake", &awakeLock);
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t pm;
+#else
+    esp_pm_config_esp32_t pm;
+#endif
+    pm.max_freq_mhz = POWER_MAX_FREQ_MHZ;
+    pm.min_freq_mhz = POWER_MIN_FREQ_MHZ;
+    pm.light_sleep_enable = POWER_LIGHT_SLEEP;
+
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK && POWER_LIGHT_SLEEP) {
+        // SDK built without tickless idle: keep DFS only
+        pm.light_sleep_enable = false;
+        err = esp_pm_configure(&pm);
+        stats.dfs = err == ESP_OK;
+    } else {
+        stats.dfs = err == ESP_OK;
+        stats.lightSleep = err == ESP_OK && POWER_LIGHT_SLEEP;
+    }
+#endif
+
+    if (stats.lightSleep) {
+        configureWakeSources();
+    }
+
+    Log.print(F("[PWR] DFS "));
+    Log.print(stats.dfs ? F("on") : F("off"));
+    Log.print(F(", light sleep "));
+    Log.println(stats.lightSleep ? F("on") : F("off"));
+}
+
+void updatePowerMode(bool portalActive, ConnectionType conn) {
+    PowerMode mode = portalActive       ? PWR_PORTAL
+                   : conn == CONN_GPRS  ? PWR_GPRS
+                   : conn == CONN_WIFI  ? PWR_WIFI
+                   : PWR_OFFLINE;
+
+    unsigned long now = millis();
+    stats.residencyMs[stats.mode] += now - lastUpdate;
+    lastUpdate = now;
+
+    if (mode != stats.mode) {
+        Log.print(F("[PWR] Mode: "));
+        Log.println(MODE_NAMES[mode]);
+        stats.mode = mode;
+    }
+    setRadioLock(modeBlocksLightSleep(mode));
+}
+
+void powerBusyBegin() {
+#if CONFIG_PM_ENABLE
+    if (busyLock) esp_pm_lock_acquire(busyLock);
+    if (awakeLock) esp_pm_lock_acquire(awakeLock);
+#endif
+}
+
+void powerBusyEnd() {
+#if CONFIG_PM_ENABLE
+    if (awakeLock) esp_pm_lock_release(awakeLock);
+    if (busyLock) esp_pm_lock_release(busyLock);
+#endif
+}
+
+PowerStats getPowerStats() {
+    return stats;
+}
+
+const char* getPowerModeName(PowerMode mode) {
+    return mode < PWR_MODE_COUNT ? MODE_NAMES[mode] : "unknown";
+}
+
+size_t formatPowerJson(char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size, "{\"mode\":\"%s\",\"dfs\":%s,\"light_sleep\":%s,\"residency_s\":{",
+                        MODE_NAMES[stats.mode], stats.dfs ? "true" : "false",
+                        stats.lightSleep ? "true" : "false");
+    for (int i = 0; i < PWR_MODE_COUNT && w < size; i++) {
+        w += snprintf(buf + w, size - w, "%s\"%s\":%u", i ? "," : "", MODE_NAMES[i],
+                      (unsigned int)(stats.residencyMs[i] / 1000));
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "}}");
+    return w < size ? w : size - 1;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file power.h
+ * @brief Power manager: DFS, automatic light sleep and sleep locks
+ *
+ * Tasks block until their next scheduled release instead of polling, and
+ * FreeRTOS tickless idle puts the chip into light sleep whenever every task
+ * is blocked. Wake sources are the RTC timer (the next FreeRTOS timeout),
+ * the SIM800 TX line (start bit of a URC on GPIO PIN_GSM_RX) and, if wired,
+ * the SIM800 RI pin.
+ *
+ * Light sleep is only allowed when the radio state permits it:
+ * - PWR_PORTAL: provisioning AP up - no light sleep (AP must beacon)
+ * - PWR_GPRS:   MQTT over the SIM800 UART - no light sleep (RX would drop)
+ * - PWR_WIFI:   station with modem sleep - light sleep between DTIMs
+ * - PWR_OFFLINE: no transport - light sleep
+ *
+ * Time spent in each mode is accumulated, so average draw can be computed
+ * from per-mode bench measurements (see docs).
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+enum PowerMode {
+    PWR_PORTAL = 0,
+    PWR_GPRS,
+    PWR_WIFI,
+    PWR_OFFLINE,
+    PWR_MODE_COUNT  ///< Must be last - used for array sizing
+};
+
+struct PowerStats {
+    PowerMode mode;
+    bool lightSleep;                      ///< Light sleep configured successfully
+    bool dfs;                             ///< DFS configured successfully
+    uint32_t residencyMs[PWR_MODE_COUNT]; ///< Time spent in each mode since boot
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Configure DFS/light sleep, locks and wake sources
+ */
+void initPower();
+
+/**
+ * @brief Re-evaluate the power mode from the radio state
+ * @note Call from one task only (the UI loop)
+ */
+void updatePowerMode(bool portalActive, ConnectionType conn);
+
+/**
+ * @brief Hold full CPU speed and block light sleep (counted, any task)
+ */
+void powerBusyBegin();
+void powerBusyEnd();
+
+/**
+ * @brief Clamp a task's idle wait to [0, maxMs]
+ * @param untilNextMs Time to the task's next scheduled release
+ */
+static inline uint32_t powerIdleWait(uint32_t untilNextMs, uint32_t maxMs) {
+    return untilNextMs < maxMs ? untilNextMs : maxMs;
+}
+
+PowerStats getPowerStats();
+
+const char* getPowerModeName(PowerMode mode);
+
+/**
+ * @brief Write mode, capabilities and residency as JSON
+ */
+size_t formatPowerJson(char* buf, size_t size);
+
+/**
+ * @brief Holds powerBusyBegin() for its lifetime
+ */
+class PowerBusy {
+public:
+    PowerBusy() { powerBusyBegin(); }
+    ~PowerBusy() { powerBusyEnd(); }
+};
+
+#endif // POWER_H
@@ -5,34 +5,139 @@
 
 #include "provision.h"
 #include "globals.h"
-#include <Preferences.h>
 #include <WiFi.h>
 #include <WebServer.h>
 #include <DNSServer.h>
-#include <esp_task_wdt.h>
 
 // =============================================================================
 // WIFI SCANNING
 // =============================================================================
 
-static int scanCount = 0;
+/**
+ * @brief One deduplicated scan result (strongest BSSID per SSID)
+ */
+struct ScanEntry {
+    char ssid[33];
+    int8_t rssi;
+};
+
+static ScanEntry scanCache[PROVISION_SCAN_MAX];
+static uint8_t scanCacheCount = 0;
+static bool scanRunning = false;
+static unsigned long lastScanStart = 0;
+
+/**
+ * @brief Kick off an asynchronous scan (returns immediately)
+ */
+static void startWiFiScan() {
+    if (scanRunning) return;
+    if (WiFi.scanNetworks(true, false) == WIFI_SCAN_FAILED) {
+        Log.println(F("[PROV] WiFi scan failed to start"));
+        return;
+    }
+    scanRunning = true;
+    lastScanStart = millis();
+}
+
+/**
+ * @brief Insert or update an SSID in the cache, keeping it sorted by RSSI
+ *
+ * Entries are kept strongest-first. A duplicate SSID only replaces its
+ * existing entry when the new BSSID is stronger.
+ */
+static void cacheScanResult(const char* ssid, int8_t rssi) {
+    int pos = -1;
+    for (int i = 0; i < scanCacheCount; i++) {
+        if (strcmp(scanCache[i].ssid, ssid) == 0) {
+            if (rssi <= scanCache[i].rssi) return;
+            pos = i;
+            break;
+        }
+    }
+
+    if (pos < 0) {
+        if (scanCacheCount < PROVISION_SCAN_MAX) {
+            pos = scanCacheCount++;
+        } else if (rssi > scanCache[scanCacheCount - 1].rssi) {
+            pos = scanCacheCount - 1;  // Evict weakest
+        } else {
+            return;
+        }
+    }
+
+    // Bubble the entry up to its sorted position
+    while (pos > 0 && scanCache[pos - 1].rssi < rssi) {
+        scanCache[pos] = scanCache[pos - 1];
+        pos--;
+    }
+    strncpy(scanCache[pos].ssid, ssid, sizeof(scanCache[pos].ssid) - 1);
+    scanCache[pos].ssid[sizeof(scanCache[pos].ssid) - 1] = '\0';
+    scanCache[pos].rssi = rssi;
+}
+
+/**
+ * @brief Collect finished async scan results into the cache (non-blocking)
+ *
+ * Re-triggers a background scan every PROVISION_SCAN_INTERVAL_MS.
+ */
+static void pollWiFiScan() {
+    if (!scanRunning) {
+        if (millis() - lastScanStart >= PROVISION_SCAN_INTERVAL_MS) {
+            startWiFiScan();
+        }
+        return;
+    }
+
+    int16_t n = WiFi.scanComplete();
+    if (n == WIFI_SCAN_RUNNING) return;
+    scanRunning = false;
 
-static void doWiFiScan() {
-    Log.println(F("[PROV] Scanning WiFi networks..."));
-    scanCount = WiFi.scanNetworks(false, false);
-    if (scanCount < 0) scanCount = 0;
-    Log.print(F("[PROV] Found "));
-    Log.print(scanCount);
-    Log.println(F(" networks"));
+    if (n < 0) {
+        Log.println(F("[PROV] WiFi scan failed"));
+        return;
+    }
+
+    scanCacheCount = 0;
+    for (int i = 0; i < n; i++) {
+        wifi_ap_record_t* ap = (wifi_ap_record_t*)WiFi.getScanInfoByIndex(i);
+        if (ap == nullptr || ap->ssid[0] == '\0') continue;  // skip hidden networks
+        cacheScanResult((const char*)ap->ssid, ap->rssi);
+    }
+    WiFi.scanDelete();
+
+    Log.print(F("[PROV] Scan found "));
+    Log.print(n);
+    Log.print(F(" APs, "));
+    Log.print(scanCacheCount);
+    Log.println(F(" unique networks"));
 }
 
-static String htmlEscape(const String& s) {
-    String out = s;
-    out.replace("&", "&amp;");
-    out.replace("<", "&lt;");
-    out.replace(">", "&gt;");
-    out.replace("\"", "&quot;");
-    return out;
+/**
+ * @brief HTML-escape s into a fixed buffer (no heap allocation)
+ * @return Number of characters written (excluding terminator)
+ */
+static size_t htmlEscape(const char* s, char* out, size_t outSize) {
+    size_t w = 0;
+    for (; *s != '\0'; s++) {
+        const char* rep = nullptr;
+        switch (*s) {
+            case '&':  rep = "&amp;";  break;
+            case '<':  rep = "&lt;";   break;
+            case '>':  rep = "&gt;";   break;
+            case '"':  rep = "&quot;"; break;
+            default:   break;
+        }
+        size_t len = rep ? strlen(rep) : 1;
+        if (w + len >= outSize) break;
+        if (rep) {
+            memcpy(out + w, rep, len);
+        } else {
+            out[w] = *s;
+        }
+        w += len;
+    }
+    out[w] = '\0';
+    return w;
 }
 
 // =============================================================================
@@ -96,82 +201,6 @@ h1{color:#00d4ff;margin-bottom:12px}
 </html>
 )rawliteral";
 
-// =============================================================================
-// NVS FUNCTIONS
-// =============================================================================
-
-void loadConfig(RuntimeConfig& cfg) {
-    Preferences prefs;
-    prefs.begin(PROVISION_NVS_NS, true);  // read-only
-
-    if (!prefs.getBool("configured", false)) {
-        Log.println(F("[PROV] No stored config, using compile-time defaults"));
-        prefs.end();
-        return;
-    }
-
-    String s;
-
-    s = prefs.getString("wifi_ssid", "");
-    if (s.length() > 0) strncpy(cfg.wifiSSID, s.c_str(), sizeof(cfg.wifiSSID) - 1);
-
-    s = prefs.getString("wifi_pass", "");
-    if (s.length() > 0) strncpy(cfg.wifiPass, s.c_str(), sizeof(cfg.wifiPass) - 1);
-
-    s = prefs.getString("mqtt_host", "");
-    if (s.length() > 0) strncpy(cfg.mqttHost, s.c_str(), sizeof(cfg.mqttHost) - 1);
-
-    cfg.mqttPort = prefs.getUShort("mqtt_port", cfg.mqttPort);
-
-    s = prefs.getString("mqtt_user", "");
-    if (s.length() > 0) strncpy(cfg.mqttUser, s.c_str(), sizeof(cfg.mqttUser) - 1);
-
-    s = prefs.getString("mqtt_pass", "");
-    if (s.length() > 0) strncpy(cfg.mqttPass, s.c_str(), sizeof(cfg.mqttPass) - 1);
-
-    prefs.end();
-
-    Log.println(F("[PROV] Config loaded from NVS"));
-    Log.print(F("[PROV]   WiFi SSID: "));
-    Log.println(cfg.wifiSSID);
-    Log.print(F("[PROV]   MQTT Host: "));
-    Log.print(cfg.mqttHost);
-    Log.print(F(":"));
-    Log.println(cfg.mqttPort);
-}
-
-void saveConfig(const RuntimeConfig& cfg) {
-    Preferences prefs;
-    prefs.begin(PROVISION_NVS_NS, false);
-
-    prefs.putString("wifi_ssid", cfg.wifiSSID);
-    prefs.putString("wifi_pass", cfg.wifiPass);
-    prefs.putString("mqtt_host", cfg.mqttHost);
-    prefs.putUShort("mqtt_port", cfg.mqttPort);
-    prefs.putString("mqtt_user", cfg.mqttUser);
-    prefs.putString("mqtt_pass", cfg.mqttPass);
-    prefs.putBool("configured", true);
-
-    prefs.end();
-    Log.println(F("[PROV] Config saved to NVS"));
-}
-
-void clearConfig() {
-    Preferences prefs;
-    prefs.begin(PROVISION_NVS_NS, false);
-    prefs.clear();
-    prefs.end();
-    Log.println(F("[PROV] NVS config cleared"));
-}
-
-bool isProvisioned() {
-    Preferences prefs;
-    prefs.begin(PROVISION_NVS_NS, true);
-    bool result = prefs.getBool("configured", false);
-    prefs.end();
-    return result;
-}
-
 // =============================================================================
 // CAPTIVE PORTAL
 // =============================================================================
@@ -179,7 +208,8 @@ bool isProvisioned() {
 static WebServer* portalServer = nullptr;
 static DNSServer* dnsServer = nullptr;
 static bool portalSubmitted = false;
-static RuntimeConfig* portalCfg = nullptr;
+static RuntimeConfig portalCfg;  ///< The form's own copy (UI task only)
+static unsigned long portalStart = 0;
 
 static void handleRoot() {
     portalServer->setContentLength(CONTENT_LENGTH_UNKNOWN);
@@ -195,98 +225,106 @@ static void handleRoot() {
         "<select id=\"sel\" onchange=\"if(this.value)document.getElementById('si').value=this.value\">"
         "<option value=\"\">-- Select --</option>"));
 
-    // Dynamic options from WiFi scan
-    for (int i = 0; i < scanCount; i++) {
-        String ssid = WiFi.SSID(i);
-        if (ssid.length() == 0) continue;  // skip hidden networks
-
-        // Dedup: skip if same SSID appeared earlier with stronger signal
-        bool dup = false;
-        for (int j = 0; j < i; j++) {
-            if (WiFi.SSID(j) == ssid) { dup = true; break; }
-        }
-        if (dup) continue;
-
-        int rssi = WiFi.RSSI(i);
+    // Options rendered from the deduplicated, RSSI-sorted scan cache
+    char esc[HTML_ESCAPE_MAX];
+    char buf[2 * HTML_ESCAPE_MAX + 64];  // An option carries the SSID twice
+    for (int i = 0; i < scanCacheCount; i++) {
+        int rssi = scanCache[i].rssi;
         int quality = rssi > -50 ? 100 : rssi < -100 ? 0 : 2 * (rssi + 100);
-        String escaped = htmlEscape(ssid);
-
-        char opt[192];
-        snprintf(opt, sizeof(opt),
+        htmlEscape(scanCache[i].ssid, esc, sizeof(esc));
+        snprintf(buf, sizeof(buf),
             "<option value=\"%s\">%s (%d%%)</option>",
-            escaped.c_str(), escaped.c_str(), quality);
-        portalServer->sendContent(opt);
+            esc, esc, quality);
+        portalServer->sendContent(buf);
     }
 
-    portalServer->sendContent_P(PSTR(
-        "</select>"
-        "<a href=\"/rescan\" class=\"rescan\">&#8635; Rescan</a>"
-        "<label>SSID</label>"));
+    portalServer->sendContent_P(scanRunning
+        ? PSTR("</select><span class=\"rescan\">Scanning&hellip;</span>")
+        : PSTR("</select><a href=\"/rescan\" class=\"rescan\">&#8635; Rescan</a>"));
+    portalServer->sendContent_P(PSTR("<label>SSID</label>"));
 
     // SSID input — pre-filled with current config
-    char buf[192];
+    htmlEscape(portalCfg.wifiSSID, esc, sizeof(esc));
     snprintf(buf, sizeof(buf),
-        "<input name=\"wifi_ssid\" id=\"si\" required maxlength=\"63\" value=\"%s\">",
-        htmlEscape(String(portalCfg->wifiSSID)).c_str());
+        "<input name=\"wifi_ssid\" id=\"si\" required maxlength=\"63\" value=\"%s\">", esc);
     portalServer->sendContent(buf);
 
     // WiFi password — pre-filled
+    htmlEscape(portalCfg.wifiPass, esc, sizeof(esc));
     snprintf(buf, sizeof(buf),
         "<label>Password</label>"
         "<input name=\"wifi_pass\" type=\"password\" maxlength=\"63\" value=\"%s\">"
-        "</fieldset>",
-        htmlEscape(String(portalCfg->wifiPass)).c_str());
+        "</fieldset>", esc);
     portalServer->sendContent(buf);
 
     // MQTT fieldset — pre-filled with current config
-    char mqttBuf[640];
-    snprintf(mqttBuf, sizeof(mqttBuf),
+    htmlEscape(portalCfg.mqttHost, esc, sizeof(esc));
+    snprintf(buf, sizeof(buf),
         "<fieldset><legend>MQTT Broker</legend>"
         "<label>Host / IP</label>"
-        "<input name=\"mqtt_host\" required maxlength=\"63\" value=\"%s\">"
+        "<input name=\"mqtt_host\" required maxlength=\"63\" value=\"%s\">", esc);
+    portalServer->sendContent(buf);
+
+    snprintf(buf, sizeof(buf),
         "<label>Port</label>"
-        "<input name=\"mqtt_port\" type=\"number\" value=\"%u\" min=\"1\" max=\"65535\">"
+        "<input name=\"mqtt_port\" type=\"number\" value=\"%u\" min=\"1\" max=\"65535\">",
+        portalCfg.mqttPort);
+    portalServer->sendContent(buf);
+
+    htmlEscape(portalCfg.mqttUser, esc, sizeof(esc));
+    snprintf(buf, sizeof(buf),
         "<label>Username</label>"
-        "<input name=\"mqtt_user\" maxlength=\"31\" value=\"%s\">"
+        "<input name=\"mqtt_user\" maxlength=\"31\" value=\"%s\">", esc);
+    portalServer->sendContent(buf);
+
+    htmlEscape(portalCfg.mqttPass, esc, sizeof(esc));
+    snprintf(buf, sizeof(buf),
         "<label>Password</label>"
         "<input name=\"mqtt_pass\" type=\"password\" maxlength=\"63\" value=\"%s\">"
-        "</fieldset>",
-        htmlEscape(String(portalCfg->mqttHost)).c_str(),
-        portalCfg->mqttPort,
-        htmlEscape(String(portalCfg->mqttUser)).c_str(),
-        htmlEscape(String(portalCfg->mqttPass)).c_str());
-    portalServer->sendContent(mqttBuf);
+        "</fieldset>", esc);
+    portalServer->sendContent(buf);
 
     // Page footer
     portalServer->sendContent_P(PAGE_FOOT);
 }
 
+/**
+ * @brief Form fields, by their config schema names
+ */
+static const char* const SAVE_FIELDS[] = {
+    "wifi_ssid", "wifi_pass", "mqtt_host", "mqtt_port", "mqtt_user", "mqtt_pass"
+};
+
 static void handleSave() {
-    if (!portalServer->hasArg("wifi_ssid") || !portalServer->hasArg("mqtt_host")) {
+    if (portalServer->arg("wifi_ssid").length() == 0 ||
+        portalServer->arg("mqtt_host").length() == 0) {
         portalServer->send(400, "text/plain", "Missing required fields");
         return;
     }
 
-    String ssid = portalServer->arg("wifi_ssid");
-    String pass = portalServer->arg("wifi_pass");
-    String host = portalServer->arg("mqtt_host");
-    String port = portalServer->arg("mqtt_port");
-    String user = portalServer->arg("mqtt_user");
-    String mpass = portalServer->arg("mqtt_pass");
-
-    strncpy(portalCfg->wifiSSID, ssid.c_str(), sizeof(portalCfg->wifiSSID) - 1);
-    portalCfg->wifiSSID[sizeof(portalCfg->wifiSSID) - 1] = '\0';
-    strncpy(portalCfg->wifiPass, pass.c_str(), sizeof(portalCfg->wifiPass) - 1);
-    portalCfg->wifiPass[sizeof(portalCfg->wifiPass) - 1] = '\0';
-    strncpy(portalCfg->mqttHost, host.c_str(), sizeof(portalCfg->mqttHost) - 1);
-    portalCfg->mqttHost[sizeof(portalCfg->mqttHost) - 1] = '\0';
-    portalCfg->mqttPort = port.length() > 0 ? port.toInt() : 1883;
-    strncpy(portalCfg->mqttUser, user.c_str(), sizeof(portalCfg->mqttUser) - 1);
-    portalCfg->mqttUser[sizeof(portalCfg->mqttUser) - 1] = '\0';
-    strncpy(portalCfg->mqttPass, mpass.c_str(), sizeof(portalCfg->mqttPass) - 1);
-    portalCfg->mqttPass[sizeof(portalCfg->mqttPass) - 1] = '\0';
-
-    saveConfig(*portalCfg);
+    // Same checks as an MQTT config command: each field through the
+    // schema into a copy, then the cross-field rules, then save
+    RuntimeConfig next = portalCfg;
+    for (const char* name : SAVE_FIELDS) {
+        String value = portalServer->arg(name);
+        if (strcmp(name, "mqtt_port") == 0 && value.length() == 0) continue;  // Keep current
+        if (!setConfigField(next, name, value.c_str())) {
+            Log.print(F("[PROV] Save rejected: "));
+            Log.println(name);
+            portalServer->send(400, "text/plain", String("Invalid ") + name);
+            return;
+        }
+    }
+    if (!validateConfig(next)) {
+        Log.println(F("[PROV] Save rejected: config out of range"));
+        portalServer->send(400, "text/plain", "Invalid configuration");
+        return;
+    }
+
+    // The network task owns runtimeCfg: it reads the saved blob when the
+    // EVT_CONFIG event from saveConfig() reaches it
+    portalCfg = next;
+    saveConfig(next);
 
     portalServer->send(200, "text/html", FPSTR(PROVISION_SUCCESS_HTML));
     portalSubmitted = true;
@@ -298,26 +336,31 @@ static void handleNotFound() {
 }
 
 static void handleRescan() {
-    doWiFiScan();
+    startWiFiScan();
     portalServer->sendHeader("Location", "/", true);
     portalServer->send(302, "text/plain", "");
 }
 
-void startProvisioningPortal(RuntimeConfig& cfg) {
+void startProvisioningPortal(const RuntimeConfig& cfg) {
+    if (portalServer != nullptr) return;
+
     Log.println(F("[PROV] Starting AP provisioning portal..."));
     Log.print(F("[PROV] AP SSID: "));
     Log.println(PROVISION_AP_SSID);
 
-    portalCfg = &cfg;
+    portalCfg = cfg;
     portalSubmitted = false;
 
-    // AP+STA mode: AP serves the portal, STA enables WiFi scanning
+    // AP+STA mode: AP serves the portal, STA stays available for scanning
+    // and for normal WiFi reconnect attempts while the portal is up
     WiFi.mode(WIFI_AP_STA);
     WiFi.softAP(PROVISION_AP_SSID);
-    delay(100);
 
-    // Scan for nearby networks
-    doWiFiScan();
+    // Scan for nearby networks in the background; the page renders from
+    // the cache and picks up results on the next load
+    scanCacheCount = 0;
+    scanRunning = false;
+    startWiFiScan();
 
     IPAddress apIP = WiFi.softAPIP();
     Log.print(F("[PROV] AP IP: "));
@@ -335,21 +378,17 @@ void startProvisioningPortal(RuntimeConfig& cfg) {
     portalServer->onNotFound(handleNotFound);
     portalServer->begin();
 
+    portalStart = millis();
+
     Log.println(F("[PROV] Portal active — connect to AP and open 192.168.4.1"));
     Log.print(F("[PROV] Timeout in "));
     Log.print(PROVISION_TIMEOUT_MS / 1000);
-    Log.println(F(" seconds"));
-
-    // Block until submit or timeout
-    unsigned long start = millis();
-    while (!portalSubmitted && (millis() - start < PROVISION_TIMEOUT_MS)) {
-        dnsServer->processNextRequest();
-        portalServer->handleClient();
-        esp_task_wdt_reset();
-        delay(10);
-    }
+    Log.println(F(" seconds (monitoring continues)"));
+}
+
+void stopProvisioningPortal() {
+    if (portalServer == nullptr) return;
 
-    // Cleanup
     portalServer->stop();
     delete portalServer;
     portalServer = nullptr;
@@ -357,15 +396,37 @@ void startProvisioningPortal(RuntimeConfig& cfg) {
     delete dnsServer;
     dnsServer = nullptr;
 
+    // Drop only the AP interface; an established STA link is kept
     WiFi.scanDelete();
-    WiFi.softAPdisconnect(true);
+    scanRunning = false;
+    WiFi.softAPdisconnect(false);
     WiFi.mode(WIFI_STA);
 
+    Log.println(F("[PROV] Portal stopped"));
+}
+
+PortalState handleProvisioningPortal() {
+    if (portalServer == nullptr) return PORTAL_IDLE;
+
+    dnsServer->processNextRequest();
+    portalServer->handleClient();
+    pollWiFiScan();
+
     if (portalSubmitted) {
         Log.println(F("[PROV] Portal completed — config saved"));
-    } else {
+        stopProvisioningPortal();
+        return PORTAL_COMPLETED;
+    }
+
+    if (millis() - portalStart >= PROVISION_TIMEOUT_MS) {
         Log.println(F("[PROV] Portal timed out — using current defaults"));
+        stopProvisioningPortal();
+        return PORTAL_TIMED_OUT;
     }
 
-    portalCfg = nullptr;
+    return PORTAL_ACTIVE;
+}
+
+bool isPortalActive() {
+    return portalServer != nullptr;
 }
@@ -3,8 +3,11 @@
  * @brief WiFi provisioning portal for runtime configuration
  *
  * Provides a captive portal web server for configuring WiFi and MQTT
- * settings at runtime, stored in NVS flash. On first boot (or after
- * SMS "WIFI RESET"), the ESP32 starts as an AP with a config form.
+ * settings at runtime, stored in NVS flash via config_store. On first
+ * boot (or after SMS "WIFI RESET"), the ESP32 starts as an AP with a
+ * config form.
+ * The portal runs in AP+STA mode alongside normal monitoring, serviced
+ * from the main loop, so sensing and GPRS publishing never wait on it.
  */
 
 #ifndef PROVISION_H
@@ -12,6 +15,7 @@
 
 #include <Arduino.h>
 #include "../config.h"
+#include "config_store.h"
 
 // =============================================================================
 // PORTAL CONFIGURATION
@@ -19,36 +23,18 @@
 
 #define PROVISION_AP_SSID    "HeatPump-Setup"
 #define PROVISION_TIMEOUT_MS 180000UL   ///< 3 minutes portal timeout
-#define PROVISION_NVS_NS     "hpcfg"    ///< NVS namespace for config
-
-// =============================================================================
-// RUNTIME CONFIGURATION
-// =============================================================================
+#define PROVISION_SCAN_MAX   20         ///< Unique SSIDs kept in the scan cache
+#define PROVISION_SCAN_INTERVAL_MS 30000UL  ///< Background rescan period
+#define HTML_ESCAPE_MAX      (64 * 6)   ///< Worst-case escaped 63-char field
 
 /**
- * @brief Runtime configuration loaded from NVS (or config.h defaults)
+ * @brief Provisioning portal lifecycle state
  */
-struct RuntimeConfig {
-    char wifiSSID[64];
-    char wifiPass[64];
-    char mqttHost[64];
-    uint16_t mqttPort;
-    char mqttUser[32];
-    char mqttPass[64];
-
-    RuntimeConfig() {
-        strncpy(wifiSSID, WIFI_SSID, sizeof(wifiSSID) - 1);
-        wifiSSID[sizeof(wifiSSID) - 1] = '\0';
-        strncpy(wifiPass, WIFI_PASS_KEY, sizeof(wifiPass) - 1);
-        wifiPass[sizeof(wifiPass) - 1] = '\0';
-        strncpy(mqttHost, MQTT_BROKER, sizeof(mqttHost) - 1);
-        mqttHost[sizeof(mqttHost) - 1] = '\0';
-        mqttPort = MQTT_PORT;
-        strncpy(mqttUser, MQTT_USER, sizeof(mqttUser) - 1);
-        mqttUser[sizeof(mqttUser) - 1] = '\0';
-        strncpy(mqttPass, MQTT_PASS, sizeof(mqttPass) - 1);
-        mqttPass[sizeof(mqttPass) - 1] = '\0';
-    }
+enum PortalState {
+    PORTAL_IDLE = 0,    ///< Portal not running
+    PORTAL_ACTIVE,      ///< AP up, serving the config form
+    PORTAL_COMPLETED,   ///< Form submitted, config saved (reported once)
+    PORTAL_TIMED_OUT    ///< PROVISION_TIMEOUT_MS elapsed (reported once)
 };
 
 // =============================================================================
@@ -56,33 +42,37 @@ struct RuntimeConfig {
 // =============================================================================
 
 /**
- * @brief Load configuration from NVS into cfg. Falls back to config.h defaults.
- */
-void loadConfig(RuntimeConfig& cfg);
-
-/**
- * @brief Save current configuration to NVS.
+ * @brief Start the AP-mode provisioning portal in the background.
+ *
+ * Switches WiFi to AP+STA, brings up the DNS and web servers and returns
+ * immediately. Service it with handleProvisioningPortal() from the main
+ * loop. The form is pre-filled from a copy of cfg; cfg itself is never
+ * written. On submit the values are validated and saved with
+ * saveConfig(), whose EVT_CONFIG event tells the task owning the live
+ * config to re-read it (readSavedConfig()). No-op if already active.
  */
-void saveConfig(const RuntimeConfig& cfg);
+void startProvisioningPortal(const RuntimeConfig& cfg);
 
 /**
- * @brief Clear all stored configuration from NVS.
+ * @brief Service the portal DNS and web servers (non-blocking)
+ *
+ * Call every loop iteration while isPortalActive(). Shuts the portal down
+ * when the form is submitted or PROVISION_TIMEOUT_MS elapses.
+ *
+ * @return PORTAL_COMPLETED or PORTAL_TIMED_OUT on the call that shut the
+ *         portal down, PORTAL_ACTIVE while running, PORTAL_IDLE otherwise
  */
-void clearConfig();
+PortalState handleProvisioningPortal();
 
 /**
- * @brief Check if NVS contains a saved configuration.
- * @return true if a config has been saved via the portal or saveConfig()
+ * @brief Stop the portal immediately and restore STA-only WiFi mode
  */
-bool isProvisioned();
+void stopProvisioningPortal();
 
 /**
- * @brief Start the AP-mode provisioning portal.
- *
- * Blocks until the user submits the form or PROVISION_TIMEOUT_MS elapses.
- * On submit, saves to NVS and updates cfg in place.
- * On timeout, cfg retains its current values (config.h defaults).
+ * @brief Check if the provisioning portal is running
+ * @return true between startProvisioningPortal() and shutdown
  */
-void startProvisioningPortal(RuntimeConfig& cfg);
+bool isPortalActive();
 
 #endif // PROVISION_H
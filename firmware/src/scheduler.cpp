@@ -0,0 +1,176 @@
+/**
+ * @file scheduler.cpp
+ * @brief Deadline-aware cooperative scheduler implementation
+ */
+
+#include "scheduler.h"
+#include <stdio.h>
+#include <string.h>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static const Scheduler* instances[SCHED_MAX_INSTANCES];
+static uint8_t instanceCount = 0;
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+/**
+ * @brief a is before b on a wrapping clock
+ */
+static inline bool timeBefore(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static inline uint32_t effectiveDeadline(const SchedJob& j) {
+    return j.deadlineMs ? j.deadlineMs : j.periodMs;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+Scheduler::Scheduler(const char* name, SchedClock nowMs, SchedClock nowUs)
+    : _name(name), _nowMs(nowMs), _nowUs(nowUs), _onMiss(nullptr), _count(0) {
+    memset(_jobs, 0, sizeof(_jobs));
+    if (instanceCount < SCHED_MAX_INSTANCES) {
+        instances[instanceCount++] = this;
+    }
+}
+
+uint8_t Scheduler::add(const char* name, SchedFn fn, void* ctx,
+                       uint32_t periodMs, uint32_t deadlineMs, uint8_t priority) {
+    if (_count >= SCHED_MAX_JOBS || periodMs == 0) return SCHED_INVALID;
+
+    SchedJob& j = _jobs[_count];
+    memset(&j, 0, sizeof(j));
+    j.name = name;
+    j.fn = fn;
+    j.ctx = ctx;
+    j.periodMs = periodMs;
+    j.deadlineMs = deadlineMs;
+    j.priority = priority;
+    j.enabled = true;
+    j.releaseMs = _nowMs();
+    return _count++;
+}
+
+bool Scheduler::setPeriod(uint8_t id, uint32_t periodMs) {
+    if (id >= _count || periodMs == 0) return false;
+    if (_jobs[id].periodMs == periodMs) return true;
+
+    // Re-anchor so a shorter period does not release immediately
+    SchedJob& j = _jobs[id];
+    j.releaseMs = j.releaseMs - j.periodMs + periodMs;
+    j.periodMs = periodMs;
+    return true;
+}
+
+void Scheduler::trigger(uint8_t id) {
+    if (id < _count) _jobs[id].releaseMs = _nowMs();
+}
+
+void Scheduler::setEnabled(uint8_t id, bool enabled) {
+    if (id >= _count || _jobs[id].enabled == enabled) return;
+    _jobs[id].enabled = enabled;
+    if (enabled) _jobs[id].releaseMs = _nowMs();
+}
+
+bool Scheduler::runOnce() {
+    uint32_t now = _nowMs();
+
+    // Earliest absolute deadline among released jobs
+    int best = -1;
+    uint32_t bestDeadline = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        const SchedJob& j = _jobs[i];
+        if (!j.enabled || timeBefore(now, j.releaseMs)) continue;
+
+        uint32_t dl = j.releaseMs + effectiveDeadline(j);
+        if (best < 0 || timeBefore(dl, bestDeadline) ||
+            (dl == bestDeadline && j.priority < _jobs[best].priority)) {
+            best = i;
+            bestDeadline = dl;
+        }
+    }
+    if (best < 0) return false;
+
+    SchedJob& j = _jobs[best];
+    uint32_t t0 = _nowUs();
+    j.fn(j.ctx);
+    uint32_t dt = _nowUs() - t0;
+    uint32_t end = _nowMs();
+
+    j.runs++;
+    j.lastUs = dt;
+    j.totalUs += dt;
+    if (dt > j.maxUs) j.maxUs = dt;
+
+    int32_t late = (int32_t)(end - bestDeadline);
+    if (late > 0) {
+        j.misses++;
+        if (late > j.worstLateMs) j.worstLateMs = late;
+    }
+
+    // Next release; releases that passed entirely during an overrun are
+    // skipped, leaving at most one catch-up run
+    j.releaseMs += j.periodMs;
+    int32_t behind = (int32_t)(end - j.releaseMs);
+    if (behind >= (int32_t)j.periodMs) {
+        uint32_t k = (uint32_t)behind / j.periodMs;
+        j.releaseMs += k * j.periodMs;
+        j.skipped += k;
+    }
+
+    if (late > 0 && _onMiss) _onMiss(j, late);
+    return true;
+}
+
+uint32_t Scheduler::msUntilNext() const {
+    uint32_t now = _nowMs();
+    uint32_t next = UINT32_MAX;
+    for (uint8_t i = 0; i < _count; i++) {
+        const SchedJob& j = _jobs[i];
+        if (!j.enabled) continue;
+        if (!timeBefore(now, j.releaseMs)) return 0;
+        uint32_t wait = j.releaseMs - now;
+        if (wait < next) next = wait;
+    }
+    return next;
+}
+
+size_t Scheduler::toJson(char* buf, size_t size) const {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size, "{\"name\":\"%s\",\"jobs\":[", _name);
+    for (uint8_t i = 0; i < _count && w < size; i++) {
+        const SchedJob& j = _jobs[i];
+        w += snprintf(buf + w, size - w,
+            "%s{\"name\":\"%s\",\"period_ms\":%u,\"deadline_ms\":%u,\"runs\":%u,"
+            "\"misses\":%u,\"skipped\":%u,\"last_us\":%u,\"max_us\":%u,"
+            "\"avg_us\":%u,\"worst_late_ms\":%d}",
+            i ? "," : "", j.name, (unsigned int)j.periodMs,
+            (unsigned int)effectiveDeadline(j), (unsigned int)j.runs,
+            (unsigned int)j.misses, (unsigned int)j.skipped,
+            (unsigned int)j.lastUs, (unsigned int)j.maxUs,
+            (unsigned int)(j.runs ? j.totalUs / j.runs : 0),
+            (int)j.worstLateMs);
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "]}");
+    return w < size ? w : size - 1;
+}
+
+// =============================================================================
+// DIAGNOSTICS REGISTRY
+// =============================================================================
+
+uint8_t schedulerCount() {
+    return instanceCount;
+}
+
+const Scheduler* schedulerAt(uint8_t index) {
+    return index < instanceCount ? instances[index] : nullptr;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file scheduler.h
+ * @brief Deadline-aware cooperative scheduler
+ *
+ * Replaces chains of "if (now - lastX >= INTERVAL)" checks. Each job has a
+ * period, a relative deadline and a priority. runOnce() dispatches the
+ * ready job with the earliest absolute deadline (priority breaks ties),
+ * times it, and records a miss if it finished after its deadline. A job
+ * that overran whole periods skips the missed releases instead of
+ * bursting to catch up; skips are counted too.
+ *
+ * The scheduler has no Arduino dependency: time comes from two injected
+ * clock functions (milliseconds for scheduling, microseconds for run-time
+ * accounting), so it runs on the host against a virtual clock.
+ *
+ * All time arithmetic is wrap-safe (signed difference of uint32_t), so
+ * periods and deadlines must stay below 2^31 ms.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// =============================================================================
+// SCHEDULER CONFIGURATION
+// =============================================================================
+
+#define SCHED_MAX_JOBS       8   ///< Jobs per scheduler
+#define SCHED_MAX_INSTANCES  4   ///< Schedulers visible to diagnostics
+#define SCHED_INVALID        0xFF
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+typedef uint32_t (*SchedClock)();
+typedef void (*SchedFn)(void* ctx);
+
+/**
+ * @brief One periodic job and its accounting
+ */
+struct SchedJob {
+    const char* name;
+    SchedFn fn;
+    void* ctx;
+    uint32_t periodMs;
+    uint32_t deadlineMs;   ///< Relative to each release
+    uint8_t priority;      ///< Lower value wins when deadlines are equal
+    bool enabled;
+    uint32_t releaseMs;    ///< Current release time
+
+    // ---- Accounting ----
+    uint32_t runs;
+    uint32_t misses;       ///< Finished after release + deadline
+    uint32_t skipped;      ///< Releases dropped after an overrun
+    uint32_t lastUs;       ///< Run time of the last invocation
+    uint32_t maxUs;
+    uint64_t totalUs;
+    int32_t worstLateMs;   ///< Largest finish time past the deadline
+};
+
+/**
+ * @brief Called after a job finishes past its deadline
+ * @param job The job (accounting already updated)
+ * @param lateMs Finish time minus absolute deadline
+ */
+typedef void (*SchedMissHook)(const SchedJob& job, int32_t lateMs);
+
+// =============================================================================
+// SCHEDULER
+// =============================================================================
+
+class Scheduler {
+    const char* _name;
+    SchedClock _nowMs;
+    SchedClock _nowUs;
+    SchedMissHook _onMiss;
+    SchedJob _jobs[SCHED_MAX_JOBS];
+    uint8_t _count;
+
+public:
+    /**
+     * @param name Shown in diagnostics
+     * @param nowMs Millisecond clock (e.g. millis)
+     * @param nowUs Microsecond clock for run-time accounting (e.g. micros)
+     */
+    Scheduler(const char* name, SchedClock nowMs, SchedClock nowUs);
+
+    /**
+     * @brief Register a periodic job, first released immediately
+     * @param periodMs Must be non-zero
+     * @param deadlineMs Relative deadline; 0 means "one period"
+     * @return Job id, or SCHED_INVALID if the table is full or periodMs is 0
+     */
+    uint8_t add(const char* name, SchedFn fn, void* ctx,
+                uint32_t periodMs, uint32_t deadlineMs, uint8_t priority);
+
+    /**
+     * @brief Change a job's period; takes effect from the next release
+     * @return false for an unknown job or a zero period (nothing changes)
+     */
+    bool setPeriod(uint8_t id, uint32_t periodMs);
+
+    /**
+     * @brief Make a job ready now (e.g. after a config change)
+     */
+    void trigger(uint8_t id);
+
+    void setEnabled(uint8_t id, bool enabled);
+
+    void setMissHook(SchedMissHook hook) { _onMiss = hook; }
+
+    /**
+     * @brief Run the ready job with the earliest deadline, if any
+     * @return true if a job ran
+     */
+    bool runOnce();
+
+    /**
+     * @brief Milliseconds until the next release (0 if a job is ready)
+     * @return UINT32_MAX when no job is enabled
+     */
+    uint32_t msUntilNext() const;
+
+    const char* name() const { return _name; }
+    uint8_t count() const { return _count; }
+    const SchedJob& job(uint8_t id) const { return _jobs[id]; }
+
+    /**
+     * @brief Write per-job accounting as a JSON object
+     * @return Characters written (truncated to size - 1)
+     */
+    size_t toJson(char* buf, size_t size) const;
+};
+
+// =============================================================================
+// DIAGNOSTICS REGISTRY
+// =============================================================================
+
+/**
+ * @brief Number of constructed schedulers (up to SCHED_MAX_INSTANCES)
+ */
+uint8_t schedulerCount();
+
+/**
+ * @brief Scheduler by construction order
+ */
+const Scheduler* schedulerAt(uint8_t index);
+
+#endif // SCHEDULER_H
@@ -5,11 +5,24 @@
 
 #include "sensors.h"
 #include "globals.h"
+#include "log_level.h"
 #include <math.h>
 
 // Auto-calibrated zero-current ADC bias (measured at startup)
 static int currentBiasADC = 0;
 
+// Calibration in effect, reloaded from RuntimeConfig on change
+static float voltageScale = VOLTAGE_SCALE_FACTOR;
+static float ntcSeriesResistance = NTC_SERIES_RESISTANCE;
+static float currentNoiseFloor = CURRENT_NOISE_FLOOR;
+
+static void onSensorConfigChanged(const RuntimeConfig& cfg, uint8_t changed) {
+    if (!(changed & CFG_SECTION_CALIBRATION)) return;
+    voltageScale = cfg.voltageScale;
+    ntcSeriesResistance = cfg.ntcSeriesResistance;
+    currentNoiseFloor = cfg.currentNoiseFloor;
+}
+
 // =============================================================================
 // IMPLEMENTATION
 // =============================================================================
@@ -29,21 +42,25 @@ void initSensors() {
     pinMode(PIN_PRESSURE_HIGH, INPUT);
     pinMode(PIN_PRESSURE_LOW, INPUT);
 
-    // Status LED
-    pinMode(PIN_STATUS_LED, OUTPUT);
-    digitalWrite(PIN_STATUS_LED, LOW);
-
     // Auto-calibrate current sensor zero point
+    calibrateCurrentZero(FAST_BOOT ? CURRENT_ZERO_SAMPLES_FAST : CURRENT_ZERO_SAMPLES);
+
+    subscribeConfig(onSensorConfigChanged);
+    Log.println(F("[SENSORS] Initialized"));
+}
+
+void calibrateCurrentZero(int samples) {
     long sum = 0;
-    for (int i = 0; i < CURRENT_ZERO_SAMPLES; i++) {
+    for (int i = 0; i < samples; i++) {
         sum += analogRead(PIN_CURRENT);
         delayMicroseconds(200);
     }
-    currentBiasADC = (int)(sum / CURRENT_ZERO_SAMPLES);
+    currentBiasADC = (int)(sum / samples);
     Log.print(F("[SENSORS] Current zero-bias ADC: "));
-    Log.println(currentBiasADC);
-
-    Log.println(F("[SENSORS] Initialized"));
+    Log.print(currentBiasADC);
+    Log.print(F(" ("));
+    Log.print(samples);
+    Log.println(F(" samples)"));
 }
 
 bool isValidReading(float value, float minValid, float maxValid) {
@@ -171,11 +188,13 @@ float readTemperature(int pin) {
     }
 
     // Use ESP32 calibrated ADC reading (accounts for ADC nonlinearity)
-    float voltage = analogReadMilliVolts(pin) / 1000.0f;
+    return ntcTemperature(analogReadMilliVolts(pin) / 1000.0f);
+}
 
+float ntcTemperature(float voltage) {
     // Calculate NTC resistance from voltage divider
     // Circuit: 3.3V -- [NTC] -- ADC -- [10K Series] -- GND
-    float resistance = NTC_SERIES_RESISTANCE * voltage / (ADC_REFERENCE_VOLTAGE - voltage);
+    float resistance = ntcSeriesResistance * voltage / (ADC_REFERENCE_VOLTAGE - voltage);
 
     // Validate resistance is reasonable
     if (resistance <= 0 || resistance > 1000000) {
@@ -207,7 +226,7 @@ float readVoltageRMS(int pin) {
     float rms = sqrt((float)sumSquares / VOLTAGE_SAMPLES);
 
     // Convert to voltage using calibration factor
-    float voltage = rms * VOLTAGE_SCALE_FACTOR / ADC_MAX_VALUE * ADC_REFERENCE_VOLTAGE;
+    float voltage = rms * voltageScale / ADC_MAX_VALUE * ADC_REFERENCE_VOLTAGE;
 
     return voltage;
 }
@@ -232,7 +251,7 @@ float readCurrentRMS(int pin) {
     float current = voltageRMS * CT_CURRENT_MAX / CT_OUTPUT_VOLTAGE_MAX;
 
     // Suppress ADC noise at zero load
-    if (current < CURRENT_NOISE_FLOOR) {
+    if (current < currentNoiseFloor) {
         current = 0.0f;
     }
 
@@ -262,50 +281,31 @@ float readPressure(int pin) {
 }
 
 void printSensorData(const SystemData& data) {
-    Log.println(F("========== SENSOR READINGS =========="));
-    Log.print(F("Time: "));
-    Log.println(data.readingTime);
-
-    Log.println(F("--- Temperatures (C) ---"));
-    Log.print(F("  Inlet:      "));
-    Log.print(data.tempInlet.value, 1);
-    Log.println(data.tempInlet.valid ? "" : " [INVALID]");
-
-    Log.print(F("  Outlet:     "));
-    Log.print(data.tempOutlet.value, 1);
-    Log.println(data.tempOutlet.valid ? "" : " [INVALID]");
-
-    Log.print(F("  Ambient:    "));
-    Log.print(data.tempAmbient.value, 1);
-    Log.println(data.tempAmbient.valid ? "" : " [INVALID]");
-
-    Log.print(F("  Compressor: "));
-    Log.print(data.tempCompressor.value, 1);
-    Log.println(data.tempCompressor.valid ? "" : " [INVALID]");
-
-    Log.println(F("--- Electrical ---"));
-    Log.print(F("  Voltage: "));
-    Log.print(data.voltage.value, 1);
-    Log.println(F(" V"));
-
-    Log.print(F("  Current: "));
-    Log.print(data.current.value, 2);
-    Log.println(F(" A"));
-
-    Log.print(F("  Power:   "));
-    Log.print(data.power, 0);
-    Log.println(F(" W"));
-
-    Log.println(F("--- Pressure (PSI) ---"));
-    Log.print(F("  High: "));
-    Log.println(data.pressureHigh.value, 0);
-
-    Log.print(F("  Low:  "));
-    Log.println(data.pressureLow.value, 0);
-
-    Log.println(F("--- Status ---"));
-    Log.print(F("  Compressor: "));
-    Log.println(data.compressorRunning ? "ON" : "OFF");
-
-    Log.println(F("====================================="));
+    LOG_D(SENSORS, "========== SENSOR READINGS ==========\n"
+          "Time: %lu\n", data.readingTime);
+
+    LOG_D(SENSORS, "--- Temperatures (C) ---\n"
+          "  Inlet:      %.1f%s\n"
+          "  Outlet:     %.1f%s\n"
+          "  Ambient:    %.1f%s\n"
+          "  Compressor: %.1f%s\n",
+          data.tempInlet.value, data.tempInlet.valid ? "" : " [INVALID]",
+          data.tempOutlet.value, data.tempOutlet.valid ? "" : " [INVALID]",
+          data.tempAmbient.value, data.tempAmbient.valid ? "" : " [INVALID]",
+          data.tempCompressor.value, data.tempCompressor.valid ? "" : " [INVALID]");
+
+    LOG_D(SENSORS, "--- Electrical ---\n"
+          "  Voltage: %.1f V\n"
+          "  Current: %.2f A\n"
+          "  Power:   %.0f W\n",
+          data.voltage.value, data.current.value, data.power);
+
+    LOG_D(SENSORS, "--- Pressure (PSI) ---\n"
+          "  High: %.0f\n"
+          "  Low:  %.0f\n"
+          "--- Status ---\n"
+          "  Compressor: %s\n"
+          "=====================================\n",
+          data.pressureHigh.value, data.pressureLow.value,
+          data.compressorRunning ? "ON" : "OFF");
 }
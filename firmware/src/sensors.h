@@ -12,6 +12,7 @@
 #include <Arduino.h>
 #include "../config.h"
 #include "types.h"
+#include "config_store.h"
 
 // =============================================================================
 // FUNCTION DECLARATIONS
@@ -22,6 +23,14 @@
  */
 void initSensors();
 
+/**
+ * @brief Measure the current sensor's zero-current ADC bias
+ * @param samples ADC samples to average (~250 us each)
+ * @note Assumes no load current is flowing. initSensors() runs it with
+ *       CURRENT_ZERO_SAMPLES (CURRENT_ZERO_SAMPLES_FAST with FAST_BOOT).
+ */
+void calibrateCurrentZero(int samples);
+
 /**
  * @brief Read all sensors and return system data snapshot
  * @return SystemData structure with all sensor readings
@@ -42,6 +51,13 @@ SystemData simulateSensors();
  */
 float readTemperature(int pin);
 
+/**
+ * @brief Convert an NTC divider voltage to temperature (Steinhart-Hart)
+ * @param voltage Calibrated ADC input voltage
+ * @return Temperature in Celsius, or NAN if the resistance is implausible
+ */
+float ntcTemperature(float voltage);
+
 /**
  * @brief Read AC voltage RMS from ZMPT101B sensor
  * @param pin ADC pin connected to voltage sensor
@@ -0,0 +1,158 @@
+/**
+ * @file supervisor.cpp
+ * @brief Software watchdog supervisor implementation
+ */
+
+#include "supervisor.h"
+#include "globals.h"
+#include "postmortem.h"
+#include "tasks.h"
+#include <esp_task_wdt.h>
+#include <atomic>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+struct SupEntry {
+    const char* name;
+    uint32_t deadlineMs;
+    bool heartbeat;                 ///< false: operation (only timed while busy)
+    SupRecovery recover;
+    std::atomic<uint32_t> lastMs;   ///< Last check-in / operation start
+    std::atomic<bool> busy;
+    bool stuck;
+    uint32_t stuckSince;
+    uint32_t stalls;
+    uint32_t recoveries;
+};
+
+static SupEntry entries[SUP_COUNT] = {
+    {"sense",     SUP_SENSE_DEADLINE_MS,   true,  nullptr, {0}, {false}, false, 0, 0, 0},
+    {"net",       SUP_NET_DEADLINE_MS,     true,  nullptr, {0}, {false}, false, 0, 0, 0},
+    {"publish",   SUP_PUBLISH_DEADLINE_MS, false, nullptr, {0}, {false}, false, 0, 0, 0},
+    {"gsm",       SUP_GSM_DEADLINE_MS,     false, nullptr, {0}, {false}, false, 0, 0, 0},
+    {"dashboard", SUP_UI_DEADLINE_MS,      true,  nullptr, {0}, {false}, false, 0, 0, 0},
+    {"control",   SUP_CONTROL_DEADLINE_MS, true,  nullptr, {0}, {false}, false, 0, 0, 0},
+};
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static bool isLate(const SupEntry& e, uint32_t now) {
+    if (!e.heartbeat && !e.busy.load(std::memory_order_relaxed)) return false;
+    return now - e.lastMs.load(std::memory_order_relaxed) > e.deadlineMs;
+}
+
+/**
+ * @brief One supervision pass
+ *
+ * When several subsystems are late (e.g. the network heartbeat and the
+ * publish operation inside it), the one whose timer started last is the
+ * innermost and is blamed.
+ */
+static void superviseOnce() {
+    uint32_t now = millis();
+    int culprit = -1;
+    bool anyStuck = false;
+
+    for (int i = 0; i < SUP_COUNT; i++) {
+        SupEntry& e = entries[i];
+        if (isLate(e, now)) {
+            if (culprit < 0 ||
+                (int32_t)(e.lastMs.load() - entries[culprit].lastMs.load()) > 0) {
+                culprit = i;
+            }
+        } else if (e.stuck) {
+            e.stuck = false;
+            e.recoveries++;
+            Log.printf("[SUP] %s recovered after %u ms\n", e.name,
+                       (unsigned int)(now - e.stuckSince));
+        }
+        anyStuck |= e.stuck;
+    }
+    if (culprit < 0) {
+        if (!anyStuck) postMortemSetCulprit(nullptr);
+        return;
+    }
+
+    SupEntry& e = entries[culprit];
+    if (!e.stuck) {
+        e.stuck = true;
+        e.stuckSince = now;
+        e.stalls++;
+        postMortemSetCulprit(e.name);
+        Log.printf("[SUP] %s stalled (no progress for %u ms)%s\n", e.name,
+                   (unsigned int)(now - e.lastMs.load()),
+                   e.recover ? ", attempting recovery" : "");
+        if (e.recover) e.recover();
+        return;
+    }
+
+    if (now - e.stuckSince > SUP_RECOVERY_GRACE_MS) {
+        Log.printf("[SUP] %s still stalled after recovery, restarting\n", e.name);
+        Log.flush();
+        esp_restart();
+    }
+}
+
+static void supervisorTask(void* arg) {
+    esp_task_wdt_add(NULL);
+
+    for (;;) {
+        esp_task_wdt_reset();
+        postMortemTick();
+        superviseOnce();
+        vTaskDelay(pdMS_TO_TICKS(SUP_CHECK_PERIOD_MS));
+    }
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void setSupervisorRecovery(SupervisedId id, SupRecovery recover) {
+    entries[id].recover = recover;
+}
+
+void startSupervisor() {
+    uint32_t now = millis();
+    for (int i = 0; i < SUP_COUNT; i++) {
+        entries[i].lastMs.store(now);
+    }
+
+    if (startPinnedTask(supervisorTask, "sup", SUP_TASK_STACK, SUP_TASK_PRIO, SUP_TASK_CORE)) {
+        // Application tasks are supervised from here on
+        esp_task_wdt_delete(NULL);
+    }
+}
+
+void supervisorCheckIn(SupervisedId id) {
+    entries[id].lastMs.store(millis(), std::memory_order_relaxed);
+}
+
+void supervisorEnter(SupervisedId id) {
+    entries[id].lastMs.store(millis(), std::memory_order_relaxed);
+    entries[id].busy.store(true, std::memory_order_relaxed);
+}
+
+void supervisorLeave(SupervisedId id) {
+    entries[id].busy.store(false, std::memory_order_relaxed);
+    entries[id].lastMs.store(millis(), std::memory_order_relaxed);
+}
+
+size_t formatSupervisorJson(char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size, "{");
+    for (int i = 0; i < SUP_COUNT && w < size; i++) {
+        const SupEntry& e = entries[i];
+        w += snprintf(buf + w, size - w,
+                      "%s\"%s\":{\"stalls\":%u,\"recoveries\":%u,\"stuck\":%s}",
+                      i ? "," : "", e.name, (unsigned int)e.stalls,
+                      (unsigned int)e.recoveries, e.stuck ? "true" : "false");
+    }
+    if (w < size) w += snprintf(buf + w, size - w, "}");
+    return w < size ? w : size - 1;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file supervisor.h
+ * @brief Software watchdog with per-subsystem deadlines and recovery
+ *
+ * Each logical subsystem checks in with the supervisor instead of feeding
+ * the hardware task watchdog directly. Two kinds of supervision:
+ * - heartbeat: the subsystem must call supervisorCheckIn() at least every
+ *   deadline (task loops: sensing, network, UI)
+ * - operation: supervisorEnter()/supervisorLeave() (or SupervisedOp)
+ *   bracket a blocking operation, which must finish within the deadline
+ *   (MQTT publish, GSM modem exchanges)
+ *
+ * A dedicated high-priority task checks every SUP_CHECK_PERIOD_MS. When a
+ * subsystem misses its deadline it is named as the culprit (logged and
+ * written to the post-mortem RTC record), its recovery hook runs (e.g.
+ * shut down the MQTT socket, abort the modem UART), and if it is still stuck
+ * SUP_RECOVERY_GRACE_MS later the device restarts. Only the supervisor
+ * task itself is registered with the hardware task watchdog, which stays
+ * the last line of defence.
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// SUPERVISOR CONFIGURATION
+// =============================================================================
+
+#define SUP_TASK_STACK          3072
+#define SUP_TASK_PRIO           10     ///< Above every application task
+#define SUP_TASK_CORE           1
+#define SUP_CHECK_PERIOD_MS     1000
+#define SUP_RECOVERY_GRACE_MS   15000  ///< Recovery time before a full reset
+
+#define SUP_SENSE_DEADLINE_MS   10000  ///< Sensing checks in every <= 1 s slice
+#define SUP_NET_DEADLINE_MS     60000  ///< Whole network pass, incl. a publish
+#define SUP_PUBLISH_DEADLINE_MS 45000  ///< Transport + connect + buffer flush
+#define SUP_GSM_DEADLINE_MS     20000  ///< One modem exchange (SMS, GPRS attach)
+#define SUP_UI_DEADLINE_MS      10000  ///< UI loop sleeps <= 1 s per pass
+#define SUP_CONTROL_DEADLINE_MS 2000   ///< Control task ticks every 100 ms
+
+/**
+ * @brief Supervised subsystems
+ */
+enum SupervisedId {
+    SUP_SENSE = 0,   ///< Heartbeat: sensing task
+    SUP_NET,         ///< Heartbeat: network task
+    SUP_PUBLISH,     ///< Operation: MQTT connect/publish
+    SUP_GSM,         ///< Operation: modem exchange
+    SUP_DASHBOARD,   ///< Heartbeat: UI task (dashboard, portal)
+    SUP_CONTROL,     ///< Heartbeat: relay control task
+    SUP_COUNT        ///< Must be last - used for array sizing
+};
+
+/**
+ * @brief Targeted recovery; runs on the supervisor task, must not block
+ *
+ * It runs while the stalled task is still blocked, so it has to unblock
+ * that task from outside (shut down a socket, abort a stream); setting a
+ * flag for the stalled task to act on does nothing until it returns.
+ */
+typedef void (*SupRecovery)();
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Set a subsystem's recovery hook (nullptr: reset after the grace)
+ */
+void setSupervisorRecovery(SupervisedId id, SupRecovery recover);
+
+/**
+ * @brief Start the supervisor task and hand the hardware watchdog to it
+ * @note Call at the end of setup(), after the application tasks start.
+ *       Removes the calling task (setup/loop) from the task watchdog.
+ */
+void startSupervisor();
+
+/**
+ * @brief Heartbeat check-in (any task, lock-free)
+ */
+void supervisorCheckIn(SupervisedId id);
+
+/**
+ * @brief Mark the start/end of a supervised blocking operation
+ */
+void supervisorEnter(SupervisedId id);
+void supervisorLeave(SupervisedId id);
+
+/**
+ * @brief Write per-subsystem stall/recovery counters as JSON
+ */
+size_t formatSupervisorJson(char* buf, size_t size);
+
+/**
+ * @brief Brackets a supervised operation for its lifetime
+ */
+class SupervisedOp {
+    SupervisedId _id;
+public:
+    explicit SupervisedOp(SupervisedId id) : _id(id) { supervisorEnter(id); }
+    ~SupervisedOp() { supervisorLeave(_id); }
+};
+
+#endif // SUPERVISOR_H
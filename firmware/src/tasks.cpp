@@ -0,0 +1,174 @@
+/**
+ * @file tasks.cpp
+ * @brief FreeRTOS task helpers and inter-task queues
+ */
+
+#include "tasks.h"
+#include "globals.h"
+#include "log_level.h"
+#include "events.h"
+#include "alerts.h"
+#include "gsm.h"
+#include "memstats.h"
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static QueueHandle_t readingQueue = nullptr;
+static QueueHandle_t latestQueue = nullptr;   ///< Length 1, overwritten
+static QueueHandle_t smsQueue = nullptr;
+
+static JitterStats jitter = {0, 0, 0, 0, 0};
+
+// =============================================================================
+// EVENT BRIDGES
+// =============================================================================
+
+/**
+ * @brief New reading (sensing task): refresh the snapshot and hand the
+ * reading to the network task
+ */
+static void onReadingEvent(const Event& ev, void* ctx) {
+    publishLatestReading(*ev.reading);
+    if (!postReading(*ev.reading)) {
+        LOG_W(MAIN, "Reading queue full, reading dropped\n");
+    }
+}
+
+/**
+ * @brief Alert change: queue an SMS for critical alerts when the modem is up
+ *
+ * The cooldown starts when the network task has sent it; one that cannot
+ * be queued is published again at the next check.
+ */
+static void onAlertEvent(const Event& ev, void* ctx) {
+    if (ev.alert.level != ALERT_CRITICAL || !networkReady) return;
+
+    AlertType type = (AlertType)ev.alert.type;
+    char text[SMS_BUFFER_SIZE];
+    formatAlertMessage(type, ALERT_CRITICAL, ev.alert.value, text, sizeof(text));
+    markAlertQueued(type);   // Before posting: the send may finish first
+    if (!postSMS(ADMIN_PHONE, text, type)) {
+        recordAlertFailed(type);
+    }
+}
+
+// =============================================================================
+// SETUP
+// =============================================================================
+
+void initTaskQueues() {
+    readingQueue = xQueueCreate(READING_QUEUE_LEN, sizeof(SystemData));
+    latestQueue = xQueueCreate(1, sizeof(SystemData));
+    smsQueue = xQueueCreate(SMS_QUEUE_LEN, sizeof(OutgoingSMS));
+
+    subscribeEvent(EVT_READING, onReadingEvent);
+    subscribeEvent(EVT_ALERT, onAlertEvent);
+}
+
+bool startPinnedTask(TaskFunction_t fn, const char* name, uint32_t stack,
+                     UBaseType_t prio, BaseType_t core) {
+    TaskHandle_t handle = nullptr;
+    BaseType_t ok = xTaskCreatePinnedToCore(fn, name, stack, nullptr, prio, &handle, core);
+    if (ok != pdPASS) {
+        Log.print(F("[TASK] Failed to start "));
+        Log.println(name);
+        return false;
+    }
+    memRegisterTask(handle, name, stack);
+    Log.printf("[TASK] %s: core %d, prio %u, stack %u\n",
+               name, (int)core, (unsigned int)prio, (unsigned int)stack);
+    return true;
+}
+
+void sleepUntilTick(TickType_t wakeTick, SupervisedId id) {
+    const TickType_t slice = pdMS_TO_TICKS(TASK_CHECKIN_SLICE_MS);
+    for (;;) {
+        supervisorCheckIn(id);
+        TickType_t left = wakeTick - xTaskGetTickCount();
+        if ((int32_t)left <= 0) return;
+        vTaskDelay(left < slice ? left : slice);
+    }
+}
+
+// =============================================================================
+// READINGS
+// =============================================================================
+
+bool postReading(const SystemData& data) {
+    return xQueueSend(readingQueue, &data, 0) == pdTRUE;
+}
+
+bool receiveReading(SystemData& data, TickType_t wait) {
+    return xQueueReceive(readingQueue, &data, wait) == pdTRUE;
+}
+
+void publishLatestReading(const SystemData& data) {
+    xQueueOverwrite(latestQueue, &data);
+}
+
+bool getLatestReading(SystemData& data) {
+    return xQueuePeek(latestQueue, &data, 0) == pdTRUE;
+}
+
+// =============================================================================
+// SMS
+// =============================================================================
+
+bool postSMS(const char* phone, const char* text, int8_t alertType) {
+    OutgoingSMS sms;
+    sms.alertType = alertType;
+    strncpy(sms.phone, phone, sizeof(sms.phone) - 1);
+    sms.phone[sizeof(sms.phone) - 1] = '\0';
+    strncpy(sms.text, text, sizeof(sms.text) - 1);
+    sms.text[sizeof(sms.text) - 1] = '\0';
+
+    if (xQueueSend(smsQueue, &sms, 0) != pdTRUE) {
+        LOG_W(MAIN, "SMS queue full, dropped message to %s\n", phone);
+        return false;
+    }
+    return true;
+}
+
+bool receiveSMS(OutgoingSMS& sms) {
+    return xQueueReceive(smsQueue, &sms, 0) == pdTRUE;
+}
+
+bool sendQueuedSMS(const OutgoingSMS& sms) {
+    bool sent = sendSMS(sms.phone, sms.text);
+    if (sms.alertType >= 0) {
+        if (sent) {
+            recordAlertSent((AlertType)sms.alertType);
+        } else {
+            recordAlertFailed((AlertType)sms.alertType);
+        }
+    }
+    return sent;
+}
+
+// =============================================================================
+// JITTER
+// =============================================================================
+
+void recordSensorJitter(int32_t deviationUs) {
+    uint32_t us = deviationUs < 0 ? (uint32_t)-deviationUs : (uint32_t)deviationUs;
+
+    jitter.samples++;
+    jitter.lastUs = us;
+    jitter.sumUs += us;
+    if (us > jitter.maxUs) jitter.maxUs = us;
+    if (us > jitter.windowMaxUs) jitter.windowMaxUs = us;
+
+    if (jitter.samples % JITTER_REPORT_EVERY == 0) {
+        LOG_I(MAIN, "Sensor jitter: window max %u us, max %u us, mean %u us (n=%u)\n",
+              (unsigned int)jitter.windowMaxUs, (unsigned int)jitter.maxUs,
+              (unsigned int)(jitter.sumUs / jitter.samples),
+              (unsigned int)jitter.samples);
+        jitter.windowMaxUs = 0;
+    }
+}
+
+JitterStats getSensorJitter() {
+    return jitter;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file tasks.h
+ * @brief FreeRTOS task layout and the typed queues between tasks
+ *
+ * The firmware runs as four tasks:
+ * - control  (highest application priority, application core): steps the
+ *   relay outputs on a fixed tick (control.h)
+ * - sensing  (high priority, application core): reads sensors on a fixed
+ *   period and evaluates alerts; never touches the network
+ * - network  (protocol core): WiFi/GPRS transport, MQTT, SMS, the offline
+ *   buffer
+ * - UI       (Arduino loop(), lowest priority): dashboard, portal, LED
+ *
+ * Data only crosses task boundaries through the queues declared here (or
+ * event bus queue subscriptions, see events.h), so
+ * each module keeps a single owner: the buffer belongs to the network
+ * task, alert state to the sensing task, port 80 to the UI task.
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <Arduino.h>
+#include "../config.h"
+#include "types.h"
+#include "supervisor.h"
+
+// =============================================================================
+// TASK CONFIGURATION
+// =============================================================================
+
+#define SENSE_TASK_STACK      4096   ///< Bytes
+#define SENSE_TASK_PRIO       5      ///< Above loop() and the network task
+#define SENSE_TASK_CORE       1      ///< APP_CPU, away from the WiFi stack
+
+#define NET_TASK_STACK        8192   ///< JSON payload + TinyGSM/PubSubClient
+#define NET_TASK_PRIO         3
+#define NET_TASK_CORE         0      ///< PRO_CPU, next to the WiFi/lwIP tasks
+
+#define NET_SMS_DEADLINE_MS     2000   ///< SMS poll must finish within
+#define NET_PUBLISH_DEADLINE_MS 20000  ///< Connect + flush the buffer over GPRS
+#define NET_DIAG_DEADLINE_MS    5000
+
+#define READING_QUEUE_LEN     8      ///< Readings waiting to be buffered
+#define SMS_QUEUE_LEN         4      ///< Outgoing SMS waiting for the modem
+#define NET_EVENT_QUEUE_LEN   4      ///< Bus events waiting for the network task
+#define TASK_CHECKIN_SLICE_MS 1000   ///< Longest sleep between supervisor check-ins
+#define JITTER_REPORT_EVERY   30     ///< Log jitter stats every N readings
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief SMS queued for the network task to send
+ */
+struct OutgoingSMS {
+    char phone[20];
+    char text[SMS_BUFFER_SIZE];
+    int8_t alertType;   ///< AlertType it reports (sender records the result), -1 if none
+};
+
+/**
+ * @brief Sensing period jitter: actual wake time minus scheduled wake time
+ */
+struct JitterStats {
+    uint32_t samples;
+    uint32_t lastUs;
+    uint32_t maxUs;       ///< Since boot
+    uint32_t windowMaxUs; ///< Since the last report
+    uint64_t sumUs;
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Create the inter-task queues and attach them to the event bus
+ *
+ * New readings (EVT_READING) are forwarded to the snapshot and the
+ * network task; critical alerts (EVT_ALERT) are queued as SMS.
+ * @note Call from setup() before any producer can run
+ */
+void initTaskQueues();
+
+/**
+ * @brief Create a task pinned to a core
+ * @return true if the task was created
+ * @note The task's stack is tracked by memory telemetry (memstats.h)
+ */
+bool startPinnedTask(TaskFunction_t fn, const char* name, uint32_t stack,
+                     UBaseType_t prio, BaseType_t core);
+
+/**
+ * @brief Sleep until a tick, checking in with the supervisor in between
+ * @param wakeTick Absolute tick to wake at
+ * @param id Subsystem the calling task checks in as
+ */
+void sleepUntilTick(TickType_t wakeTick, SupervisedId id);
+
+// ---- Readings (sensing -> network) ----
+
+/**
+ * @brief Hand a reading to the network task for buffering/publishing
+ * @return false if the queue is full (reading dropped)
+ */
+bool postReading(const SystemData& data);
+
+/**
+ * @brief Take the next queued reading
+ * @param wait Ticks to block when the queue is empty
+ */
+bool receiveReading(SystemData& data, TickType_t wait);
+
+/**
+ * @brief Replace the latest-reading snapshot (single-slot mailbox)
+ */
+void publishLatestReading(const SystemData& data);
+
+/**
+ * @brief Copy the latest reading without removing it
+ * @return false if no reading has been taken yet
+ */
+bool getLatestReading(SystemData& data);
+
+// ---- SMS (any task -> network) ----
+
+/**
+ * @brief Queue an SMS for the network task (never blocks)
+ * @param alertType AlertType the SMS reports, or -1
+ * @return false if the queue is full
+ */
+bool postSMS(const char* phone, const char* text, int8_t alertType = -1);
+
+/**
+ * @brief Send a queued SMS and report the outcome of an alert SMS to the
+ *        alert cooldown (network task)
+ * @return true if sent
+ */
+bool sendQueuedSMS(const OutgoingSMS& sms);
+
+/**
+ * @brief Take the next queued SMS (never blocks)
+ */
+bool receiveSMS(OutgoingSMS& sms);
+
+// ---- Jitter ----
+
+/**
+ * @brief Record one sensing wake-up deviation
+ * @param deviationUs Actual minus scheduled wake time (negative = early)
+ */
+void recordSensorJitter(int32_t deviationUs);
+
+/**
+ * @brief Sensing jitter since boot
+ */
+JitterStats getSensorJitter();
+
+#endif // TASKS_H
@@ -0,0 +1,147 @@
+/**
+ * @file thermostat.cpp
+ * @brief Outlet temperature loop implementation
+ */
+
+#include "thermostat.h"
+#include <math.h>
+#include "log_level.h"
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+// Owned by the control task
+static float setpoints[MODE_COUNT];
+static OperatingMode loopMode = MODE_OFF;   ///< Mode the state below belongs to
+static float filtered = 0;
+static float lastFiltered = 0;
+static float integral = 0;
+static float modulator = 0;                 ///< Compressor-seconds owed (+) or ahead (-)
+static float demand = NAN;
+static bool call = true;
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/**
+ * @brief Stand aside: the compressor follows the mode
+ */
+static bool release() {
+    loopMode = MODE_OFF;
+    demand = NAN;
+    call = true;
+    return true;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void initThermostat() {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) {
+        setpoints[m] = NAN;
+    }
+    release();
+}
+
+bool setThermostatSetpoint(OperatingMode mode, float setpointC) {
+    if (mode != MODE_HEATING && mode != MODE_COOLING) return false;
+    if (!isnan(setpointC) &&
+        !(setpointC >= THERMO_SETPOINT_MIN_C && setpointC <= THERMO_SETPOINT_MAX_C)) {
+        return false;
+    }
+    setpoints[mode] = setpointC;
+    if (isnan(setpointC)) {
+        LOG_I(CTRL, "Outlet loop off for %s\n", mode == MODE_HEATING ? "heating" : "cooling");
+    } else {
+        LOG_I(CTRL, "Outlet setpoint for %s: %.1f C\n",
+              mode == MODE_HEATING ? "heating" : "cooling", setpointC);
+    }
+    return true;
+}
+
+float getThermostatSetpoint(OperatingMode mode) {
+    return mode < MODE_COUNT ? setpoints[mode] : NAN;
+}
+
+bool thermostatStep(const SystemData* reading, OperatingMode mode,
+                    bool compressorOn, bool compressorAvailable) {
+    float setpoint = getThermostatSetpoint(mode);
+    if (isnan(setpoint)) return release();
+
+    if (reading == nullptr || !reading->tempOutlet.valid || !reading->tempInlet.valid) {
+        if (loopMode != MODE_OFF) {
+            LOG_W(CTRL, "Outlet loop suspended: no valid inlet/outlet reading\n");
+        }
+        return release();
+    }
+
+    const float dt = THERMO_PERIOD_MS / 1000.0f;
+    const float sign = mode == MODE_HEATING ? 1.0f : -1.0f;
+    float outlet = reading->tempOutlet.value;
+    bool starting = mode != loopMode;
+
+    if (starting) {
+        loopMode = mode;
+        filtered = lastFiltered = outlet;
+        integral = 0;
+        modulator = 0;
+    }
+
+    filtered += (outlet - filtered) * dt / (THERMO_FILTER_S + dt);
+    float error = sign * (setpoint - filtered);
+    float feedForward = clampf(sign * (setpoint - reading->tempInlet.value) / THERMO_DESIGN_RISE_C,
+                               0.0f, 1.0f);
+    float derivative = -sign * (filtered - lastFiltered) / dt;
+    lastFiltered = filtered;
+
+    float raw = feedForward + THERMO_KP * (error + THERMO_TD_S * derivative) + integral;
+    demand = clampf(raw, 0.0f, 1.0f);
+
+    // Sigma-delta on the actual compressor state. It takes the unclipped
+    // output, so cycling ripple past 0..1 is repaid in run time instead of
+    // lost; its own bound stops it winding up
+    const float modLimit = 2 * THERMO_MOD_HYST_S;
+    modulator = clampf(modulator + (raw - (compressorOn ? 1.0f : 0.0f)) * dt,
+                       -modLimit, modLimit);
+
+    // Anti-windup: the modulator only reaches its bound when the compressor
+    // cannot deliver what is asked (running flat out, or held off), and
+    // then the integral stops moving in that direction. Ripple alone never
+    // gets there, so it cannot bias the integral. Frozen while a trip holds
+    // the compressor off.
+    bool saturated = (modulator >= modLimit && error > 0) ||
+                     (modulator <= -modLimit && error < 0);
+    if (compressorAvailable && !saturated) {
+        integral = clampf(integral + THERMO_KP * error * dt / THERMO_TI_S,
+                          -THERMO_I_LIMIT, THERMO_I_LIMIT);
+    }
+    if (starting) {
+        call = demand >= 0.5f;
+    } else if (!call && modulator >= THERMO_MOD_HYST_S) {
+        call = true;
+    } else if (call && modulator <= -THERMO_MOD_HYST_S) {
+        call = false;
+    }
+
+    LOG_D(CTRL, "Outlet %.2f (filtered %.2f) sp %.1f ff %.2f i %.3f demand %.2f %s\n",
+          outlet, filtered, setpoint, feedForward, integral, demand, call ? "on" : "off");
+    return call;
+}
+
+ThermoStatus getThermostatStatus() {
+    ThermoStatus s;
+    s.active = loopMode != MODE_OFF;
+    s.setpoint = getThermostatSetpoint(loopMode);
+    s.outlet = filtered;
+    s.demand = demand;
+    s.integral = integral;
+    s.call = call;
+    return s;
+}
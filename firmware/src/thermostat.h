@@ -0,0 +1,108 @@
+/**
+ * @file thermostat.h
+ * @brief Closed-loop outlet water temperature control (Stage 2)
+ *
+ * Holds the water outlet at a setpoint by cycling the single-speed
+ * compressor, instead of leaving it to the unit's own thermostat. The
+ * control task runs thermostatStep() every THERMO_PERIOD_MS:
+ * - feed-forward from the inlet: (setpoint - inlet) / THERMO_DESIGN_RISE_C
+ *   is the duty at which the average outlet sits at the setpoint
+ * - PI (optional D) on the low-pass filtered outlet corrects what the
+ *   feed-forward misses (actual rise, sensor offsets)
+ * - a sigma-delta modulator turns the output into compressor on/off
+ *   requests. It counts the compressor's actual state, so run or off time
+ *   the engine adds for the minimum on/off times is paid back in the next
+ *   cycle rather than accumulating as error
+ *
+ * Anti-windup: the integral is bounded, stops moving toward a side on
+ * which the modulator is pinned (compressor flat out or held off for
+ * longer than a cycle) and is frozen while a trip holds the compressor
+ * off. A clamp on the output alone is not enough with a cycling
+ * compressor: the outlet ripple saturates it every off period and would
+ * bias the integral.
+ *
+ * The engine (control.h) still owns the relays: the loop only asks for the
+ * compressor, and the restart delay, minimum run time and every interlock
+ * apply unchanged. Without a setpoint for the current mode, or without a
+ * valid inlet and outlet reading, the loop stands aside and the compressor
+ * follows the mode as before. Gains were tuned against the thermal plant
+ * in tools/vsim/plant.h (see test_thermostat.cpp).
+ */
+
+#ifndef THERMOSTAT_H
+#define THERMOSTAT_H
+
+#include <Arduino.h>
+#include "types.h"
+
+// =============================================================================
+// LOOP CONFIGURATION
+// =============================================================================
+
+#define THERMO_PERIOD_MS      10000   ///< Loop period (fixed rate)
+#define THERMO_SETPOINT_MIN_C 5.0f
+#define THERMO_SETPOINT_MAX_C 55.0f
+#define THERMO_DESIGN_RISE_C  5.0f    ///< Outlet above inlet at full capacity (nameplate)
+#define THERMO_FILTER_S       600.0f  ///< Outlet low-pass time constant
+#define THERMO_KP             0.10f   ///< Demand per degree C of error
+#define THERMO_TI_S           1800.0f ///< Integral time
+#define THERMO_TD_S           0.0f    ///< Derivative time (on the measurement)
+#define THERMO_I_LIMIT        0.5f    ///< Integral term bound (demand)
+#define THERMO_MOD_HYST_S     150.0f  ///< Modulator threshold, compressor-seconds
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief Loop state for status reports
+ */
+struct ThermoStatus {
+    bool active;        ///< Closing the loop (setpoint and valid sensors)
+    float setpoint;     ///< Current mode's setpoint, NAN without one
+    float outlet;       ///< Filtered outlet
+    float demand;       ///< 0..1, NAN when inactive
+    float integral;
+    bool call;          ///< Compressor requested
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Clear the setpoints and the loop state
+ */
+void initThermostat();
+
+/**
+ * @brief Set the outlet setpoint of a mode
+ * @param mode MODE_HEATING or MODE_COOLING
+ * @param setpointC THERMO_SETPOINT_MIN_C..MAX_C, or NAN to hand the mode
+ *        back to the unit's own thermostat
+ * @return false for another mode or a setpoint out of range
+ */
+bool setThermostatSetpoint(OperatingMode mode, float setpointC);
+
+/**
+ * @brief Outlet setpoint of a mode (NAN without one)
+ */
+float getThermostatSetpoint(OperatingMode mode);
+
+/**
+ * @brief One loop step; call every THERMO_PERIOD_MS
+ * @param reading Latest reading, or nullptr if there is no fresh one
+ * @param mode Requested operating mode
+ * @param compressorOn Compressor relay state
+ * @param compressorAvailable False while a trip or the E-stop holds it off
+ * @return True if the compressor may run (always true when inactive)
+ */
+bool thermostatStep(const SystemData* reading, OperatingMode mode,
+                    bool compressorOn, bool compressorAvailable);
+
+/**
+ * @brief Loop state as of the last step
+ */
+ThermoStatus getThermostatStatus();
+
+#endif // THERMOSTAT_H
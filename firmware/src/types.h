@@ -33,6 +33,7 @@ enum AlertType {
     ALERT_PRESSURE_HIGH,
     ALERT_PRESSURE_LOW,
     ALERT_OVERCURRENT,
+    ALERT_MEMORY,      ///< Internal: heap exhaustion or fragmentation (memstats.h)
     ALERT_TYPE_COUNT  ///< Must be last - used for array sizing
 };
 
@@ -47,6 +48,15 @@ enum SMSCommand {
     SMS_CMD_UNKNOWN
 };
 
+/**
+ * @brief Outcome of parsing an AT+CMGL listing
+ */
+enum SMSParseResult {
+    SMS_PARSE_NONE = 0,  ///< No +CMGL entry in the response
+    SMS_PARSE_OK,        ///< Message extracted from the first entry
+    SMS_PARSE_ERROR      ///< Entry present but malformed
+};
+
 /**
  * @brief GSM module state machine
  */
@@ -59,6 +69,54 @@ enum GSMState {
     GSM_STATE_ERROR
 };
 
+/**
+ * @brief Operating modes for heat pump (Stage 2 control)
+ */
+enum OperatingMode {
+    MODE_OFF = 0,
+    MODE_COOLING,
+    MODE_HEATING,
+    MODE_FAN_ONLY,
+    MODE_COUNT        ///< Must be last - used for array sizing
+};
+
+/**
+ * @brief Fan speed levels
+ */
+enum FanSpeed {
+    FAN_OFF = 0,
+    FAN_LOW,
+    FAN_MEDIUM,
+    FAN_HIGH,
+    FAN_AUTO,         ///< Medium whenever the mode runs the fan
+    FAN_SPEED_COUNT   ///< Must be last - used for array sizing
+};
+
+/**
+ * @brief Control command types
+ */
+enum ControlCommandType {
+    CTRL_CMD_NONE = 0,
+    CTRL_CMD_SET_MODE,
+    CTRL_CMD_SET_FAN,
+    CTRL_CMD_DEFROST,
+    CTRL_CMD_EMERGENCY_STOP,
+    CTRL_CMD_STATUS,
+    CTRL_CMD_SET_SETPOINT
+};
+
+/**
+ * @brief Command execution result codes
+ */
+enum CommandResult {
+    CMD_SUCCESS = 0,
+    CMD_REJECTED_INTERLOCK,  ///< E-stop active or a relay dependency not met
+    CMD_REJECTED_COOLDOWN,   ///< Compressor minimum off time not yet elapsed
+    CMD_REJECTED_INVALID,    ///< Invalid command or parameters
+    CMD_REJECTED_SAFETY,     ///< A sensor trip holds a needed relay off
+    CMD_FAILED               ///< Command queue full
+};
+
 /**
  * @brief Active MQTT transport type
  */
@@ -158,6 +216,7 @@ inline const char* getAlertTypeName(AlertType type) {
         case ALERT_PRESSURE_HIGH:   return "HIGH PRESSURE";
         case ALERT_PRESSURE_LOW:    return "LOW PRESSURE";
         case ALERT_OVERCURRENT:     return "OVERCURRENT";
+        case ALERT_MEMORY:          return "LOW MEMORY";
         default:                    return "UNKNOWN";
     }
 }
@@ -0,0 +1,255 @@
+/**
+ * @file wifi_link.cpp
+ * @brief WiFi station connect with cached fast-path reconnect
+ */
+
+#include "wifi_link.h"
+#include "globals.h"
+#include <Preferences.h>
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+/** @brief Survive soft resets (watchdog, ESP.restart); zeroed on power-on */
+RTC_DATA_ATTR static WiFiLinkCache rtcLink;
+RTC_DATA_ATTR static WiFiLeaseCache rtcLease;
+
+static WiFiConnectStats stats = {0, false, false, false, 0, 0};
+
+/** @brief Connected on rtcLease applied without DHCP; nothing renews it */
+static bool onReusedLease = false;
+static unsigned long leaseSyncMs = 0;
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint32_t hashSSID(const char* ssid) {
+    uint32_t h = 2166136261UL;
+    while (*ssid) {
+        h ^= (uint8_t)*ssid++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static bool hasStaticIP() {
+    return strlen(WIFI_STATIC_IP) > 0;
+}
+
+/**
+ * @brief Return a valid cache entry for the current SSID, or nullptr
+ *
+ * Falls back to the NVS copy after a power cycle has cleared RTC memory.
+ */
+static const WiFiLinkCache* getCachedLink() {
+    uint32_t h = hashSSID(runtimeCfg.wifiSSID);
+
+    if (rtcLink.magic != WIFI_LINK_MAGIC) {
+        Preferences prefs;
+        prefs.begin(WIFI_LINK_NVS_NS, true);
+        if (prefs.getBytesLength("link") == sizeof(rtcLink)) {
+            prefs.getBytes("link", &rtcLink, sizeof(rtcLink));
+        }
+        prefs.end();
+    }
+
+    if (rtcLink.magic != WIFI_LINK_MAGIC || rtcLink.ssidHash != h) {
+        return nullptr;
+    }
+    return &rtcLink;
+}
+
+/**
+ * @brief The RTC lease, if the fast path may apply it for this SSID
+ *
+ * A lease DHCP was renewing is at least half its lease time from expiry
+ * at any moment, so with WIFI_LEASE_REUSE_MAX_MS at or below that it
+ * stays valid for the whole reuse window, counted from the reset.
+ */
+static const WiFiLeaseCache* getReusableLease(uint32_t ssidHash) {
+    if (!WIFI_FAST_REUSE_LEASE || hasStaticIP()) return nullptr;
+    if (rtcLease.ssidHash != ssidHash || rtcLease.ip == 0) return nullptr;
+    if (rtcLease.ageMs >= WIFI_LEASE_REUSE_MAX_MS) return nullptr;
+    return &rtcLease;
+}
+
+/**
+ * @brief Record the lease DHCP just handed out (RTC only)
+ */
+static void storeLease() {
+    rtcLease.ssidHash = hashSSID(runtimeCfg.wifiSSID);
+    rtcLease.ip = (uint32_t)WiFi.localIP();
+    rtcLease.gateway = (uint32_t)WiFi.gatewayIP();
+    rtcLease.subnet = (uint32_t)WiFi.subnetMask();
+    rtcLease.dns = (uint32_t)WiFi.dnsIP();
+    rtcLease.ageMs = 0;
+}
+
+/**
+ * @brief Record the current link; writes NVS only when it changed
+ */
+static void storeLink() {
+    WiFiLinkCache link;
+    memset(&link, 0, sizeof(link));
+    link.magic = WIFI_LINK_MAGIC;
+    link.ssidHash = hashSSID(runtimeCfg.wifiSSID);
+    memcpy(link.bssid, WiFi.BSSID(), sizeof(link.bssid));
+    link.channel = WiFi.channel();
+
+    if (memcmp(&link, &rtcLink, sizeof(link)) == 0) return;
+
+    rtcLink = link;
+    Preferences prefs;
+    prefs.begin(WIFI_LINK_NVS_NS, false);
+    prefs.putBytes("link", &rtcLink, sizeof(rtcLink));
+    prefs.end();
+}
+
+/**
+ * @brief Apply static IP, reused lease, or DHCP before WiFi.begin()
+ */
+static void applyIPConfig(const WiFiLeaseCache* lease) {
+    if (hasStaticIP()) {
+        IPAddress ip, gw, mask, dns;
+        ip.fromString(WIFI_STATIC_IP);
+        gw.fromString(WIFI_STATIC_GATEWAY);
+        mask.fromString(WIFI_STATIC_SUBNET);
+        if (!dns.fromString(WIFI_STATIC_DNS)) dns = gw;
+        WiFi.config(ip, gw, mask, dns);
+    } else if (lease != nullptr) {
+        WiFi.config(IPAddress(lease->ip), IPAddress(lease->gateway),
+                    IPAddress(lease->subnet), IPAddress(lease->dns));
+    } else {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // DHCP
+    }
+}
+
+static bool waitConnected(unsigned long timeout) {
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < timeout) {
+        delay(20);
+    }
+    return WiFi.status() == WL_CONNECTED;
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+bool connectWiFi() {
+    Log.print(F("[WIFI] Connecting to "));
+    Log.println(runtimeCfg.wifiSSID);
+
+    // Keep the AP interface up if the portal is serving clients
+    WiFi.mode(isPortalActive() ? WIFI_AP_STA : WIFI_STA);
+    WiFi.persistent(false);  // We manage our own cache; avoid flash writes
+
+    unsigned long start = millis();
+    bool connected = false;
+    stats.fastPath = false;
+    stats.leaseReused = false;
+
+    // Fast path: known AP, known channel - no scan, and after a soft reset
+    // no DHCP either
+    const WiFiLinkCache* link = getCachedLink();
+    if (link != nullptr) {
+        const WiFiLeaseCache* lease = getReusableLease(link->ssidHash);
+        stats.fastAttempts++;
+        applyIPConfig(lease);
+        WiFi.begin(runtimeCfg.wifiSSID, runtimeCfg.wifiPass, link->channel, link->bssid, true);
+        connected = waitConnected(WIFI_FAST_CONNECT_TIMEOUT);
+        if (connected) {
+            stats.fastPath = true;
+            stats.leaseReused = lease != nullptr;
+            stats.fastHits++;
+        } else {
+            // Keep the entry: a router outage should not cost us the
+            // fast path once it is back. A full connect overwrites it.
+            Log.println(F("[WIFI] Fast path failed, doing full scan"));
+            WiFi.disconnect();
+        }
+    }
+
+    // Slow path: full channel scan + DHCP (or static IP)
+    if (!connected) {
+        applyIPConfig(nullptr);
+        WiFi.begin(runtimeCfg.wifiSSID, runtimeCfg.wifiPass);
+        connected = waitConnected(WIFI_CONNECT_TIMEOUT);
+    }
+
+    stats.durationMs = millis() - start;
+    stats.success = connected;
+
+    if (connected) {
+        storeLink();
+        onReusedLease = stats.leaseReused;
+        leaseSyncMs = millis();
+        if (!onReusedLease && !hasStaticIP()) storeLease();
+        Log.print(F("[WIFI] Connected, IP: "));
+        Log.print(WiFi.localIP());
+        Log.print(F(" ch "));
+        Log.print(WiFi.channel());
+        Log.print(stats.leaseReused ? F(" (fast, reused lease, ")
+                  : stats.fastPath ? F(" (fast, ") : F(" (full, "));
+        Log.print(stats.durationMs);
+        Log.println(F(" ms)"));
+        return true;
+    }
+
+    Log.print(F("[WIFI] Connection failed after "));
+    Log.print(stats.durationMs);
+    Log.println(F(" ms"));
+    WiFi.disconnect(!isPortalActive());
+    return false;
+}
+
+bool isWiFiConnected() {
+    return WiFi.status() == WL_CONNECTED;
+}
+
+void forgetWiFiLink() {
+    rtcLink.magic = 0;
+    rtcLease.ssidHash = 0;
+    Preferences prefs;
+    prefs.begin(WIFI_LINK_NVS_NS, false);
+    prefs.remove("link");
+    prefs.end();
+}
+
+void serviceWiFiLink() {
+    if (!isWiFiConnected() || hasStaticIP()) return;
+
+    if (!onReusedLease) {
+        // DHCP renews this one; just follow an address change
+        if ((uint32_t)WiFi.localIP() != rtcLease.ip) storeLease();
+        return;
+    }
+
+    unsigned long now = millis();
+    rtcLease.ageMs += now - leaseSyncMs;
+    leaseSyncMs = now;
+    if (rtcLease.ageMs < WIFI_LEASE_REUSE_MAX_MS) return;
+
+    Log.println(F("[WIFI] Reused lease reached its age limit, reconnecting with DHCP"));
+    rtcLease.ssidHash = 0;
+    onReusedLease = false;
+    WiFi.disconnect();
+}
+
+const WiFiConnectStats& getWiFiConnectStats() {
+    return stats;
+}
+
+size_t formatWiFiLinkJson(char* buf, size_t size) {
+    if (size == 0) return 0;
+
+    size_t w = snprintf(buf, size,
+                        "{\"connect_ms\":%lu,\"fast\":%s,\"lease_reused\":%s,\"ok\":%s,"
+                        "\"fast_hits\":%u,\"fast_attempts\":%u}",
+                        stats.durationMs, stats.fastPath ? "true" : "false",
+                        stats.leaseReused ? "true" : "false", stats.success ? "true" : "false",
+                        (unsigned int)stats.fastHits, (unsigned int)stats.fastAttempts);
+    return w < size ? w : size - 1;
+}
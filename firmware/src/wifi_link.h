@@ -0,0 +1,116 @@
+/**
+ * @file wifi_link.h
+ * @brief WiFi station connect with cached fast-path reconnect
+ *
+ * The last successful BSSID and channel are cached in RTC memory
+ * (survives soft resets) and NVS (survives power loss). A reconnect first
+ * tries that exact AP on that channel, skipping the channel scan; only if
+ * that fails does it fall back to a full WiFi.begin(ssid, pass).
+ *
+ * The DHCP lease is kept in RTC memory only, with its age. After a soft
+ * reset the fast path applies it as-is and skips DHCP too, as long as it
+ * is younger than WIFI_LEASE_REUSE_MAX_MS. Nothing renews a lease applied
+ * that way, so serviceWiFiLink() drops the link once it reaches that age
+ * and the reconnect gets a fresh lease. After power loss the lease may
+ * have expired and been handed out again, so it is never reused.
+ */
+
+#ifndef WIFI_LINK_H
+#define WIFI_LINK_H
+
+#include <Arduino.h>
+#include "../config.h"
+
+// =============================================================================
+// CACHE CONFIGURATION
+// =============================================================================
+
+#define WIFI_LINK_NVS_NS   "hpwifi"   ///< NVS namespace for the link cache
+#define WIFI_LINK_MAGIC    0x57464C32UL  ///< "WFL2" - cache layout version
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief Last known-good station link parameters (RTC and NVS)
+ */
+struct WiFiLinkCache {
+    uint32_t magic;      ///< WIFI_LINK_MAGIC when valid
+    uint32_t ssidHash;   ///< FNV-1a of the SSID this entry belongs to
+    uint8_t bssid[6];    ///< AP MAC address
+    uint8_t channel;     ///< Primary channel
+    uint8_t reserved;
+};
+
+/**
+ * @brief Last DHCP lease (RTC only)
+ */
+struct WiFiLeaseCache {
+    uint32_t ssidHash;   ///< Network the lease belongs to, 0 if none
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t ageMs;      ///< Time connected on it, as of the last serviceWiFiLink()
+};
+
+/**
+ * @brief Timing of the most recent connect attempt
+ */
+struct WiFiConnectStats {
+    unsigned long durationMs;  ///< Time from begin() to connected/failed
+    bool fastPath;             ///< true if the cached BSSID/channel path succeeded
+    bool leaseReused;          ///< true if the fast path skipped DHCP
+    bool success;              ///< true if the station connected
+    uint32_t fastAttempts;     ///< Fast-path attempts since boot
+    uint32_t fastHits;         ///< Fast-path successes since boot
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Connect to the configured WiFi network
+ *
+ * Tries the cached fast path first (WIFI_FAST_CONNECT_TIMEOUT), then a
+ * full scan + DHCP connect (WIFI_CONNECT_TIMEOUT). Keeps the AP interface
+ * up if the provisioning portal is active.
+ *
+ * @return true if connected
+ */
+bool connectWiFi();
+
+/**
+ * @brief Check if the station is connected
+ * @return true if WiFi.status() == WL_CONNECTED
+ */
+bool isWiFiConnected();
+
+/**
+ * @brief Drop the cached link so the next connect does a full scan
+ */
+void forgetWiFiLink();
+
+/**
+ * @brief Age the lease and drop a reused one at WIFI_LEASE_REUSE_MAX_MS
+ *
+ * Call from the net task every pass. The caller's "WiFi dropped" handling
+ * then reconnects with DHCP.
+ */
+void serviceWiFiLink();
+
+/**
+ * @brief Get timing of the most recent connectWiFi() call
+ */
+const WiFiConnectStats& getWiFiConnectStats();
+
+/**
+ * @brief Write the connect stats as JSON:
+ * {"connect_ms":..,"fast":..,"lease_reused":..,"ok":..,"fast_hits":..,"fast_attempts":..}
+ * @return Characters written (clamped to size - 1)
+ */
+size_t formatWiFiLinkJson(char* buf, size_t size);
+
+#endif // WIFI_LINK_H
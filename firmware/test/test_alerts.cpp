@@ -0,0 +1,217 @@
+/**
+ * @file test_alerts.cpp
+ * @brief Alert thresholds, transitions and cooldown as seen on the event bus
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "alerts.h"
+#include "globals.h"
+#include "events.h"
+#include "host_hooks.h"
+
+static std::vector<AlertEvent> alertLog;
+
+/// What the test notifier does with a critical alert, like the SMS path
+enum NotifierMode { SMS_SENT, SMS_FAILED, SMS_IN_FLIGHT };
+static NotifierMode notifier = SMS_SENT;
+
+static void onAlert(const Event& ev, void*) {
+    alertLog.push_back(ev.alert);
+    if (ev.alert.level != ALERT_CRITICAL) return;
+
+    AlertType type = (AlertType)ev.alert.type;
+    markAlertQueued(type);
+    if (notifier == SMS_SENT) recordAlertSent(type);
+    if (notifier == SMS_FAILED) recordAlertFailed(type);
+}
+
+/** @brief A reading with every value in its normal band */
+static SystemData normalReading() {
+    SystemData d;
+    d.voltage.value = 230.0f;
+    d.current.value = 8.0f;
+    d.tempCompressor.value = 70.0f;
+    d.pressureHigh.value = 280.0f;
+    d.pressureLow.value = 70.0f;
+    return d;
+}
+
+class AlertsTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        subscribeEvent(EVT_ALERT, onAlert);
+    }
+
+    void SetUp() override {
+        // Start well past boot: the cooldown is measured from time 0
+        hostClockManual(3600ULL * 1000000ULL);
+        hostNvsErase();
+        loadConfig(runtimeCfg);
+        initAlerts();
+        alertLog.clear();
+        notifier = SMS_SENT;
+    }
+};
+
+TEST_F(AlertsTest, VoltageBands) {
+    bool high = false;
+    EXPECT_EQ(checkVoltage(230.0f, &high), ALERT_OK);
+    EXPECT_EQ(checkVoltage(VOLTAGE_HIGH_WARNING, &high), ALERT_WARNING);
+    EXPECT_TRUE(high);
+    EXPECT_EQ(checkVoltage(VOLTAGE_HIGH_CRITICAL + 1, &high), ALERT_CRITICAL);
+    EXPECT_TRUE(high);
+    EXPECT_EQ(checkVoltage(VOLTAGE_LOW_WARNING, &high), ALERT_WARNING);
+    EXPECT_FALSE(high);
+    EXPECT_EQ(checkVoltage(VOLTAGE_LOW_CRITICAL - 1, &high), ALERT_CRITICAL);
+    EXPECT_FALSE(high);
+}
+
+TEST_F(AlertsTest, OtherBands) {
+    EXPECT_EQ(checkCompressorTemp(COMP_TEMP_WARNING), ALERT_WARNING);
+    EXPECT_EQ(checkCompressorTemp(COMP_TEMP_CRITICAL), ALERT_CRITICAL);
+    EXPECT_EQ(checkPressureHigh(PRESSURE_HIGH_WARNING - 1), ALERT_OK);
+    EXPECT_EQ(checkPressureHigh(PRESSURE_HIGH_CRITICAL), ALERT_CRITICAL);
+    EXPECT_EQ(checkPressureLow(PRESSURE_LOW_WARNING), ALERT_WARNING);
+    EXPECT_EQ(checkPressureLow(PRESSURE_LOW_CRITICAL), ALERT_CRITICAL);
+    EXPECT_EQ(checkCurrent(CURRENT_WARNING), ALERT_WARNING);
+    EXPECT_EQ(checkCurrent(CURRENT_CRITICAL), ALERT_CRITICAL);
+}
+
+TEST_F(AlertsTest, NormalReadingPublishesNothing) {
+    SystemData d = normalReading();
+    checkAllAlerts(d);
+    EXPECT_TRUE(alertLog.empty());
+    EXPECT_EQ(d.voltage.alertLevel, ALERT_OK);
+}
+
+TEST_F(AlertsTest, CriticalIsPublishedOnceThenRepeatedAfterCooldown) {
+    SystemData d = normalReading();
+    d.voltage.value = VOLTAGE_HIGH_CRITICAL + 10;
+
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 1u);
+    EXPECT_EQ(alertLog[0].type, ALERT_VOLTAGE_HIGH);
+    EXPECT_EQ(alertLog[0].level, ALERT_CRITICAL);
+    EXPECT_EQ(alertLog[0].prevLevel, ALERT_OK);
+    EXPECT_EQ(d.voltage.alertLevel, ALERT_CRITICAL);
+
+    // Still critical inside the cooldown: silent
+    hostAdvanceMs(ALERT_COOLDOWN / 2);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 1u);
+
+    // Past the cooldown: reminder with level == prevLevel
+    hostAdvanceMs(ALERT_COOLDOWN);
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 2u);
+    EXPECT_EQ(alertLog[1].level, ALERT_CRITICAL);
+    EXPECT_EQ(alertLog[1].prevLevel, ALERT_CRITICAL);
+}
+
+TEST_F(AlertsTest, CooldownHoldsAcrossMillisWrap) {
+    // First critical 2 minutes before millis() wraps
+    hostClockManual(((1ULL << 32) - 120000ULL) * 1000ULL);
+    SystemData d = normalReading();
+    d.voltage.value = VOLTAGE_HIGH_CRITICAL + 10;
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 1u);
+
+    // Wrapped, but only 3 of 5 minutes elapsed: still silent
+    hostAdvanceMs(180000);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 1u);
+
+    hostAdvanceMs(ALERT_COOLDOWN - 180000);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 2u);
+}
+
+TEST_F(AlertsTest, FailedSMSIsRetriedWithoutCooldown) {
+    SystemData d = normalReading();
+    d.pressureHigh.value = PRESSURE_HIGH_CRITICAL + 10;
+
+    // Modem down: every check publishes again so the SMS is retried
+    notifier = SMS_FAILED;
+    checkAllAlerts(d);
+    hostAdvanceMs(SENSOR_READ_INTERVAL);
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 2u);
+    EXPECT_EQ(alertLog[1].prevLevel, ALERT_CRITICAL);
+
+    // Sent: now the cooldown holds
+    notifier = SMS_SENT;
+    hostAdvanceMs(SENSOR_READ_INTERVAL);
+    checkAllAlerts(d);
+    hostAdvanceMs(SENSOR_READ_INTERVAL);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 3u);
+}
+
+TEST_F(AlertsTest, QueuedSMSHoldsReminders) {
+    SystemData d = normalReading();
+    d.current.value = CURRENT_CRITICAL + 1;
+
+    notifier = SMS_IN_FLIGHT;
+    checkAllAlerts(d);
+    hostAdvanceMs(ALERT_COOLDOWN * 2);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 1u);
+
+    // The send finishes: cooldown runs from now
+    recordAlertSent(ALERT_OVERCURRENT);
+    hostAdvanceMs(ALERT_COOLDOWN / 2);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 1u);
+    hostAdvanceMs(ALERT_COOLDOWN);
+    checkAllAlerts(d);
+    EXPECT_EQ(alertLog.size(), 2u);
+}
+
+TEST_F(AlertsTest, ClearingIsPublishedAndReArmsCooldown) {
+    SystemData d = normalReading();
+    d.current.value = CURRENT_CRITICAL + 1;
+    checkAllAlerts(d);
+
+    char summary[128];
+    getAlertSummary(summary, sizeof(summary));
+    EXPECT_NE(strstr(summary, "OVERCURRENT"), nullptr);
+
+    d.current.value = 8.0f;
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 2u);
+    EXPECT_EQ(alertLog[1].level, ALERT_OK);
+    EXPECT_EQ(alertLog[1].prevLevel, ALERT_CRITICAL);
+    getAlertSummary(summary, sizeof(summary));
+    EXPECT_STREQ(summary, "No active alerts");
+}
+
+TEST_F(AlertsTest, WarningTransitionsArePublished) {
+    SystemData d = normalReading();
+    d.tempCompressor.value = COMP_TEMP_WARNING + 1;
+    checkAllAlerts(d);
+    checkAllAlerts(d);
+    ASSERT_EQ(alertLog.size(), 1u);
+    EXPECT_EQ(alertLog[0].type, ALERT_COMPRESSOR_TEMP);
+    EXPECT_EQ(alertLog[0].level, ALERT_WARNING);
+}
+
+TEST_F(AlertsTest, ThresholdsFollowConfig) {
+    RuntimeConfig cfg = runtimeCfg;
+    ASSERT_TRUE(setConfigField(cfg, "current_crit", "9.5"));
+    saveConfig(cfg);
+
+    EXPECT_EQ(checkCurrent(10.0f), ALERT_CRITICAL);
+}
+
+TEST_F(AlertsTest, MessageFormat) {
+    char msg[160];
+    formatAlertMessage(ALERT_PRESSURE_HIGH, ALERT_CRITICAL, 455.4f, msg, sizeof(msg));
+    EXPECT_NE(strstr(msg, "ALERT: HIGH PRESSURE"), nullptr);
+    EXPECT_NE(strstr(msg, "Level: CRITICAL"), nullptr);
+    EXPECT_NE(strstr(msg, "Value: 455 PSI"), nullptr);
+    EXPECT_NE(strstr(msg, "Device: " DEVICE_ID), nullptr);
+
+    formatAlertMessage(ALERT_VOLTAGE_LOW, ALERT_WARNING, 212.34f, msg, sizeof(msg));
+    EXPECT_NE(strstr(msg, "Value: 212.3 V"), nullptr);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_buffer.cpp
+ * @brief Offline reading buffer: FIFO order, overflow, status text
+ */
+
+#include <gtest/gtest.h>
+#include "buffer.h"
+
+static SystemData reading(unsigned long t) {
+    SystemData d;
+    d.readingTime = t;
+    return d;
+}
+
+class BufferTest : public ::testing::Test {
+protected:
+    void SetUp() override { initBuffer(); }
+};
+
+TEST_F(BufferTest, StartsEmpty) {
+    EXPECT_FALSE(bufferHasData());
+    EXPECT_EQ(bufferCount(), 0);
+    EXPECT_EQ(getNextBufferedData(), nullptr);
+    EXPECT_FALSE(didBufferOverflow());
+}
+
+TEST_F(BufferTest, ReturnsReadingsOldestFirst) {
+    for (unsigned long t = 1; t <= 3; t++) bufferData(reading(t));
+    ASSERT_EQ(bufferCount(), 3);
+
+    for (unsigned long t = 1; t <= 3; t++) {
+        SystemData* d = getNextBufferedData();
+        ASSERT_NE(d, nullptr);
+        EXPECT_EQ(d->readingTime, t);
+        markDataPublished();
+    }
+    EXPECT_FALSE(bufferHasData());
+}
+
+TEST_F(BufferTest, PeekDoesNotConsume) {
+    bufferData(reading(7));
+    EXPECT_EQ(getNextBufferedData()->readingTime, 7u);
+    EXPECT_EQ(getNextBufferedData()->readingTime, 7u);
+    EXPECT_EQ(bufferCount(), 1);
+}
+
+TEST_F(BufferTest, OverflowDropsOldest) {
+    for (unsigned long t = 0; t < BUFFER_SIZE + 5; t++) bufferData(reading(t));
+
+    EXPECT_TRUE(isBufferFull());
+    EXPECT_TRUE(didBufferOverflow());
+    EXPECT_EQ(bufferCount(), BUFFER_SIZE);
+    EXPECT_EQ(getNextBufferedData()->readingTime, 5u);
+
+    resetOverflowFlag();
+    EXPECT_FALSE(didBufferOverflow());
+}
+
+TEST_F(BufferTest, WrapsAroundAfterDraining) {
+    for (unsigned long t = 0; t < BUFFER_SIZE - 1; t++) bufferData(reading(t));
+    for (int i = 0; i < BUFFER_SIZE - 2; i++) markDataPublished();
+    for (unsigned long t = 1000; t < 1010; t++) bufferData(reading(t));
+
+    EXPECT_EQ(bufferCount(), 11);
+    EXPECT_EQ(getNextBufferedData()->readingTime, (unsigned long)BUFFER_SIZE - 2);
+    markDataPublished();
+    EXPECT_EQ(getNextBufferedData()->readingTime, 1000u);
+}
+
+TEST_F(BufferTest, StatusText) {
+    char buf[64];
+    bufferData(reading(1));
+    getBufferStatus(buf, sizeof(buf));
+    EXPECT_STREQ(buf, ("Buffer: 1/" + std::to_string(BUFFER_SIZE)).c_str());
+
+    for (int i = 0; i < BUFFER_SIZE; i++) bufferData(reading(2));
+    getBufferStatus(buf, sizeof(buf));
+    EXPECT_NE(strstr(buf, "(OVERFLOW)"), nullptr);
+
+    clearBuffer();
+    EXPECT_EQ(bufferCount(), 0);
+    EXPECT_FALSE(didBufferOverflow());
+}
+
+TEST(BufferInstanceTest, IndependentOfModuleBuffer) {
+    initBuffer();
+    DataBuffer own;
+    bufferReset(own);
+
+    EXPECT_TRUE(bufferPush(own, reading(7)));
+    EXPECT_EQ(bufferCount(), 0);
+    ASSERT_NE(bufferPeek(own), nullptr);
+    EXPECT_EQ(bufferPeek(own)->readingTime, 7u);
+
+    for (int i = 1; i < BUFFER_SIZE; i++) EXPECT_TRUE(bufferPush(own, reading(8)));
+    EXPECT_FALSE(bufferPush(own, reading(9)));
+    EXPECT_TRUE(own.overflow);
+
+    bufferPop(own);
+    EXPECT_EQ(own.count, BUFFER_SIZE - 1);
+}
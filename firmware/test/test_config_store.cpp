@@ -0,0 +1,190 @@
+/**
+ * @file test_config_store.cpp
+ * @brief Config blob persistence, validation and change notification
+ */
+
+#include <gtest/gtest.h>
+#include <Preferences.h>
+#include "config_store.h"
+#include "events.h"
+#include "host_hooks.h"
+
+static uint8_t lastChanged = 0;
+static int notifications = 0;
+
+static void onConfig(const RuntimeConfig&, uint8_t changed) {
+    lastChanged = changed;
+    notifications++;
+}
+
+class ConfigStoreTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        subscribeConfig(onConfig);
+    }
+
+    void SetUp() override {
+        hostNvsErase();
+        notifications = 0;
+        lastChanged = 0;
+    }
+};
+
+TEST_F(ConfigStoreTest, DefaultsWhenEmpty) {
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    EXPECT_FALSE(isProvisioned());
+    EXPECT_STREQ(cfg.mqttHost, MQTT_BROKER);
+    EXPECT_EQ(cfg.mqttPort, MQTT_PORT);
+    EXPECT_EQ(lastChanged, CFG_SECTION_ALL);
+}
+
+TEST_F(ConfigStoreTest, SaveThenLoadRoundTrips) {
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    ASSERT_TRUE(setConfigField(cfg, "mqtt_host", "broker.local"));
+    ASSERT_TRUE(setConfigField(cfg, "mqtt_port", "8883"));
+    ASSERT_TRUE(setConfigField(cfg, "volt_high_crit", "260.5"));
+    saveConfig(cfg);
+    EXPECT_EQ(lastChanged, CFG_SECTION_NETWORK | CFG_SECTION_ALERTS);
+
+    RuntimeConfig loaded;
+    loadConfig(loaded);
+    EXPECT_TRUE(isProvisioned());
+    EXPECT_STREQ(loaded.mqttHost, "broker.local");
+    EXPECT_EQ(loaded.mqttPort, 8883);
+    EXPECT_FLOAT_EQ(loaded.voltageHighCritical, 260.5f);
+}
+
+TEST_F(ConfigStoreTest, ReadSavedConfigDoesNotNotify) {
+    RuntimeConfig cfg;
+    ASSERT_TRUE(setConfigField(cfg, "mqtt_host", "untouched"));
+    EXPECT_FALSE(readSavedConfig(cfg));
+    EXPECT_STREQ(cfg.mqttHost, "untouched");
+
+    RuntimeConfig saved;
+    ASSERT_TRUE(setConfigField(saved, "mqtt_host", "broker.local"));
+    ASSERT_TRUE(setConfigField(saved, "sms_interval_ms", "45000"));
+    saveConfig(saved);
+    notifications = 0;
+
+    EXPECT_TRUE(readSavedConfig(cfg));
+    EXPECT_STREQ(cfg.mqttHost, "broker.local");
+    EXPECT_EQ(cfg.smsCheckInterval, 45000u);
+    EXPECT_EQ(notifications, 0);
+}
+
+TEST_F(ConfigStoreTest, RejectsBadFields) {
+    RuntimeConfig cfg;
+    EXPECT_FALSE(setConfigField(cfg, "no_such_field", "1"));
+    EXPECT_FALSE(setConfigField(cfg, "mqtt_port", "70000"));
+    EXPECT_FALSE(setConfigField(cfg, "mqtt_port", "abc"));
+    EXPECT_FALSE(setConfigField(cfg, "current_crit", "nan"));
+    EXPECT_EQ(cfg.mqttPort, MQTT_PORT);
+}
+
+TEST_F(ConfigStoreTest, RejectsOutOfRangeAndMalformedNumbers) {
+    RuntimeConfig cfg;
+    EXPECT_FALSE(setConfigField(cfg, "sensor_interval_ms", "0"));
+    EXPECT_FALSE(setConfigField(cfg, "sensor_interval_ms", "5abc"));
+    EXPECT_FALSE(setConfigField(cfg, "sensor_interval_ms", "-1"));
+    EXPECT_FALSE(setConfigField(cfg, "sensor_interval_ms", "4000000000"));
+    EXPECT_FALSE(setConfigField(cfg, "publish_interval_ms", "0"));
+    EXPECT_FALSE(setConfigField(cfg, "mqtt_port", "0"));
+    EXPECT_FALSE(setConfigField(cfg, "current_crit", "inf"));
+    EXPECT_FALSE(setConfigField(cfg, "current_crit", "-inf"));
+    EXPECT_FALSE(setConfigField(cfg, "current_crit", "13.5 A"));
+    EXPECT_EQ(cfg.sensorReadInterval, SENSOR_READ_INTERVAL);
+    EXPECT_EQ(cfg.publishInterval, MQTT_PUBLISH_INTERVAL);
+    EXPECT_FLOAT_EQ(cfg.currentCritical, CURRENT_CRITICAL);
+
+    EXPECT_TRUE(setConfigField(cfg, "sensor_interval_ms", " 5000"));
+    EXPECT_EQ(cfg.sensorReadInterval, 5000u);
+    EXPECT_TRUE(validateConfig(cfg));
+}
+
+TEST_F(ConfigStoreTest, RejectsInvertedThresholds) {
+    RuntimeConfig cfg;
+    EXPECT_TRUE(validateConfig(cfg));
+
+    ASSERT_TRUE(setConfigField(cfg, "current_warn", "16"));  // Above current_crit
+    EXPECT_FALSE(validateConfig(cfg));
+    ASSERT_TRUE(setConfigField(cfg, "current_crit", "18"));
+    EXPECT_TRUE(validateConfig(cfg));
+
+    ASSERT_TRUE(setConfigField(cfg, "volt_low_crit", "220"));  // Above volt_low_warn
+    EXPECT_FALSE(validateConfig(cfg));
+}
+
+TEST_F(ConfigStoreTest, LoadRepairsStoredOutOfRangeValues) {
+    // As written by firmware without range checks
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    cfg.sensorReadInterval = 0;
+    cfg.currentWarning = 20.0f;
+    saveConfig(cfg);
+
+    RuntimeConfig loaded;
+    loadConfig(loaded);
+    EXPECT_TRUE(isProvisioned());
+    EXPECT_EQ(loaded.sensorReadInterval, SENSOR_READ_INTERVAL);
+    EXPECT_FLOAT_EQ(loaded.currentWarning, CURRENT_WARNING);
+    EXPECT_FLOAT_EQ(loaded.currentCritical, CURRENT_CRITICAL);
+    EXPECT_TRUE(validateConfig(loaded));
+}
+
+TEST_F(ConfigStoreTest, TruncatesLongStrings) {
+    RuntimeConfig cfg;
+    std::string longUser(100, 'u');
+    ASSERT_TRUE(setConfigField(cfg, "mqtt_user", longUser.c_str()));
+    EXPECT_EQ(strlen(cfg.mqttUser), sizeof(cfg.mqttUser) - 1);
+}
+
+TEST_F(ConfigStoreTest, CorruptBlobFallsBackToDefaults) {
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    setConfigField(cfg, "mqtt_host", "broker.local");
+    saveConfig(cfg);
+
+    // Flip one payload byte behind the header
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, false);
+    std::vector<uint8_t> blob(prefs.getBytesLength(CONFIG_NVS_KEY));
+    prefs.getBytes(CONFIG_NVS_KEY, blob.data(), blob.size());
+    blob[sizeof(ConfigBlobHeader) + 3] ^= 0x55;
+    prefs.putBytes(CONFIG_NVS_KEY, blob.data(), blob.size());
+    prefs.end();
+
+    RuntimeConfig loaded;
+    loadConfig(loaded);
+    EXPECT_FALSE(isProvisioned());
+    EXPECT_STREQ(loaded.mqttHost, MQTT_BROKER);
+}
+
+TEST_F(ConfigStoreTest, MigratesLegacyKeys) {
+    Preferences prefs;
+    prefs.begin(CONFIG_NVS_NS, false);
+    prefs.putBool("configured", true);
+    prefs.putString("mqtt_host", "legacy.local");
+    prefs.putUShort("mqtt_port", 1884);
+    prefs.end();
+
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    EXPECT_TRUE(isProvisioned());
+    EXPECT_STREQ(cfg.mqttHost, "legacy.local");
+    EXPECT_EQ(cfg.mqttPort, 1884);
+
+    prefs.begin(CONFIG_NVS_NS, true);
+    EXPECT_FALSE(prefs.isKey("configured"));
+    EXPECT_GT(prefs.getBytesLength(CONFIG_NVS_KEY), sizeof(ConfigBlobHeader));
+    prefs.end();
+}
+
+TEST_F(ConfigStoreTest, UnchangedSaveNotifiesNobody) {
+    RuntimeConfig cfg;
+    loadConfig(cfg);
+    notifications = 0;
+    saveConfig(cfg);
+    EXPECT_EQ(notifications, 0);
+}
@@ -0,0 +1,332 @@
+/**
+ * @file test_control.cpp
+ * @brief Relay control engine: start sequence, restart delay, trips, E-stop
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "control.h"
+#include "config_store.h"
+#include "globals.h"
+#include "latency.h"
+#include "sensors.h"
+#include "tasks.h"
+#include "host_hooks.h"
+#include "plant.h"
+
+static const uint8_t RELAY_PINS[RELAY_COUNT] = {
+    PIN_RELAY_COMPRESSOR, PIN_RELAY_FAN_LOW, PIN_RELAY_FAN_MED, PIN_RELAY_FAN_HIGH,
+    PIN_RELAY_VALVE_COOL, PIN_RELAY_VALVE_HEAT, PIN_RELAY_DEFROST, PIN_RELAY_ESTOP
+};
+
+/** @brief Relay mask as read back from the pins */
+static uint8_t pinRelays() {
+    uint8_t on = 0;
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        if (hostDigitalLevel(RELAY_PINS[r]) == RELAY_ACTIVE) on |= RELAY_BIT(r);
+    }
+    return on;
+}
+
+static bool isOn(Relay r) {
+    return pinRelays() & RELAY_BIT(r);
+}
+
+class ControlTest : public ::testing::Test {
+protected:
+    SystemData reading;     ///< Published on every tick while feeding
+    bool feeding = true;
+
+    static void SetUpTestSuite() {
+        initTaskQueues();
+    }
+
+    void SetUp() override {
+        hostClockManual(3600ULL * 1000000ULL);
+        hostNvsErase();
+        loadConfig(runtimeCfg);
+        initLatency();
+        initControl();
+
+        reading = SystemData();
+        setValid(reading.tempInlet, 40.0f);
+        setValid(reading.tempOutlet, 45.0f);
+        setValid(reading.tempAmbient, 20.0f);
+        setValid(reading.tempCompressor, 55.0f);
+        setValid(reading.voltage, 230.0f);
+        setValid(reading.current, 8.0f);
+        setValid(reading.pressureHigh, 280.0f);
+        setValid(reading.pressureLow, 70.0f);
+        feeding = true;
+    }
+
+    static void setValid(SensorReading& r, float value) {
+        r.value = value;
+        r.valid = true;
+    }
+
+    /** @brief One engine tick, CONTROL_TICK_MS after the previous one */
+    void tick() {
+        hostAdvanceMs(CONTROL_TICK_MS);
+        if (feeding) {
+            reading.readingTime = millis();
+            publishLatestReading(reading);
+        }
+        controlTick();
+    }
+
+    void runFor(uint32_t ms) {
+        for (uint32_t t = 0; t < ms; t += CONTROL_TICK_MS) tick();
+    }
+
+    /** @brief Post a command, run one tick and return its result */
+    CommandResult command(ControlCommandType type, OperatingMode mode = MODE_OFF,
+                          FanSpeed speed = FAN_AUTO, bool activate = true) {
+        ControlCommand cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        strcpy(cmd.commandId, "test-id");
+        cmd.type = type;
+        cmd.mode = mode;
+        cmd.fanSpeed = speed;
+        cmd.activate = activate;
+        EXPECT_TRUE(postControlCommand(cmd));
+        tick();
+
+        ControlResult r;
+        EXPECT_TRUE(receiveControlResult(r));
+        EXPECT_STREQ(r.commandId, "test-id");
+        EXPECT_EQ(r.type, type);
+        return r.result;
+    }
+
+    CommandResult setMode(OperatingMode mode) {
+        return command(CTRL_CMD_SET_MODE, mode);
+    }
+
+    /** @brief Heating with the compressor running, from boot */
+    void startHeating() {
+        runFor(COMPRESSOR_RESTART_DELAY_MS);
+        ASSERT_EQ(setMode(MODE_HEATING), CMD_SUCCESS);
+        runFor(FAN_PRERUN_DELAY_MS);
+        ASSERT_TRUE(isOn(RELAY_COMPRESSOR));
+    }
+};
+
+TEST_F(ControlTest, BootsWithEveryRelayOff) {
+    for (uint8_t r = 0; r < RELAY_COUNT; r++) {
+        EXPECT_EQ(hostDigitalLevel(RELAY_PINS[r]), RELAY_INACTIVE) << getRelayName((Relay)r);
+    }
+    runFor(1000);
+    EXPECT_EQ(pinRelays(), RELAY_BIT(RELAY_ESTOP));  // Only the safety chain closes
+    EXPECT_EQ(getControlStatus().mode, MODE_OFF);
+}
+
+TEST_F(ControlTest, BootCountsAsCompressorStop) {
+    // A reset loop must not short-cycle the compressor
+    EXPECT_EQ(setMode(MODE_HEATING), CMD_REJECTED_COOLDOWN);
+    EXPECT_EQ(setMode(MODE_FAN_ONLY), CMD_SUCCESS);
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));
+}
+
+TEST_F(ControlTest, HeatingStartsFanAndValveBeforeCompressor) {
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    ASSERT_EQ(setMode(MODE_HEATING), CMD_SUCCESS);
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));
+    EXPECT_TRUE(isOn(RELAY_VALVE_HEAT));
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+
+    runFor(FAN_PRERUN_DELAY_MS - 2 * CONTROL_TICK_MS);
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    runFor(2 * CONTROL_TICK_MS);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+    EXPECT_FALSE(isOn(RELAY_VALVE_COOL));
+
+    ControlStatus s = getControlStatus();
+    EXPECT_EQ(s.mode, MODE_HEATING);
+    EXPECT_EQ(s.relays, pinRelays());
+}
+
+TEST_F(ControlTest, RestartDelayRejectsSecondSetMode) {
+    startHeating();
+    runFor(COMPRESSOR_MIN_RUN_MS);
+    ASSERT_EQ(setMode(MODE_OFF), CMD_SUCCESS);
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+
+    runFor(10000);
+    EXPECT_EQ(setMode(MODE_HEATING), CMD_REJECTED_COOLDOWN);
+    EXPECT_EQ(setMode(MODE_COOLING), CMD_REJECTED_COOLDOWN);
+    EXPECT_EQ(getControlStatus().mode, MODE_OFF);
+
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    EXPECT_EQ(setMode(MODE_HEATING), CMD_SUCCESS);
+}
+
+TEST_F(ControlTest, MinimumRunTimeDelaysStopButNotTheRequest) {
+    startHeating();
+    ASSERT_EQ(setMode(MODE_OFF), CMD_SUCCESS);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+
+    runFor(COMPRESSOR_MIN_RUN_MS - 2 * CONTROL_TICK_MS);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+    runFor(2 * CONTROL_TICK_MS);
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+}
+
+TEST_F(ControlTest, FanRunsOnAfterCompressorStops) {
+    startHeating();
+    runFor(COMPRESSOR_MIN_RUN_MS);
+    ASSERT_EQ(setMode(MODE_OFF), CMD_SUCCESS);
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));
+
+    runFor(FAN_POSTRUN_DELAY_MS - 2 * CONTROL_TICK_MS);
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));
+    runFor(2 * CONTROL_TICK_MS);
+    EXPECT_EQ(pinRelays(), RELAY_BIT(RELAY_ESTOP));
+}
+
+TEST_F(ControlTest, ModeChangeStopsCompressorBeforeSwitchingValve) {
+    startHeating();
+    runFor(COMPRESSOR_MIN_RUN_MS);
+    ASSERT_EQ(setMode(MODE_COOLING), CMD_SUCCESS);
+
+    // The valve never moves under a running compressor
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    EXPECT_FALSE(isOn(RELAY_VALVE_HEAT) && isOn(RELAY_VALVE_COOL));
+    runFor(CONTROL_TICK_MS * 2);
+    EXPECT_TRUE(isOn(RELAY_VALVE_COOL));
+    EXPECT_FALSE(isOn(RELAY_VALVE_HEAT));
+
+    // Cooling resumes once the restart delay is over
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+}
+
+TEST_F(ControlTest, FanSpeedChangeIsBreakBeforeMake) {
+    startHeating();
+    ASSERT_EQ(command(CTRL_CMD_SET_FAN, MODE_OFF, FAN_HIGH), CMD_SUCCESS);
+    EXPECT_FALSE(isOn(RELAY_FAN_MED) && isOn(RELAY_FAN_HIGH));
+    runFor(CONTROL_TICK_MS * 2);
+    EXPECT_TRUE(isOn(RELAY_FAN_HIGH));
+    EXPECT_FALSE(isOn(RELAY_FAN_MED));
+    EXPECT_EQ(command(CTRL_CMD_SET_FAN, MODE_OFF, FAN_OFF), CMD_REJECTED_INTERLOCK);
+}
+
+TEST_F(ControlTest, HighPressureRejectsCooling) {
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    reading.pressureHigh.value = 480.0f;
+    tick();
+    EXPECT_TRUE(getControlStatus().trips & 1u);  // pressure_high is row 0
+    EXPECT_EQ(setMode(MODE_COOLING), CMD_REJECTED_SAFETY);
+    EXPECT_EQ(setMode(MODE_FAN_ONLY), CMD_SUCCESS);
+
+    // Released only back below the warning level
+    reading.pressureHigh.value = 420.0f;
+    tick();
+    EXPECT_EQ(setMode(MODE_COOLING), CMD_REJECTED_SAFETY);
+    reading.pressureHigh.value = 300.0f;
+    tick();
+    EXPECT_EQ(setMode(MODE_COOLING), CMD_SUCCESS);
+}
+
+TEST_F(ControlTest, CompressorTempTripStopsWithinOneTick) {
+    startHeating();
+    reading.tempCompressor.value = 100.0f;
+    tick();
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));  // Post-run still cools the coil
+
+    // Mode is kept; the compressor restarts after the delay once clear
+    reading.tempCompressor.value = 80.0f;
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+}
+
+TEST_F(ControlTest, InvalidVoltageHoldsEverythingOff) {
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    reading.voltage.valid = false;
+    tick();
+    EXPECT_EQ(setMode(MODE_FAN_ONLY), CMD_REJECTED_SAFETY);
+    EXPECT_EQ(pinRelays(), 0);
+}
+
+TEST_F(ControlTest, StaleReadingHoldsCompressorOff) {
+    startHeating();
+    feeding = false;
+    runFor(CONTROL_STALE_READINGS * runtimeCfg.sensorReadInterval);
+    EXPECT_TRUE(isOn(RELAY_COMPRESSOR));
+    tick();
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    EXPECT_TRUE(getControlStatus().trips & TRIP_STALE_BIT);
+    EXPECT_TRUE(isOn(RELAY_FAN_MED));
+}
+
+TEST_F(ControlTest, EmergencyStopDeenergisesEverything) {
+    startHeating();
+    EXPECT_EQ(command(CTRL_CMD_EMERGENCY_STOP), CMD_SUCCESS);
+    EXPECT_EQ(pinRelays(), 0);  // Including the safety chain
+    EXPECT_TRUE(getControlStatus().emergencyStop);
+
+    EXPECT_EQ(setMode(MODE_FAN_ONLY), CMD_REJECTED_INTERLOCK);
+    EXPECT_EQ(setMode(MODE_OFF), CMD_SUCCESS);
+
+    // Release closes the chain but restarts nothing
+    EXPECT_EQ(command(CTRL_CMD_EMERGENCY_STOP, MODE_OFF, FAN_AUTO, false), CMD_SUCCESS);
+    EXPECT_EQ(pinRelays(), RELAY_BIT(RELAY_ESTOP));
+    EXPECT_EQ(getControlStatus().mode, MODE_OFF);
+}
+
+TEST_F(ControlTest, DefrostOnlyWhileHeating) {
+    EXPECT_EQ(command(CTRL_CMD_DEFROST), CMD_REJECTED_INTERLOCK);
+
+    startHeating();
+    EXPECT_EQ(command(CTRL_CMD_DEFROST), CMD_SUCCESS);
+    EXPECT_TRUE(isOn(RELAY_DEFROST));
+    runFor(DEFROST_TRIGGER_MS);
+    EXPECT_FALSE(isOn(RELAY_DEFROST));
+}
+
+TEST_F(ControlTest, PlantOvercurrentTripsCompressor) {
+    // Real sensor path: plant voltages -> readAllSensors() -> engine
+    plantApply(plantAt((PLANT_ON_S + 60) * 1000000ULL, false));  // Calibrate while off
+    initSensors();
+    feeding = false;
+    auto sense = [](bool fault) {
+        plantApply(plantAt(millis() * 1000ULL, fault));
+        publishLatestReading(readAllSensors());
+    };
+
+    sense(false);
+    runFor(COMPRESSOR_RESTART_DELAY_MS);
+    sense(false);
+    ASSERT_EQ(setMode(MODE_HEATING), CMD_SUCCESS);
+    for (uint32_t t = 0; t < FAN_PRERUN_DELAY_MS; t += runtimeCfg.sensorReadInterval) {
+        sense(false);
+        runFor(runtimeCfg.sensorReadInterval);
+    }
+    ASSERT_TRUE(isOn(RELAY_COMPRESSOR));
+
+    sense(true);
+    tick();
+    EXPECT_FALSE(isOn(RELAY_COMPRESSOR));
+    EXPECT_TRUE(getControlStatus().trips & (1u << 3));  // overcurrent
+}
+
+TEST_F(ControlTest, RecordsCommandLatency) {
+    uint32_t before = getLatencyHistogram(LAT_CONTROL_CMD).count;
+    setMode(MODE_FAN_ONLY);
+    command(CTRL_CMD_STATUS);
+    EXPECT_EQ(getLatencyHistogram(LAT_CONTROL_CMD).count, before + 1);
+    EXPECT_GT(getLatencyHistogram(LAT_CONTROL_TICK).count, 0u);
+}
+
+TEST_F(ControlTest, StatusJson) {
+    startHeating();
+    char buf[CONTROL_JSON_MAX];
+    formatControlJson(getControlStatus(), buf, sizeof(buf));
+    std::string json = buf;
+    EXPECT_NE(json.find("\"mode\":\"heating\""), std::string::npos) << json;
+    EXPECT_NE(json.find("\"fan_speed\":\"auto\""), std::string::npos) << json;
+    EXPECT_NE(json.find("\"compressor\":true"), std::string::npos) << json;
+    EXPECT_NE(json.find("\"trips\":[]"), std::string::npos) << json;
+}
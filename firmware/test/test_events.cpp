@@ -0,0 +1,196 @@
+/**
+ * @file test_events.cpp
+ * @brief Event bus: handler dispatch order and payloads, queue delivery,
+ * drops and table limits
+ *
+ * Subscriptions cannot be removed. ctest runs each test in its own
+ * process, but the tests also pass in one run: none of them depends on
+ * what another subscribed.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "config_store.h"
+#include "events.h"
+#include "host_hooks.h"
+
+// =============================================================================
+// RECORDING HANDLERS
+// =============================================================================
+
+static std::string calls;
+static Event lastEvent;
+static const SystemData* lastReading;
+
+/** @brief Appends its context (a C string) to calls */
+static void tagHandler(const Event& ev, void* ctx) {
+    calls += (const char*)ctx;
+    lastEvent = ev;
+}
+
+static void readingHandler(const Event& ev, void*) {
+    calls += "r";
+    lastReading = ev.reading;
+}
+
+class EventsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostClockManual(5000ULL * 1000ULL);
+        calls.clear();
+        memset(&lastEvent, 0, sizeof(lastEvent));
+        lastReading = nullptr;
+    }
+
+    void TearDown() override {
+        hostClockReal();
+    }
+};
+
+// =============================================================================
+// HANDLERS
+// =============================================================================
+
+TEST_F(EventsTest, HandlersRunInSubscriptionOrderWithTheirContext) {
+    ASSERT_TRUE(subscribeEvent(EVT_TRANSPORT, tagHandler, (void*)"1"));
+    ASSERT_TRUE(subscribeEvent(EVT_TRANSPORT, tagHandler, (void*)"2"));
+    ASSERT_TRUE(subscribeEvent(EVT_TRANSPORT, tagHandler, (void*)"3"));
+
+    EXPECT_TRUE(publishTransportEvent(CONN_WIFI, CONN_NONE));
+    EXPECT_EQ(calls, "123");
+    EXPECT_EQ(lastEvent.type, EVT_TRANSPORT);
+    EXPECT_EQ(lastEvent.transport.conn, CONN_WIFI);
+    EXPECT_EQ(lastEvent.transport.prev, CONN_NONE);
+    EXPECT_EQ(lastEvent.timeMs, 5000u);
+}
+
+TEST_F(EventsTest, OnlyTheEventTypeIsDispatched) {
+    ASSERT_TRUE(subscribeEvent(EVT_TRANSPORT, tagHandler, (void*)"t"));
+    EXPECT_TRUE(publishConfigEvent(CFG_SECTION_ALERTS));
+    EXPECT_EQ(calls.find('t'), std::string::npos);
+
+    calls.clear();
+    ASSERT_TRUE(subscribeEvent(EVT_CONFIG, tagHandler, (void*)"c"));
+    hostAdvanceMs(250);
+    EXPECT_TRUE(publishConfigEvent(CFG_SECTION_ALERTS | CFG_SECTION_NETWORK));
+    EXPECT_EQ(calls.find('t'), std::string::npos);
+    EXPECT_NE(calls.find('c'), std::string::npos);
+    EXPECT_EQ(lastEvent.configChanged, CFG_SECTION_ALERTS | CFG_SECTION_NETWORK);
+    EXPECT_EQ(lastEvent.timeMs, 5250u);
+}
+
+TEST_F(EventsTest, ReadingHandlerSeesThePublishersData) {
+    ASSERT_TRUE(subscribeEvent(EVT_READING, readingHandler));
+
+    SystemData d;
+    d.voltage.value = 231.5f;
+    EXPECT_TRUE(publishReadingEvent(d));
+    EXPECT_EQ(calls, "r");
+    EXPECT_EQ(lastReading, &d);
+    EXPECT_EQ(lastReading->voltage.value, 231.5f);
+}
+
+TEST_F(EventsTest, AlertPayload) {
+    ASSERT_TRUE(subscribeEvent(EVT_ALERT, tagHandler, (void*)"a"));
+
+    EXPECT_TRUE(publishAlertEvent(ALERT_OVERCURRENT, ALERT_CRITICAL, ALERT_WARNING, 16.5f));
+    EXPECT_EQ(calls, "a");
+    EXPECT_EQ(lastEvent.alert.type, ALERT_OVERCURRENT);
+    EXPECT_EQ(lastEvent.alert.level, ALERT_CRITICAL);
+    EXPECT_EQ(lastEvent.alert.prevLevel, ALERT_WARNING);
+    EXPECT_EQ(lastEvent.alert.value, 16.5f);
+}
+
+TEST_F(EventsTest, UnknownTypeIsRejected) {
+    Event ev;
+    ev.type = EVT_TYPE_COUNT;
+    EXPECT_FALSE(publishEvent(ev));
+    EXPECT_FALSE(subscribeEvent(EVT_TYPE_COUNT, tagHandler));
+    EXPECT_FALSE(subscribeEvent(EVT_CONFIG, nullptr));
+}
+
+// =============================================================================
+// QUEUES
+// =============================================================================
+
+TEST_F(EventsTest, QueueGetsCopiesOfMaskedTypes) {
+    ASSERT_TRUE(subscribeEvent(EVT_READING, readingHandler));
+    QueueHandle_t q = createEventQueue(4);
+    ASSERT_NE(q, nullptr);
+    ASSERT_TRUE(subscribeEventQueue(EVENT_MASK(EVT_READING) | EVENT_MASK(EVT_ALERT), q));
+
+    SystemData d;
+    EXPECT_TRUE(publishReadingEvent(d));
+    EXPECT_TRUE(publishTransportEvent(CONN_GPRS, CONN_WIFI));  // Not in the mask
+    EXPECT_TRUE(publishAlertEvent(ALERT_VOLTAGE_LOW, ALERT_WARNING, ALERT_OK, 205.0f));
+    ASSERT_EQ(uxQueueMessagesWaiting(q), 2u);
+
+    // The reading is on the publisher's stack: queues get nullptr
+    Event ev;
+    ASSERT_EQ(xQueueReceive(q, &ev, 0), pdTRUE);
+    EXPECT_EQ(ev.type, EVT_READING);
+    EXPECT_EQ(ev.reading, nullptr);
+
+    ASSERT_EQ(xQueueReceive(q, &ev, 0), pdTRUE);
+    EXPECT_EQ(ev.type, EVT_ALERT);
+    EXPECT_EQ(ev.alert.type, ALERT_VOLTAGE_LOW);
+    EXPECT_EQ(ev.alert.value, 205.0f);
+    EXPECT_EQ(ev.timeMs, 5000u);
+
+    // Synchronous handlers still saw the real pointer
+    EXPECT_EQ(lastReading, &d);
+}
+
+TEST_F(EventsTest, FullQueueDropsButHandlersStillRun) {
+    ASSERT_TRUE(subscribeEvent(EVT_CONFIG, tagHandler, (void*)"q"));
+    QueueHandle_t q = createEventQueue(1);
+    ASSERT_TRUE(subscribeEventQueue(EVENT_MASK(EVT_CONFIG), q));
+    uint32_t drops = getEventDrops();
+
+    EXPECT_TRUE(publishConfigEvent(CFG_SECTION_INTERVALS));
+    EXPECT_FALSE(publishConfigEvent(CFG_SECTION_CALIBRATION));
+    EXPECT_EQ(getEventDrops(), drops + 1);
+    EXPECT_EQ(calls.size() % 2, 0u);  // Every config handler, twice
+    EXPECT_EQ(calls.back(), 'q');
+    EXPECT_EQ(lastEvent.configChanged, CFG_SECTION_CALIBRATION);
+
+    // The queue kept the first one
+    Event ev;
+    ASSERT_EQ(xQueueReceive(q, &ev, 0), pdTRUE);
+    EXPECT_EQ(ev.configChanged, CFG_SECTION_INTERVALS);
+    EXPECT_TRUE(publishConfigEvent(CFG_SECTION_NETWORK));
+    EXPECT_EQ(getEventDrops(), drops + 1);
+    xQueueReceive(q, &ev, 0);
+}
+
+// =============================================================================
+// TABLE LIMITS (last: they fill the tables)
+// =============================================================================
+
+TEST_F(EventsTest, HandlerTableIsBounded) {
+    int added = 0;
+    while (subscribeEvent(EVT_TRANSPORT, tagHandler, (void*)"x")) added++;
+    EXPECT_GE(added, 1);
+
+    // Whatever was there before, the type now has exactly the maximum
+    EXPECT_TRUE(publishTransportEvent(CONN_WIFI, CONN_GPRS));
+    EXPECT_EQ(calls.size(), (size_t)EVENT_MAX_HANDLERS);
+
+    // A full type does not affect the others
+    EXPECT_TRUE(subscribeEvent(EVT_ALERT, tagHandler, (void*)"b"));
+}
+
+TEST_F(EventsTest, QueueTableIsBounded) {
+    EXPECT_FALSE(subscribeEventQueue(EVENT_MASK(EVT_ALERT), nullptr));
+
+    // Subscribing one queue many times gets one copy per slot
+    QueueHandle_t q = createEventQueue(EVENT_MAX_QUEUES);
+    int added = 0;
+    while (subscribeEventQueue(EVENT_MASK(EVT_TRANSPORT), q)) added++;
+    EXPECT_GE(added, 1);
+    EXPECT_LE(added, EVENT_MAX_QUEUES);
+    EXPECT_FALSE(subscribeEventQueue(EVENT_MASK(EVT_TRANSPORT), q));
+
+    EXPECT_TRUE(publishTransportEvent(CONN_NONE, CONN_WIFI));
+    EXPECT_EQ(uxQueueMessagesWaiting(q), (UBaseType_t)added);
+}
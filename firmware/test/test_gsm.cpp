@@ -0,0 +1,135 @@
+/**
+ * @file test_gsm.cpp
+ * @brief SMS command parsing, modem response parsing and status text
+ */
+
+#include <gtest/gtest.h>
+#include "gsm.h"
+#include "host_hooks.h"
+
+class GsmTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // checkIncomingSMS() polls for a second; run it on virtual time
+        hostClockManual(1000000);
+        Serial2.clear();
+        modem.sentSms.clear();
+        modem.smsOk = true;
+    }
+};
+
+TEST_F(GsmTest, ParsesSmsCommands) {
+    EXPECT_EQ(parseSMSCommand("status"), SMS_CMD_STATUS);
+    EXPECT_EQ(parseSMSCommand("  Stat \r"), SMS_CMD_STATUS);
+    EXPECT_EQ(parseSMSCommand("REBOOT"), SMS_CMD_RESET);
+    EXPECT_EQ(parseSMSCommand("wifi reset"), SMS_CMD_WIFI_RESET);
+    EXPECT_EQ(parseSMSCommand("WIFI_RESET"), SMS_CMD_WIFI_RESET);
+    EXPECT_EQ(parseSMSCommand("status please"), SMS_CMD_UNKNOWN);
+    EXPECT_EQ(parseSMSCommand(""), SMS_CMD_UNKNOWN);
+}
+
+TEST_F(GsmTest, ReadsUnreadMessage) {
+    Serial2.feed("\r\n+CMGL: 1,\"REC UNREAD\",\"+911234\",,\"24/01/01,10:00:00+22\"\r\n"
+                      " status \r\n\r\nOK\r\n");
+
+    SMSMessage msg;
+    ASSERT_TRUE(checkIncomingSMS(msg));
+    EXPECT_STREQ(msg.sender.c_str(), "+911234");
+    EXPECT_STREQ(msg.content.c_str(), "status");
+    EXPECT_TRUE(msg.isNew);
+
+    const std::string& tx = Serial2.written();
+    EXPECT_NE(tx.find("AT+CMGL=\"REC UNREAD\""), std::string::npos);
+    EXPECT_NE(tx.find("AT+CMGD=1,4"), std::string::npos);
+}
+
+TEST_F(GsmTest, NoMessageLeavesStorageAlone) {
+    Serial2.feed("\r\nOK\r\n");
+
+    SMSMessage msg;
+    EXPECT_FALSE(checkIncomingSMS(msg));
+    EXPECT_EQ(Serial2.written().find("AT+CMGD"), std::string::npos);
+}
+
+TEST_F(GsmTest, MalformedHeaderIsDiscarded) {
+    Serial2.feed("+CMGL: 1,REC UNREAD\r\n");
+
+    SMSMessage msg;
+    EXPECT_FALSE(checkIncomingSMS(msg));
+    EXPECT_NE(Serial2.written().find("AT+CMGD=1,4"), std::string::npos);
+}
+
+TEST_F(GsmTest, ParsesListingWithoutModem) {
+    SMSMessage msg;
+    EXPECT_EQ(parseSMSListing("\r\nOK\r\n", msg), SMS_PARSE_NONE);
+    EXPECT_EQ(parseSMSListing("+CMGL: 2,\"REC UNREAD\",\"\",,\"x\"\r\nhi\r\n", msg),
+              SMS_PARSE_ERROR);
+    EXPECT_EQ(parseSMSListing("+CMGL: 2,\"REC UNREAD\",\"+44\",,\"x\"\r\n", msg),
+              SMS_PARSE_ERROR);
+
+    // No trailing CRLF after the text
+    ASSERT_EQ(parseSMSListing("+CMGL: 2,\"REC UNREAD\",\"+44\",,\"x\"\r\nreset", msg),
+              SMS_PARSE_OK);
+    EXPECT_STREQ(msg.sender.c_str(), "+44");
+    EXPECT_STREQ(msg.content.c_str(), "reset");
+    EXPECT_TRUE(Serial2.written().empty());
+}
+
+TEST_F(GsmTest, SignalQualityPercent) {
+    modem.signalQuality = 99;
+    EXPECT_EQ(getSignalQuality(), 0);
+    modem.signalQuality = 31;
+    EXPECT_EQ(getSignalQuality(), 100);
+    modem.signalQuality = 0;
+    EXPECT_EQ(getSignalQuality(), 0);
+}
+
+TEST_F(GsmTest, SendSmsReportsModemResult) {
+    EXPECT_TRUE(sendSMS("+911234", "hello"));
+    ASSERT_EQ(modem.sentSms.size(), 1u);
+    EXPECT_EQ(modem.sentSms[0].phone, "+911234");
+
+    modem.smsOk = false;
+    EXPECT_FALSE(sendSMS("+911234", "again"));
+}
+
+TEST_F(GsmTest, StatusMessageFitsOneSms) {
+    SystemData d;
+    d.tempInlet.value = 40.0f;
+    d.tempOutlet.value = 45.5f;
+    d.voltage.value = 231.0f;
+    d.current.value = 7.25f;
+    d.power = 1675.0f;
+    d.compressorRunning = true;
+
+    char buf[200];
+    size_t n = formatStatusMessage(d, buf, sizeof(buf));
+    EXPECT_LE(n, 160u);
+    EXPECT_NE(strstr(buf, "In:40.0 Out:45.5"), nullptr);
+    EXPECT_NE(strstr(buf, "231V 7.2A 1675W"), nullptr);
+    EXPECT_NE(strstr(buf, "Comp:ON"), nullptr);
+}
+
+TEST_F(GsmTest, AbortedModemStreamFailsExchangesUntilRestart) {
+    abortModemExchange();
+    modem.stream.println("AT+CMGS=\"+911234\"");
+    std::string reply;
+    while (modem.stream.available()) {
+        reply += (char)modem.stream.read();
+    }
+    EXPECT_EQ(reply, "\r\nERROR\r\n");
+    EXPECT_TRUE(Serial2.written().empty());
+
+    // A stalled SMS poll returns with nothing, whatever the UART holds
+    Serial2.feed("\r\n+CMGL: 1,\"REC UNREAD\",\"+911234\",,\"24/01/01,10:00:00+22\"\r\nSTATUS\r\n");
+    SMSMessage msg;
+    EXPECT_FALSE(checkIncomingSMS(msg));
+
+    unsigned int restarts = modem.restarts;
+    EXPECT_TRUE(serviceModemRestart());
+    EXPECT_EQ(modem.restarts, restarts + 1);
+    EXPECT_FALSE(modemUart.aborted());
+
+    modem.stream.println("AT");
+    EXPECT_EQ(Serial2.written(), "AT\r\n");
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_latency.cpp
+ * @brief Log-linear bucket index, percentile and slow-count math, and the
+ * JSON at every buffer size
+ *
+ * Histograms cannot be cleared, so each test records into its own
+ * LatencyId; the full-histogram test runs last.
+ */
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "latency.h"
+
+TEST(LatencyTest, SmallValuesHaveTheirOwnBucket) {
+    for (uint32_t us = 0; us < 8; us++) {
+        EXPECT_EQ(latencyBucket(us), us);
+        EXPECT_EQ(latencyBucketLow((uint16_t)us), us);
+    }
+    // From 8 us on, four sub-buckets per power of two
+    EXPECT_EQ(latencyBucket(8), 8);
+    EXPECT_EQ(latencyBucket(9), 8);
+    EXPECT_EQ(latencyBucket(10), 9);
+    EXPECT_EQ(latencyBucket(15), 11);
+    EXPECT_EQ(latencyBucket(16), 12);
+}
+
+TEST(LatencyTest, BucketBoundsAreContiguous) {
+    EXPECT_EQ(LAT_BUCKETS, 104);
+    for (uint16_t b = 0; b < LAT_BUCKETS; b++) {
+        uint32_t low = latencyBucketLow(b);
+        EXPECT_EQ(latencyBucket(low), b) << "bucket " << b;
+        if (b + 1 < LAT_BUCKETS) {
+            uint32_t next = latencyBucketLow(b + 1);
+            EXPECT_GT(next, low) << "bucket " << b;
+            EXPECT_EQ(latencyBucket(next - 1), b) << "bucket " << b;
+        }
+    }
+}
+
+TEST(LatencyTest, ValuesAreWithinAQuarterOfTheirBucket) {
+    for (uint32_t us = 4; us < (1UL << (LAT_MAX_MSB + 1)); us = us * 5 / 4 + 3) {
+        uint32_t low = latencyBucketLow(latencyBucket(us));
+        ASSERT_LE(low, us);
+        EXPECT_LE((us - low) * 4, low) << us;
+    }
+}
+
+TEST(LatencyTest, TopOctaveClamps) {
+    uint16_t top = LAT_BUCKETS - 1;
+    EXPECT_EQ(latencyBucket((1UL << (LAT_MAX_MSB + 1)) - 1), top);
+    EXPECT_EQ(latencyBucket(1UL << (LAT_MAX_MSB + 1)), top);
+    EXPECT_EQ(latencyBucket(UINT32_MAX), top);
+}
+
+TEST(LatencyTest, EmptyHistogramReportsZero) {
+    EXPECT_EQ(latencyPercentile(LAT_THERMO_JITTER, 50), 0u);
+    EXPECT_EQ(latencyPercentile(LAT_THERMO_JITTER, 99), 0u);
+    EXPECT_EQ(latencyCountAbove(LAT_THERMO_JITTER, 0), 0u);
+}
+
+TEST(LatencyTest, PercentilesAreBucketUpperBoundsCappedAtMax) {
+    for (uint32_t us = 1; us <= 100; us++) {
+        latencyRecord(LAT_SENSOR_READ, us);
+    }
+    const LatencyHistogram& h = getLatencyHistogram(LAT_SENSOR_READ);
+    EXPECT_EQ(h.count, 100u);
+    EXPECT_EQ(h.maxUs, 100u);
+    EXPECT_EQ(h.sumUs, 5050u);
+
+    EXPECT_EQ(latencyPercentile(LAT_SENSOR_READ, 0), 1u);     // Smallest sample
+    EXPECT_EQ(latencyPercentile(LAT_SENSOR_READ, 50), 55u);   // 50 is in [48, 55]
+    EXPECT_EQ(latencyPercentile(LAT_SENSOR_READ, 90), 95u);   // 90 is in [80, 95]
+    EXPECT_EQ(latencyPercentile(LAT_SENSOR_READ, 99), 100u);  // [96, 111], capped at max
+    EXPECT_EQ(latencyPercentile(LAT_SENSOR_READ, 100), 100u);
+}
+
+TEST(LatencyTest, PercentileRoundsTheRankUp) {
+    // 3 samples: p50 is the 2nd, p34 the 2nd, p33 the 1st
+    latencyRecord(LAT_PUBLISH, 10);
+    latencyRecord(LAT_PUBLISH, 1000);
+    latencyRecord(LAT_PUBLISH, 100000);
+    EXPECT_EQ(latencyPercentile(LAT_PUBLISH, 33), 11u);
+    EXPECT_EQ(latencyPercentile(LAT_PUBLISH, 34), 1023u);
+    EXPECT_EQ(latencyPercentile(LAT_PUBLISH, 50), 1023u);
+    EXPECT_EQ(latencyPercentile(LAT_PUBLISH, 99), 100000u);
+}
+
+TEST(LatencyTest, SingleOutlierShowsOnlyInTheTail) {
+    for (int i = 0; i < 999; i++) latencyRecord(LAT_NET_PASS, 2000);
+    latencyRecord(LAT_NET_PASS, 5000000);
+
+    uint32_t p50 = latencyPercentile(LAT_NET_PASS, 50);
+    EXPECT_GE(p50, 2000u);
+    EXPECT_LE(p50, 2500u);
+    EXPECT_LE(latencyPercentile(LAT_NET_PASS, 99.9f), 2500u);
+    EXPECT_EQ(latencyPercentile(LAT_NET_PASS, 100), 5000000u);
+}
+
+TEST(LatencyTest, CountAboveUsesBucketResolution) {
+    latencyRecord(LAT_SMS_CHECK, 50000);
+    latencyRecord(LAT_SMS_CHECK, 99000);    // Same bucket as 100000: not counted
+    latencyRecord(LAT_SMS_CHECK, 150000);
+    latencyRecord(LAT_SMS_CHECK, 4000000);
+    EXPECT_EQ(latencyCountAbove(LAT_SMS_CHECK, LAT_SLOW_LOOP_US), 2u);
+    EXPECT_EQ(latencyCountAbove(LAT_SMS_CHECK, 0), 4u);
+    EXPECT_EQ(latencyCountAbove(LAT_SMS_CHECK, UINT32_MAX), 0u);
+}
+
+TEST(LatencyTest, JsonSummaryAndBuckets) {
+    latencyRecord(LAT_MQTT_CONNECT, 300);
+    latencyRecord(LAT_MQTT_CONNECT, 300);
+    latencyRecord(LAT_MQTT_CONNECT, 900);
+
+    static char buf[8192];
+    size_t n = formatLatencyJson(buf, sizeof(buf), true);
+    EXPECT_EQ(n, strlen(buf));
+    EXPECT_NE(strstr(buf, "\"mqtt_connect\":{\"n\":3,\"mean_us\":500,\"max_us\":900,"
+                          "\"p50_us\":319,\"p90_us\":900,\"p99_us\":900,\"slow\":0,"
+                          "\"b\":[[256,2],[896,1]]}"), nullptr);
+
+    // Too small for any op: still closed
+    char small[40];
+    n = formatLatencyJson(small, sizeof(small), true);
+    EXPECT_EQ(n, strlen(small));
+    EXPECT_EQ(std::string(small).substr(n - 4), ":{}}");
+    EXPECT_EQ(formatLatencyJson(small, 0, true), 0u);
+}
+
+// =============================================================================
+// FULL HISTOGRAMS (last: fills every op)
+// =============================================================================
+
+TEST(LatencyTest, FullHistogramsFitTheWorstCaseBuffer) {
+    // Every bucket of every op, with 10-digit counts in the top ones
+    for (int i = 0; i < LAT_COUNT; i++) {
+        LatencyHistogram& h = const_cast<LatencyHistogram&>(getLatencyHistogram((LatencyId)i));
+        for (uint16_t b = 0; b < LAT_BUCKETS; b++) latencyRecord((LatencyId)i, latencyBucketLow(b));
+        for (uint16_t b = LAT_BUCKETS - 8; b < LAT_BUCKETS; b++) h.buckets[b] = UINT32_MAX / 8;
+        h.count = UINT32_MAX;
+        h.maxUs = UINT32_MAX;
+    }
+
+    std::vector<char> buf(LAT_JSON_MAX);
+    size_t n = formatLatencyJson(buf.data(), buf.size(), true);
+    ASSERT_EQ(n, strlen(buf.data()));
+    ASSERT_LT(n + 1, buf.size());  // Not truncated
+
+    DynamicJsonDocument doc(256 * 1024);
+    ASSERT_FALSE(deserializeJson(doc, buf.data()));
+    for (int i = 0; i < LAT_COUNT; i++) {
+        JsonArray b = doc["ops"][getLatencyName((LatencyId)i)]["b"];
+        EXPECT_EQ(b.size(), (size_t)LAT_BUCKETS) << getLatencyName((LatencyId)i);
+    }
+}
+
+TEST(LatencyTest, FullHistogramsStayValidJsonInSmallBuffers) {
+    for (int i = 0; i < LAT_COUNT; i++) {
+        for (uint16_t b = 0; b < LAT_BUCKETS; b++) latencyRecord((LatencyId)i, latencyBucketLow(b));
+    }
+
+    std::vector<char> buf(LAT_JSON_MAX);
+    DynamicJsonDocument doc(256 * 1024);
+    for (size_t size = 40; size < 8192; size += 97) {
+        size_t n = formatLatencyJson(buf.data(), size, true);
+        ASSERT_LT(n, size);
+        ASSERT_EQ(n, strlen(buf.data()));
+        ASSERT_FALSE(deserializeJson(doc, buf.data())) << size << ": " << buf.data();
+    }
+
+    // 4 KB (the old /api/latency buffer): every summary, buckets while they fit
+    formatLatencyJson(buf.data(), 4096, true);
+    ASSERT_FALSE(deserializeJson(doc, buf.data()));
+    JsonObject ops = doc["ops"];
+    EXPECT_EQ(ops.size(), (size_t)LAT_COUNT);
+    EXPECT_FALSE(ops[getLatencyName(LAT_SENSOR_READ)]["b"].isNull());
+    EXPECT_TRUE(ops[getLatencyName(LAT_THERMO_JITTER)]["b"].isNull());
+    EXPECT_GT(ops[getLatencyName(LAT_THERMO_JITTER)]["n"].as<unsigned long>(), 0u);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file test_log_level.cpp
+ * @brief Module and level parsing, runtime levels and the levels JSON
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "log_level.h"
+
+static const char ALL_INFO[] =
+    "{\"MAIN\":3,\"SENSORS\":3,\"ALERTS\":3,\"BUFFER\":3,\"MQTT\":3,\"GSM\":3,"
+    "\"WIFI\":3,\"PROV\":3,\"DASH\":3,\"CFG\":3,\"CTRL\":3}";
+
+class LogLevelTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setLogLevel(LOG_MOD_COUNT, LOG_LEVEL_INFO);
+    }
+};
+
+TEST_F(LogLevelTest, ParseModule) {
+    EXPECT_EQ(parseLogModule("MQTT"), LOG_MOD_MQTT);
+    EXPECT_EQ(parseLogModule("sensors"), LOG_MOD_SENSORS);
+    EXPECT_EQ(parseLogModule("Ctrl"), LOG_MOD_CTRL);
+    EXPECT_EQ(parseLogModule("*"), LOG_MOD_COUNT);
+    EXPECT_EQ(parseLogModule("MQT"), -1);
+    EXPECT_EQ(parseLogModule("MQTTX"), -1);
+    EXPECT_EQ(parseLogModule(""), -1);
+    EXPECT_EQ(parseLogModule(nullptr), -1);
+
+    for (int i = 0; i < LOG_MOD_COUNT; i++) {
+        EXPECT_EQ(parseLogModule(getLogModuleName((LogModule)i)), i);
+    }
+    EXPECT_STREQ(getLogModuleName(LOG_MOD_COUNT), "UNKNOWN");
+}
+
+TEST_F(LogLevelTest, ParseLevel) {
+    EXPECT_EQ(parseLogLevel("none"), LOG_LEVEL_NONE);
+    EXPECT_EQ(parseLogLevel("ERROR"), LOG_LEVEL_ERROR);
+    EXPECT_EQ(parseLogLevel("warn"), LOG_LEVEL_WARN);
+    EXPECT_EQ(parseLogLevel("Debug"), LOG_LEVEL_DEBUG);
+    EXPECT_EQ(parseLogLevel("verbose"), LOG_LEVEL_VERBOSE);
+    EXPECT_EQ(parseLogLevel("0"), 0);
+    EXPECT_EQ(parseLogLevel("5"), 5);
+
+    EXPECT_EQ(parseLogLevel("6"), -1);
+    EXPECT_EQ(parseLogLevel("44"), -1);
+    EXPECT_EQ(parseLogLevel("-1"), -1);
+    EXPECT_EQ(parseLogLevel("warning"), -1);
+    EXPECT_EQ(parseLogLevel(""), -1);
+    EXPECT_EQ(parseLogLevel(nullptr), -1);
+}
+
+TEST_F(LogLevelTest, SetOneOrAll) {
+    setLogLevel(LOG_MOD_GSM, LOG_LEVEL_DEBUG);
+    EXPECT_EQ(logModuleLevel[LOG_MOD_GSM], LOG_LEVEL_DEBUG);
+    EXPECT_EQ(logModuleLevel[LOG_MOD_MQTT], LOG_LEVEL_INFO);
+
+    setLogLevel(LOG_MOD_MQTT, 9);  // Clamped
+    EXPECT_EQ(logModuleLevel[LOG_MOD_MQTT], LOG_LEVEL_VERBOSE);
+
+    setLogLevel(LOG_MOD_COUNT, LOG_LEVEL_ERROR);
+    for (int i = 0; i < LOG_MOD_COUNT; i++) {
+        EXPECT_EQ(logModuleLevel[i], LOG_LEVEL_ERROR);
+    }
+}
+
+TEST_F(LogLevelTest, FormatListsEveryModule) {
+    char buf[192];
+    size_t n = formatLogLevels(buf, sizeof(buf));
+    EXPECT_STREQ(buf, ALL_INFO);
+    EXPECT_EQ(n, strlen(ALL_INFO));
+
+    setLogLevel(LOG_MOD_WIFI, LOG_LEVEL_VERBOSE);
+    formatLogLevels(buf, sizeof(buf));
+    EXPECT_NE(strstr(buf, "\"WIFI\":5,"), nullptr);
+}
+
+TEST_F(LogLevelTest, FormatIsClampedToTheBuffer) {
+    char buf[sizeof(ALL_INFO) + 8];
+    EXPECT_EQ(formatLogLevels(buf, 0), 0u);
+
+    // Every size: the return value is what is in the buffer
+    for (size_t size = 1; size <= sizeof(buf); size++) {
+        memset(buf, 'x', sizeof(buf));
+        size_t n = formatLogLevels(buf, size);
+        ASSERT_LT(n, size) << size;
+        ASSERT_EQ(n, strlen(buf)) << size;
+        EXPECT_EQ(std::string(buf), std::string(ALL_INFO, n)) << size;
+    }
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_log_token.cpp
+ * @brief Token frame encoding, truncation, and the round trip through
+ * tools/log_decode.py
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "log_token.h"
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+/** @brief Read the varint at pos, advancing pos */
+static uint64_t readVarint(const uint8_t* p, size_t& pos) {
+    uint64_t v = 0;
+    int shift = 0;
+    uint8_t b;
+    do {
+        b = p[pos++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return v;
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+template <typename... Args>
+static LogTokenFrame encode(uint32_t id, const Args&... args) {
+    LogTokenFrame frame(id);
+    int expand[] = {0, (frame.arg(args), 0)...};
+    (void)expand;
+    return frame;
+}
+
+static const std::string LONG_STR(LOG_TOKEN_MAX_STR, 'x');
+
+// =============================================================================
+// ENCODER
+// =============================================================================
+
+TEST(LogToken, HeaderAndScalars) {
+    LogTokenFrame f = encode(0x11223344u, -1, 300u, 2.5f, "hi");
+    const uint8_t* p = f.data();
+
+    ASSERT_EQ(f.size(), 6u + 2 + 3 + 5 + 4);
+    EXPECT_EQ(p[0], LOG_TOKEN_FRAME_START);
+    EXPECT_EQ(p[1], 0x44);
+    EXPECT_EQ(p[4], 0x11);
+    EXPECT_EQ(p[5], 4);
+    EXPECT_EQ(f.argc(), 4);
+    EXPECT_FALSE(f.truncated());
+
+    EXPECT_EQ(p[6], 'i');
+    EXPECT_EQ(p[7], 0x01);  // zigzag(-1)
+    EXPECT_EQ(p[8], 'u');
+    EXPECT_EQ(p[9], 0xAC);  // 300 = 0b10_0101100
+    EXPECT_EQ(p[10], 0x02);
+    EXPECT_EQ(p[11], 'f');
+    float v;
+    memcpy(&v, p + 12, sizeof(v));
+    EXPECT_EQ(v, 2.5f);
+    EXPECT_EQ(p[16], 's');
+    EXPECT_EQ(p[17], 2);
+    EXPECT_EQ(memcmp(p + 18, "hi", 2), 0);
+}
+
+TEST(LogToken, SixtyFourBitArgumentsAreKeptWhole) {
+    long long big = -(1LL << 40) - 3;
+    unsigned long long ubig = (1ULL << 63) + 5;
+    LogTokenFrame f = encode(1, big, ubig, INT64_MIN);
+    const uint8_t* p = f.data();
+
+    size_t pos = 6;
+    EXPECT_EQ(p[pos++], 'i');
+    EXPECT_EQ(unzigzag(readVarint(p, pos)), big);
+    EXPECT_EQ(p[pos++], 'u');
+    EXPECT_EQ(readVarint(p, pos), ubig);
+    EXPECT_EQ(p[pos++], 'i');
+    EXPECT_EQ(unzigzag(readVarint(p, pos)), INT64_MIN);
+    EXPECT_EQ(pos, f.size());
+}
+
+TEST(LogToken, ThirtyTwoBitValuesEncodeTheSameAtBothWidths) {
+    for (int32_t v : {0, 1, -1, 63, -64, 100000, INT32_MAX, INT32_MIN}) {
+        LogTokenFrame a = encode(1, (int)v);
+        LogTokenFrame b = encode(1, (long long)v);
+        ASSERT_EQ(a.size(), b.size()) << v;
+        EXPECT_EQ(memcmp(a.data(), b.data(), a.size()), 0) << v;
+    }
+}
+
+TEST(LogToken, LongStringIsCapped) {
+    std::string s(LOG_TOKEN_MAX_STR + 20, 'y');
+    LogTokenFrame f = encode(1, s.c_str());
+    EXPECT_EQ(f.data()[7], LOG_TOKEN_MAX_STR);
+    EXPECT_EQ(f.size(), 6u + 2 + LOG_TOKEN_MAX_STR);
+}
+
+TEST(LogToken, OverflowDropsWholeArgumentsAndFlagsTheFrame) {
+    // 6 + 3 x 50 = 156; a fourth string needs 50 more
+    const char* s = LONG_STR.c_str();
+    LogTokenFrame f = encode(1, s, s, s, s, 7);
+
+    EXPECT_TRUE(f.truncated());
+    EXPECT_EQ(f.argc(), 3);
+    EXPECT_EQ(f.size(), 156u);
+    EXPECT_EQ(f.data()[5], 3 | LOG_TOKEN_TRUNCATED);
+
+    // Every argument left in the frame parses to its end
+    size_t pos = 6;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(f.data()[pos], 's');
+        pos += 2 + f.data()[pos + 1];
+    }
+    EXPECT_EQ(pos, f.size());
+}
+
+TEST(LogToken, ExactFitIsNotTruncated) {
+    // 6 + 3 x 50 + 36: a 34-byte string fills the frame to the byte
+    std::string tail(LOG_TOKEN_MAX_FRAME - 156 - 2, 'z');
+    const char* s = LONG_STR.c_str();
+    LogTokenFrame f = encode(1, s, s, s, tail.c_str());
+    EXPECT_FALSE(f.truncated());
+    EXPECT_EQ(f.argc(), 4);
+    EXPECT_EQ(f.size(), (size_t)LOG_TOKEN_MAX_FRAME);
+
+    LogTokenFrame g = encode(1, s, s, s, tail.c_str(), 1);
+    EXPECT_TRUE(g.truncated());
+    EXPECT_EQ(g.argc(), 4);
+    EXPECT_EQ(g.size(), (size_t)LOG_TOKEN_MAX_FRAME);
+}
+
+// =============================================================================
+// DECODER ROUND TRIP
+// =============================================================================
+
+#define FMT_INTS   "[T] v=%d u=%u s=%s\n"
+#define FMT_WIDE   "[T] big=%lld ubig=%llu\n"
+#define FMT_FLOAT  "[T] f=%.2f\n"
+#define FMT_LONG   "[T] %s %s %s %s n=%d\n"
+
+static void writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    fwrite(bytes.data(), 1, bytes.size(), f);
+    fclose(f);
+}
+
+static void append(std::vector<uint8_t>& out, const LogTokenFrame& f) {
+    out.insert(out.end(), f.data(), f.data() + f.size());
+}
+
+static void append(std::vector<uint8_t>& out, const char* text) {
+    out.insert(out.end(), text, text + strlen(text));
+}
+
+/** @brief Format strings as the firmware image stores them */
+static void appendFormat(std::vector<uint8_t>& image, const char* fmt) {
+    append(image, "\x1F" "LF");
+    append(image, fmt);
+    image.push_back(0);
+}
+
+TEST(LogToken, DecoderRebuildsTheText) {
+    std::string python = PYTHON3;
+    if (python.empty()) GTEST_SKIP() << "no Python 3 interpreter";
+
+    std::vector<uint8_t> image = {0x7F, 'E', 'L', 'F', 0, 0};
+    appendFormat(image, FMT_INTS);
+    appendFormat(image, FMT_WIDE);
+    appendFormat(image, FMT_FLOAT);
+    appendFormat(image, FMT_LONG);
+
+    const char* s = LONG_STR.c_str();
+    std::vector<uint8_t> capture;
+    append(capture, "boot text\n");
+    append(capture, encode(logTokenHash(FMT_INTS), -5, 7u, "abc"));
+    append(capture, encode(logTokenHash(FMT_WIDE), -(1LL << 40), (1ULL << 63) + 5));
+    append(capture, encode(logTokenHash(FMT_FLOAT), 3.25f));
+    append(capture, "between\n");
+    append(capture, encode(logTokenHash(FMT_LONG), s, s, s, s, 9));
+    append(capture, encode(logTokenHash(FMT_INTS), 0, 0u, ""));
+
+    std::string dir = ::testing::TempDir();
+    std::string imagePath = dir + "log_token_image.bin";
+    std::string capturePath = dir + "log_token_capture.bin";
+    writeFile(imagePath, image);
+    writeFile(capturePath, capture);
+
+    std::string cmd = python + " " LOG_DECODE_PY " " + imagePath + " " + capturePath + " 2>/dev/null";
+    FILE* pipe = popen(cmd.c_str(), "r");
+    ASSERT_NE(pipe, nullptr);
+    std::string out;
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), pipe)) > 0) out.append(buf, n);
+    ASSERT_EQ(pclose(pipe), 0) << out;
+
+    std::string truncated = "<'[T] %s %s %s %s n=%d' ['" + LONG_STR + "', '" + LONG_STR +
+                            "', '" + LONG_STR + "'] truncated>\n";
+    EXPECT_EQ(out,
+              "boot text\n"
+              "[T] v=-5 u=7 s=abc\n"
+              "[T] big=-1099511627776 ubig=9223372036854775813\n"
+              "[T] f=3.25\n"
+              "between\n" +
+              truncated +
+              "[T] v=0 u=0 s=\n");
+}
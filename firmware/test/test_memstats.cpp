@@ -0,0 +1,141 @@
+/**
+ * @file test_memstats.cpp
+ * @brief Memory telemetry: fragmentation and leak alerts, stacks, JSON
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "memstats.h"
+#include "alerts.h"
+#include "events.h"
+#include "globals.h"
+#include "tasks.h"
+#include "host_hooks.h"
+
+static std::vector<AlertEvent> memAlerts;
+
+static void onAlert(const Event& ev, void*) {
+    if (ev.alert.type == ALERT_MEMORY) memAlerts.push_back(ev.alert);
+}
+
+static std::string memJson() {
+    static char buf[MEM_JSON_MAX];
+    formatMemJson(buf, sizeof(buf));
+    return buf;
+}
+
+static void idleTask(void*) {
+    for (;;) vTaskDelay(1000);
+}
+
+class MemStatsTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        subscribeEvent(EVT_ALERT, onAlert);
+    }
+
+    void SetUp() override {
+        hostClockManual(3600ULL * 1000000ULL);
+        hostHeapReset();
+        hostNvsErase();
+        loadConfig(runtimeCfg);
+        initAlerts();
+        initMemStats();
+        memAlerts.clear();
+    }
+
+    /** @brief Set the heap, move time on and take one sample */
+    void sample(uint32_t freeBytes, uint32_t largest, uint64_t advanceMs = MEM_SAMPLE_INTERVAL_MS) {
+        hostSetHeap(freeBytes, largest);
+        hostAdvanceMs(advanceMs);
+        sampleMemStats();
+    }
+};
+
+TEST_F(MemStatsTest, HealthyHeapRaisesNothing) {
+    sample(150000, 120000);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_OK);
+    EXPECT_TRUE(memAlerts.empty());
+
+    MemSample s = getMemSample();
+    EXPECT_EQ(s.freeBytes, 150000u);
+    EXPECT_EQ(s.largestBlock, 120000u);
+    EXPECT_EQ(s.fragPct, 20);
+    EXPECT_LT(memHoursToExhaustion(), 0.0f);
+}
+
+TEST_F(MemStatsTest, FragmentationWarnsThenGoesCriticalWithPlentyFree) {
+    // 100 KB free but split up: the 6 KB diagnostics buffer barely fits
+    sample(100000, 12000);
+    ASSERT_EQ(memAlerts.size(), 1u);
+    EXPECT_EQ(memAlerts[0].level, ALERT_WARNING);
+
+    sample(100000, 6000);
+    ASSERT_EQ(memAlerts.size(), 2u);
+    EXPECT_EQ(memAlerts[1].level, ALERT_CRITICAL);
+    EXPECT_NEAR(memAlerts[1].value, 6000 / 1024.0f, 0.01f);
+
+    // Just past the threshold is not enough to clear (hysteresis)...
+    sample(100000, MEM_BLOCK_CRITICAL + 100);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_CRITICAL);
+    sample(100000, MEM_BLOCK_WARNING + 100);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_WARNING);
+
+    // ...but a defragmented heap is
+    sample(100000, 90000);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_OK);
+    EXPECT_EQ(memAlerts.back().level, ALERT_OK);
+}
+
+TEST_F(MemStatsTest, FailedAllocationIsCritical) {
+    sample(150000, 120000);
+    hostFailAlloc(70000);
+    sample(150000, 120000);
+    ASSERT_EQ(memAlerts.size(), 1u);
+    EXPECT_EQ(memAlerts[0].level, ALERT_CRITICAL);
+    EXPECT_NE(memJson().find("\"alloc_failed\":1"), std::string::npos);
+
+    sample(150000, 120000);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_OK);
+}
+
+TEST_F(MemStatsTest, SlowLeakIsFlaggedDaysBeforeExhaustion) {
+    // Lose 1 KB an hour from 90 KB, one sample per hour
+    uint32_t freeBytes = 90 * 1024;
+    int hours = 0;
+    while (getMemAlertLevel() == ALERT_OK && hours < 100) {
+        sample(freeBytes, freeBytes, MEM_TREND_INTERVAL_MS);
+        freeBytes -= 1024;
+        hours++;
+    }
+
+    ASSERT_EQ(getMemAlertLevel(), ALERT_WARNING);
+    ASSERT_EQ(memAlerts.size(), 1u);
+    float left = memHoursToExhaustion();
+    EXPECT_GT(left, 24.0f);
+    EXPECT_LT(left, (float)MEM_OOM_HORIZON_H);
+    // Actual time to the critical floor at 1 KB/h
+    EXPECT_NEAR(left, (freeBytes + 1024 - MEM_FREE_CRITICAL) / 1024.0f, 1.0f);
+    EXPECT_GE(hours, MEM_TREND_MIN_POINTS);
+}
+
+TEST_F(MemStatsTest, TrendKeepsWorstOfEachInterval) {
+    sample(150000, 120000, 0);
+    sample(140000, 90000);                                // Dip mid-interval
+    sample(150000, 120000, MEM_TREND_INTERVAL_MS);        // Closes the hour
+    sample(150000, 120000, MEM_TREND_INTERVAL_MS);
+
+    std::string json = memJson();
+    EXPECT_NE(json.find(",140000,90000,0,36]"), std::string::npos) << json;
+    EXPECT_NE(json.find(",150000,120000,0,20]]"), std::string::npos) << json;
+}
+
+TEST_F(MemStatsTest, TracksTaskStacks) {
+    ASSERT_TRUE(startPinnedTask(idleTask, "idle", 4096, 1, 0));
+    sample(150000, 120000);
+
+    // The host reports half of every stack as never used
+    EXPECT_NE(memJson().find("\"idle\":{\"stack\":4096,\"min_free\":2048}"), std::string::npos);
+    EXPECT_EQ(getMemAlertLevel(), ALERT_OK);
+}
@@ -0,0 +1,270 @@
+/**
+ * @file test_mqtt.cpp
+ * @brief Telemetry payload, connection sequence and remote commands
+ */
+
+#include <gtest/gtest.h>
+#include <ArduinoJson.h>
+#include "mqtt.h"
+#include "buffer.h"
+#include "log_level.h"
+#include "latency.h"
+#include "scheduler.h"
+#include "host_hooks.h"
+
+static const char* TOPIC(const char* suffix) {
+    static std::string t;
+    t = std::string(MQTT_TOPIC_BASE) + suffix;
+    return t.c_str();
+}
+
+class MqttTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostClockManual(1000000);
+        hostNvsErase();
+        loadConfig(runtimeCfg);
+        initBuffer();
+        mqtt.disconnect();
+        mqtt.setConnectResult(true);
+        mqtt.setPublishResult(true);
+        mqtt.setBufferSize(JSON_BUFFER_SIZE);
+        mqtt.clearPublished();
+        activeConnection = CONN_GPRS;
+    }
+
+    static SystemData sample() {
+        SystemData d;
+        d.readingTime = 123456;
+        d.tempInlet.value = 40.04f;
+        d.tempOutlet.value = 45.06f;
+        d.voltage.value = 229.96f;
+        d.voltage.valid = true;
+        d.current.value = 7.256f;
+        d.power = 1668.6f;
+        d.pressureHigh.value = 280.4f;
+        d.compressorRunning = true;
+        d.current.alertLevel = ALERT_WARNING;
+        return d;
+    }
+};
+
+TEST_F(MqttTest, PayloadRoundTrips) {
+    char buf[JSON_BUFFER_SIZE];
+    size_t n = buildJsonPayload(sample(), buf, sizeof(buf));
+    ASSERT_GT(n, 0u);
+    ASSERT_LT(n, sizeof(buf));
+
+    StaticJsonDocument<JSON_BUFFER_SIZE> doc;
+    ASSERT_FALSE(deserializeJson(doc, (const char*)buf));
+    EXPECT_STREQ(doc["device"], DEVICE_ID);
+    EXPECT_EQ(doc["timestamp"].as<unsigned long>(), 123456u);
+    EXPECT_NEAR(doc["temperature"]["inlet"].as<float>(), 40.0f, 1e-4);
+    EXPECT_NEAR(doc["temperature"]["outlet"].as<float>(), 45.1f, 1e-4);
+    EXPECT_NEAR(doc["electrical"]["voltage"].as<float>(), 230.0f, 1e-4);
+    EXPECT_NEAR(doc["electrical"]["current"].as<float>(), 7.26f, 1e-4);
+    EXPECT_EQ(doc["electrical"]["power"].as<int>(), 1669);
+    EXPECT_EQ(doc["pressure"]["high"].as<int>(), 280);
+    EXPECT_TRUE(doc["status"]["compressor"].as<bool>());
+    EXPECT_EQ(doc["alerts"]["current"].as<int>(), (int)ALERT_WARNING);
+    EXPECT_TRUE(doc["valid"]["voltage"].as<bool>());
+    EXPECT_FALSE(doc["valid"]["current"].as<bool>());
+}
+
+TEST_F(MqttTest, ConnectAnnouncesAndSubscribes) {
+    ASSERT_TRUE(connectMQTT());
+    EXPECT_TRUE(isMQTTConnected());
+    EXPECT_STREQ(mqtt.host().c_str(), runtimeCfg.mqttHost);
+    EXPECT_EQ(mqtt.port(), runtimeCfg.mqttPort);
+
+    const auto& pub = mqtt.published();
+    ASSERT_GE(pub.size(), 1u);
+    EXPECT_EQ(pub[0].topic, TOPIC("/status/online"));
+    EXPECT_EQ(pub[0].payload, "true");
+    EXPECT_TRUE(pub[0].retained);
+
+    ASSERT_EQ(mqtt.subscriptions().size(), 1u);
+    EXPECT_EQ(mqtt.subscriptions()[0], TOPIC("/commands"));
+}
+
+TEST_F(MqttTest, NoTransportNoConnect) {
+    activeConnection = CONN_NONE;
+    EXPECT_FALSE(connectMQTT());
+    EXPECT_TRUE(mqtt.published().empty());
+}
+
+TEST_F(MqttTest, BufferedDataDrainsInOrderAndStopsOnFailure) {
+    ASSERT_TRUE(connectMQTT());
+    for (unsigned long t = 1; t <= 3; t++) {
+        SystemData d = sample();
+        d.readingTime = t;
+        bufferData(d);
+    }
+    mqtt.clearPublished();
+
+    EXPECT_TRUE(publishBufferedData());
+    EXPECT_FALSE(bufferHasData());
+    ASSERT_EQ(mqtt.published().size(), 3u);
+    EXPECT_NE(mqtt.published()[0].payload.find("\"timestamp\":1,"), std::string::npos);
+    EXPECT_NE(mqtt.published()[2].payload.find("\"timestamp\":3,"), std::string::npos);
+
+    bufferData(sample());
+    mqtt.setPublishResult(false);
+    EXPECT_FALSE(publishBufferedData());
+    EXPECT_EQ(bufferCount(), 1);
+}
+
+TEST_F(MqttTest, ConfigCommandUpdatesAndPersists) {
+    ASSERT_TRUE(connectMQTT());
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command\":\"config\",\"set\":{\"current_crit\":13.5,\"mqtt_user\":\"ops\"}}");
+
+    EXPECT_FLOAT_EQ(runtimeCfg.currentCritical, 13.5f);
+    EXPECT_STREQ(runtimeCfg.mqttUser, "ops");
+
+    RuntimeConfig stored;
+    loadConfig(stored);
+    EXPECT_FLOAT_EQ(stored.currentCritical, 13.5f);
+}
+
+TEST_F(MqttTest, ConfigCommandWithBadKeyChangesNothing) {
+    ASSERT_TRUE(connectMQTT());
+    float before = runtimeCfg.currentCritical;
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command\":\"config\",\"set\":{\"current_crit\":13.5,\"bogus\":1}}");
+    EXPECT_FLOAT_EQ(runtimeCfg.currentCritical, before);
+    EXPECT_FALSE(isProvisioned());
+}
+
+TEST_F(MqttTest, ConfigCommandWithBadValueChangesNothing) {
+    ASSERT_TRUE(connectMQTT());
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command\":\"config\",\"set\":{\"mqtt_user\":\"ops\",\"sensor_interval_ms\":0}}");
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command\":\"config\",\"set\":{\"current_warn\":14,\"current_crit\":13.5}}");
+    EXPECT_EQ(runtimeCfg.sensorReadInterval, SENSOR_READ_INTERVAL);
+    EXPECT_STREQ(runtimeCfg.mqttUser, MQTT_USER);
+    EXPECT_FLOAT_EQ(runtimeCfg.currentCritical, CURRENT_CRITICAL);
+    EXPECT_FALSE(isProvisioned());
+}
+
+TEST_F(MqttTest, LogLevelCommand) {
+    ASSERT_TRUE(connectMQTT());
+    mqtt.deliver(TOPIC("/commands"), "{\"command\":\"log_level\",\"module\":\"MQTT\",\"level\":\"debug\"}");
+    EXPECT_EQ(logModuleLevel[LOG_MOD_MQTT], LOG_LEVEL_DEBUG);
+
+    mqtt.deliver(TOPIC("/commands"), "{\"command\":\"log_level\",\"level\":1}");
+    EXPECT_EQ(logModuleLevel[LOG_MOD_MQTT], LOG_LEVEL_ERROR);
+    EXPECT_EQ(logModuleLevel[LOG_MOD_GSM], LOG_LEVEL_ERROR);
+}
+
+TEST_F(MqttTest, IgnoresNonJsonPayload) {
+    ASSERT_TRUE(connectMQTT());
+    float before = runtimeCfg.currentCritical;
+    mqtt.deliver(TOPIC("/commands"), "not json {");
+    mqtt.deliver(TOPIC("/commands"), "{\"command\":\"config\"}");
+    EXPECT_FLOAT_EQ(runtimeCfg.currentCritical, before);
+}
+
+TEST_F(MqttTest, ControlCommandRoundTrip) {
+    initControl();
+    ASSERT_TRUE(connectMQTT());
+    mqtt.clearPublished();
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command_id\":\"c1\",\"command\":\"set_mode\",\"params\":{\"mode\":\"fan_only\"}}");
+    EXPECT_TRUE(mqtt.published().empty());  // Answered once the engine has run
+
+    controlTick();
+    ControlResult r;
+    ASSERT_TRUE(receiveControlResult(r));
+    ASSERT_TRUE(publishControlResponse(r));
+
+    ASSERT_EQ(mqtt.published().size(), 1u);
+    EXPECT_EQ(mqtt.published()[0].topic, TOPIC("/responses"));
+    StaticJsonDocument<CONTROL_RESPONSE_MAX> doc;
+    ASSERT_FALSE(deserializeJson(doc, mqtt.published()[0].payload.c_str()));
+    EXPECT_STREQ(doc["command_id"], "c1");
+    EXPECT_STREQ(doc["command"], "set_mode");
+    EXPECT_STREQ(doc["result"], "success");
+    EXPECT_STREQ(doc["state"]["mode"], "fan_only");
+}
+
+TEST_F(MqttTest, InvalidControlCommandIsRejectedAtOnce) {
+    initControl();
+    ASSERT_TRUE(connectMQTT());
+    mqtt.clearPublished();
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command_id\":\"c2\",\"command\":\"set_mode\",\"params\":{\"mode\":\"turbo\"}}");
+
+    ASSERT_EQ(mqtt.published().size(), 1u);
+    StaticJsonDocument<CONTROL_RESPONSE_MAX> doc;
+    ASSERT_FALSE(deserializeJson(doc, mqtt.published()[0].payload.c_str()));
+    EXPECT_STREQ(doc["result"], "rejected");
+    EXPECT_STREQ(doc["error_code"], "invalid");
+    EXPECT_STREQ(doc["state"]["mode"], "off");
+}
+
+TEST_F(MqttTest, SetpointCommand) {
+    initControl();
+    ASSERT_TRUE(connectMQTT());
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command_id\":\"c3\",\"command\":\"set_setpoint\","
+                 "\"params\":{\"mode\":\"heating\",\"setpoint\":42.5}}");
+    controlTick();
+    ControlResult r;
+    ASSERT_TRUE(receiveControlResult(r));
+    EXPECT_EQ(r.result, CMD_SUCCESS);
+    EXPECT_FLOAT_EQ(getThermostatSetpoint(MODE_HEATING), 42.5f);
+
+    // Without a setpoint the mode goes back to the unit's own thermostat
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command_id\":\"c4\",\"command\":\"set_setpoint\",\"params\":{\"mode\":\"heating\"}}");
+    controlTick();
+    ASSERT_TRUE(receiveControlResult(r));
+    EXPECT_EQ(r.result, CMD_SUCCESS);
+    EXPECT_TRUE(isnan(getThermostatSetpoint(MODE_HEATING)));
+
+    mqtt.clearPublished();
+    mqtt.deliver(TOPIC("/commands"),
+                 "{\"command_id\":\"c5\",\"command\":\"set_setpoint\",\"params\":{\"mode\":\"off\",\"setpoint\":40}}");
+    ASSERT_EQ(mqtt.published().size(), 1u);
+    EXPECT_NE(mqtt.published()[0].payload.find("\"error_code\":\"invalid\""), std::string::npos);
+}
+
+// =============================================================================
+// DIAGNOSTICS (last: fills every latency histogram)
+// =============================================================================
+
+static uint32_t diagMs() { return 0; }
+static void diagJobFn(void*) {}
+
+TEST_F(MqttTest, DiagnosticsWithFullHistogramsAreCompleteJson) {
+    for (int i = 0; i < LAT_COUNT; i++) {
+        for (uint16_t b = 0; b < LAT_BUCKETS; b++) latencyRecord((LatencyId)i, latencyBucketLow(b));
+    }
+    static Scheduler a("diag_a", diagMs, diagMs), b("diag_b", diagMs, diagMs);
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        a.add("job", diagJobFn, nullptr, 1000, 0, 0);
+        b.add("job", diagJobFn, nullptr, 1000, 0, 0);
+    }
+
+    ASSERT_TRUE(connectMQTT());
+    mqtt.clearPublished();
+    ASSERT_TRUE(publishDiagnostics());
+    ASSERT_EQ(mqtt.published().size(), 1u);
+    const std::string& payload = mqtt.published()[0].payload;
+    EXPECT_EQ(mqtt.published()[0].topic, TOPIC("/diag/latency"));
+    EXPECT_LT(payload.size(), (size_t)DIAG_PAYLOAD_MAX);
+
+    DynamicJsonDocument doc(256 * 1024);
+    ASSERT_FALSE(deserializeJson(doc, payload.c_str())) << payload.substr(payload.size() - 64);
+    EXPECT_STREQ(doc["device"], DEVICE_ID);
+    for (int i = 0; i < LAT_COUNT; i++) {
+        const char* name = getLatencyName((LatencyId)i);
+        EXPECT_EQ(doc["latency"]["ops"][name]["b"].size(), (size_t)LAT_BUCKETS) << name;
+    }
+    EXPECT_FALSE(doc["power"].isNull());
+    EXPECT_FALSE(doc["supervisor"].isNull());
+    EXPECT_FALSE(doc["wifi"].isNull());
+    EXPECT_EQ(doc["sched"].size(), (size_t)schedulerCount());
+}
@@ -0,0 +1,94 @@
+/**
+ * @file test_mqtt_wire.cpp
+ * @brief Fleet simulator MQTT codec: packet layout and incremental parsing
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include "mqtt_wire.h"
+
+TEST(MqttWireTest, ConnectCarriesWillAndCredentials) {
+    MqttConnectOptions c = {};
+    c.clientId = "sim00001";
+    c.user = "u";
+    c.password = "p";
+    c.willTopic = "t";
+    c.willMessage = "false";
+    c.willQos = 1;
+    c.willRetain = true;
+    c.keepAliveS = 60;
+
+    std::vector<uint8_t> out;
+    mqttAppendConnect(out, c);
+
+    ASSERT_GE(out.size(), 12u);
+    EXPECT_EQ(out[0], 0x10);
+    EXPECT_EQ(out[1], out.size() - 2);
+    EXPECT_EQ(memcmp(&out[2], "\x00\x04MQTT\x04", 7), 0);
+    EXPECT_EQ(out[9], 0x80 | 0x40 | 0x20 | 0x08 | 0x04 | 0x02);
+    EXPECT_EQ(out[10], 0);
+    EXPECT_EQ(out[11], 60);
+    EXPECT_EQ(memcmp(&out[12], "\x00\x08sim00001", 10), 0);
+}
+
+TEST(MqttWireTest, PublishQos1HasPacketId) {
+    std::vector<uint8_t> out;
+    const uint8_t payload[] = {'4', '2'};
+    mqttAppendPublish(out, "a/b", payload, sizeof(payload), 1, 0x1234, false);
+
+    const uint8_t expected[] = {0x32, 9, 0, 3, 'a', '/', 'b', 0x12, 0x34, '4', '2'};
+    ASSERT_EQ(out.size(), sizeof(expected));
+    EXPECT_EQ(memcmp(out.data(), expected, sizeof(expected)), 0);
+}
+
+TEST(MqttWireTest, LongPublishUsesMultiByteLength) {
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> payload(200, 'x');
+    mqttAppendPublish(out, "t", payload.data(), payload.size(), 0, 0, true);
+
+    // 2 + 1 + 200 = 203 = 0xCB -> 0xCB 0x01
+    EXPECT_EQ(out[0], 0x31);
+    EXPECT_EQ(out[1], 0xCB);
+    EXPECT_EQ(out[2], 0x01);
+    EXPECT_EQ(out.size(), 3u + 203u);
+
+    MqttPacket pkt;
+    EXPECT_EQ(mqttNextPacket(out.data(), out.size(), pkt), 1);
+    EXPECT_EQ(pkt.type, MQTT_PKT_PUBLISH);
+    EXPECT_EQ(pkt.length, out.size());
+}
+
+TEST(MqttWireTest, ParsesConnackAndPuback) {
+    const uint8_t buf[] = {0x20, 2, 0, 5, 0x40, 2, 0xAB, 0xCD};
+    MqttPacket pkt;
+
+    ASSERT_EQ(mqttNextPacket(buf, sizeof(buf), pkt), 1);
+    EXPECT_EQ(pkt.type, MQTT_PKT_CONNACK);
+    EXPECT_EQ(pkt.returnCode, 5);
+    EXPECT_EQ(pkt.length, 4u);
+
+    ASSERT_EQ(mqttNextPacket(buf + 4, sizeof(buf) - 4, pkt), 1);
+    EXPECT_EQ(pkt.type, MQTT_PKT_PUBACK);
+    EXPECT_EQ(pkt.packetId, 0xABCD);
+}
+
+TEST(MqttWireTest, WaitsForPartialPacket) {
+    const uint8_t buf[] = {0x40, 2, 0x00, 0x07};
+    MqttPacket pkt;
+    for (size_t n = 0; n < sizeof(buf); n++) {
+        EXPECT_EQ(mqttNextPacket(buf, n, pkt), 0) << n << " bytes";
+    }
+    EXPECT_EQ(mqttNextPacket(buf, sizeof(buf), pkt), 1);
+}
+
+TEST(MqttWireTest, RejectsMalformedPackets) {
+    MqttPacket pkt;
+    const uint8_t badConnack[] = {0x20, 3, 0, 0, 0};
+    EXPECT_EQ(mqttNextPacket(badConnack, sizeof(badConnack), pkt), -1);
+
+    const uint8_t longLength[] = {0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    EXPECT_EQ(mqttNextPacket(longLength, sizeof(longLength), pkt), -1);
+
+    const uint8_t reserved[] = {0x00, 0};
+    EXPECT_EQ(mqttNextPacket(reserved, sizeof(reserved), pkt), -1);
+}
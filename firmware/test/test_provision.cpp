@@ -0,0 +1,101 @@
+/**
+ * @file test_provision.cpp
+ * @brief Portal form: schema parsing and validation before a save, and
+ * the hand-off of saved values to the task that owns the live config
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <WiFi.h>
+#include "config_store.h"
+#include "events.h"
+#include "host_hooks.h"
+#include "provision.h"
+
+#define FORM_OK "wifi_ssid=HomeNet&wifi_pass=secret&mqtt_host=broker.lan&mqtt_user=hp&mqtt_pass=pw"
+
+class ProvisionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hostClockManual(1000000);
+        hostNvsErase();
+        loadConfig(cfg);
+        startProvisioningPortal(cfg);
+    }
+
+    void TearDown() override {
+        stopProvisioningPortal();
+        hostClockReal();
+    }
+
+    /** @brief POST the form to /save, return the raw response */
+    std::string save(const std::string& body) {
+        std::string req =
+            "POST /save HTTP/1.1\r\nHost: 192.168.4.1\r\n"
+            "Content-Type: application/x-www-form-urlencoded\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        auto conn = WiFiServer::hostAccept(80, req);
+        handleProvisioningPortal();
+        return conn->written();
+    }
+
+    static bool status(const std::string& response, int code) {
+        return response.compare(0, 12, "HTTP/1.1 " + std::to_string(code)) == 0;
+    }
+
+    RuntimeConfig cfg;
+};
+
+TEST_F(ProvisionTest, ValidFormIsSaved) {
+    std::string r = save(FORM_OK "&mqtt_port=8883");
+    EXPECT_TRUE(status(r, 200)) << r.substr(0, 40);
+    EXPECT_TRUE(isProvisioned());
+    EXPECT_FALSE(isPortalActive());
+
+    RuntimeConfig stored;
+    loadConfig(stored);
+    EXPECT_STREQ(stored.wifiSSID, "HomeNet");
+    EXPECT_STREQ(stored.mqttHost, "broker.lan");
+    EXPECT_EQ(stored.mqttPort, 8883);
+    EXPECT_STREQ(stored.mqttPass, "pw");
+}
+
+TEST_F(ProvisionTest, OutOfRangePortIsRejected) {
+    for (const char* port : {"0", "abc", "70000", "-1", "8883x"}) {
+        std::string r = save(std::string(FORM_OK "&mqtt_port=") + port);
+        EXPECT_TRUE(status(r, 400)) << port << ": " << r.substr(0, 40);
+        EXPECT_NE(r.find("mqtt_port"), std::string::npos) << port;
+    }
+    EXPECT_FALSE(isProvisioned());
+    EXPECT_TRUE(isPortalActive());  // Still open for a corrected form
+}
+
+TEST_F(ProvisionTest, EmptyPortKeepsTheCurrentOne) {
+    EXPECT_TRUE(status(save(FORM_OK "&mqtt_port="), 200));
+    RuntimeConfig stored;
+    loadConfig(stored);
+    EXPECT_EQ(stored.mqttPort, MQTT_PORT);
+}
+
+TEST_F(ProvisionTest, RequiredFieldsMustBeFilled) {
+    EXPECT_TRUE(status(save("wifi_ssid=&mqtt_host=broker.lan"), 400));
+    EXPECT_TRUE(status(save("wifi_ssid=HomeNet"), 400));
+    EXPECT_FALSE(isProvisioned());
+}
+
+TEST_F(ProvisionTest, SaveLeavesTheCallersConfigAlone) {
+    QueueHandle_t events = createEventQueue(4);
+    ASSERT_TRUE(subscribeEventQueue(EVENT_MASK(EVT_CONFIG), events));
+    RuntimeConfig before = cfg;
+
+    ASSERT_TRUE(status(save(FORM_OK "&mqtt_port=8883"), 200));
+    EXPECT_EQ(memcmp(&cfg, &before, sizeof(cfg)), 0);
+
+    // The owner learns of the save from the event and reads the blob
+    Event ev;
+    ASSERT_EQ(xQueueReceive(events, &ev, 0), pdTRUE);
+    EXPECT_EQ(ev.configChanged, CFG_SECTION_NETWORK);
+    ASSERT_TRUE(readSavedConfig(cfg));
+    EXPECT_STREQ(cfg.mqttHost, "broker.lan");
+    EXPECT_EQ(cfg.mqttPort, 8883);
+}
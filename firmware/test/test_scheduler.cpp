@@ -0,0 +1,258 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief EDF dispatch, overrun accounting and wrap-safe timing of the
+ * cooperative scheduler against a virtual clock
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "scheduler.h"
+
+static uint32_t clockMs;
+
+static uint32_t fakeMs() { return clockMs; }
+static uint32_t fakeUs() { return clockMs * 1000u; }
+
+/** @brief What a test job does when it runs */
+struct TestJob {
+    char tag;
+    uint32_t runMs;      ///< Virtual time the job takes
+    std::string* order;  ///< Tags in run order
+};
+
+static void runJob(void* ctx) {
+    TestJob* t = (TestJob*)ctx;
+    if (t->order) *t->order += t->tag;
+    clockMs += t->runMs;
+}
+
+static int missCalls;
+static int32_t lastLateMs;
+
+static void onMiss(const SchedJob& job, int32_t lateMs) {
+    missCalls++;
+    lastLateMs = lateMs;
+}
+
+class SchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        clockMs = 1000;
+        missCalls = 0;
+        lastLateMs = 0;
+        order.clear();
+    }
+
+    /** @brief Run every ready job, return how many ran */
+    int drain(Scheduler& s) {
+        int n = 0;
+        while (s.runOnce()) n++;
+        return n;
+    }
+
+    std::string order;
+};
+
+TEST_F(SchedulerTest, EarliestDeadlineRunsFirst) {
+    Scheduler s("edf", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order}, b = {'b', 0, &order}, c = {'c', 0, &order};
+    s.add("a", runJob, &a, 1000, 500, 0);
+    s.add("b", runJob, &b, 1000, 100, 0);
+    s.add("c", runJob, &c, 1000, 0, 0);  // Deadline = period
+
+    EXPECT_EQ(drain(s), 3);
+    EXPECT_EQ(order, "bac");
+}
+
+TEST_F(SchedulerTest, PriorityBreaksDeadlineTies) {
+    Scheduler s("prio", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order}, b = {'b', 0, &order}, c = {'c', 0, &order};
+    s.add("a", runJob, &a, 1000, 200, 2);
+    s.add("b", runJob, &b, 1000, 200, 0);
+    s.add("c", runJob, &c, 1000, 200, 1);
+
+    EXPECT_EQ(drain(s), 3);
+    EXPECT_EQ(order, "bca");
+}
+
+TEST_F(SchedulerTest, JobWaitsForItsNextRelease) {
+    Scheduler s("period", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order};
+    uint8_t id = s.add("a", runJob, &a, 250, 0, 0);
+
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_FALSE(s.runOnce());
+    EXPECT_EQ(s.msUntilNext(), 250u);
+
+    clockMs += 249;
+    EXPECT_FALSE(s.runOnce());
+    clockMs += 1;
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_EQ(s.job(id).runs, 2u);
+    EXPECT_EQ(s.job(id).misses, 0u);
+}
+
+TEST_F(SchedulerTest, DisabledJobWaitsForTrigger) {
+    Scheduler s("enable", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order};
+    uint8_t id = s.add("a", runJob, &a, 1000, 0, 0);
+    s.setEnabled(id, false);
+    EXPECT_FALSE(s.runOnce());
+    EXPECT_EQ(s.msUntilNext(), UINT32_MAX);
+
+    s.setEnabled(id, true);
+    EXPECT_TRUE(s.runOnce());
+
+    clockMs += 10;
+    s.trigger(id);
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_EQ(s.job(id).runs, 2u);
+}
+
+TEST_F(SchedulerTest, OverrunCountsMissAndSkipsWholePeriods) {
+    Scheduler s("overrun", fakeMs, fakeUs);
+    s.setMissHook(onMiss);
+    TestJob slow = {'s', 350, &order};
+    uint8_t id = s.add("slow", runJob, &slow, 100, 50, 0);
+
+    // Released at 1000, due 1050, finishes at 1350
+    EXPECT_TRUE(s.runOnce());
+    const SchedJob& j = s.job(id);
+    EXPECT_EQ(j.runs, 1u);
+    EXPECT_EQ(j.misses, 1u);
+    EXPECT_EQ(j.worstLateMs, 300);
+    EXPECT_EQ(j.lastUs, 350000u);
+    EXPECT_EQ(missCalls, 1);
+    EXPECT_EQ(lastLateMs, 300);
+
+    // Releases at 1100 and 1200 passed entirely: skipped. The one at
+    // 1300 is still pending and runs as the single catch-up.
+    EXPECT_EQ(j.skipped, 2u);
+    EXPECT_EQ(j.releaseMs, 1300u);
+
+    slow.runMs = 10;
+    EXPECT_TRUE(s.runOnce());  // Due 1350, finishes 1360
+    EXPECT_EQ(j.misses, 2u);
+    EXPECT_EQ(j.worstLateMs, 300);
+    EXPECT_EQ(j.skipped, 2u);
+    EXPECT_EQ(j.maxUs, 350000u);
+    EXPECT_EQ(s.msUntilNext(), 40u);
+}
+
+TEST_F(SchedulerTest, RunOnTimeIsNotAMiss) {
+    Scheduler s("ontime", fakeMs, fakeUs);
+    s.setMissHook(onMiss);
+    TestJob a = {'a', 50, &order};
+    uint8_t id = s.add("a", runJob, &a, 100, 50, 0);
+
+    EXPECT_TRUE(s.runOnce());  // Finishes exactly at the deadline
+    EXPECT_EQ(s.job(id).misses, 0u);
+    EXPECT_EQ(s.job(id).skipped, 0u);
+    EXPECT_EQ(missCalls, 0);
+}
+
+TEST_F(SchedulerTest, SetPeriodReanchorsTheNextRelease) {
+    Scheduler s("setperiod", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order};
+    uint8_t id = s.add("a", runJob, &a, 1000, 0, 0);
+    EXPECT_TRUE(s.runOnce());  // Next release 2000
+
+    // Shorter: next release moves to 1000 + 200, not "now"
+    EXPECT_TRUE(s.setPeriod(id, 200));
+    EXPECT_EQ(s.job(id).releaseMs, 1200u);
+    clockMs = 1199;
+    EXPECT_FALSE(s.runOnce());
+    clockMs = 1200;
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_EQ(s.job(id).releaseMs, 1400u);
+
+    // Longer
+    EXPECT_TRUE(s.setPeriod(id, 500));
+    EXPECT_EQ(s.job(id).releaseMs, 1700u);
+}
+
+TEST_F(SchedulerTest, ZeroPeriodIsRejected) {
+    Scheduler s("zero", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order};
+    EXPECT_EQ(s.add("bad", runJob, &a, 0, 0, 0), SCHED_INVALID);
+    EXPECT_EQ(s.count(), 0u);
+
+    uint8_t id = s.add("a", runJob, &a, 100, 0, 0);
+    EXPECT_FALSE(s.setPeriod(id, 0));
+    EXPECT_FALSE(s.setPeriod(SCHED_MAX_JOBS, 100));
+    EXPECT_EQ(s.job(id).periodMs, 100u);
+
+    // Still periodic, not released on every pass
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_FALSE(s.runOnce());
+}
+
+TEST_F(SchedulerTest, TableFull) {
+    Scheduler s("full", fakeMs, fakeUs);
+    TestJob a = {'a', 0, nullptr};
+    for (int i = 0; i < SCHED_MAX_JOBS; i++) {
+        EXPECT_EQ(s.add("a", runJob, &a, 100, 0, 0), i);
+    }
+    EXPECT_EQ(s.add("a", runJob, &a, 100, 0, 0), SCHED_INVALID);
+}
+
+TEST_F(SchedulerTest, PeriodsHoldAcrossMillisWrap) {
+    clockMs = 0xFFFFFF00u;  // 256 ms before the wrap
+    Scheduler s("wrap", fakeMs, fakeUs);
+    s.setMissHook(onMiss);
+    TestJob a = {'a', 5, &order};
+    uint8_t id = s.add("a", runJob, &a, 100, 0, 0);
+
+    int runs = 0;
+    while ((int32_t)(clockMs - 300u) < 0) {
+        runs += drain(s);
+        clockMs += 10;
+    }
+    // Released at -256, -156, -56, 44, 144 and 244; next due at 344
+    EXPECT_EQ(runs, 6);
+    EXPECT_EQ(s.job(id).misses, 0u);
+    EXPECT_EQ(s.job(id).skipped, 0u);
+    EXPECT_EQ(missCalls, 0);
+    EXPECT_EQ(s.job(id).releaseMs, 344u);
+}
+
+TEST_F(SchedulerTest, EarliestDeadlineAcrossMillisWrap) {
+    clockMs = 0xFFFFFFF0u;
+    Scheduler s("wrapedf", fakeMs, fakeUs);
+    TestJob a = {'a', 0, &order}, b = {'b', 0, &order};
+    s.add("a", runJob, &a, 1000, 100, 0);  // Due after the wrap (0x54)
+    s.add("b", runJob, &b, 1000, 10, 0);   // Due before it (0xFFFFFFFA)
+
+    EXPECT_EQ(drain(s), 2);
+    EXPECT_EQ(order, "ba");
+}
+
+TEST_F(SchedulerTest, OverrunAcrossMillisWrapSkips) {
+    clockMs = 0xFFFFFFF0u;
+    Scheduler s("wrapskip", fakeMs, fakeUs);
+    TestJob slow = {'s', 250, &order};
+    uint8_t id = s.add("slow", runJob, &slow, 100, 0, 0);
+
+    EXPECT_TRUE(s.runOnce());
+    EXPECT_EQ(s.job(id).misses, 1u);
+    EXPECT_EQ(s.job(id).worstLateMs, 150);
+    EXPECT_EQ(s.job(id).skipped, 1u);
+    EXPECT_EQ(s.job(id).releaseMs, 0xFFFFFFF0u + 200u);
+}
+
+TEST_F(SchedulerTest, JsonCarriesAccounting) {
+    Scheduler s("json", fakeMs, fakeUs);
+    TestJob a = {'a', 120, nullptr};
+    s.add("a", runJob, &a, 100, 50, 0);
+    s.runOnce();
+
+    char buf[256];
+    size_t n = s.toJson(buf, sizeof(buf));
+    EXPECT_EQ(n, strlen(buf));
+    EXPECT_NE(strstr(buf, "\"name\":\"json\""), nullptr);
+    EXPECT_NE(strstr(buf, "\"runs\":1,\"misses\":1,\"skipped\":0"), nullptr);
+    EXPECT_NE(strstr(buf, "\"worst_late_ms\":70"), nullptr);
+
+    char small[16];
+    EXPECT_EQ(s.toJson(small, sizeof(small)), sizeof(small) - 1);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file test_sensors.cpp
+ * @brief Sensor conversions driven by synthetic ADC waveforms
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include "sensors.h"
+#include "host_hooks.h"
+
+/** @brief 50 Hz sine centred on the ADC midpoint */
+static HostWaveform mains(float peakVolts, float offset = 1.65f) {
+    return [=](uint64_t us) {
+        return offset + peakVolts * (float)sin(2.0 * M_PI * 50.0 * (double)us / 1e6);
+    };
+}
+
+class SensorsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // The RMS loops pace themselves with delayMicroseconds()
+        hostClockManual(0);
+        hostResetPins();
+        hostSetPinVolts(PIN_CURRENT, CT_BIAS_VOLTAGE);
+        initSensors();
+    }
+};
+
+TEST_F(SensorsTest, VoltageRms) {
+    // 230 V RMS at the mains side is (230 / 269.40) V RMS at the ADC
+    float peak = 230.0f / VOLTAGE_SCALE_FACTOR * sqrtf(2.0f);
+    hostSetPinWaveform(PIN_VOLTAGE, mains(peak));
+    EXPECT_NEAR(readVoltageRMS(PIN_VOLTAGE), 230.0f, 1.5f);
+
+    hostSetPinVolts(PIN_VOLTAGE, 1.65f);
+    EXPECT_LT(readVoltageRMS(PIN_VOLTAGE), 1.0f);
+}
+
+TEST_F(SensorsTest, CurrentRmsAgainstCalibratedZero) {
+    float peak = 10.0f * CT_OUTPUT_VOLTAGE_MAX / CT_CURRENT_MAX * sqrtf(2.0f);
+    hostSetPinWaveform(PIN_CURRENT, mains(peak));
+    EXPECT_NEAR(readCurrentRMS(PIN_CURRENT), 10.0f, 0.1f);
+}
+
+TEST_F(SensorsTest, CurrentBelowNoiseFloorReadsZero) {
+    float peak = 0.1f * CT_OUTPUT_VOLTAGE_MAX / CT_CURRENT_MAX * sqrtf(2.0f);
+    hostSetPinWaveform(PIN_CURRENT, mains(peak));
+    EXPECT_EQ(readCurrentRMS(PIN_CURRENT), 0.0f);
+}
+
+TEST_F(SensorsTest, NtcTemperature) {
+    // 10k NTC against the 9.8k series resistor
+    hostSetPinVolts(PIN_TEMP_INLET, 3.3f * 10000.0f / (10000.0f + NTC_SERIES_RESISTANCE));
+    EXPECT_NEAR(readTemperature(PIN_TEMP_INLET), 24.87f, 0.3f);
+
+    hostSetPinVolts(PIN_TEMP_INLET, 3.3f * 3000.0f / (3000.0f + NTC_SERIES_RESISTANCE));
+    EXPECT_NEAR(readTemperature(PIN_TEMP_INLET), 52.67f, 0.3f);
+}
+
+TEST_F(SensorsTest, NtcMathWithoutAdc) {
+    EXPECT_NEAR(ntcTemperature(3.3f * 10000.0f / (10000.0f + NTC_SERIES_RESISTANCE)), 24.87f, 0.05f);
+    EXPECT_NEAR(ntcTemperature(3.3f * 30000.0f / (30000.0f + NTC_SERIES_RESISTANCE)), -8.99f, 0.05f);
+    EXPECT_TRUE(isnan(ntcTemperature(0.0f)));
+}
+
+TEST_F(SensorsTest, NtcRailsAreInvalid) {
+    hostSetPinVolts(PIN_TEMP_OUTLET, 0.0f);
+    EXPECT_TRUE(isnan(readTemperature(PIN_TEMP_OUTLET)));
+    hostSetPinVolts(PIN_TEMP_OUTLET, 3.3f);
+    EXPECT_TRUE(isnan(readTemperature(PIN_TEMP_OUTLET)));
+}
+
+TEST_F(SensorsTest, PressureIsLinearAndClamped) {
+    hostSetPinVolts(PIN_PRESSURE_HIGH, 1.65f);
+    EXPECT_NEAR(readPressure(PIN_PRESSURE_HIGH), 143.75f, 0.5f);
+    hostSetPinVolts(PIN_PRESSURE_HIGH, 0.1f);
+    EXPECT_EQ(readPressure(PIN_PRESSURE_HIGH), 0.0f);
+}
+
+TEST_F(SensorsTest, ReadAllFlagsInvalidChannels) {
+    float peak = 230.0f / VOLTAGE_SCALE_FACTOR * sqrtf(2.0f);
+    hostSetPinWaveform(PIN_VOLTAGE, mains(peak));
+    hostSetPinVolts(PIN_TEMP_INLET, 1.6667f);
+
+    SystemData d = readAllSensors();
+    EXPECT_TRUE(d.voltage.valid);
+    EXPECT_TRUE(d.tempInlet.valid);
+    EXPECT_FALSE(d.tempOutlet.valid);  // unconnected pin reads 0 V
+    EXPECT_TRUE(d.current.valid);
+    EXPECT_FALSE(d.compressorRunning);
+    EXPECT_EQ(d.power, 0.0f);
+}
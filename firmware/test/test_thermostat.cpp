@@ -0,0 +1,290 @@
+/**
+ * @file test_thermostat.cpp
+ * @brief Outlet temperature loop, closed against the thermal plant
+ *
+ * Each test runs the control engine and the loop against ThermalPlant
+ * (tools/vsim/plant.h) on the manual clock for hours of plant time.
+ * Readings are built straight from the plant, except in the sensor path
+ * test, which goes through the ADC front end and readAllSensors().
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include "control.h"
+#include "config_store.h"
+#include "globals.h"
+#include "latency.h"
+#include "sensors.h"
+#include "tasks.h"
+#include "host_hooks.h"
+#include "plant.h"
+
+#define SIM_STEP_MS 1000UL
+
+/**
+ * @brief What a stretch of simulation did
+ */
+struct LoopStats {
+    double outletSum = 0;     ///< Time-weighted, for the mean
+    double seconds = 0;
+    float outletMin = 1e9f;
+    float outletMax = -1e9f;
+    float tankMax = -1e9f;
+    int starts = 0;
+    uint32_t shortestOnMs = UINT32_MAX;    ///< Completed runs only
+    uint32_t shortestOffMs = UINT32_MAX;   ///< Completed stops only
+
+    float mean() const { return seconds > 0 ? (float)(outletSum / seconds) : NAN; }
+};
+
+class ThermostatTest : public ::testing::Test {
+protected:
+    ThermalPlant plant;
+    bool heating = true;
+    bool realSensors = false;
+    bool highPressure = false;   ///< Inject a high-pressure trip
+    uint32_t lastSenseMs = 0;
+    uint32_t lastSwitchMs = 0;
+    bool wasOn = false;
+
+    static void SetUpTestSuite() {
+        initTaskQueues();
+    }
+
+    void SetUp() override {
+        hostClockManual(3600ULL * 1000000ULL);
+        hostNvsErase();
+        loadConfig(runtimeCfg);
+        initLatency();
+        initControl();
+        heating = true;
+        realSensors = false;
+        highPressure = false;
+        lastSenseMs = millis() - runtimeCfg.sensorReadInterval;
+        lastSwitchMs = millis();
+        wasOn = false;
+    }
+
+    static bool compressorOn() {
+        return getControlStatus().relays & RELAY_BIT(RELAY_COMPRESSOR);
+    }
+
+    SystemData plantReading() {
+        if (realSensors) {
+            plantApply(thermalState(millis() * 1000ULL, plant, compressorOn()));
+            return readAllSensors();
+        }
+        SystemData r;
+        r.readingTime = millis();
+        auto set = [](SensorReading& s, float v) { s.value = v; s.valid = true; };
+        set(r.tempInlet, plant.tankC);
+        set(r.tempOutlet, plant.tankC + plant.riseC);
+        set(r.tempAmbient, plant.ambientC);
+        set(r.tempCompressor, compressorOn() ? 55.0f : plant.ambientC + 10.0f);
+        set(r.voltage, 230.0f);
+        set(r.current, compressorOn() ? PLANT_RUN_CURRENT_A : 0.0f);
+        set(r.pressureHigh, highPressure ? 480.0f : 280.0f);
+        set(r.pressureLow, 70.0f);
+        return r;
+    }
+
+    /** @brief Post a command and run until it has been applied */
+    CommandResult command(ControlCommandType type, OperatingMode mode, float setpoint = NAN) {
+        ControlCommand cmd;
+        memset(&cmd, 0, sizeof(cmd));
+        cmd.type = type;
+        cmd.mode = mode;
+        cmd.setpoint = setpoint;
+        EXPECT_TRUE(postControlCommand(cmd));
+        run(SIM_STEP_MS);
+
+        ControlResult r;
+        EXPECT_TRUE(receiveControlResult(r));
+        return r.result;
+    }
+
+    /** @brief Advance plant, sensing and engine; collect stats */
+    void run(uint64_t ms, LoopStats* stats = nullptr) {
+        for (uint64_t t = 0; t < ms; t += SIM_STEP_MS) {
+            bool on = compressorOn();
+            hostAdvanceMs(SIM_STEP_MS);
+            thermalStep(plant, SIM_STEP_MS / 1000.0f, on, heating);
+
+            if (millis() - lastSenseMs >= runtimeCfg.sensorReadInterval) {
+                lastSenseMs = millis();
+                publishLatestReading(plantReading());
+            }
+            controlTick();
+
+            bool nowOn = compressorOn();
+            if (nowOn != wasOn) {
+                uint32_t held = millis() - lastSwitchMs;
+                if (stats && stats->seconds > 0) {
+                    uint32_t& shortest = wasOn ? stats->shortestOnMs : stats->shortestOffMs;
+                    if (held < shortest) shortest = held;
+                }
+                if (stats && nowOn) stats->starts++;
+                lastSwitchMs = millis();
+                wasOn = nowOn;
+            }
+            if (stats) {
+                float outlet = plant.tankC + plant.riseC;
+                stats->outletSum += outlet * (SIM_STEP_MS / 1000.0);
+                stats->seconds += SIM_STEP_MS / 1000.0;
+                stats->outletMin = fminf(stats->outletMin, outlet);
+                stats->outletMax = fmaxf(stats->outletMax, outlet);
+                stats->tankMax = fmaxf(stats->tankMax, plant.tankC);
+            }
+        }
+    }
+
+    /** @brief Past the boot restart delay, mode on, loop closed */
+    void start(OperatingMode mode, float setpoint) {
+        heating = mode == MODE_HEATING;
+        run(COMPRESSOR_RESTART_DELAY_MS);
+        ASSERT_EQ(command(CTRL_CMD_SET_SETPOINT, mode, setpoint), CMD_SUCCESS);
+        ASSERT_EQ(command(CTRL_CMD_SET_MODE, mode), CMD_SUCCESS);
+    }
+
+    static void report(const char* name, const LoopStats& s) {
+        printf("  %-10s mean %.2f C, range %.1f..%.1f, %d starts (%.1f/h), "
+               "shortest on %u s, off %u s\n",
+               name, s.mean(), s.outletMin, s.outletMax, s.starts, s.starts * 3600.0 / s.seconds,
+               (unsigned int)(s.shortestOnMs / 1000), (unsigned int)(s.shortestOffMs / 1000));
+    }
+};
+
+#define HOURS(h) ((uint64_t)((h) * 3600000.0))
+
+/** @brief Cycling stayed within the compressor's minimum on/off times */
+static void expectGentleCycling(const LoopStats& s) {
+    EXPECT_GE(s.shortestOnMs, COMPRESSOR_MIN_RUN_MS);
+    EXPECT_GE(s.shortestOffMs, COMPRESSOR_RESTART_DELAY_MS);
+    EXPECT_LE(s.starts * 3600.0 / s.seconds, 4.0);
+}
+
+TEST_F(ThermostatTest, HoldsHeatingSetpoint) {
+    plant = thermalInit(30.0f, 15.0f, 2.0f);
+    start(MODE_HEATING, 45.0f);
+    run(HOURS(4));
+
+    LoopStats s;
+    run(HOURS(4), &s);
+    report("heating", s);
+    EXPECT_NEAR(s.mean(), 45.0f, 0.3f);
+    expectGentleCycling(s);
+
+    // The integral made up for the nameplate rise (5 C) above the plant's (4 C)
+    EXPECT_GT(getThermostatStatus().integral, 0.0f);
+}
+
+TEST_F(ThermostatTest, HoldsCoolingSetpoint) {
+    plant = thermalInit(20.0f, 30.0f, 1.5f);
+    start(MODE_COOLING, 10.0f);
+    run(HOURS(4));
+
+    LoopStats s;
+    run(HOURS(4), &s);
+    report("cooling", s);
+    EXPECT_NEAR(s.mean(), 10.0f, 0.3f);
+    expectGentleCycling(s);
+}
+
+TEST_F(ThermostatTest, RejectsLoadStep) {
+    plant = thermalInit(40.0f, 15.0f, 1.0f);
+    start(MODE_HEATING, 45.0f);
+    run(HOURS(6));
+
+    plant.loadKw = 3.0f;
+    LoopStats settling, s;
+    run(HOURS(2), &settling);
+    run(HOURS(4), &s);
+    report("load step", s);
+    EXPECT_GT(settling.outletMin, 38.0f);
+    EXPECT_NEAR(s.mean(), 45.0f, 0.3f);
+    expectGentleCycling(s);
+}
+
+TEST_F(ThermostatTest, NoWindupWhileTripped) {
+    plant = thermalInit(40.0f, 15.0f, 2.0f);
+    start(MODE_HEATING, 45.0f);
+    run(HOURS(4));
+
+    // An hour held off by a trip: the tank cools, the integral must not grow
+    float integral = getThermostatStatus().integral;
+    highPressure = true;
+    LoopStats tripped;
+    run(HOURS(1), &tripped);
+    EXPECT_EQ(tripped.starts, 0);
+    EXPECT_FALSE(compressorOn());
+    EXPECT_FLOAT_EQ(getThermostatStatus().integral, integral);
+    EXPECT_FLOAT_EQ(getThermostatStatus().demand, 1.0f);
+
+    highPressure = false;
+    LoopStats recovery, s;
+    run(HOURS(3), &recovery);
+    run(HOURS(3), &s);
+    report("recovery", recovery);
+    EXPECT_LT(recovery.tankMax, 45.0f);   // No overshoot from a wound-up integral
+    EXPECT_NEAR(s.mean(), 45.0f, 0.3f);
+}
+
+TEST_F(ThermostatTest, HoldsSetpointThroughSensorFrontEnd) {
+    plant = thermalInit(42.0f, 15.0f, 2.0f);
+    plantApply(thermalState(millis() * 1000ULL, plant, false));
+    initSensors();
+    realSensors = true;
+    start(MODE_HEATING, 45.0f);
+    run(HOURS(3));
+
+    LoopStats s;
+    run(HOURS(3), &s);
+    report("sensors", s);
+    EXPECT_NEAR(s.mean(), 45.0f, 0.5f);
+    expectGentleCycling(s);
+}
+
+TEST_F(ThermostatTest, RunsAtFixedRate) {
+    plant = thermalInit(40.0f, 15.0f, 2.0f);
+    start(MODE_HEATING, 45.0f);
+    uint32_t steps = getLatencyHistogram(LAT_THERMO_STEP).count;
+    uint32_t late = latencyCountAbove(LAT_THERMO_JITTER, 1000);
+    run(HOURS(1));
+
+    // Histograms run since boot: compare counts
+    EXPECT_EQ(getLatencyHistogram(LAT_THERMO_STEP).count - steps, 3600000UL / THERMO_PERIOD_MS);
+    EXPECT_EQ(latencyCountAbove(LAT_THERMO_JITTER, 1000), late);  // Schedule never drifts
+}
+
+TEST_F(ThermostatTest, SetpointCommand) {
+    plant = thermalInit(40.0f, 15.0f, 2.0f);
+    run(SIM_STEP_MS);
+    EXPECT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_HEATING, 70.0f), CMD_REJECTED_INVALID);
+    EXPECT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_FAN_ONLY, 20.0f), CMD_REJECTED_INVALID);
+    EXPECT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_OFF, 45.0f), CMD_REJECTED_INVALID);  // Current: off
+    EXPECT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_COOLING, 12.0f), CMD_SUCCESS);
+
+    start(MODE_HEATING, 45.0f);
+    EXPECT_FLOAT_EQ(getControlStatus().setpoint, 45.0f);
+    EXPECT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_OFF, 44.0f), CMD_SUCCESS);
+    EXPECT_FLOAT_EQ(getThermostatSetpoint(MODE_HEATING), 44.0f);
+    EXPECT_FLOAT_EQ(getThermostatSetpoint(MODE_COOLING), 12.0f);
+
+    char buf[CONTROL_JSON_MAX];
+    run(THERMO_PERIOD_MS);
+    formatControlJson(getControlStatus(), buf, sizeof(buf));
+    EXPECT_NE(strstr(buf, "\"setpoint\":44.0,\"demand\":"), nullptr) << buf;
+}
+
+TEST_F(ThermostatTest, WithoutSetpointCompressorFollowsMode) {
+    plant = thermalInit(50.0f, 15.0f, 0.0f);
+    start(MODE_HEATING, 45.0f);
+    run(HOURS(0.5));
+    EXPECT_FALSE(compressorOn());   // Tank above the setpoint
+
+    ASSERT_EQ(command(CTRL_CMD_SET_SETPOINT, MODE_HEATING, NAN), CMD_SUCCESS);
+    run(THERMO_PERIOD_MS);
+    EXPECT_TRUE(compressorOn());
+    EXPECT_TRUE(isnan(getControlStatus().demand));
+    EXPECT_FALSE(getThermostatStatus().active);
+}
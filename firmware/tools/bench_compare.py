@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Micro-benchmark Comparison
+==========================
+
+Compares two runs of the firmware micro-benchmark suite and flags cases
+that got slower by more than a threshold. Exits with status 1 if any did,
+so it can gate a CI job.
+
+Either input may be the JSON written by `bench_firmware --json` or a raw
+serial capture from a BENCH_BUILD device; in a capture, the line starting
+with {"suite": is used.
+
+Usage:
+    python bench_compare.py baseline.json current.json
+    python bench_compare.py base.json new.json --threshold 5 --metric min_ns
+    python bench_compare.py esp32_before.log esp32_after.log
+"""
+
+import argparse
+import json
+import sys
+
+METRICS = ("min_ns", "median_ns", "mean_ns", "p90_ns")
+
+
+def load_run(path: str) -> dict:
+    """Read a results document from a JSON file or a serial capture."""
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        text = f.read()
+
+    try:
+        return json.loads(text)
+    except json.JSONDecodeError:
+        pass
+
+    run = None
+    for line in text.splitlines():
+        line = line.strip()
+        if line.startswith('{"suite":'):
+            run = json.loads(line)  # Last run in the capture wins
+    if run is None:
+        raise ValueError(f"{path}: no benchmark results found")
+    return run
+
+
+def compare(base: dict, cur: dict, metric: str, threshold: float):
+    """Yield (name, base_value, cur_value, change_pct, verdict) per case."""
+    base_cases = {r["name"]: r for r in base["results"]}
+    cur_cases = {r["name"]: r for r in cur["results"]}
+
+    for name in list(base_cases) + [n for n in cur_cases if n not in base_cases]:
+        b = base_cases.get(name)
+        c = cur_cases.get(name)
+        if b is None:
+            yield name, None, c[metric], None, "new"
+            continue
+        if c is None:
+            yield name, b[metric], None, None, "missing"
+            continue
+
+        change = (c[metric] - b[metric]) / b[metric] * 100.0 if b[metric] > 0 else 0.0
+        # A change inside the combined sample spread is not significant
+        noise = (b.get("stddev_ns", 0) + c.get("stddev_ns", 0)) / b[metric] * 100.0 if b[metric] > 0 else 0.0
+        if change > threshold and change > noise:
+            verdict = "REGRESSION"
+        elif change < -threshold:
+            verdict = "improved"
+        else:
+            verdict = "ok"
+        yield name, b[metric], c[metric], change, verdict
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Compare two micro-benchmark runs")
+    parser.add_argument("baseline", help="Baseline results (JSON or serial capture)")
+    parser.add_argument("current", help="Current results (JSON or serial capture)")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="Slowdown in percent that counts as a regression (default 10)")
+    parser.add_argument("--metric", choices=METRICS, default="median_ns",
+                        help="Statistic to compare (default median_ns)")
+    args = parser.parse_args()
+
+    try:
+        base = load_run(args.baseline)
+        cur = load_run(args.current)
+    except (OSError, ValueError) as e:
+        print(f"error: {e}", file=sys.stderr)
+        return 2
+
+    if base.get("platform") != cur.get("platform"):
+        print(f"warning: comparing {base.get('platform')} against {cur.get('platform')}",
+              file=sys.stderr)
+
+    print(f"{'case':<20} {'base':>12} {'current':>12} {'change':>9}  verdict")
+    regressions = 0
+    for name, b, c, change, verdict in compare(base, cur, args.metric, args.threshold):
+        b_s = f"{b:.1f}" if b is not None else "-"
+        c_s = f"{c:.1f}" if c is not None else "-"
+        ch_s = f"{change:+.1f}%" if change is not None else "-"
+        print(f"{name:<20} {b_s:>12} {c_s:>12} {ch_s:>9}  {verdict}")
+        if verdict == "REGRESSION":
+            regressions += 1
+
+    if regressions:
+        print(f"\n{regressions} regression(s) beyond {args.threshold:g}% ({args.metric})")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,961 @@
+/**
+ * @file fleet_sim.cpp
+ * @brief Multi-threaded device fleet load generator (host build)
+ *
+ * Simulates thousands of heat pump monitors against a real broker and
+ * backend. Each device builds its telemetry with the firmware's own
+ * buildJsonPayload(), keeps readings in a firmware DataBuffer while its
+ * link is down and drains that backlog MQTT_BACKLOG_GAP_MS apart once
+ * reconnected, as publishBufferedData() does. Devices are spread over
+ * worker threads; each worker drives its sessions from one poll() loop
+ * over non-blocking sockets.
+ *
+ * Measured:
+ *   - publish rate, connect/disconnect counts, backlog depth and overflow
+ *   - broker ack latency (PUBLISH -> PUBACK, QoS 1)
+ *   - end-to-end ingest latency: probe devices tag readings with a marker
+ *     power value and poll GET /api/devices/<id>/readings/latest until the
+ *     backend returns it
+ *
+ * Usage:
+ *   fleet_sim --devices 5000 --interval-ms 10000 --duration-s 600
+ *   fleet_sim --devices 2000 --burst-at-s 60 --burst-s 300 --probes 16
+ *   fleet_sim --outage-mtbf-s 3600 --outage-s 120 --json fleet.json
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer.h"
+#include "latency.h"
+#include "mqtt.h"
+#include "mqtt_wire.h"
+
+// =============================================================================
+// CONSTANTS
+// =============================================================================
+
+#define FLEET_CONNECT_TIMEOUT_US 10000000ULL  ///< TCP connect + CONNACK
+#define FLEET_ACK_TIMEOUT_US     30000000ULL  ///< PUBACK never arrived
+#define FLEET_TX_HIGH_WATER      65536        ///< Unsent bytes before publishes back off
+#define FLEET_POLL_MS            5
+#define FLEET_PROBE_BASE         900000       ///< Marker power values start here
+#define FLEET_PROBE_TIMEOUT_US   30000000ULL
+
+// =============================================================================
+// OPTIONS
+// =============================================================================
+
+struct FleetOptions {
+    std::string host = "localhost";
+    int port = 1883;
+    std::string user = "heatpump";
+    std::string password = "heatpump123";
+    std::string prefix = "sim";
+    int devices = 1000;
+    int threads = 0;                           ///< 0 = hardware concurrency
+    uint32_t intervalMs = MQTT_PUBLISH_INTERVAL;
+    float jitter = 0.1f;                       ///< +- fraction of the interval
+    uint32_t durationS = 60;
+    uint32_t rampPerS = 500;                   ///< Initial connects per second
+    uint32_t retryMs = GPRS_RETRY_INTERVAL;
+    uint32_t drainGapMs = MQTT_BACKLOG_GAP_MS;
+    int qos = 1;
+    uint32_t outageMtbfS = 0;                  ///< Mean time between per-device outages (0 = none)
+    uint32_t outageS = 120;                    ///< Mean per-device outage length
+    int burstAtS = -1;                         ///< Fleet-wide outage start (-1 = none)
+    uint32_t burstS = 0;
+    int probes = 0;                            ///< Devices used for end-to-end probes
+    std::string api = "localhost:8000";
+    uint32_t probePollMs = 100;
+    uint32_t reportS = 5;
+    std::string jsonPath;
+};
+
+static FleetOptions opt;
+static std::atomic<bool> stopping(false);
+static sockaddr_in brokerAddr;
+static uint64_t runStartUs = 0;
+
+static uint64_t nowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// =============================================================================
+// STATISTICS
+// =============================================================================
+
+/**
+ * @brief Latency histogram using the firmware's log-linear buckets
+ */
+struct Histogram {
+    std::atomic<uint32_t> buckets[LAT_BUCKETS];
+
+    Histogram() {
+        for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+    }
+    void record(uint64_t us) {
+        uint32_t v = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+        buckets[latencyBucket(v)].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Merged bucket counts, for percentiles over any time window
+ */
+struct HistSnapshot {
+    uint64_t buckets[LAT_BUCKETS] = {};
+    uint64_t total = 0;
+
+    void add(const Histogram& h) {
+        for (int i = 0; i < LAT_BUCKETS; i++) {
+            uint32_t n = h.buckets[i].load(std::memory_order_relaxed);
+            buckets[i] += n;
+            total += n;
+        }
+    }
+    HistSnapshot minus(const HistSnapshot& prev) const {
+        HistSnapshot d;
+        for (int i = 0; i < LAT_BUCKETS; i++) {
+            d.buckets[i] = buckets[i] - prev.buckets[i];
+            d.total += d.buckets[i];
+        }
+        return d;
+    }
+    /** @brief Upper bound of the bucket holding the percentile, in ms */
+    float percentileMs(float pct) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t)ceil(total * pct / 100.0);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < LAT_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                uint32_t high = i + 1 < LAT_BUCKETS ? latencyBucketLow(i + 1) - 1 : UINT32_MAX;
+                return high / 1000.0f;
+            }
+        }
+        return 0;
+    }
+};
+
+struct FleetCounters {
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> acked{0};
+    std::atomic<uint64_t> ackTimeouts{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> connects{0};
+    std::atomic<uint64_t> connectFails{0};
+    std::atomic<uint64_t> linkDrops{0};
+    std::atomic<uint64_t> buffered{0};     ///< Readings that went to the backlog
+    std::atomic<uint64_t> overflowed{0};   ///< Backlog readings overwritten (lost)
+    std::atomic<int64_t> online{0};
+    std::atomic<int64_t> backlog{0};       ///< Readings waiting across the fleet
+    Histogram ack;
+    Histogram connect;
+    Histogram e2e;
+    std::atomic<uint64_t> probesLost{0};
+};
+
+static FleetCounters stats;
+
+// =============================================================================
+// END-TO-END PROBES
+// =============================================================================
+
+struct ProbeRequest {
+    std::string deviceId;
+    int device;
+    uint32_t marker;
+    uint64_t publishedUs;
+};
+
+static std::mutex probeMutex;
+static std::deque<ProbeRequest> probeQueue;
+static std::unique_ptr<std::atomic<bool>[]> probePending;
+
+/**
+ * @brief GET the latest reading for a device and extract its power field
+ * @return false if the request failed or had no power value
+ */
+static bool fetchLatestPower(const std::string& deviceId, double& power) {
+    std::string host = opt.api;
+    std::string port = "80";
+    size_t colon = host.rfind(':');
+    if (colon != std::string::npos) {
+        port = host.substr(colon + 1);
+        host = host.substr(0, colon);
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return false;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    bool ok = false;
+    if (fd >= 0) {
+        timeval tv = {2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        if (connect(fd, res->ai_addr, res->ai_addrlen) == 0) {
+            char req[256];
+            int n = snprintf(req, sizeof(req),
+                             "GET /api/devices/%s/readings/latest HTTP/1.1\r\n"
+                             "Host: %s\r\nConnection: close\r\n\r\n",
+                             deviceId.c_str(), host.c_str());
+            if (send(fd, req, n, MSG_NOSIGNAL) == n) {
+                std::string resp;
+                char buf[2048];
+                ssize_t r;
+                while ((r = recv(fd, buf, sizeof(buf), 0)) > 0) resp.append(buf, r);
+                size_t p = resp.find("\"power\":");
+                if (resp.compare(0, 12, "HTTP/1.1 200") == 0 && p != std::string::npos) {
+                    power = strtod(resp.c_str() + p + 8, nullptr);
+                    ok = true;
+                }
+            }
+        }
+        close(fd);
+    }
+    freeaddrinfo(res);
+    return ok;
+}
+
+static void probeThread() {
+    std::vector<ProbeRequest> waiting;
+    while (!stopping.load()) {
+        {
+            std::lock_guard<std::mutex> lock(probeMutex);
+            while (!probeQueue.empty()) {
+                waiting.push_back(probeQueue.front());
+                probeQueue.pop_front();
+            }
+        }
+
+        uint64_t now = nowUs();
+        for (size_t i = 0; i < waiting.size();) {
+            ProbeRequest& p = waiting[i];
+            double power = 0;
+            bool done = false;
+            if (fetchLatestPower(p.deviceId, power) && fabs(power - p.marker) < 0.5) {
+                stats.e2e.record(nowUs() - p.publishedUs);
+                done = true;
+            } else if (now - p.publishedUs > FLEET_PROBE_TIMEOUT_US) {
+                stats.probesLost++;
+                done = true;
+            }
+            if (done) {
+                probePending[p.device].store(false);
+                waiting[i] = waiting.back();
+                waiting.pop_back();
+            } else {
+                i++;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(opt.probePollMs));
+    }
+}
+
+// =============================================================================
+// DEVICE
+// =============================================================================
+
+enum DeviceState {
+    DEV_OFFLINE,
+    DEV_CONNECTING,     ///< TCP connect in progress
+    DEV_WAIT_CONNACK,
+    DEV_ONLINE
+};
+
+struct Device {
+    int index;
+    std::string id;
+    std::string topicData;
+    std::string topicStatus;
+    DeviceState state = DEV_OFFLINE;
+    int fd = -1;
+    std::vector<uint8_t> tx;
+    size_t txPos = 0;
+    std::vector<uint8_t> rx;
+    std::unique_ptr<DataBuffer> backlog;
+    std::vector<std::pair<uint16_t, uint64_t>> inflight;  ///< QoS 1 id, sent at
+    uint16_t nextPacketId = 1;
+    uint64_t bootUs = 0;
+    uint64_t stateSinceUs = 0;
+    uint64_t nextReadingUs = 0;
+    uint64_t nextRetryUs = 0;
+    uint64_t nextDrainUs = 0;
+    uint64_t nextOutageUs = UINT64_MAX;
+    uint64_t outageUntilUs = 0;
+    uint64_t lastTxUs = 0;
+    std::mt19937 rng;
+};
+
+static float uniform(Device& d, float lo, float hi) {
+    return std::uniform_real_distribution<float>(lo, hi)(d.rng);
+}
+
+static uint64_t expUs(Device& d, uint32_t meanS) {
+    return (uint64_t)(std::exponential_distribution<double>(1.0 / meanS)(d.rng) * 1e6);
+}
+
+static bool inBurst(uint64_t now) {
+    if (opt.burstAtS < 0) return false;
+    uint64_t start = runStartUs + (uint64_t)opt.burstAtS * 1000000ULL;
+    return now >= start && now < start + (uint64_t)opt.burstS * 1000000ULL;
+}
+
+/**
+ * @brief A plausible reading around the simulate_device.py baseline
+ */
+static SystemData makeReading(Device& d, uint64_t now) {
+    SystemData s;
+    s.readingTime = (unsigned long)((now - d.bootUs) / 1000);
+    s.tempInlet.value = 45.0f + uniform(d, -2, 2);
+    s.tempOutlet.value = 50.0f + uniform(d, -2, 2);
+    s.tempAmbient.value = 25.0f + uniform(d, -3, 3);
+    s.tempCompressor.value = 70.0f + uniform(d, -5, 5);
+    s.voltage.value = 230.0f + uniform(d, -5, 5);
+    s.current.value = 8.5f + uniform(d, -1, 1);
+    s.power = s.voltage.value * s.current.value;
+    s.pressureHigh.value = 280.0f + uniform(d, -10, 10);
+    s.pressureLow.value = 70.0f + uniform(d, -5, 5);
+    s.compressorRunning = true;
+    s.fanRunning = true;
+    SensorReading* all[] = {&s.tempInlet, &s.tempOutlet, &s.tempAmbient, &s.tempCompressor,
+                            &s.voltage, &s.current, &s.pressureHigh, &s.pressureLow};
+    for (SensorReading* r : all) {
+        r->valid = true;
+        r->timestamp = s.readingTime;
+    }
+    return s;
+}
+
+static void closeLink(Device& d, uint64_t now) {
+    if (d.fd >= 0) close(d.fd);
+    if (d.state == DEV_ONLINE) stats.online--;
+    d.fd = -1;
+    d.state = DEV_OFFLINE;
+    d.tx.clear();
+    d.txPos = 0;
+    d.rx.clear();
+    d.inflight.clear();
+    // The device notices on its next retry tick
+    d.nextRetryUs = now + (uint64_t)(uniform(d, 0.0f, 1.0f) * opt.retryMs * 1000.0f);
+}
+
+static void flushTx(Device& d, uint64_t now) {
+    while (d.txPos < d.tx.size()) {
+        ssize_t n = send(d.fd, d.tx.data() + d.txPos, d.tx.size() - d.txPos, MSG_NOSIGNAL);
+        if (n > 0) {
+            d.txPos += n;
+            d.lastTxUs = now;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            stats.linkDrops++;
+            closeLink(d, now);
+            return;
+        }
+    }
+    d.tx.clear();
+    d.txPos = 0;
+}
+
+static void sendConnect(Device& d, uint64_t now) {
+    MqttConnectOptions c = {};
+    c.clientId = d.id.c_str();
+    c.user = opt.user.empty() ? nullptr : opt.user.c_str();
+    c.password = opt.password.empty() ? nullptr : opt.password.c_str();
+    c.willTopic = d.topicStatus.c_str();
+    c.willMessage = "false";
+    c.willQos = 1;
+    c.willRetain = true;
+    c.keepAliveS = MQTT_KEEPALIVE_S;
+    mqttAppendConnect(d.tx, c);
+    d.state = DEV_WAIT_CONNACK;
+    flushTx(d, now);
+}
+
+static void startConnect(Device& d, uint64_t now) {
+    d.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (d.fd < 0) {
+        stats.connectFails++;
+        d.nextRetryUs = now + opt.retryMs * 1000ULL;
+        return;
+    }
+    fcntl(d.fd, F_SETFL, fcntl(d.fd, F_GETFL) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(d.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    d.stateSinceUs = now;
+    if (connect(d.fd, (sockaddr*)&brokerAddr, sizeof(brokerAddr)) == 0) {
+        sendConnect(d, now);
+    } else if (errno == EINPROGRESS) {
+        d.state = DEV_CONNECTING;
+    } else {
+        stats.connectFails++;
+        closeLink(d, now);
+        d.nextRetryUs = now + opt.retryMs * 1000ULL;
+    }
+}
+
+/**
+ * @brief Queue one reading as a PUBLISH (QoS per options)
+ * @return false if the socket is too far behind to take it
+ */
+static bool publishReading(Device& d, SystemData data, uint64_t now) {
+    if (d.tx.size() - d.txPos > FLEET_TX_HIGH_WATER) return false;
+
+    bool probe = d.index < opt.probes && !probePending[d.index].load();
+    uint32_t marker = 0;
+    if (probe) {
+        marker = FLEET_PROBE_BASE + (uint32_t)(d.rng() % 100000);
+        data.power = (float)marker;
+    }
+
+    char payload[JSON_BUFFER_SIZE];
+    size_t len = buildJsonPayload(data, payload, sizeof(payload));
+    uint16_t pid = 0;
+    if (opt.qos > 0) {
+        pid = d.nextPacketId++;
+        if (d.nextPacketId == 0) d.nextPacketId = 1;
+        d.inflight.emplace_back(pid, now);
+    }
+    mqttAppendPublish(d.tx, d.topicData.c_str(), (const uint8_t*)payload, len,
+                      (uint8_t)opt.qos, pid, false);
+    stats.published++;
+    stats.bytes += len;
+
+    if (probe) {
+        probePending[d.index].store(true);
+        std::lock_guard<std::mutex> lock(probeMutex);
+        probeQueue.push_back({d.id, d.index, marker, now});
+    }
+    flushTx(d, now);
+    return true;
+}
+
+static void onConnected(Device& d, uint64_t now) {
+    d.state = DEV_ONLINE;
+    stats.online++;
+    stats.connects++;
+    stats.connect.record(now - d.stateSinceUs);
+    d.nextDrainUs = now;
+
+    // As publishStatus(true)
+    static const char online[] = "true";
+    mqttAppendPublish(d.tx, d.topicStatus.c_str(), (const uint8_t*)online, 4, 0, 0, true);
+    flushTx(d, now);
+}
+
+static void handlePackets(Device& d, uint64_t now) {
+    size_t pos = 0;
+    MqttPacket pkt;
+    int r;
+    while ((r = mqttNextPacket(d.rx.data() + pos, d.rx.size() - pos, pkt)) == 1) {
+        pos += pkt.length;
+        if (pkt.type == MQTT_PKT_CONNACK && d.state == DEV_WAIT_CONNACK) {
+            if (pkt.returnCode == 0) {
+                onConnected(d, now);
+            } else {
+                stats.connectFails++;
+                closeLink(d, now);
+                d.nextRetryUs = now + opt.retryMs * 1000ULL;
+                return;
+            }
+        } else if (pkt.type == MQTT_PKT_PUBACK) {
+            for (size_t i = 0; i < d.inflight.size(); i++) {
+                if (d.inflight[i].first == pkt.packetId) {
+                    stats.ack.record(now - d.inflight[i].second);
+                    stats.acked++;
+                    d.inflight.erase(d.inflight.begin() + i);
+                    break;
+                }
+            }
+        }
+        if (d.fd < 0) return;
+    }
+    if (r < 0) {
+        stats.linkDrops++;
+        closeLink(d, now);
+        return;
+    }
+    d.rx.erase(d.rx.begin(), d.rx.begin() + pos);
+}
+
+static void handleIo(Device& d, short revents, uint64_t now) {
+    if (d.state == DEV_CONNECTING && (revents & (POLLOUT | POLLERR | POLLHUP))) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(d.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            stats.connectFails++;
+            closeLink(d, now);
+            d.nextRetryUs = now + opt.retryMs * 1000ULL;
+            return;
+        }
+        sendConnect(d, now);
+        return;
+    }
+
+    if (revents & POLLIN) {
+        uint8_t buf[4096];
+        ssize_t n = recv(d.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            d.rx.insert(d.rx.end(), buf, buf + n);
+            handlePackets(d, now);
+        } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            stats.linkDrops++;
+            closeLink(d, now);
+            return;
+        }
+    } else if (revents & (POLLERR | POLLHUP)) {
+        stats.linkDrops++;
+        closeLink(d, now);
+        return;
+    }
+
+    if (d.fd >= 0 && (revents & POLLOUT)) flushTx(d, now);
+}
+
+/**
+ * @brief Timers: outages, readings, backlog drain, keepalive, timeouts
+ */
+static void serviceDevice(Device& d, uint64_t now) {
+    // ---- Link outages ----
+    if (now >= d.nextOutageUs) {
+        d.outageUntilUs = now + expUs(d, opt.outageS);
+        d.nextOutageUs = d.outageUntilUs + expUs(d, opt.outageMtbfS);
+    }
+    bool linkUp = now >= d.outageUntilUs && !inBurst(now);
+    if (!linkUp && d.fd >= 0) {
+        stats.linkDrops++;
+        closeLink(d, now);
+    }
+
+    // ---- Reconnect on the retry tick ----
+    if (d.state == DEV_OFFLINE && now >= d.nextRetryUs) {
+        if (linkUp) {
+            startConnect(d, now);
+        } else {
+            d.nextRetryUs = now + opt.retryMs * 1000ULL;
+        }
+    }
+    if ((d.state == DEV_CONNECTING || d.state == DEV_WAIT_CONNACK) &&
+        now - d.stateSinceUs > FLEET_CONNECT_TIMEOUT_US) {
+        stats.connectFails++;
+        closeLink(d, now);
+        d.nextRetryUs = now + opt.retryMs * 1000ULL;
+    }
+
+    // ---- Sensor reading: publish now, or keep for later ----
+    if (now >= d.nextReadingUs) {
+        d.nextReadingUs += (uint64_t)(opt.intervalMs * 1000.0f * uniform(d, 1 - opt.jitter, 1 + opt.jitter));
+        SystemData s = makeReading(d, now);
+        bool sent = d.state == DEV_ONLINE && d.backlog->count == 0 && publishReading(d, s, now);
+        if (!sent) {
+            stats.buffered++;
+            if (bufferPush(*d.backlog, s)) {
+                stats.backlog++;
+            } else {
+                stats.overflowed++;
+            }
+        }
+    }
+
+    if (d.state != DEV_ONLINE) return;
+
+    // ---- Backlog drain, oldest first ----
+    if (d.backlog->count > 0 && now >= d.nextDrainUs) {
+        if (publishReading(d, *bufferPeek(*d.backlog), now)) {
+            bufferPop(*d.backlog);
+            stats.backlog--;
+        }
+        d.nextDrainUs = now + opt.drainGapMs * 1000ULL;
+    }
+    if (d.fd < 0) return;
+
+    // ---- Keepalive and lost acks ----
+    if (now - d.lastTxUs > MQTT_KEEPALIVE_S * 500000ULL) {
+        mqttAppendPingreq(d.tx);
+        flushTx(d, now);
+    }
+    while (!d.inflight.empty() && now - d.inflight.front().second > FLEET_ACK_TIMEOUT_US) {
+        stats.ackTimeouts++;
+        d.inflight.erase(d.inflight.begin());
+    }
+}
+
+// =============================================================================
+// WORKER
+// =============================================================================
+
+static void workerThread(std::vector<Device*> devices) {
+    std::vector<pollfd> fds;
+    std::vector<Device*> owners;
+
+    while (!stopping.load()) {
+        uint64_t now = nowUs();
+        for (Device* d : devices) serviceDevice(*d, now);
+
+        fds.clear();
+        owners.clear();
+        for (Device* d : devices) {
+            if (d->fd < 0) continue;
+            short ev = POLLIN;
+            if (d->state == DEV_CONNECTING || d->txPos < d->tx.size()) ev |= POLLOUT;
+            fds.push_back({d->fd, ev, 0});
+            owners.push_back(d);
+        }
+        if (fds.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLEET_POLL_MS));
+            continue;
+        }
+        if (poll(fds.data(), fds.size(), FLEET_POLL_MS) <= 0) continue;
+
+        now = nowUs();
+        for (size_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents) handleIo(*owners[i], fds[i].revents, now);
+        }
+    }
+
+    // Clean shutdown: the broker publishes no will
+    uint64_t now = nowUs();
+    for (Device* d : devices) {
+        if (d->state == DEV_ONLINE) {
+            mqttAppendDisconnect(d->tx);
+            flushTx(*d, now);
+        }
+        if (d->fd >= 0) closeLink(*d, now);
+    }
+}
+
+// =============================================================================
+// REPORTING
+// =============================================================================
+
+struct IntervalReport {
+    uint32_t t;
+    int64_t online;
+    int64_t backlog;
+    float publishRate;
+    float ackRate;
+    float ackP50, ackP95, ackP99;
+    float e2eP50, e2eP99;
+};
+
+static void snapshot(const Histogram& h, HistSnapshot& out) {
+    out = HistSnapshot();
+    out.add(h);
+}
+
+static void printJsonPercentiles(FILE* f, const char* name, const HistSnapshot& h) {
+    fprintf(f, "\"%s\":{\"count\":%llu,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"p999\":%.3f}",
+            name, (unsigned long long)h.total, h.percentileMs(50), h.percentileMs(95),
+            h.percentileMs(99), h.percentileMs(99.9f));
+}
+
+static void writeJson(const std::vector<IntervalReport>& intervals, double elapsedS) {
+    FILE* f = fopen(opt.jsonPath.c_str(), "w");
+    if (f == nullptr) {
+        perror(opt.jsonPath.c_str());
+        return;
+    }
+    HistSnapshot ack, conn, e2e;
+    snapshot(stats.ack, ack);
+    snapshot(stats.connect, conn);
+    snapshot(stats.e2e, e2e);
+
+    fprintf(f, "{\"devices\":%d,\"threads\":%d,\"interval_ms\":%u,\"qos\":%d,\"elapsed_s\":%.1f,",
+            opt.devices, opt.threads, opt.intervalMs, opt.qos, elapsedS);
+    fprintf(f, "\"published\":%llu,\"acked\":%llu,\"ack_timeouts\":%llu,\"bytes\":%llu,"
+               "\"publish_rate\":%.1f,\"connects\":%llu,\"connect_failures\":%llu,"
+               "\"link_drops\":%llu,\"buffered\":%llu,\"overflowed\":%llu,\"probes_lost\":%llu,",
+            (unsigned long long)stats.published, (unsigned long long)stats.acked,
+            (unsigned long long)stats.ackTimeouts, (unsigned long long)stats.bytes,
+            stats.published / elapsedS, (unsigned long long)stats.connects,
+            (unsigned long long)stats.connectFails, (unsigned long long)stats.linkDrops,
+            (unsigned long long)stats.buffered, (unsigned long long)stats.overflowed,
+            (unsigned long long)stats.probesLost);
+    printJsonPercentiles(f, "ack_ms", ack);
+    fputc(',', f);
+    printJsonPercentiles(f, "connect_ms", conn);
+    fputc(',', f);
+    printJsonPercentiles(f, "e2e_ms", e2e);
+    fprintf(f, ",\"intervals\":[");
+    for (size_t i = 0; i < intervals.size(); i++) {
+        const IntervalReport& r = intervals[i];
+        fprintf(f, "%s{\"t\":%u,\"online\":%lld,\"backlog\":%lld,\"publish_rate\":%.1f,"
+                   "\"ack_rate\":%.1f,\"ack_p50\":%.3f,\"ack_p95\":%.3f,\"ack_p99\":%.3f,"
+                   "\"e2e_p50\":%.3f,\"e2e_p99\":%.3f}",
+                i ? "," : "", r.t, (long long)r.online, (long long)r.backlog, r.publishRate,
+                r.ackRate, r.ackP50, r.ackP95, r.ackP99, r.e2eP50, r.e2eP99);
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+}
+
+// =============================================================================
+// SETUP
+// =============================================================================
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --host H --port P --user U --password P   broker (localhost:1883, heatpump)\n"
+        "  --devices N          simulated devices (1000)\n"
+        "  --threads N          worker threads (hardware concurrency)\n"
+        "  --prefix S           device id prefix (sim -> sim00000)\n"
+        "  --interval-ms N      reading/publish interval (MQTT_PUBLISH_INTERVAL)\n"
+        "  --jitter F           interval jitter fraction (0.1)\n"
+        "  --duration-s N       run time (60)\n"
+        "  --ramp N             initial connects per second (500)\n"
+        "  --retry-ms N         reconnect tick (GPRS_RETRY_INTERVAL)\n"
+        "  --drain-gap-ms N     gap between backlog publishes (MQTT_BACKLOG_GAP_MS)\n"
+        "  --qos 0|1            telemetry QoS; ack latency needs 1 (1)\n"
+        "  --outage-mtbf-s N    mean time between per-device outages (0 = off)\n"
+        "  --outage-s N         mean per-device outage length (120)\n"
+        "  --burst-at-s N --burst-s N   fleet-wide outage window\n"
+        "  --probes N           devices tagged for end-to-end latency (0)\n"
+        "  --api HOST:PORT      backend for probes (localhost:8000)\n"
+        "  --report-s N         progress interval (5)\n"
+        "  --json FILE          write a summary for later comparison\n",
+        argv0);
+}
+
+static bool parseArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return false;
+        }
+        const char* v = argv[++i];
+        if (a == "--host") opt.host = v;
+        else if (a == "--port") opt.port = atoi(v);
+        else if (a == "--user") opt.user = v;
+        else if (a == "--password") opt.password = v;
+        else if (a == "--prefix") opt.prefix = v;
+        else if (a == "--devices") opt.devices = atoi(v);
+        else if (a == "--threads") opt.threads = atoi(v);
+        else if (a == "--interval-ms") opt.intervalMs = strtoul(v, nullptr, 10);
+        else if (a == "--jitter") opt.jitter = strtof(v, nullptr);
+        else if (a == "--duration-s") opt.durationS = strtoul(v, nullptr, 10);
+        else if (a == "--ramp") opt.rampPerS = strtoul(v, nullptr, 10);
+        else if (a == "--retry-ms") opt.retryMs = strtoul(v, nullptr, 10);
+        else if (a == "--drain-gap-ms") opt.drainGapMs = strtoul(v, nullptr, 10);
+        else if (a == "--qos") opt.qos = atoi(v) ? 1 : 0;
+        else if (a == "--outage-mtbf-s") opt.outageMtbfS = strtoul(v, nullptr, 10);
+        else if (a == "--outage-s") opt.outageS = strtoul(v, nullptr, 10);
+        else if (a == "--burst-at-s") opt.burstAtS = atoi(v);
+        else if (a == "--burst-s") opt.burstS = strtoul(v, nullptr, 10);
+        else if (a == "--probes") opt.probes = atoi(v);
+        else if (a == "--api") opt.api = v;
+        else if (a == "--report-s") opt.reportS = strtoul(v, nullptr, 10);
+        else if (a == "--json") opt.jsonPath = v;
+        else {
+            usage(argv[0]);
+            return false;
+        }
+    }
+    if (opt.devices <= 0 || opt.intervalMs == 0 || opt.rampPerS == 0 || opt.reportS == 0) {
+        usage(argv[0]);
+        return false;
+    }
+    if (opt.threads <= 0) opt.threads = std::max(1u, std::thread::hardware_concurrency());
+    if (opt.threads > opt.devices) opt.threads = opt.devices;
+    if (opt.probes > opt.devices) opt.probes = opt.devices;
+    return true;
+}
+
+static bool resolveBroker() {
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(opt.host.c_str(), nullptr, &hints, &res) != 0 || res == nullptr) {
+        fprintf(stderr, "[FLEET] Cannot resolve %s\n", opt.host.c_str());
+        return false;
+    }
+    brokerAddr = *(sockaddr_in*)res->ai_addr;
+    brokerAddr.sin_port = htons(opt.port);
+    freeaddrinfo(res);
+    return true;
+}
+
+/**
+ * @brief Each session is one descriptor; the default soft limit is often 1024
+ */
+static void raiseFileLimit() {
+    rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) return;
+    rlim_t want = (rlim_t)opt.devices + 64;
+    if (rl.rlim_cur < want) {
+        rl.rlim_cur = std::min(want, rl.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &rl);
+        getrlimit(RLIMIT_NOFILE, &rl);
+    }
+    if (rl.rlim_cur < want) {
+        fprintf(stderr, "[FLEET] Warning: open file limit %llu < %llu devices\n",
+                (unsigned long long)rl.rlim_cur, (unsigned long long)opt.devices);
+    }
+}
+
+static void onSignal(int) {
+    stopping.store(true);
+}
+
+int main(int argc, char** argv) {
+    if (!parseArgs(argc, argv) || !resolveBroker()) return 2;
+    raiseFileLimit();
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    runStartUs = nowUs();
+    probePending.reset(new std::atomic<bool>[opt.devices]);
+
+    std::vector<std::unique_ptr<Device>> fleet;
+    fleet.reserve(opt.devices);
+    for (int i = 0; i < opt.devices; i++) {
+        std::unique_ptr<Device> d(new Device());
+        char id[48];
+        snprintf(id, sizeof(id), "%s%05d", opt.prefix.c_str(), i);
+        d->index = i;
+        d->id = id;
+        d->topicData = std::string("heatpump/") + id + "/data";
+        d->topicStatus = std::string("heatpump/") + id + "/status/online";
+        d->backlog.reset(new DataBuffer());
+        bufferReset(*d->backlog);
+        d->rng.seed(i + 1);
+        d->bootUs = runStartUs;
+        d->nextRetryUs = runStartUs + (uint64_t)i * 1000000ULL / opt.rampPerS;
+        d->nextReadingUs = d->nextRetryUs + (uint64_t)(uniform(*d, 0, 1) * opt.intervalMs * 1000.0f);
+        if (opt.outageMtbfS > 0) d->nextOutageUs = runStartUs + expUs(*d, opt.outageMtbfS);
+        probePending[i].store(false);
+        fleet.push_back(std::move(d));
+    }
+
+    printf("[FLEET] %d devices on %d threads -> %s:%d, every %u ms, QoS %d, %u s\n",
+           opt.devices, opt.threads, opt.host.c_str(), opt.port, opt.intervalMs, opt.qos,
+           opt.durationS);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; t++) {
+        std::vector<Device*> mine;
+        for (int i = t; i < opt.devices; i += opt.threads) mine.push_back(fleet[i].get());
+        workers.emplace_back(workerThread, std::move(mine));
+    }
+    std::thread prober;
+    if (opt.probes > 0) prober = std::thread(probeThread);
+
+    // ---- Progress reports ----
+    std::vector<IntervalReport> intervals;
+    HistSnapshot prevAck, prevE2e;
+    uint64_t prevPublished = 0, prevAcked = 0;
+    uint64_t lastUs = runStartUs;
+    uint64_t endUs = runStartUs + (uint64_t)opt.durationS * 1000000ULL;
+
+    while (!stopping.load() && nowUs() < endUs) {
+        uint64_t next = std::min<uint64_t>(lastUs + opt.reportS * 1000000ULL, endUs);
+        while (!stopping.load() && nowUs() < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        uint64_t now = nowUs();
+        double dt = (now - lastUs) / 1e6;
+        lastUs = now;
+
+        HistSnapshot ack, e2e;
+        snapshot(stats.ack, ack);
+        snapshot(stats.e2e, e2e);
+        HistSnapshot dAck = ack.minus(prevAck);
+        HistSnapshot dE2e = e2e.minus(prevE2e);
+        prevAck = ack;
+        prevE2e = e2e;
+
+        uint64_t published = stats.published.load();
+        uint64_t acked = stats.acked.load();
+        IntervalReport r;
+        r.t = (uint32_t)((now - runStartUs) / 1000000ULL);
+        r.online = stats.online.load();
+        r.backlog = stats.backlog.load();
+        r.publishRate = (published - prevPublished) / dt;
+        r.ackRate = (acked - prevAcked) / dt;
+        r.ackP50 = dAck.percentileMs(50);
+        r.ackP95 = dAck.percentileMs(95);
+        r.ackP99 = dAck.percentileMs(99);
+        r.e2eP50 = dE2e.percentileMs(50);
+        r.e2eP99 = dE2e.percentileMs(99);
+        prevPublished = published;
+        prevAcked = acked;
+        intervals.push_back(r);
+
+        printf("[FLEET] t=%4us online=%lld/%d pub=%.0f/s ack=%.0f/s "
+               "ack p50/p95/p99=%.1f/%.1f/%.1f ms backlog=%lld",
+               r.t, (long long)r.online, opt.devices, r.publishRate, r.ackRate,
+               r.ackP50, r.ackP95, r.ackP99, (long long)r.backlog);
+        if (opt.probes > 0) printf(" e2e p50/p99=%.0f/%.0f ms", r.e2eP50, r.e2eP99);
+        printf("\n");
+        fflush(stdout);
+    }
+
+    stopping.store(true);
+    for (auto& w : workers) w.join();
+    if (prober.joinable()) prober.join();
+
+    double elapsedS = (nowUs() - runStartUs) / 1e6;
+    HistSnapshot ack, conn, e2e;
+    snapshot(stats.ack, ack);
+    snapshot(stats.connect, conn);
+    snapshot(stats.e2e, e2e);
+
+    printf("\n[FLEET] Summary after %.1f s\n", elapsedS);
+    printf("[FLEET]   published %llu (%.1f/s), acked %llu, ack timeouts %llu\n",
+           (unsigned long long)stats.published, stats.published / elapsedS,
+           (unsigned long long)stats.acked, (unsigned long long)stats.ackTimeouts);
+    printf("[FLEET]   connects %llu, connect failures %llu, link drops %llu\n",
+           (unsigned long long)stats.connects, (unsigned long long)stats.connectFails,
+           (unsigned long long)stats.linkDrops);
+    printf("[FLEET]   buffered %llu, overflowed %llu, left in backlog %lld\n",
+           (unsigned long long)stats.buffered, (unsigned long long)stats.overflowed,
+           (long long)stats.backlog.load());
+    printf("[FLEET]   ack     p50/p95/p99/p99.9 = %.1f/%.1f/%.1f/%.1f ms\n",
+           ack.percentileMs(50), ack.percentileMs(95), ack.percentileMs(99), ack.percentileMs(99.9f));
+    printf("[FLEET]   connect p50/p95/p99       = %.1f/%.1f/%.1f ms\n",
+           conn.percentileMs(50), conn.percentileMs(95), conn.percentileMs(99));
+    if (opt.probes > 0) {
+        printf("[FLEET]   e2e     p50/p95/p99       = %.0f/%.0f/%.0f ms (%llu samples, %llu lost)\n",
+               e2e.percentileMs(50), e2e.percentileMs(95), e2e.percentileMs(99),
+               (unsigned long long)e2e.total, (unsigned long long)stats.probesLost);
+    }
+
+    if (!opt.jsonPath.empty()) writeJson(intervals, elapsedS);
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file mqtt_wire.cpp
+ * @brief MQTT 3.1.1 packet encoding/decoding
+ */
+
+#include "mqtt_wire.h"
+#include <string.h>
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static void appendRemainingLength(std::vector<uint8_t>& out, size_t len) {
+    do {
+        uint8_t b = len % 128;
+        len /= 128;
+        if (len > 0) b |= 0x80;
+        out.push_back(b);
+    } while (len > 0);
+}
+
+static void appendU16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(v >> 8);
+    out.push_back(v & 0xFF);
+}
+
+static void appendString(std::vector<uint8_t>& out, const char* s) {
+    size_t n = strlen(s);
+    appendU16(out, (uint16_t)n);
+    out.insert(out.end(), s, s + n);
+}
+
+static size_t stringSize(const char* s) {
+    return 2 + strlen(s);
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void mqttAppendConnect(std::vector<uint8_t>& out, const MqttConnectOptions& opt) {
+    uint8_t flags = 0x02;  // Clean session
+    size_t len = 10 + stringSize(opt.clientId);
+
+    if (opt.willTopic != nullptr) {
+        flags |= 0x04 | (opt.willQos << 3) | (opt.willRetain ? 0x20 : 0);
+        len += stringSize(opt.willTopic) + stringSize(opt.willMessage);
+    }
+    if (opt.user != nullptr) {
+        flags |= 0x80;
+        len += stringSize(opt.user);
+    }
+    if (opt.password != nullptr) {
+        flags |= 0x40;
+        len += stringSize(opt.password);
+    }
+
+    out.push_back(MQTT_PKT_CONNECT << 4);
+    appendRemainingLength(out, len);
+    appendString(out, "MQTT");
+    out.push_back(4);  // Protocol level 3.1.1
+    out.push_back(flags);
+    appendU16(out, opt.keepAliveS);
+    appendString(out, opt.clientId);
+    if (opt.willTopic != nullptr) {
+        appendString(out, opt.willTopic);
+        appendString(out, opt.willMessage);
+    }
+    if (opt.user != nullptr) appendString(out, opt.user);
+    if (opt.password != nullptr) appendString(out, opt.password);
+}
+
+void mqttAppendPublish(std::vector<uint8_t>& out, const char* topic,
+                       const uint8_t* payload, size_t len,
+                       uint8_t qos, uint16_t packetId, bool retain) {
+    out.push_back((MQTT_PKT_PUBLISH << 4) | (qos << 1) | (retain ? 1 : 0));
+    appendRemainingLength(out, stringSize(topic) + (qos > 0 ? 2 : 0) + len);
+    appendString(out, topic);
+    if (qos > 0) appendU16(out, packetId);
+    out.insert(out.end(), payload, payload + len);
+}
+
+void mqttAppendPingreq(std::vector<uint8_t>& out) {
+    out.push_back(MQTT_PKT_PINGREQ << 4);
+    out.push_back(0);
+}
+
+void mqttAppendDisconnect(std::vector<uint8_t>& out) {
+    out.push_back(MQTT_PKT_DISCONNECT << 4);
+    out.push_back(0);
+}
+
+int mqttNextPacket(const uint8_t* buf, size_t len, MqttPacket& pkt) {
+    if (len < 2) return 0;
+
+    // Remaining length: up to 4 bytes, 7 bits each
+    size_t remaining = 0;
+    size_t pos = 1;
+    for (int shift = 0;; shift += 7) {
+        if (pos >= len) return 0;
+        if (shift > 21) return -1;
+        uint8_t b = buf[pos++];
+        remaining |= (size_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+    }
+    if (len < pos + remaining) return 0;
+
+    pkt.type = buf[0] >> 4;
+    pkt.flags = buf[0] & 0x0F;
+    pkt.packetId = 0;
+    pkt.returnCode = 0;
+    pkt.length = pos + remaining;
+
+    const uint8_t* body = buf + pos;
+    switch (pkt.type) {
+        case MQTT_PKT_CONNACK:
+            if (remaining != 2) return -1;
+            pkt.returnCode = body[1];
+            break;
+        case MQTT_PKT_PUBACK:
+        case MQTT_PKT_SUBACK:
+            if (remaining < 2) return -1;
+            pkt.packetId = (uint16_t)(body[0] << 8 | body[1]);
+            break;
+        case MQTT_PKT_PINGRESP:
+        case MQTT_PKT_PUBLISH:
+            break;
+        default:
+            if (pkt.type == 0) return -1;
+            break;
+    }
+    return 1;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file mqtt_wire.h
+ * @brief Minimal MQTT 3.1.1 packet encoder/decoder for the fleet simulator
+ *
+ * Only what a telemetry device uses: CONNECT (with will and credentials),
+ * PUBLISH at QoS 0/1, PUBACK, PINGREQ and DISCONNECT going out;
+ * CONNACK, PUBACK, PINGRESP and SUBACK coming in. No sockets here - the
+ * simulator owns I/O and feeds received bytes to mqttNextPacket().
+ */
+
+#ifndef MQTT_WIRE_H
+#define MQTT_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// =============================================================================
+// PACKET TYPES
+// =============================================================================
+
+enum MqttPacketType : uint8_t {
+    MQTT_PKT_CONNECT = 1,
+    MQTT_PKT_CONNACK = 2,
+    MQTT_PKT_PUBLISH = 3,
+    MQTT_PKT_PUBACK = 4,
+    MQTT_PKT_SUBACK = 9,
+    MQTT_PKT_PINGREQ = 12,
+    MQTT_PKT_PINGRESP = 13,
+    MQTT_PKT_DISCONNECT = 14
+};
+
+/**
+ * @brief CONNECT options (clean session always set)
+ */
+struct MqttConnectOptions {
+    const char* clientId;
+    const char* user;         ///< nullptr for none
+    const char* password;     ///< nullptr for none
+    const char* willTopic;    ///< nullptr for no will
+    const char* willMessage;
+    uint8_t willQos;
+    bool willRetain;
+    uint16_t keepAliveS;
+};
+
+/**
+ * @brief One decoded incoming packet
+ */
+struct MqttPacket {
+    uint8_t type;         ///< MqttPacketType
+    uint8_t flags;        ///< Low nibble of the fixed header
+    uint16_t packetId;    ///< PUBACK / SUBACK
+    uint8_t returnCode;   ///< CONNACK
+    size_t length;        ///< Whole packet, header included
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+void mqttAppendConnect(std::vector<uint8_t>& out, const MqttConnectOptions& opt);
+
+/**
+ * @param packetId Ignored for QoS 0
+ */
+void mqttAppendPublish(std::vector<uint8_t>& out, const char* topic,
+                       const uint8_t* payload, size_t len,
+                       uint8_t qos, uint16_t packetId, bool retain);
+
+void mqttAppendPingreq(std::vector<uint8_t>& out);
+void mqttAppendDisconnect(std::vector<uint8_t>& out);
+
+/**
+ * @brief Decode the packet at the start of buf
+ * @return 1 if pkt was filled, 0 if more bytes are needed, -1 if malformed
+ */
+int mqttNextPacket(const uint8_t* buf, size_t len, MqttPacket& pkt);
+
+#endif // MQTT_WIRE_H
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Tokenized Log Decoder
+=====================
+
+Rebuilds text from LOGT() token frames (firmware built with LOG_TOKENIZED).
+Format strings are read straight from the firmware image: every LOGT format
+is stored in flash prefixed with "\\x1FLF", and its ID is the FNV-1a hash of
+the format text, so no separate string table has to be kept in sync.
+
+Plain text in the stream (Log.print output) is passed through unchanged.
+
+Usage:
+    python log_decode.py firmware.ino.elf capture.bin
+    python log_decode.py firmware.ino.elf --serial /dev/ttyUSB0
+    python log_decode.py firmware.ino.elf --url http://192.168.1.50/api/log
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+import time
+import urllib.request
+
+FRAME_START = 0x1E
+FMT_MARKER = b"\x1fLF"
+TRUNCATED = 0x80  # argc flag: the encoder dropped the trailing arguments
+
+# printf length modifiers Python's % operator does not understand
+_LENGTH_MODS = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)([diouxXc])")
+
+
+def fnv1a(data: bytes) -> int:
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def load_string_table(image_path: str) -> dict:
+    """Scan a firmware .elf/.bin for marker-prefixed format strings."""
+    with open(image_path, "rb") as f:
+        blob = f.read()
+
+    table = {}
+    pos = blob.find(FMT_MARKER)
+    while pos >= 0:
+        start = pos + len(FMT_MARKER)
+        end = blob.find(b"\0", start)
+        if end < 0:
+            break
+        fmt = blob[start:end]
+        table[fnv1a(fmt)] = _LENGTH_MODS.sub(r"%\1\2", fmt.decode("utf-8", "replace"))
+        pos = blob.find(FMT_MARKER, end)
+    return table
+
+
+def _varint(buf: bytes, i: int):
+    v = shift = 0
+    while True:
+        if i >= len(buf):
+            raise IndexError
+        b = buf[i]
+        i += 1
+        v |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return v, i
+
+
+def decode_frame(buf: bytes, i: int, table: dict):
+    """Decode one frame starting after the 0x1E byte. Returns (text, next_i)."""
+    token_id, argc = struct.unpack_from("<IB", buf, i)
+    i += 5
+    truncated = bool(argc & TRUNCATED)
+    argc &= ~TRUNCATED
+    args = []
+    for _ in range(argc):
+        tag = chr(buf[i])
+        i += 1
+        if tag == "i":
+            v, i = _varint(buf, i)
+            args.append((v >> 1) ^ -(v & 1))
+        elif tag == "u":
+            v, i = _varint(buf, i)
+            args.append(v)
+        elif tag == "f":
+            args.append(struct.unpack_from("<f", buf, i)[0])
+            i += 4
+        elif tag == "s":
+            n = buf[i]
+            args.append(buf[i + 1:i + 1 + n].decode("utf-8", "replace"))
+            i += 1 + n
+        else:
+            raise ValueError(f"bad tag {tag!r}")
+
+    fmt = table.get(token_id)
+    if fmt is None:
+        return f"<unknown token 0x{token_id:08x} {args}>\n", i
+    if truncated:
+        return f"<{fmt.strip()!r} {args} truncated>\n", i
+    try:
+        return fmt % tuple(args), i
+    except (TypeError, ValueError):
+        return f"<{fmt.strip()!r} {args}>\n", i
+
+
+class Decoder:
+    """Incremental stream decoder; keeps partial frames between feeds."""
+
+    def __init__(self, table: dict):
+        self.table = table
+        self.pending = b""
+
+    def feed(self, data: bytes) -> str:
+        buf = self.pending + data
+        out = []
+        i = 0
+        while i < len(buf):
+            j = buf.find(bytes([FRAME_START]), i)
+            if j < 0:
+                out.append(buf[i:].decode("utf-8", "replace"))
+                i = len(buf)
+                break
+            out.append(buf[i:j].decode("utf-8", "replace"))
+            try:
+                text, i = decode_frame(buf, j + 1, self.table)
+                out.append(text)
+            except (IndexError, struct.error):
+                break  # Incomplete frame - wait for more bytes
+            except ValueError:
+                i = j + 1  # Corrupt frame - resync on next start byte
+        self.pending = buf[i:]
+        return "".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode tokenized heat pump logs")
+    parser.add_argument("image", help="Firmware .elf or .bin containing the format strings")
+    parser.add_argument("capture", nargs="?", help="Raw capture file (default: stdin)")
+    parser.add_argument("--serial", help="Read live from a serial port (needs pyserial)")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--url", help="Poll a device's /api/log endpoint")
+    args = parser.parse_args()
+
+    table = load_string_table(args.image)
+    print(f"[decode] {len(table)} format strings loaded", file=sys.stderr)
+    dec = Decoder(table)
+
+    if args.serial:
+        import serial
+        port = serial.Serial(args.serial, args.baud)
+        while True:
+            sys.stdout.write(dec.feed(port.read(port.in_waiting or 1)))
+            sys.stdout.flush()
+    elif args.url:
+        pos = 0
+        while True:
+            with urllib.request.urlopen(f"{args.url}?pos={pos}") as r:
+                d = json.load(r)
+            # Each code point of "text" is one raw byte (\u00XX escapes)
+            sys.stdout.write(dec.feed(d["text"].encode("latin-1", "replace")))
+            sys.stdout.flush()
+            pos = d["pos"]
+            time.sleep(2)
+    else:
+        src = open(args.capture, "rb") if args.capture else sys.stdin.buffer
+        sys.stdout.write(dec.feed(src.read()))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,428 @@
+/**
+ * @file device.cpp
+ * @brief One boot of the firmware on the virtual clock
+ *
+ * Mirrors setup(), sensingTask() and networkTask() from firmware.ino with
+ * the same modules, queues and scheduler jobs. The FreeRTOS tasks become
+ * passes of a single loop: the sensing pass runs on its absolute tick
+ * schedule, the network pass after every wake. Between passes the clock
+ * jumps to the earliest of the next reading, the next scheduler release,
+ * the next scenario edge and the next trend sample.
+ *
+ * WiFi, the portal, the dashboard, the supervisor and power management are
+ * not in the host build, so the transport is GPRS only. Passes run back to
+ * back: a long network pass (a backlog flush) delays the next reading,
+ * where on the device the sensing task would preempt it.
+ */
+
+#include "vsim.h"
+#include "plant.h"
+#include <esp_timer.h>
+#include <malloc.h>
+#include "host_hooks.h"
+#include "globals.h"
+#include "alerts.h"
+#include "buffer.h"
+#include "config_store.h"
+#include "events.h"
+#include "gsm.h"
+#include "latency.h"
+#include "memstats.h"
+#include "mqtt.h"
+#include "scheduler.h"
+#include "sensors.h"
+#include "tasks.h"
+
+// =============================================================================
+// PRIVATE DATA
+// =============================================================================
+
+static const SimScenario* scenario = nullptr;
+static SimRun* run = nullptr;
+static SimBootStats* stats = nullptr;
+
+static uint64_t bootWallUs = 0;    ///< Scenario time at power-on
+static uint64_t bootClockUs = 0;   ///< Device clock at power-on
+
+static uint32_t schedMillis() { return millis(); }
+static uint32_t schedMicros() { return micros(); }
+
+static Scheduler netSched("net", schedMillis, schedMicros);
+static uint8_t publishJob = SCHED_INVALID;
+
+static uint32_t lastGPRSAttempt = 0;
+static bool linkUp = true;
+
+static bool haveTimestamp = false;
+static uint32_t lastTimestamp = 0;
+static uint64_t lastSenseWallUs = 0;
+static uint64_t lastPublishWallUs = 0;
+static bool lastCriticalSeen[ALERT_TYPE_COUNT];
+static uint64_t lastCriticalWallUs[ALERT_TYPE_COUNT];
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+static uint64_t clockUs() {
+    return (uint64_t)esp_timer_get_time();
+}
+
+static uint64_t wallNowUs() {
+    return bootWallUs + (clockUs() - bootClockUs);
+}
+
+static bool inWindow(const SimWindow* w, uint8_t n, uint64_t t) {
+    for (uint8_t i = 0; i < n; i++) {
+        if (t >= w[i].startUs && t < w[i].endUs) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief First window start or end after t (UINT64_MAX if none)
+ */
+static uint64_t nextEdge(const SimWindow* w, uint8_t n, uint64_t t) {
+    uint64_t next = UINT64_MAX;
+    for (uint8_t i = 0; i < n; i++) {
+        if (w[i].startUs > t) next = std::min(next, w[i].startUs);
+        if (w[i].endUs > t) next = std::min(next, w[i].endUs);
+    }
+    return next;
+}
+
+static uint32_t heapInUse() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return (uint32_t)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (uint32_t)mallinfo().uordblks;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Cellular coverage: the modem loses its network and the broker
+ * session drops
+ */
+static void setLink(bool up) {
+    linkUp = up;
+    modem.networkConnected = up;
+    modem.smsOk = up;
+    mqtt.setConnectResult(up);
+    if (!up) {
+        modem.gprsConnected = false;
+        if (mqtt.connected()) mqtt.dropConnection();
+    }
+}
+
+static void takeSample() {
+    if (run->sampleCount >= VSIM_MAX_SAMPLES) return;
+
+    SimSample& s = run->samples[run->sampleCount++];
+    s.wallUs = wallNowUs();
+    s.boot = run->boots - 1;
+    s.uptimeMs = millis();
+    s.buffered = bufferCount();
+    s.heapBytes = heapInUse();
+    s.logBytes = (uint32_t)Log.getHead();
+    s.eventDrops = getEventDrops();
+    s.publishMisses = netSched.job(publishJob).misses;
+    s.online = mqtt.connected();
+}
+
+// =============================================================================
+// OBSERVERS
+// =============================================================================
+
+/**
+ * @brief Critical alert SMS that went out must be a cooldown apart
+ *
+ * Measured on sends rather than EVT_ALERT: an SMS that fails (no
+ * coverage) is retried at every check until one is sent.
+ */
+static void onAlertSmsSent(uint8_t type) {
+    uint64_t wall = wallNowUs();
+    run->criticalSms++;
+
+    if (lastCriticalSeen[type]) {
+        int64_t gapMs = (int64_t)(wall - lastCriticalWallUs[type]) / 1000;
+        if (run->minReminderGapMs < 0 || gapMs < run->minReminderGapMs) {
+            run->minReminderGapMs = gapMs;
+        }
+        if (gapMs < (int64_t)runtimeCfg.alertCooldown) {
+            run->cooldownViolations++;
+        }
+    }
+    lastCriticalSeen[type] = true;
+    lastCriticalWallUs[type] = wall;
+}
+
+/**
+ * @brief Account for /data messages; timestamps must keep increasing
+ * (wrap-aware, as the backend would order them)
+ */
+static void collectPublished() {
+    for (const HostMqttMessage& m : mqtt.published()) {
+        size_t n = m.topic.size();
+        if (n < 5 || m.topic.compare(n - 5, 5, "/data") != 0) continue;
+
+        const char* p = strstr(m.payload.c_str(), "\"timestamp\":");
+        uint32_t ts = p ? (uint32_t)strtoul(p + 12, nullptr, 10) : 0;
+        if (haveTimestamp && (int32_t)(ts - lastTimestamp) <= 0) {
+            stats->outOfOrder++;
+        }
+        haveTimestamp = true;
+        lastTimestamp = ts;
+
+        stats->published++;
+        if (stats->firstPublishMs < 0) {
+            stats->firstPublishMs = (int64_t)(clockUs() - bootClockUs) / 1000;
+        }
+    }
+    mqtt.clearPublished();
+}
+
+/**
+ * @brief Time from the end of each outage until the backlog is flushed
+ */
+static void checkRecovery() {
+    uint64_t wall = wallNowUs();
+    for (uint8_t i = 0; i < scenario->outageCount; i++) {
+        if (run->recoveryMs[i] >= 0 || wall < scenario->outages[i].endUs) continue;
+        if (mqtt.connected() && bufferCount() == 0) {
+            run->recoveryMs[i] = (int64_t)(wall - scenario->outages[i].endUs) / 1000;
+        }
+    }
+}
+
+// =============================================================================
+// TRANSPORT (firmware.ino, GPRS half)
+// =============================================================================
+
+static void setTransport(ConnectionType conn) {
+    if (conn == activeConnection) return;
+
+    ConnectionType prev = activeConnection;
+    activeConnection = conn;
+    publishTransportEvent(conn, prev);
+}
+
+static void ensureMQTTTransport(uint32_t currentMillis) {
+    if (isGPRSConnected()) {
+        if (activeConnection != CONN_GPRS) {
+            disconnectMQTT();
+            mqtt.setClient(gsmClient);
+            setTransport(CONN_GPRS);
+        }
+        return;
+    }
+
+    if (currentMillis - lastGPRSAttempt >= GPRS_RETRY_INTERVAL) {
+        lastGPRSAttempt = currentMillis;
+        stats->gprsAttempts++;
+        if (connectGPRS()) {
+            disconnectMQTT();
+            mqtt.setClient(gsmClient);
+            setTransport(CONN_GPRS);
+            return;
+        }
+    }
+
+    setTransport(CONN_NONE);
+}
+
+// =============================================================================
+// SCHEDULED JOBS
+// =============================================================================
+
+static void smsPollJob(void* ctx) {
+    // No incoming SMS in the scenarios; outgoing alert SMS go out from
+    // networkPass()
+}
+
+static void publishJobFn(void* ctx) {
+    uint64_t wall = wallNowUs();
+    if (lastPublishWallUs != 0 && wall - lastPublishWallUs > run->maxPublishGapUs) {
+        run->maxPublishGapUs = wall - lastPublishWallUs;
+    }
+    lastPublishWallUs = wall;
+
+    LatencyScope timer(LAT_PUBLISH_CYCLE);
+    ensureMQTTTransport(millis());
+
+    if (activeConnection != CONN_NONE) {
+        bool wasConnected = mqtt.connected();
+        if (connectMQTT()) {
+            if (!wasConnected) stats->connects++;
+            publishBufferedData();
+        }
+    }
+}
+
+static void diagJob(void* ctx) {
+    publishDiagnostics();
+    publishMemoryStats();
+}
+
+static void memJob(void* ctx) {
+    sampleMemStats();
+}
+
+// =============================================================================
+// TASK PASSES
+// =============================================================================
+
+static void sensePass() {
+    uint64_t wall = wallNowUs();
+    if (lastSenseWallUs != 0 && wall - lastSenseWallUs > run->maxSenseGapUs) {
+        run->maxSenseGapUs = wall - lastSenseWallUs;
+    }
+    lastSenseWallUs = wall;
+
+    plantApply(plantAt(wall, inWindow(scenario->faults, scenario->faultCount, wall)));
+    {
+        LatencyScope timer(LAT_SENSOR_READ);
+        currentData = readAllSensors();
+    }
+    checkAllAlerts(currentData);
+    publishReadingEvent(currentData);
+
+    stats->readings++;
+    if (!linkUp) run->readingsOffline++;
+}
+
+static void networkPass() {
+    uint32_t passStart = micros();
+
+    SystemData reading;
+    while (receiveReading(reading, 0)) {
+        if (isBufferFull()) stats->overflowed++;
+        bufferData(reading);
+    }
+
+    serviceModemRestart();
+    OutgoingSMS sms;
+    while (receiveSMS(sms)) {
+        if (sendQueuedSMS(sms) && sms.alertType >= 0) onAlertSmsSent(sms.alertType);
+    }
+
+    netSched.runOnce();
+
+    if (activeConnection == CONN_GPRS && !isGPRSConnected()) {
+        disconnectMQTT();
+        setTransport(CONN_NONE);
+    }
+    mqttLoop();
+    latencyRecord(LAT_NET_PASS, micros() - passStart);
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+void simRunBoot(const SimScenario& sc, SimRun& r) {
+    scenario = &sc;
+    run = &r;
+    uint16_t bootIndex = r.boots++;
+    stats = &r.boot[bootIndex];
+    stats->firstPublishMs = -1;
+
+    // Power-on: the first boot may start late in the millis() range
+    bootWallUs = r.wallUs;
+    bootClockUs = bootIndex == 0 ? sc.startUptimeUs : 0;
+    hostClockManual(bootClockUs);
+    stats->startWallUs = bootWallUs;
+
+    uint64_t endWallUs = sc.durationUs;
+    bool brownout = false;
+    for (uint8_t i = 0; i < sc.brownoutCount; i++) {
+        if (sc.brownouts[i] > bootWallUs && sc.brownouts[i] < endWallUs) {
+            endWallUs = sc.brownouts[i];
+            brownout = true;
+            break;
+        }
+    }
+
+    // ---- setup() ----
+    setLink(!inWindow(sc.outages, sc.outageCount, bootWallUs));
+    plantApply(plantAt(bootWallUs, inWindow(sc.faults, sc.faultCount, bootWallUs)));
+
+    initTaskQueues();
+    initLatency();
+    initMemStats();
+    initSensors();
+    initAlerts();
+    loadConfig(runtimeCfg);
+    networkReady = true;   // Modem registered: alert SMS are queued
+
+    sensePass();
+    initBuffer();
+
+    mqtt.setServer(runtimeCfg.mqttHost, runtimeCfg.mqttPort);
+    mqtt.setCallback(mqttCallback);
+    mqtt.setKeepAlive(MQTT_KEEPALIVE_S);
+    mqtt.setBufferSize(JSON_BUFFER_SIZE);
+
+    netSched.add("sms", smsPollJob, nullptr, runtimeCfg.smsCheckInterval, NET_SMS_DEADLINE_MS, 1);
+    publishJob = netSched.add("publish", publishJobFn, nullptr, runtimeCfg.publishInterval,
+                              NET_PUBLISH_DEADLINE_MS, 0);
+    netSched.add("diag", diagJob, nullptr, DIAG_PUBLISH_INTERVAL, NET_DIAG_DEADLINE_MS, 2);
+    netSched.add("mem", memJob, nullptr, MEM_SAMPLE_INTERVAL_MS, MEM_SAMPLE_DEADLINE_MS, 3);
+
+    stats->heapStart = heapInUse();
+    uint64_t periodUs = (uint64_t)runtimeCfg.sensorReadInterval * 1000ULL;
+    uint64_t nextSenseUs = clockUs() + periodUs;
+    uint64_t nextSampleWallUs = bootWallUs;
+
+    // ---- Task passes, fast-forwarding between deadlines ----
+    for (;;) {
+        uint64_t wall = wallNowUs();
+        if (wall >= endWallUs) break;
+
+        bool up = !inWindow(sc.outages, sc.outageCount, wall);
+        if (up != linkUp) setLink(up);
+
+        uint64_t now = clockUs();
+        if (now >= nextSenseUs) {
+            // Overran a whole period: resynchronise instead of catching up
+            if (now - nextSenseUs > periodUs) nextSenseUs = now;
+            sensePass();
+            nextSenseUs += periodUs;
+        }
+
+        networkPass();
+        collectPublished();
+        checkRecovery();
+
+        wall = wallNowUs();
+        if (wall >= nextSampleWallUs) {
+            takeSample();
+            nextSampleWallUs += sc.sampleEveryUs;
+        }
+
+        // Earliest next event, in wall time
+        now = clockUs();
+        uint64_t nextWallUs = bootWallUs + (nextSenseUs - bootClockUs);
+        uint32_t schedMs = netSched.msUntilNext();
+        if (schedMs != UINT32_MAX) {
+            nextWallUs = std::min<uint64_t>(nextWallUs, wall + schedMs * 1000ULL);
+        }
+        nextWallUs = std::min(nextWallUs, nextEdge(sc.outages, sc.outageCount, wall));
+        nextWallUs = std::min(nextWallUs, nextSampleWallUs);
+        nextWallUs = std::min(nextWallUs, endWallUs);
+        if (nextWallUs > wall) hostAdvanceUs(nextWallUs - wall);
+    }
+
+    takeSample();
+    stats->pendingAtEnd = bufferCount();
+    stats->heapEnd = heapInUse();
+    stats->endWallUs = wallNowUs();
+
+    if (brownout) {
+        r.wallUs = endWallUs + sc.powerOffMs * 1000ULL;
+        r.finished = r.wallUs >= sc.durationUs;
+    } else {
+        r.finished = true;
+    }
+}
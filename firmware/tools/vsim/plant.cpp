@@ -0,0 +1,143 @@
+/**
+ * @file plant.cpp
+ * @brief Simulated heat pump: model and sensor front-end inverse
+ */
+
+#include "plant.h"
+#include <math.h>
+#include "host_hooks.h"
+#include "sensors.h"
+
+// =============================================================================
+// PRIVATE HELPERS
+// =============================================================================
+
+/**
+ * @brief Divider voltage at which the firmware's NTC math reads tempC
+ *
+ * Bisects ntcTemperature(), which falls as the voltage rises, so the
+ * plant always agrees with the firmware's own Steinhart-Hart constants.
+ * The fit peaks near 66 C (about 630 ohm) and is only monotonic below
+ * that, so the model keeps every temperature under it.
+ */
+static float ntcVolts(float tempC) {
+    float lo = 0.01f;
+    float hi = ADC_REFERENCE_VOLTAGE - 0.01f;
+    for (int i = 0; i < 40; i++) {
+        float mid = (lo + hi) / 2;
+        if (ntcTemperature(mid) > tempC) lo = mid;
+        else hi = mid;
+    }
+    return (lo + hi) / 2;
+}
+
+/**
+ * @brief Temperature pin, re-solved only when the value moves
+ */
+struct NtcPin {
+    uint8_t pin;
+    float tempC;
+};
+
+static NtcPin ntcPins[] = {
+    {PIN_TEMP_INLET, NAN},
+    {PIN_TEMP_OUTLET, NAN},
+    {PIN_TEMP_AMBIENT, NAN},
+    {PIN_TEMP_COMPRESSOR, NAN},
+};
+
+static void setNtc(uint8_t index, float tempC) {
+    NtcPin& p = ntcPins[index];
+    if (fabsf(p.tempC - tempC) < 0.01f) return;
+    p.tempC = tempC;
+    hostSetPinVolts(p.pin, ntcVolts(tempC));
+}
+
+/** @brief 50 Hz sine of rmsAtAdc volts RMS around offset */
+static HostWaveform mains(float rmsAtAdc, float offset) {
+    float peak = rmsAtAdc * sqrtf(2.0f);
+    return [=](uint64_t us) {
+        return offset + peak * (float)sin(2.0 * M_PI * 50.0 * (double)(us % 20000) / 1e6);
+    };
+}
+
+static float pressureVolts(float psi) {
+    return PRESSURE_MIN_VOLTAGE + psi / PRESSURE_MAX_PSI * (PRESSURE_MAX_VOLTAGE - PRESSURE_MIN_VOLTAGE);
+}
+
+// =============================================================================
+// IMPLEMENTATION
+// =============================================================================
+
+PlantState plantAt(uint64_t wallUs, bool fault) {
+    double t = wallUs / 1e6;
+    double day = fmod(t / 86400.0, 1.0);
+
+    PlantState s;
+    s.ambientC = 22.0f + 6.0f * (float)sin(2.0 * M_PI * (day - 0.375));  // Peak mid-afternoon
+    s.mainsV = 230.0f + 4.0f * (float)sin(2.0 * M_PI * day * 3.0);
+    bool running = fault || fmod(t, PLANT_CYCLE_S) < PLANT_ON_S;
+
+    if (running) {
+        s.currentA = fault ? PLANT_FAULT_CURRENT_A : PLANT_RUN_CURRENT_A;
+        s.inletC = 45.0f;
+        s.outletC = 50.0f;
+        s.compressorC = fault ? 62.0f : 55.0f;
+        s.pressureHighPsi = 280.0f;
+        s.pressureLowPsi = 70.0f;
+    } else {
+        s.currentA = 0.0f;
+        s.inletC = 40.0f;
+        s.outletC = 41.0f;
+        s.compressorC = s.ambientC + 10.0f;
+        s.pressureHighPsi = 160.0f;
+        s.pressureLowPsi = 120.0f;
+    }
+    return s;
+}
+
+void plantApply(const PlantState& s) {
+    setNtc(0, s.inletC);
+    setNtc(1, s.outletC);
+    setNtc(2, s.ambientC);
+    setNtc(3, s.compressorC);
+
+    hostSetPinWaveform(PIN_VOLTAGE, mains(s.mainsV / VOLTAGE_SCALE_FACTOR, ADC_REFERENCE_VOLTAGE / 2));
+    hostSetPinWaveform(PIN_CURRENT, mains(s.currentA * CT_OUTPUT_VOLTAGE_MAX / CT_CURRENT_MAX,
+                                          CT_BIAS_VOLTAGE));
+    hostSetPinVolts(PIN_PRESSURE_HIGH, pressureVolts(s.pressureHighPsi));
+    hostSetPinVolts(PIN_PRESSURE_LOW, pressureVolts(s.pressureLowPsi));
+}
+
+ThermalPlant thermalInit(float tankC, float ambientC, float loadKw) {
+    ThermalPlant p;
+    p.tankC = tankC;
+    p.riseC = 0.0f;
+    p.ambientC = ambientC;
+    p.loadKw = loadKw;
+    return p;
+}
+
+void thermalStep(ThermalPlant& p, float dtS, bool compressorOn, bool heating) {
+    float sign = heating ? 1.0f : -1.0f;
+    float target = compressorOn ? sign * PLANT_CAPACITY_KW / PLANT_FLOW_KW_PER_K : 0.0f;
+    p.riseC += (target - p.riseC) * (1.0f - expf(-dtS / PLANT_RISE_TAU_S));
+
+    // What the heat pump delivers is what the loop flow carries out of it
+    float kw = PLANT_FLOW_KW_PER_K * p.riseC
+             - PLANT_LOSS_KW_PER_K * (p.tankC - p.ambientC)
+             - sign * p.loadKw;
+    p.tankC += kw * dtS / PLANT_TANK_KJ_PER_K;
+}
+
+PlantState thermalState(uint64_t wallUs, const ThermalPlant& p, bool compressorOn) {
+    PlantState s = plantAt(wallUs, false);
+    s.ambientC = p.ambientC;
+    s.inletC = p.tankC;
+    s.outletC = p.tankC + p.riseC;
+    s.currentA = compressorOn ? PLANT_RUN_CURRENT_A : 0.0f;
+    s.compressorC = compressorOn ? 55.0f : p.ambientC + 10.0f;
+    s.pressureHighPsi = compressorOn ? 280.0f : 160.0f;
+    s.pressureLowPsi = compressorOn ? 70.0f : 120.0f;
+    return s;
+}
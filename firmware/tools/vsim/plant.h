@@ -0,0 +1,97 @@
+/**
+ * @file plant.h
+ * @brief Simulated heat pump for the virtual-time harness
+ *
+ * The plant is a pure function of scenario (wall) time: a daily ambient
+ * swing, a 30 minute compressor duty cycle and optional fault windows
+ * (a labouring compressor: stuck on and drawing past the overcurrent
+ * limit). plantApply() turns a state into the voltages the firmware's
+ * sensors expect on each ADC pin, so readAllSensors() runs unmodified.
+ *
+ * For closed-loop work the water side has a dynamic model as well
+ * (ThermalPlant): a buffer tank losing heat to ambient and to the
+ * building load, charged by the heat pump while the compressor runs. The
+ * outlet sits above the tank (below it when cooling) by the rise the
+ * capacity gives at the loop flow, reached with a first-order lag.
+ */
+
+#ifndef VSIM_PLANT_H
+#define VSIM_PLANT_H
+
+#include <stdint.h>
+
+// =============================================================================
+// PLANT CONFIGURATION
+// =============================================================================
+
+#define PLANT_CYCLE_S          1800    ///< Compressor on/off cycle
+#define PLANT_ON_S             1200    ///< Compressor on time per cycle
+#define PLANT_RUN_CURRENT_A    8.5f
+#define PLANT_FAULT_CURRENT_A  16.5f   ///< Above CURRENT_CRITICAL
+
+#define PLANT_CAPACITY_KW      5.0f    ///< Heat moved with the compressor on
+#define PLANT_FLOW_KW_PER_K    1.25f   ///< Loop flow (0.3 kg/s of water): 4 C rise
+#define PLANT_TANK_KJ_PER_K    840.0f  ///< 200 l buffer tank
+#define PLANT_LOSS_KW_PER_K    0.05f   ///< Tank to ambient
+#define PLANT_RISE_TAU_S       90.0f   ///< Outlet lag after a start or stop
+
+// =============================================================================
+// DATA STRUCTURES
+// =============================================================================
+
+/**
+ * @brief Physical quantities at the sensors
+ */
+struct PlantState {
+    float inletC;
+    float outletC;
+    float ambientC;
+    float compressorC;
+    float mainsV;        ///< RMS
+    float currentA;      ///< RMS
+    float pressureHighPsi;
+    float pressureLowPsi;
+};
+
+/**
+ * @brief Water side state
+ */
+struct ThermalPlant {
+    float tankC;         ///< Tank and return (inlet) water
+    float riseC;         ///< Outlet minus inlet
+    float ambientC;
+    float loadKw;        ///< Heat drawn by the building (heating) or added (cooling)
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Plant state at a scenario time
+ * @param fault Compressor stuck on and drawing past CURRENT_CRITICAL
+ */
+PlantState plantAt(uint64_t wallUs, bool fault);
+
+/**
+ * @brief Drive the ADC pins (host_hooks) to read as state
+ */
+void plantApply(const PlantState& state);
+
+/**
+ * @brief Tank at tankC, outlet settled with the compressor off
+ */
+ThermalPlant thermalInit(float tankC, float ambientC, float loadKw);
+
+/**
+ * @brief Advance the water side by dtS seconds
+ * @param heating Direction of the heat pump (false: cooling)
+ */
+void thermalStep(ThermalPlant& plant, float dtS, bool compressorOn, bool heating);
+
+/**
+ * @brief Plant state at a scenario time with the water side from plant
+ */
+PlantState thermalState(uint64_t wallUs, const ThermalPlant& plant, bool compressorOn);
+
+#endif // VSIM_PLANT_H
@@ -0,0 +1,478 @@
+/**
+ * @file vsim.cpp
+ * @brief Virtual-time simulation harness: scenarios, checks and report
+ *
+ * Runs weeks of firmware behaviour in seconds on the host build. Each
+ * scenario is played boot by boot (see device.cpp), then checked for
+ * correctness and summarised with resource-usage trends.
+ *
+ * Scenarios:
+ *   wrap      millis() wraps (49.7 days of uptime) during a persistent
+ *             critical alert: cooldowns, the scheduler and reading order
+ *             must hold across it
+ *   outage    a week without cellular coverage: the buffer keeps the
+ *             newest readings, retries stay paced, the backlog is
+ *             flushed on return and the heap stays flat
+ *   brownout  two days with repeated supply collapses during an outage
+ *             and a plant fault: every boot recovers and only readings
+ *             still in RAM are lost
+ *
+ * Usage:
+ *   vsim                       all scenarios
+ *   vsim --scenario outage --trend
+ *   vsim --json vsim.json
+ *
+ * Exit status 1 if any check fails.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "vsim.h"
+#include "buffer.h"
+#include "mqtt.h"
+
+// =============================================================================
+// SCENARIOS
+// =============================================================================
+
+/** @brief 32-bit millis() range in device-clock microseconds */
+static const uint64_t MILLIS_WRAP_US = (1ULL << 32) * 1000ULL;
+
+static SimScenario wrapScenario() {
+    SimScenario sc = {};
+    sc.name = "wrap";
+    sc.description = "49-day millis() wraparound during a critical alert";
+    sc.durationUs = 2 * VSIM_US_PER_H;
+    sc.startUptimeUs = MILLIS_WRAP_US - 30 * VSIM_US_PER_MIN;  // Wraps 30 min in
+    // Reminders fall due 2 min before the wrap and 3 min after it
+    sc.faults[sc.faultCount++] = {12 * VSIM_US_PER_MIN, 82 * VSIM_US_PER_MIN};
+    sc.sampleEveryUs = 10 * VSIM_US_PER_MIN;
+    return sc;
+}
+
+static SimScenario outageScenario() {
+    SimScenario sc = {};
+    sc.name = "outage";
+    sc.description = "week-long cellular outage";
+    sc.durationUs = 7 * VSIM_US_PER_DAY + 3 * VSIM_US_PER_H;
+    sc.outages[sc.outageCount++] = {VSIM_US_PER_H, VSIM_US_PER_H + 7 * VSIM_US_PER_DAY};
+    sc.sampleEveryUs = VSIM_US_PER_H;
+    return sc;
+}
+
+static SimScenario brownoutScenario() {
+    SimScenario sc = {};
+    sc.name = "brownout";
+    sc.description = "repeated brown-outs through an outage and a plant fault";
+    sc.durationUs = 2 * VSIM_US_PER_DAY;
+    sc.outages[sc.outageCount++] = {10 * VSIM_US_PER_H, 16 * VSIM_US_PER_H};
+    sc.faults[sc.faultCount++] = {30 * VSIM_US_PER_H, 33 * VSIM_US_PER_H};
+    sc.powerOffMs = 5000;
+    sc.sampleEveryUs = 30 * VSIM_US_PER_MIN;
+
+    // Roughly every two hours, jittered by a fixed LCG so runs compare
+    uint32_t seed = 12345;
+    uint64_t t = 0;
+    while (sc.brownoutCount < 24) {
+        seed = seed * 1103515245u + 12345u;
+        t += VSIM_US_PER_H + (uint64_t)((seed >> 8) % 7200) * VSIM_US_PER_S;
+        if (t >= sc.durationUs) break;
+        sc.brownouts[sc.brownoutCount++] = t;
+    }
+    return sc;
+}
+
+// =============================================================================
+// RUNNER
+// =============================================================================
+
+/**
+ * @brief Play a scenario, one forked process per boot
+ * @return Shared observations (never freed; the process is short-lived)
+ */
+static SimRun* runScenario(const SimScenario& sc) {
+    SimRun* run = (SimRun*)mmap(nullptr, sizeof(SimRun), PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (run == MAP_FAILED) {
+        perror("mmap");
+        exit(2);
+    }
+    memset(run, 0, sizeof(SimRun));
+    run->minReminderGapMs = -1;
+    for (int i = 0; i < VSIM_MAX_WINDOWS; i++) run->recoveryMs[i] = -1;
+
+    fflush(stdout);
+    while (!run->finished && run->boots < VSIM_MAX_BOOTS) {
+        // The parent never touches firmware state, so every child boots
+        // with pristine statics - exactly what a brown-out leaves behind
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            exit(2);
+        }
+        if (pid == 0) {
+            simRunBoot(sc, *run);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "[VSIM] %s: boot %u died (status 0x%x)\n", sc.name, run->boots, status);
+            exit(2);
+        }
+    }
+    return run;
+}
+
+// =============================================================================
+// CHECKS
+// =============================================================================
+
+struct SimCheck {
+    std::string name;
+    bool pass;
+    std::string detail;
+};
+
+struct SimTotals {
+    uint64_t readings = 0;
+    uint64_t published = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t overflowed = 0;
+    uint64_t pendingLost = 0;   ///< In RAM at a brown-out
+    uint64_t pendingEnd = 0;    ///< In RAM at the end of the scenario
+    uint64_t gprsAttempts = 0;
+    uint64_t connects = 0;
+};
+
+static SimTotals totals(const SimRun& run) {
+    SimTotals t;
+    for (uint16_t i = 0; i < run.boots; i++) {
+        const SimBootStats& b = run.boot[i];
+        t.readings += b.readings;
+        t.published += b.published;
+        t.outOfOrder += b.outOfOrder;
+        t.overflowed += b.overflowed;
+        t.gprsAttempts += b.gprsAttempts;
+        t.connects += b.connects;
+        if (i + 1 < run.boots) t.pendingLost += b.pendingAtEnd;
+        else t.pendingEnd += b.pendingAtEnd;
+    }
+    return t;
+}
+
+static std::string fmt(const char* format, ...) __attribute__((format(printf, 1, 2)));
+static std::string fmt(const char* format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    return buf;
+}
+
+/**
+ * @brief Least-squares heap slope over one boot's samples, bytes per day
+ */
+static double heapSlopePerDay(const SimRun& run, uint16_t boot, uint64_t afterUs) {
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (uint16_t i = 0; i < run.sampleCount; i++) {
+        const SimSample& s = run.samples[i];
+        if (s.boot != boot || s.wallUs < afterUs) continue;
+        double x = s.wallUs / (double)VSIM_US_PER_DAY;
+        n++;
+        sx += x;
+        sy += s.heapBytes;
+        sxx += x * x;
+        sxy += x * s.heapBytes;
+    }
+    double den = n * sxx - sx * sx;
+    return n >= 3 && den > 0 ? (n * sxy - sx * sy) / den : 0;
+}
+
+static void commonChecks(const SimRun& run, const SimTotals& t, std::vector<SimCheck>& out) {
+    uint64_t accounted = t.published + t.overflowed + t.pendingLost + t.pendingEnd;
+    out.push_back({"every reading accounted for", accounted == t.readings,
+                   fmt("%llu readings = %llu published + %llu overwritten + %llu lost at power-off"
+                       " + %llu pending",
+                       (unsigned long long)t.readings, (unsigned long long)t.published,
+                       (unsigned long long)t.overflowed, (unsigned long long)t.pendingLost,
+                       (unsigned long long)t.pendingEnd)});
+    out.push_back({"published in timestamp order", t.outOfOrder == 0,
+                   fmt("%llu out of order", (unsigned long long)t.outOfOrder)});
+    out.push_back({"critical reminders respect the cooldown", run.cooldownViolations == 0,
+                   fmt("%u violations, shortest gap %.1f s (cooldown %.0f s)",
+                       run.cooldownViolations, run.minReminderGapMs / 1000.0,
+                       ALERT_COOLDOWN / 1000.0)});
+}
+
+static std::vector<SimCheck> checkWrap(const SimScenario& sc, const SimRun& run) {
+    std::vector<SimCheck> out;
+    SimTotals t = totals(run);
+    commonChecks(run, t, out);
+
+    // The fault spans the wrap, so reminders must have gone out on both sides
+    uint32_t expected = (uint32_t)((sc.faults[0].endUs - sc.faults[0].startUs) /
+                                   (ALERT_COOLDOWN * 1000ULL));
+    out.push_back({"critical alert repeated through the wrap", run.criticalSms >= expected,
+                   fmt("%u critical SMS, expected >= %u", run.criticalSms, expected)});
+    out.push_back({"readings on schedule across the wrap",
+                   run.maxSenseGapUs <= SENSOR_READ_INTERVAL * 1500ULL,
+                   fmt("longest gap %.2f s (period %.1f s)", run.maxSenseGapUs / 1e6,
+                       SENSOR_READ_INTERVAL / 1000.0)});
+    out.push_back({"publish cycle on schedule across the wrap",
+                   run.maxPublishGapUs <= MQTT_PUBLISH_INTERVAL * 1500ULL,
+                   fmt("longest gap %.2f s (period %.1f s)", run.maxPublishGapUs / 1e6,
+                       MQTT_PUBLISH_INTERVAL / 1000.0)});
+    out.push_back({"nothing lost", t.overflowed == 0,
+                   fmt("%llu readings overwritten", (unsigned long long)t.overflowed)});
+    return out;
+}
+
+static std::vector<SimCheck> checkOutage(const SimScenario& sc, const SimRun& run) {
+    std::vector<SimCheck> out;
+    SimTotals t = totals(run);
+    commonChecks(run, t, out);
+
+    const SimWindow& w = sc.outages[0];
+    uint64_t outageMs = (w.endUs - w.startUs) / 1000;
+
+    // Everything taken offline beyond the newest BUFFER_SIZE is overwritten,
+    // plus whatever arrives before the first GPRS retry after the outage
+    uint64_t minLost = run.readingsOffline > BUFFER_SIZE ? run.readingsOffline - BUFFER_SIZE : 0;
+    uint64_t maxLost = minLost + GPRS_RETRY_INTERVAL / SENSOR_READ_INTERVAL + 1;
+    out.push_back({"buffer keeps the newest readings",
+                   minLost > 0 && t.overflowed >= minLost && t.overflowed <= maxLost,
+                   fmt("%u taken offline, %llu overwritten, capacity %d", run.readingsOffline,
+                       (unsigned long long)t.overflowed, BUFFER_SIZE)});
+
+    uint64_t minAttempts = outageMs / GPRS_RETRY_INTERVAL;
+    out.push_back({"GPRS retries paced", t.gprsAttempts >= minAttempts && t.gprsAttempts <= minAttempts + 3,
+                   fmt("%llu attempts over %.1f days (one per %.0f s expected)",
+                       (unsigned long long)t.gprsAttempts, outageMs / 86400000.0,
+                       GPRS_RETRY_INTERVAL / 1000.0)});
+
+    int64_t bound = GPRS_RETRY_INTERVAL + MQTT_PUBLISH_INTERVAL +
+                    BUFFER_SIZE * (int64_t)MQTT_BACKLOG_GAP_MS + 5000;
+    out.push_back({"backlog flushed after the outage", run.recoveryMs[0] >= 0 && run.recoveryMs[0] <= bound,
+                   fmt("%.1f s after coverage returned (bound %.1f s)", run.recoveryMs[0] / 1000.0,
+                       bound / 1000.0)});
+
+    double slope = heapSlopePerDay(run, 0, VSIM_US_PER_DAY);
+    out.push_back({"heap flat over the week", slope < 1024.0 && slope > -1024.0,
+                   fmt("%+.0f bytes/day after the first day", slope)});
+
+    uint32_t drops = run.sampleCount ? run.samples[run.sampleCount - 1].eventDrops : 0;
+    out.push_back({"no event bus drops", drops == 0, fmt("%u dropped", drops)});
+    return out;
+}
+
+static std::vector<SimCheck> checkBrownout(const SimScenario& sc, const SimRun& run) {
+    std::vector<SimCheck> out;
+    SimTotals t = totals(run);
+    commonChecks(run, t, out);
+
+    out.push_back({"every brown-out rebooted", run.boots == sc.brownoutCount + 1,
+                   fmt("%u boots for %u brown-outs", run.boots, sc.brownoutCount)});
+
+    // With coverage, the first GPRS attempt waits one retry interval
+    int64_t bound = GPRS_RETRY_INTERVAL + MQTT_PUBLISH_INTERVAL + 5000;
+    uint16_t eligible = 0;
+    uint16_t late = 0;
+    int64_t worst = 0;
+    for (uint16_t i = 0; i < run.boots; i++) {
+        const SimBootStats& b = run.boot[i];
+        bool covered = true;
+        for (uint8_t k = 0; k < sc.outageCount; k++) {
+            if (b.startWallUs < sc.outages[k].endUs && b.startWallUs + bound * 1000ULL > sc.outages[k].startUs) {
+                covered = false;
+            }
+        }
+        if (!covered || b.endWallUs - b.startWallUs < (uint64_t)bound * 1000ULL) continue;
+        eligible++;
+        if (b.firstPublishMs < 0 || b.firstPublishMs > bound) late++;
+        worst = std::max(worst, b.firstPublishMs);
+    }
+    out.push_back({"publishing resumes after every boot", eligible > 0 && late == 0,
+                   fmt("%u of %u boots late, slowest first publish %.1f s (bound %.1f s)",
+                       late, eligible, worst / 1000.0, bound / 1000.0)});
+
+    uint32_t maxLost = 0;
+    for (uint16_t i = 0; i + 1 < run.boots; i++) maxLost = std::max(maxLost, run.boot[i].pendingAtEnd);
+    out.push_back({"loss per brown-out bounded by the buffer", maxLost <= BUFFER_SIZE,
+                   fmt("%llu readings lost at power-off in total, at most %u at once",
+                       (unsigned long long)t.pendingLost, maxLost)});
+    return out;
+}
+
+// =============================================================================
+// REPORT
+// =============================================================================
+
+static void printTrend(const SimRun& run) {
+    printf("[VSIM]   %8s %5s %12s %6s %9s %9s %6s %6s %4s\n",
+           "wall h", "boot", "uptime ms", "buf", "heap B", "log B", "drops", "misses", "up");
+    for (uint16_t i = 0; i < run.sampleCount; i++) {
+        const SimSample& s = run.samples[i];
+        printf("[VSIM]   %8.2f %5u %12lu %6u %9u %9u %6u %6u %4s\n",
+               s.wallUs / (double)VSIM_US_PER_H, s.boot, (unsigned long)s.uptimeMs, s.buffered,
+               s.heapBytes, s.logBytes, s.eventDrops, s.publishMisses, s.online ? "yes" : "no");
+    }
+}
+
+static void printSummary(const SimScenario& sc, const SimRun& run, double realS) {
+    SimTotals t = totals(run);
+    double simH = sc.durationUs / (double)VSIM_US_PER_H;
+
+    uint32_t heapMin = UINT32_MAX, heapMax = 0, maxBuffered = 0;
+    uint64_t logBytes = 0;
+    for (uint16_t i = 0; i < run.sampleCount; i++) {
+        const SimSample& s = run.samples[i];
+        heapMin = std::min(heapMin, s.heapBytes);
+        heapMax = std::max(heapMax, s.heapBytes);
+        maxBuffered = std::max<uint32_t>(maxBuffered, s.buffered);
+        // Log output restarts at each boot; sum the last sample of each
+        if (i + 1 == run.sampleCount || run.samples[i + 1].boot != s.boot) logBytes += s.logBytes;
+    }
+
+    printf("[VSIM] %s: %s\n", sc.name, sc.description);
+    printf("[VSIM]   simulated %.1f h in %.2f s (%.0fx), %u boot%s\n", simH, realS,
+           realS > 0 ? simH * 3600.0 / realS : 0.0, run.boots, run.boots == 1 ? "" : "s");
+    printf("[VSIM]   readings %llu, published %llu, overwritten %llu, lost at power-off %llu,"
+           " pending %llu\n",
+           (unsigned long long)t.readings, (unsigned long long)t.published,
+           (unsigned long long)t.overflowed, (unsigned long long)t.pendingLost,
+           (unsigned long long)t.pendingEnd);
+    printf("[VSIM]   MQTT connects %llu, GPRS attempts %llu, critical SMS %u\n",
+           (unsigned long long)t.connects, (unsigned long long)t.gprsAttempts, run.criticalSms);
+    printf("[VSIM]   heap %u..%u B, peak buffer %u/%d, log %.1f KB/day\n",
+           heapMin == UINT32_MAX ? 0 : heapMin, heapMax, maxBuffered, BUFFER_SIZE,
+           logBytes / 1024.0 / (sc.durationUs / (double)VSIM_US_PER_DAY));
+}
+
+static bool printChecks(const std::vector<SimCheck>& checks) {
+    bool ok = true;
+    for (const SimCheck& c : checks) {
+        printf("[VSIM]   %s  %s: %s\n", c.pass ? "PASS" : "FAIL", c.name.c_str(), c.detail.c_str());
+        ok &= c.pass;
+    }
+    return ok;
+}
+
+static void writeJsonScenario(FILE* f, const SimScenario& sc, const SimRun& run,
+                              const std::vector<SimCheck>& checks, double realS) {
+    SimTotals t = totals(run);
+    fprintf(f, "{\"name\":\"%s\",\"sim_hours\":%.2f,\"real_s\":%.3f,\"boots\":%u,"
+               "\"readings\":%llu,\"published\":%llu,\"overwritten\":%llu,\"lost_power_off\":%llu,"
+               "\"critical_sms\":%u,\"cooldown_violations\":%u,\"checks\":[",
+            sc.name, sc.durationUs / (double)VSIM_US_PER_H, realS, run.boots,
+            (unsigned long long)t.readings, (unsigned long long)t.published,
+            (unsigned long long)t.overflowed, (unsigned long long)t.pendingLost,
+            run.criticalSms, run.cooldownViolations);
+    for (size_t i = 0; i < checks.size(); i++) {
+        fprintf(f, "%s{\"name\":\"%s\",\"pass\":%s,\"detail\":\"%s\"}", i ? "," : "",
+                checks[i].name.c_str(), checks[i].pass ? "true" : "false", checks[i].detail.c_str());
+    }
+    fprintf(f, "],\"samples\":[");
+    for (uint16_t i = 0; i < run.sampleCount; i++) {
+        const SimSample& s = run.samples[i];
+        fprintf(f, "%s{\"wall_s\":%llu,\"boot\":%u,\"uptime_ms\":%lu,\"buffered\":%u,\"heap\":%u,"
+                   "\"log\":%u,\"event_drops\":%u,\"publish_misses\":%u,\"online\":%s}",
+                i ? "," : "", (unsigned long long)(s.wallUs / VSIM_US_PER_S), s.boot,
+                (unsigned long)s.uptimeMs, s.buffered, s.heapBytes, s.logBytes, s.eventDrops,
+                s.publishMisses, s.online ? "true" : "false");
+    }
+    fprintf(f, "]}");
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+typedef SimScenario (*ScenarioFn)();
+typedef std::vector<SimCheck> (*CheckFn)(const SimScenario&, const SimRun&);
+
+struct ScenarioEntry {
+    ScenarioFn make;
+    CheckFn check;
+};
+
+static const ScenarioEntry SCENARIOS[] = {
+    {wrapScenario, checkWrap},
+    {outageScenario, checkOutage},
+    {brownoutScenario, checkBrownout},
+};
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--scenario wrap|outage|brownout] [--trend] [--json FILE]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    const char* jsonPath = nullptr;
+    bool trend = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--trend") == 0) {
+            trend = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    FILE* json = nullptr;
+    if (jsonPath != nullptr) {
+        json = fopen(jsonPath, "w");
+        if (json == nullptr) {
+            perror(jsonPath);
+            return 2;
+        }
+        fprintf(json, "{\"suite\":\"vsim\",\"version\":\"%s\",\"scenarios\":[", FIRMWARE_VERSION);
+    }
+
+    bool allOk = true;
+    int ran = 0;
+    for (const ScenarioEntry& e : SCENARIOS) {
+        SimScenario sc = e.make();
+        if (only != nullptr && strcmp(only, sc.name) != 0) continue;
+
+        auto t0 = std::chrono::steady_clock::now();
+        SimRun* run = runScenario(sc);
+        double realS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::vector<SimCheck> checks = e.check(sc, *run);
+        if (ran) printf("\n");
+        printSummary(sc, *run, realS);
+        if (trend) printTrend(*run);
+        allOk &= printChecks(checks);
+
+        if (json != nullptr) {
+            if (ran) fputc(',', json);
+            writeJsonScenario(json, sc, *run, checks, realS);
+        }
+        ran++;
+    }
+
+    if (json != nullptr) {
+        fprintf(json, "]}\n");
+        fclose(json);
+    }
+    if (ran == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file vsim.h
+ * @brief Virtual-time firmware simulation: scenarios and observations
+ *
+ * A scenario describes the outside world as a function of wall time:
+ * link outages, plant fault windows and brown-outs. simRunBoot() plays one
+ * boot of the firmware against it on the host's manual clock, skipping
+ * straight to the next sensing tick, scheduler release or scenario edge.
+ * Each boot runs in its own forked process so a brown-out really loses
+ * every RAM-resident module state. Observations accumulate in a SimRun
+ * that lives in shared memory and survives those reboots.
+ */
+
+#ifndef VSIM_H
+#define VSIM_H
+
+#include <stdint.h>
+#include "types.h"
+
+// =============================================================================
+// LIMITS
+// =============================================================================
+
+#define VSIM_MAX_WINDOWS    8
+#define VSIM_MAX_BROWNOUTS  64
+#define VSIM_MAX_BOOTS      (VSIM_MAX_BROWNOUTS + 1)
+#define VSIM_MAX_SAMPLES    2048
+
+#define VSIM_US_PER_S   1000000ULL
+#define VSIM_US_PER_MIN (60ULL * VSIM_US_PER_S)
+#define VSIM_US_PER_H   (60ULL * VSIM_US_PER_MIN)
+#define VSIM_US_PER_DAY (24ULL * VSIM_US_PER_H)
+
+// =============================================================================
+// SCENARIO
+// =============================================================================
+
+/**
+ * @brief [startUs, endUs) in wall time
+ */
+struct SimWindow {
+    uint64_t startUs;
+    uint64_t endUs;
+};
+
+struct SimScenario {
+    const char* name;
+    const char* description;
+    uint64_t durationUs;
+    uint64_t startUptimeUs;         ///< Device clock at the first boot
+    SimWindow outages[VSIM_MAX_WINDOWS];   ///< Cellular network gone
+    uint8_t outageCount;
+    SimWindow faults[VSIM_MAX_WINDOWS]; ///< Compressor overcurrent
+    uint8_t faultCount;
+    uint64_t brownouts[VSIM_MAX_BROWNOUTS];  ///< Supply collapses (ascending)
+    uint8_t brownoutCount;
+    uint32_t powerOffMs;            ///< Dead time after each brown-out
+    uint64_t sampleEveryUs;         ///< Resource trend interval
+};
+
+// =============================================================================
+// OBSERVATIONS
+// =============================================================================
+
+/**
+ * @brief One resource-usage sample
+ */
+struct SimSample {
+    uint64_t wallUs;
+    uint16_t boot;
+    uint32_t uptimeMs;      ///< millis() as the firmware sees it
+    uint16_t buffered;
+    uint32_t heapBytes;     ///< Host heap in use (process-wide)
+    uint32_t logBytes;      ///< Log output since boot
+    uint32_t eventDrops;
+    uint32_t publishMisses;
+    bool online;
+};
+
+struct SimBootStats {
+    uint64_t startWallUs;
+    uint64_t endWallUs;
+    uint32_t readings;
+    uint32_t published;       ///< Distinct /data messages
+    uint32_t outOfOrder;      ///< Timestamp not after the previous one
+    uint32_t overflowed;      ///< Readings overwritten in the buffer
+    uint32_t pendingAtEnd;    ///< Buffered, unpublished at brown-out or end
+    uint32_t gprsAttempts;
+    uint32_t connects;
+    int64_t firstPublishMs;   ///< Uptime of the first publish, -1 if none
+    uint32_t heapStart;
+    uint32_t heapEnd;
+};
+
+/**
+ * @brief Everything observed over a scenario (shared across reboots)
+ */
+struct SimRun {
+    uint64_t wallUs;                ///< Next boot starts here
+    uint16_t boots;
+    bool finished;
+    SimBootStats boot[VSIM_MAX_BOOTS];
+
+    uint32_t readingsOffline;       ///< Taken inside an outage window
+    uint32_t criticalSms;           ///< Critical alert SMS sent
+    uint32_t cooldownViolations;    ///< Critical SMS closer than the cooldown
+    int64_t minReminderGapMs;       ///< -1 until a reminder is seen
+    uint64_t maxSenseGapUs;         ///< Between readings within a boot
+    uint64_t maxPublishGapUs;       ///< Between publish cycles within a boot
+    int64_t recoveryMs[VSIM_MAX_WINDOWS];  ///< Outage end to empty buffer, -1 if never
+
+    SimSample samples[VSIM_MAX_SAMPLES];
+    uint16_t sampleCount;
+};
+
+// =============================================================================
+// FUNCTION DECLARATIONS
+// =============================================================================
+
+/**
+ * @brief Boot the firmware at run.wallUs and run it until the next
+ * brown-out or the end of the scenario (in a fresh process)
+ */
+void simRunBoot(const SimScenario& sc, SimRun& run);
+
+#endif // VSIM_H